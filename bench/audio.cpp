@@ -0,0 +1,75 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+using namespace vcml::audio;
+
+struct conversion {
+    u32 src_format;
+    u32 src_channels;
+    u32 src_rate;
+    u32 dst_format;
+    u32 dst_channels;
+    u32 dst_rate;
+};
+
+static const conversion CONVERSIONS[] = {
+    { FORMAT_S16LE, 2, 48000, FORMAT_S16BE, 2, 48000 }, // endian
+    { FORMAT_U8, 2, 48000, FORMAT_S32LE, 2, 48000 },    // width, sign
+    { FORMAT_S16LE, 2, 48000, FORMAT_F32LE, 2, 48000 }, // int to float
+    { FORMAT_F32LE, 2, 48000, FORMAT_S16LE, 2, 48000 }, // float to int
+    { FORMAT_S16LE, 1, 48000, FORMAT_S16LE, 2, 48000 }, // upmix
+    { FORMAT_S16LE, 6, 48000, FORMAT_S16LE, 2, 48000 }, // downmix
+    { FORMAT_S16LE, 2, 44100, FORMAT_S16LE, 2, 48000 }, // upsample
+    { FORMAT_S16LE, 2, 48000, FORMAT_S16LE, 2, 16000 }, // downsample
+};
+
+static void audio_convert(benchmark::State& state) {
+    const conversion& c = CONVERSIONS[state.range(0)];
+    const size_t frames = 4096;
+
+    converter conv;
+    conv.configure(c.src_format, c.src_channels, c.src_rate, c.dst_format,
+                   c.dst_channels, c.dst_rate);
+
+    vector<u8> input(frames * conv.src_frame_size());
+    for (size_t i = 0; i < input.size(); i++)
+        input[i] = (u8)(i * 37);
+
+    vector<u8> output;
+    output.reserve(4 * frames * conv.dst_frame_size());
+
+    for (auto _ : state) {
+        output.clear();
+        conv.convert(input.data(), input.size(), output);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetLabel(mkstr("%s/%u/%u > %s/%u/%u", format_str(c.src_format),
+                         c.src_channels, c.src_rate, format_str(c.dst_format),
+                         c.dst_channels, c.dst_rate));
+    state.SetItemsProcessed(state.iterations() * frames);
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(audio_convert)->ArgName("conversion")->DenseRange(0, 7);
+
+static void audio_fill_silence(benchmark::State& state) {
+    vector<u8> buffer(state.range(0));
+    for (auto _ : state) {
+        fill_silence(buffer.data(), buffer.size(), FORMAT_U16LE);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(audio_fill_silence)->ArgName("bytes")->Range(256, 64 * KiB);
@@ -0,0 +1,112 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+struct fixture_info {
+    string name;
+    bench_fixture::factory create;
+    bench_fixture* instance;
+};
+
+static std::map<std::type_index, fixture_info>& fixtures() {
+    static std::map<std::type_index, fixture_info> db;
+    return db;
+}
+
+bench_fixture::bench_fixture(const sc_module_name& nm):
+    component(nm), m_reset("reset"), m_clock("clock", 100 * MHz) {
+    m_reset.rst.bind(rst);
+    m_clock.clk.bind(clk);
+}
+
+bool bench_fixture::define(const std::type_index& type, const char* name,
+                           factory create) {
+    return fixtures().emplace(type, fixture_info{ name, create, nullptr })
+        .second;
+}
+
+bench_fixture* bench_fixture::find(const std::type_index& type) {
+    auto it = fixtures().find(type);
+    return it != fixtures().end() ? it->second.instance : nullptr;
+}
+
+void bench_fixture::create_all() {
+    for (auto& [type, info] : fixtures()) {
+        if (info.instance == nullptr)
+            info.instance = info.create();
+    }
+}
+
+void bench_fixture::destroy_all() {
+    for (auto& [type, info] : fixtures()) {
+        delete info.instance;
+        info.instance = nullptr;
+    }
+}
+
+class bench_runner : public sc_core::sc_module
+{
+public:
+    int result;
+
+    bench_runner(const sc_module_name& nm): sc_module(nm), result(0) {
+        SC_HAS_PROCESS(bench_runner);
+        SC_THREAD(run);
+        set_stack_size(16 * MiB); // benchmark reporters need some stack
+    }
+
+    void run() {
+        wait(SC_ZERO_TIME);
+        if (benchmark::RunSpecifiedBenchmarks() == 0)
+            result = EXIT_FAILURE;
+        benchmark::Shutdown();
+        sc_stop();
+    }
+};
+
+// google benchmark rejects arguments it does not know, so the property
+// options need to be removed once the broker has picked them up
+static void strip_broker_args(int& argc, char** argv) {
+    int n = 1;
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--config") == 0 || strcmp(argv[i], "-c") == 0) &&
+            i + 1 < argc) {
+            i++;
+            continue;
+        }
+
+        argv[n++] = argv[i];
+    }
+
+    argc = n;
+    argv[argc] = nullptr;
+}
+
+int main(int argc, char** argv) {
+    ::mwr::report_segfaults();
+    ::mwr::publishers::terminal publisher;
+    ::vcml::broker_arg broker(argc, argv);
+
+    strip_broker_args(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return EXIT_FAILURE;
+
+    return sc_core::sc_elab_and_sim(argc, argv);
+}
+
+extern "C" int sc_main(int argc, char** argv) {
+    bench_fixture::create_all();
+    bench_runner runner("bench");
+    sc_core::sc_start();
+    bench_fixture::destroy_all();
+    return runner.result;
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_BENCH_H
+#define VCML_BENCH_H
+
+#include <benchmark/benchmark.h>
+
+#include <systemc>
+#include <typeindex>
+#include "vcml.h"
+
+using namespace ::sc_core;
+using namespace ::vcml;
+
+// Benchmarks run from within an SC_THREAD, so they may issue TLM accesses
+// and call wait. Models must be created during elaboration; a benchmark
+// therefore declares its models inside a fixture, which is instantiated
+// before simulation starts and retrieved via bench_fixture::get<T>().
+class bench_fixture : public component
+{
+private:
+    generic::reset m_reset;
+    generic::clock m_clock;
+
+public:
+    typedef function<bench_fixture*(void)> factory;
+
+    bench_fixture() = delete;
+    bench_fixture(const sc_module_name& nm);
+    virtual ~bench_fixture() = default;
+
+    static bool define(const std::type_index& type, const char* name,
+                       factory create);
+    static bench_fixture* find(const std::type_index& type);
+    static void create_all();
+    static void destroy_all();
+
+    template <typename T>
+    static T& get();
+};
+
+template <typename T>
+T& bench_fixture::get() {
+    T* fixture = dynamic_cast<T*>(find(typeid(T)));
+    VCML_ERROR_ON(!fixture, "fixture %s not defined", typeid(T).name());
+    return *fixture;
+}
+
+#define BENCH_FIXTURE(type)                                                \
+    MWR_CONSTRUCTOR(MWR_CAT(register_fixture_, __LINE__)) {                \
+        auto create = []() -> bench_fixture* { return new type(#type); };  \
+        if (!bench_fixture::define(typeid(type), #type, create))           \
+            VCML_ERROR("fixture '%s' already defined", #type);             \
+    }
+
+#endif
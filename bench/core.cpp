@@ -0,0 +1,161 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+class core_fixture : public bench_fixture
+{
+public:
+    tlm_initiator_socket out;
+    peq<int> queue;
+
+    core_fixture(const sc_module_name& nm):
+        bench_fixture(nm), out("out"), queue("queue") {
+        out.stub();
+    }
+};
+
+BENCH_FIXTURE(core_fixture)
+
+// Hosts the properties of broker_elaborate, spread across many objects as
+// platforms do, since each object keeps its attributes in a plain list.
+class broker_fixture : public bench_fixture
+{
+public:
+    class holder : public sc_object
+    {
+    public:
+        holder(const char* nm): sc_object(nm) {}
+    };
+
+    vector<unique_ptr<holder>> objects;
+
+    broker_fixture(const sc_module_name& nm): bench_fixture(nm), objects() {
+        for (size_t i = 0; i < 1000; i++) {
+            string name = mkstr("obj%zu", i);
+            objects.push_back(std::make_unique<holder>(name.c_str()));
+        }
+    }
+};
+
+BENCH_FIXTURE(broker_fixture)
+
+class null_tracer : public tracer
+{
+public:
+    size_t count;
+
+    null_tracer(): tracer(), count(0) {}
+    virtual ~null_tracer() = default;
+
+    virtual void trace(const trace_activity& act) override { count++; }
+};
+
+static void peq_notify(benchmark::State& state) {
+    auto& f = bench_fixture::get<core_fixture>();
+    const int pending = state.range(0);
+
+    for (auto _ : state) {
+        for (int i = 0; i < pending; i++)
+            f.queue.notify(i, sc_time((i * 7) % pending + 1, SC_NS));
+        for (int i = 0; i < pending; i++)
+            f.queue.cancel(i);
+    }
+
+    state.SetItemsProcessed(state.iterations() * pending);
+}
+
+BENCHMARK(peq_notify)->ArgName("pending")->RangeMultiplier(8)->Range(8, 512);
+
+static void tracer_record(benchmark::State& state) {
+    auto& f = bench_fixture::get<core_fixture>();
+    std::unique_ptr<null_tracer> tr;
+    if (state.range(0))
+        tr = std::make_unique<null_tracer>();
+
+    u32 data = 0;
+    tlm_generic_payload tx;
+    tx_setup(tx, TLM_READ_COMMAND, 0x1000, &data, sizeof(data));
+
+    for (auto _ : state) {
+        tracer::record(TRACE_FW, f.out, tx);
+        tracer::record(TRACE_BW, f.out, tx);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(tracer_record)->ArgName("tracers")->Arg(0)->Arg(1);
+
+static void sc_sync_roundtrip(benchmark::State& state) {
+    const size_t batch = 1000;
+    size_t count = 0;
+
+    for (auto _ : state) {
+        sc_async([&count]() -> void {
+            for (size_t i = 0; i < batch; i++)
+                sc_sync([&count]() -> void { count++; });
+        });
+    }
+
+    if (count != state.iterations() * batch)
+        state.SkipWithError("lost sc_sync requests");
+    state.SetItemsProcessed(count);
+}
+
+BENCHMARK(sc_sync_roundtrip)->UseRealTime();
+
+static void broker_elaborate(benchmark::State& state) {
+    auto& f = bench_fixture::get<broker_fixture>();
+    const size_t count = state.range(0);
+    const size_t nobj = f.objects.size();
+
+    vector<string> names(count / nobj);
+    for (size_t i = 0; i < names.size(); i++)
+        names[i] = mkstr("prop%zu", i);
+
+    // half of the properties are configured, the other half of the values
+    // goes unused and has to be reported
+    broker config("bench");
+    for (size_t i = 0; i < count; i++) {
+        const char* obj = f.objects[i % nobj]->name();
+        const char* prop = names[i / nobj].c_str();
+        if (i % 2)
+            config.define(mkstr("%s.%s", obj, prop), i);
+        else
+            config.define(mkstr("%s.%s_unused", obj, prop), i);
+    }
+
+    vector<unique_ptr<property<u64>>> props;
+    props.reserve(count);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; i++) {
+            props.push_back(std::make_unique<property<u64>>(
+                f.objects[i % nobj].get(), names[i / nobj].c_str(), 0));
+        }
+
+        auto unused = broker::collect_unused();
+        if (unused.size() < count / 2)
+            state.SkipWithError("unexpected number of unused properties");
+
+        state.PauseTiming();
+        props.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(broker_elaborate)
+    ->ArgName("props")
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,69 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+// Models a large platform: 64 subsystems with 64 modules each, all of which
+// get their session hooks called whenever the simulation is suspended.
+class suspend_fixture : public bench_fixture
+{
+public:
+    class subsystem : public module
+    {
+    public:
+        vector<unique_ptr<module>> modules;
+
+        subsystem(const sc_module_name& nm): module(nm), modules() {
+            for (size_t i = 0; i < 64; i++) {
+                string name = mkstr("mod%zu", i);
+                modules.push_back(std::make_unique<module>(name.c_str()));
+            }
+        }
+    };
+
+    vector<unique_ptr<subsystem>> subsystems;
+
+    suspend_fixture(const sc_module_name& nm):
+        bench_fixture(nm), subsystems() {
+        for (size_t i = 0; i < 64; i++) {
+            string name = mkstr("sub%zu", i);
+            subsystems.push_back(std::make_unique<subsystem>(name.c_str()));
+        }
+    }
+};
+
+BENCH_FIXTURE(suspend_fixture)
+
+// Resumes as soon as the simulation has halted, like a debugger performing
+// a single step would, only without the round trip to the frontend.
+class step_suspender : public debugging::suspender
+{
+public:
+    step_suspender(): debugging::suspender("step") {}
+    virtual ~step_suspender() = default;
+
+    virtual void notify_suspended() override { resume(); }
+};
+
+static void suspend_step(benchmark::State& state) {
+    bench_fixture::get<suspend_fixture>();
+    step_suspender step;
+
+    for (auto _ : state) {
+        step.suspend();
+        wait(SC_ZERO_TIME); // suspends and resumes during the update phase
+    }
+
+    if (step.is_suspending())
+        state.SkipWithError("suspender still active");
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(suspend_step)->Unit(benchmark::kMicrosecond);
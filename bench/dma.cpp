@@ -0,0 +1,123 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+// Runs memcpy-style pl330 channel programs: an outer loop around an inner
+// DMALD/DMAST loop, started through the debug registers.
+class pl330_fixture : public bench_fixture
+{
+public:
+    enum : u64 {
+        PROG_ADDR = 0x0,
+        SRC_ADDR = 1 * MiB,
+        DST_ADDR = 3 * MiB,
+        MEM_SIZE = 5 * MiB,
+    };
+
+    dma::pl330 pl330;
+    generic::memory mem;
+
+    tlm_initiator_socket out;
+
+    pl330_fixture(const sc_module_name& nm):
+        bench_fixture(nm),
+        pl330("pl330"),
+        mem("mem", MEM_SIZE),
+        out("out") {
+        clk_bind(*this, "clk", pl330, "clk");
+        clk_bind(*this, "clk", mem, "clk");
+
+        gpio_bind(*this, "rst", pl330, "rst");
+        gpio_bind(*this, "rst", mem, "rst");
+
+        out.bind(pl330.in);
+        pl330.dma.bind(mem.in);
+
+        pl330.irq_abort.stub();
+    }
+
+    // burst_size is log2 of the beat size, burst_len the number of beats
+    void program(u32 burst_size, u32 burst_len, size_t len) {
+        u8* code = mem.data() + PROG_ADDR;
+        u32 burst = bit(burst_size) * burst_len;
+        u32 outer = len / burst / 256;
+
+        u32 ccr = 1u << 0 | burst_size << 1 | (burst_len - 1) << 4 | // src
+                  1u << 14 | burst_size << 15 | (burst_len - 1) << 18; // dst
+
+        auto mov = [&](u8 reg, u32 val) {
+            *code++ = 0xbc; // DMAMOV
+            *code++ = reg;
+            memcpy(code, &val, sizeof(val));
+            code += sizeof(val);
+        };
+
+        mov(1, ccr);
+        mov(0, (u32)SRC_ADDR);
+        mov(2, (u32)DST_ADDR);
+
+        *code++ = 0x22; // DMALP lc1
+        *code++ = (u8)(outer - 1);
+        *code++ = 0x20; // DMALP lc0
+        *code++ = 0xff;
+        *code++ = 0x04; // DMALD
+        *code++ = 0x08; // DMAST
+        *code++ = 0x38; // DMALPEND lc0
+        *code++ = 0x02;
+        *code++ = 0x3c; // DMALPEND lc1
+        *code++ = 0x06;
+        *code++ = 0x00; // DMAEND
+    }
+
+    bool copy() {
+        u32 inst0 = 0x1 | 0xa0 << 16; // DMAGO channel 0
+        u32 inst1 = (u32)PROG_ADDR;
+        u32 cmd = 0;
+
+        out.writew<u32>(pl330.offset_of("dbginst0"), inst0);
+        out.writew<u32>(pl330.offset_of("dbginst1"), inst1);
+        out.writew<u32>(pl330.offset_of("dbgcmd"), cmd);
+
+        // poll for the channel to become stopped (0x0) or faulting (0xf)
+        auto& ch = pl330.channels[0];
+        do {
+            wait(SC_ZERO_TIME);
+        } while (!ch.is_state(0x0) && !ch.is_state(0xf));
+
+        return ch.is_state(0x0);
+    }
+};
+
+BENCH_FIXTURE(pl330_fixture)
+
+static void pl330_memcpy(benchmark::State& state) {
+    auto& f = bench_fixture::get<pl330_fixture>();
+    const size_t len = 1 * MiB;
+    f.pl330.dma.allow_dmi = state.range(0);
+    f.program(3, state.range(1), len);
+
+    for (auto _ : state) {
+        if (!f.copy()) {
+            state.SkipWithError("pl330 channel faulted");
+            break;
+        }
+    }
+
+    f.pl330.dma.allow_dmi = true;
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+BENCHMARK(pl330_memcpy)
+    ->ArgNames({ "dmi", "burst" })
+    ->Args({ 0, 4 })
+    ->Args({ 0, 16 })
+    ->Args({ 1, 4 })
+    ->Args({ 1, 16 });
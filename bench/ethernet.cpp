@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+class eth_bench_node : public module, public eth_host
+{
+public:
+    mac_addr addr;
+    size_t rx_frames;
+
+    eth_initiator_socket eth_tx;
+    eth_target_socket eth_rx;
+
+    eth_bench_node(const sc_module_name& nm, u8 id):
+        module(nm),
+        eth_host(),
+        addr(0x02, 0x00, 0x00, 0x00, 0x00, id),
+        rx_frames(0),
+        eth_tx("eth_tx"),
+        eth_rx("eth_rx") {}
+
+    virtual void eth_receive(const eth_target_socket& rx,
+                             const eth_frame& frame) override {
+        rx_frames++;
+    }
+};
+
+// Switches unicast frames between the nodes of a learning ethernet::network,
+// each node sending to its neighbor, so that every frame hits the MAC table.
+class eth_network_fixture : public bench_fixture
+{
+public:
+    enum : size_t { NUM_NODES = 8 };
+
+    ethernet::network net;
+    vector<eth_bench_node*> nodes;
+
+    eth_network_fixture(const sc_module_name& nm):
+        bench_fixture(nm), net("net"), nodes() {
+        net.learning = true;
+        for (size_t i = 0; i < NUM_NODES; i++) {
+            string name = mkstr("node%zu", i);
+            nodes.push_back(new eth_bench_node(name.c_str(), (u8)i + 1));
+            net.connect(*nodes.back());
+        }
+    }
+
+    virtual ~eth_network_fixture() {
+        for (eth_bench_node* node : nodes)
+            delete node;
+    }
+
+    vector<eth_frame> setup(size_t payload_size) {
+        vector<u8> payload(payload_size, 0x5a);
+        vector<eth_frame> frames;
+        for (size_t i = 0; i < NUM_NODES; i++) {
+            size_t j = (i + 1) % NUM_NODES;
+            frames.emplace_back(nodes[j]->addr, nodes[i]->addr, payload);
+        }
+
+        // prime the MAC table, so that only this round floods
+        net.flush_macs();
+        for (size_t i = 0; i < NUM_NODES; i++)
+            nodes[i]->eth_tx.send(frames[i]);
+
+        for (eth_bench_node* node : nodes)
+            node->rx_frames = 0;
+
+        return frames;
+    }
+
+    size_t total_rx() const {
+        size_t total = 0;
+        for (eth_bench_node* node : nodes)
+            total += node->rx_frames;
+        return total;
+    }
+};
+
+BENCH_FIXTURE(eth_network_fixture)
+
+static void eth_network_switch(benchmark::State& state) {
+    auto& f = bench_fixture::get<eth_network_fixture>();
+    vector<eth_frame> frames = f.setup(state.range(0));
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < eth_network_fixture::NUM_NODES; i++)
+            f.nodes[i]->eth_tx.send(frames[i]);
+    }
+
+    size_t sent = state.iterations() * eth_network_fixture::NUM_NODES;
+    if (f.total_rx() != sent)
+        state.SkipWithError("frames were flooded or dropped");
+
+    state.SetItemsProcessed(sent);
+    state.SetBytesProcessed(sent * frames[0].size());
+}
+
+BENCHMARK(eth_network_switch)
+    ->ArgName("payload")
+    ->Arg(46)
+    ->Arg(1500);
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+// Streams device reads through a riscv::iommu that translates them using a
+// single sv39 second-stage superpage, so every access goes via the IOTLB.
+class iommu_fixture : public bench_fixture
+{
+public:
+    enum : u64 {
+        MEM_ADDR = 0x80000000,
+        MEM_SIZE = 1 * MiB,
+        IOMMU_ADDR = 0x40000000,
+        IOMMU_SIZE = 1 * KiB,
+        IOMMU_DDTP = IOMMU_ADDR + 16,
+        DDTP0_OFFSET = 16 * KiB,
+        DDTP1_OFFSET = 32 * KiB,
+        PGTP_OFFSET = 64 * KiB,
+        DATA_OFFSET = 512 * KiB,
+        DATA_SIZE = 256 * KiB,
+    };
+
+    generic::memory mem;
+    generic::bus bus;
+    riscv::iommu iommu;
+
+    tlm_initiator_socket out;
+    tlm_initiator_socket dma;
+
+    iommu_fixture(const sc_module_name& nm):
+        bench_fixture(nm),
+        mem("mem", MEM_SIZE),
+        bus("bus"),
+        iommu("iommu", false),
+        out("out"),
+        dma("dma") {
+        bus.bind(mem.in, MEM_ADDR, MEM_ADDR + MEM_SIZE - 1);
+        bus.bind(iommu.in, IOMMU_ADDR, IOMMU_ADDR + IOMMU_SIZE - 1);
+        bus.bind(out);
+        bus.bind(iommu.out);
+        dma.bind(iommu.dma);
+
+        clk_bind(*this, "clk", mem, "clk");
+        clk_bind(*this, "clk", bus, "clk");
+        clk_bind(*this, "clk", iommu, "clk");
+
+        gpio_bind(*this, "rst", mem, "rst");
+        gpio_bind(*this, "rst", bus, "rst");
+        gpio_bind(*this, "rst", iommu, "rst");
+
+        iommu.cirq.stub();
+        iommu.firq.stub();
+        iommu.pmirq.stub();
+        iommu.pirq.stub();
+    }
+
+    // maps iova 0 to MEM_ADDR for device 2 and fills the data region
+    void setup() {
+        u64* pgtp = (u64*)(mem.data() + PGTP_OFFSET);
+        memset(pgtp, 0, 4096);
+        pgtp[0] = (MEM_ADDR >> 2) | 0xdf; // 0x0 -> MEM | DA | U | RWX | V
+
+        u64* ddtp0 = (u64*)(mem.data() + DDTP0_OFFSET);
+        ddtp0[0] = (MEM_ADDR + DDTP1_OFFSET) >> 2 | 1;
+
+        u64* ddtp1 = (u64*)(mem.data() + DDTP1_OFFSET);
+        memset(ddtp1 + 16, 0, 8 * sizeof(u64));
+        ddtp1[16] = 0x11; // dev[2].tc = V | DTF
+        ddtp1[17] = (MEM_ADDR + PGTP_OFFSET) >> 12 | 8ull << 60; // sv39
+        ddtp1[18] = 0x3000; // dev[2].ta.pscid = 3
+
+        u64 ddtp = (MEM_ADDR + DDTP0_OFFSET) >> 2 | 3;
+        out.writew<u64>(IOMMU_DDTP, ddtp);
+
+        for (u64 i = 0; i < DATA_SIZE; i++)
+            mem.data()[DATA_OFFSET + i] = (u8)i;
+    }
+
+    bool stream(u8* buffer, size_t burst) {
+        tlm_sbi info = sbi_cpuid(2);
+        for (u64 offset = 0; offset < DATA_SIZE; offset += burst) {
+            if (failed(dma.read(DATA_OFFSET + offset, buffer, burst, info)))
+                return false;
+        }
+
+        return true;
+    }
+};
+
+BENCH_FIXTURE(iommu_fixture)
+
+static void iommu_dma_read(benchmark::State& state) {
+    auto& f = bench_fixture::get<iommu_fixture>();
+    f.dma.allow_dmi = state.range(0);
+    f.setup();
+
+    vector<u8> buffer(state.range(1));
+    for (auto _ : state) {
+        if (!f.stream(buffer.data(), buffer.size())) {
+            state.SkipWithError("dma through iommu failed");
+            break;
+        }
+    }
+
+    f.dma.allow_dmi = true;
+    state.SetBytesProcessed(state.iterations() * iommu_fixture::DATA_SIZE);
+}
+
+BENCHMARK(iommu_dma_read)
+    ->ArgNames({ "dmi", "burst" })
+    ->Args({ 0, 64 })
+    ->Args({ 0, 4096 })
+    ->Args({ 1, 64 })
+    ->Args({ 1, 4096 });
@@ -0,0 +1,199 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+// Drives sequential multi-block transfers through an sdhci into an SD card
+// the way a driver would, using either SDMA or ADMA2 descriptor tables.
+class sd_fixture : public bench_fixture
+{
+public:
+    enum : u32 {
+        BLOCK_SIZE = 512,
+        SEGMENT_SIZE = 64 * KiB,
+    };
+
+    enum : u64 {
+        DESC_BASE = 0x0,
+        DATA_BASE = 64 * KiB,
+        MEM_SIZE = DATA_BASE + 4 * MiB,
+    };
+
+    enum : u16 {
+        INT_TRANSFER_COMPLETE = bit(1),
+        INT_DMA_INTERRUPT = bit(3),
+        INT_ERROR = bit(15),
+    };
+
+    sd::sdhci sdhci;
+    sd::card card;
+    generic::memory mem;
+
+    tlm_initiator_socket out;
+
+    bool initialized;
+
+    sd_fixture(const sc_module_name& nm):
+        bench_fixture(nm),
+        sdhci("sdhci"),
+        card("card", "ramdisk:64MiB"),
+        mem("mem", MEM_SIZE),
+        out("out"),
+        initialized(false) {
+        clk_bind(*this, "clk", sdhci, "clk");
+        clk_bind(*this, "clk", card, "clk");
+        clk_bind(*this, "clk", mem, "clk");
+
+        gpio_bind(*this, "rst", sdhci, "rst");
+        gpio_bind(*this, "rst", card, "rst");
+        gpio_bind(*this, "rst", mem, "rst");
+
+        out.bind(sdhci.in);
+        sdhci.out.bind(mem.in);
+        sdhci.sd_out.bind(card.sd_in);
+        sdhci.irq.stub();
+    }
+
+    u16 interrupts() {
+        u16 stat = 0;
+        out.readw<u16>(0x30, stat);
+        return stat;
+    }
+
+    void clear_interrupts() {
+        out.writew<u16>(0x32, 0xffff);
+        out.writew<u16>(0x30, 0xffff);
+    }
+
+    bool command(u8 opcode, u32 arg, u16 flags = 0) {
+        if (failed(out.writew<u32>(0x08, arg)))
+            return false;
+        if (failed(out.writew<u16>(0x0e, (u16)opcode << 8 | flags)))
+            return false;
+
+        u16 errors = 0;
+        out.readw<u16>(0x32, errors);
+        clear_interrupts();
+        return errors == 0;
+    }
+
+    bool initialize() {
+        if (initialized)
+            return true;
+
+        initialized = command(0, 0) &&           // GO_IDLE_STATE
+                      command(8, 0x1aa) &&       // SEND_IF_COND
+                      command(55, 0) &&          // APP_CMD
+                      command(41, 0x40ff8000) && // SD_SEND_OP_COND
+                      command(2, 0) &&           // ALL_SEND_CID
+                      command(3, 0) &&           // SEND_RELATIVE_ADDR
+                      command(7, 0);             // SELECT_CARD
+        return initialized;
+    }
+
+    void setup_adma(size_t len) {
+        vector<u32> table;
+        for (size_t off = 0; off < len; off += SEGMENT_SIZE) {
+            size_t n = min<size_t>(SEGMENT_SIZE, len - off);
+            u32 attr = 0x21; // valid, tran
+            if (off + n >= len)
+                attr |= 0x2; // end
+            table.push_back((u32)(n & 0xffff) << 16 | attr);
+            table.push_back((u32)(DATA_BASE + off));
+        }
+
+        size_t size = table.size() * sizeof(u32);
+        mem.write(range(DESC_BASE, DESC_BASE + size - 1), table.data(),
+                  SBI_NONE);
+        out.writew<u32>(0x58, (u32)DESC_BASE);
+        out.writew<u8>(0x28, 0x10); // ADMA2
+    }
+
+    void setup_sdma() {
+        out.writew<u32>(0x00, (u32)DATA_BASE);
+        out.writew<u8>(0x28, 0x00); // SDMA
+    }
+
+    bool transfer(u8 opcode, size_t len, bool adma) {
+        if (!initialize())
+            return false;
+
+        if (adma)
+            setup_adma(len);
+        else
+            setup_sdma();
+
+        // 512KiB SDMA buffer boundary
+        out.writew<u16>(0x04, (u16)(BLOCK_SIZE | 7 << 12));
+        out.writew<u16>(0x06, (u16)(len / BLOCK_SIZE));
+        out.writew<u32>(0x08, 0);
+        out.writew<u16>(0x0e, (u16)opcode << 8 | 0x3a);
+
+        while (true) {
+            u16 stat = interrupts();
+            if (stat & INT_ERROR)
+                return false;
+            if (stat & INT_TRANSFER_COMPLETE)
+                break;
+
+            if (stat & INT_DMA_INTERRUPT) {
+                u32 addr = 0;
+                out.readw<u32>(0x00, addr);
+                out.writew<u16>(0x30, INT_DMA_INTERRUPT);
+                out.writew<u32>(0x00, addr);
+            }
+
+            wait(SC_ZERO_TIME);
+        }
+
+        clear_interrupts();
+        return command(12, 0); // STOP_TRANSMISSION
+    }
+};
+
+BENCH_FIXTURE(sd_fixture)
+
+static void sd_xfer(benchmark::State& state, u8 opcode) {
+    auto& f = bench_fixture::get<sd_fixture>();
+    const size_t len = 1 * MiB;
+    const bool adma = state.range(0);
+    f.sdhci.out.allow_dmi = state.range(1);
+
+    for (auto _ : state) {
+        if (!f.transfer(opcode, len, adma)) {
+            state.SkipWithError("sd transfer failed");
+            break;
+        }
+    }
+
+    f.sdhci.out.allow_dmi = true;
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+static void sd_seq_read(benchmark::State& state) {
+    sd_xfer(state, 18); // READ_MULTIPLE_BLOCK
+}
+
+static void sd_seq_write(benchmark::State& state) {
+    sd_xfer(state, 25); // WRITE_MULTIPLE_BLOCK
+}
+
+BENCHMARK(sd_seq_read)
+    ->ArgNames({ "adma", "dmi" })
+    ->Args({ 0, 0 })
+    ->Args({ 0, 1 })
+    ->Args({ 1, 0 })
+    ->Args({ 1, 1 });
+BENCHMARK(sd_seq_write)
+    ->ArgNames({ "adma", "dmi" })
+    ->Args({ 0, 0 })
+    ->Args({ 0, 1 })
+    ->Args({ 1, 0 })
+    ->Args({ 1, 1 });
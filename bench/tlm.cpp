@@ -0,0 +1,168 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+class regs_peripheral : public peripheral
+{
+public:
+    enum : size_t { NUM_REGS = 64 };
+
+    vector<reg<u32>*> regs;
+
+    tlm_target_socket in;
+
+    regs_peripheral(const sc_module_name& nm):
+        peripheral(nm, ENDIAN_LITTLE, 0, 0), regs(), in("in") {
+        for (size_t i = 0; i < NUM_REGS; i++) {
+            string name = mkstr("reg%zu", i);
+            regs.push_back(new reg<u32>(name.c_str(), i * 4, 0));
+            regs.back()->allow_read_write();
+        }
+    }
+
+    virtual ~regs_peripheral() {
+        for (auto* r : regs)
+            delete r;
+    }
+};
+
+class tlm_fixture : public bench_fixture
+{
+public:
+    enum : u64 {
+        MEM_SIZE = 16 * MiB,
+        NUM_WINDOWS = 64,
+        WINDOW_SIZE = 64 * KiB,
+        WINDOW_BASE = 0x10000000,
+        REGS_BASE = 0x20000000,
+    };
+
+    generic::memory mem;
+    generic::bus bus;
+    regs_peripheral regs;
+
+    tlm_initiator_socket out;
+
+    tlm_fixture(const sc_module_name& nm):
+        bench_fixture(nm),
+        mem("mem", MEM_SIZE),
+        bus("bus"),
+        regs("regs"),
+        out("out") {
+        clk_bind(*this, "clk", mem, "clk");
+        clk_bind(*this, "clk", bus, "clk");
+        clk_bind(*this, "clk", regs, "clk");
+
+        gpio_bind(*this, "rst", mem, "rst");
+        gpio_bind(*this, "rst", bus, "rst");
+        gpio_bind(*this, "rst", regs, "rst");
+
+        tlm_bind(bus, *this, "out");
+        tlm_bind(bus, mem, "in", 0, MEM_SIZE - 1, 0);
+        tlm_bind(bus, regs, "in", REGS_BASE, REGS_BASE + 0xfff, 0);
+
+        for (u64 i = 0; i < NUM_WINDOWS; i++) {
+            u64 lo = WINDOW_BASE + i * 2 * WINDOW_SIZE;
+            u64 hi = lo + WINDOW_SIZE - 1;
+            tlm_bind(bus, mem, "in", lo, hi, i * WINDOW_SIZE);
+        }
+    }
+};
+
+BENCH_FIXTURE(tlm_fixture)
+
+static void dmi_cache_lookup(benchmark::State& state) {
+    const u64 nentries = state.range(0);
+    const u64 stride = 2 * MiB;
+    static u8 dummy[4 * KiB];
+
+    tlm_dmi_cache cache;
+    cache.set_entry_limit(nentries);
+
+    // leave gaps between the entries, so that the cache cannot merge them
+    for (u64 i = 0; i < nentries; i++) {
+        tlm_dmi dmi;
+        dmi.allow_read_write();
+        dmi.set_start_address(i * stride);
+        dmi.set_end_address(i * stride + MiB - 1);
+        dmi.set_dmi_ptr(dummy);
+        cache.insert(dmi);
+    }
+
+    u64 i = 0;
+    tlm_dmi dmi;
+    for (auto _ : state) {
+        u64 addr = (i++ % nentries) * stride + 0x100;
+        benchmark::DoNotOptimize(cache.lookup(addr, 4, TLM_READ_COMMAND, dmi));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(dmi_cache_lookup)->RangeMultiplier(4)->Range(1, 64);
+
+static void socket_access(benchmark::State& state) {
+    auto& f = bench_fixture::get<tlm_fixture>();
+    f.out.allow_dmi = state.range(0) != 0;
+    f.out.unmap_dmi(0, ~0ull);
+
+    u32 data = 0;
+    u64 addr = 0;
+    for (auto _ : state) {
+        if (failed(f.out.readw(addr, data)))
+            state.SkipWithError("memory read failed");
+        addr = (addr + 4) % tlm_fixture::MEM_SIZE;
+        benchmark::DoNotOptimize(data);
+    }
+
+    state.SetBytesProcessed(state.iterations() * sizeof(data));
+    f.out.allow_dmi = true;
+}
+
+BENCHMARK(socket_access)->ArgName("dmi")->Arg(0)->Arg(1);
+
+static void bus_decode(benchmark::State& state) {
+    const u64 WINDOW_SIZE = tlm_fixture::WINDOW_SIZE;
+    auto& f = bench_fixture::get<tlm_fixture>();
+    f.out.allow_dmi = false;
+
+    u32 data = 0;
+    u64 i = 0;
+    for (auto _ : state) {
+        u64 win = (i++ * 37) % tlm_fixture::NUM_WINDOWS;
+        u64 addr = tlm_fixture::WINDOW_BASE + win * 2 * WINDOW_SIZE;
+        if (failed(f.out.readw(addr, data)))
+            state.SkipWithError("bus decode failed");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    f.out.allow_dmi = true;
+}
+
+BENCHMARK(bus_decode);
+
+static void reg_bank_dispatch(benchmark::State& state) {
+    auto& f = bench_fixture::get<tlm_fixture>();
+    f.out.allow_dmi = false;
+
+    u32 data = 0;
+    u64 i = 0;
+    for (auto _ : state) {
+        u64 idx = (i++ * 13) % regs_peripheral::NUM_REGS;
+        if (failed(f.out.readw(tlm_fixture::REGS_BASE + idx * 4, data)))
+            state.SkipWithError("register read failed");
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    f.out.allow_dmi = true;
+}
+
+BENCHMARK(reg_bank_dispatch);
@@ -0,0 +1,115 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+// Talks bulk-only mass storage to a usb::drive directly on packet level,
+// as the xHCI transfer engine would after resolving a TD.
+class usb_fixture : public bench_fixture, public usb_host_if
+{
+public:
+    enum : u32 {
+        BLOCK_SIZE = 512,
+        EP_IN = 1,
+        EP_OUT = 2,
+    };
+
+    usb::drive drive;
+    usb_initiator_socket usb_out;
+
+    vector<u8> buffer;
+    u32 tag;
+
+    usb_fixture(const sc_module_name& nm):
+        bench_fixture(nm),
+        usb_host_if(),
+        drive("drive", "ramdisk:64MiB", false, false),
+        usb_out("usb_out"),
+        buffer(),
+        tag(0) {
+        clk_bind(*this, "clk", drive, "clk");
+        gpio_bind(*this, "rst", drive, "rst");
+        usb_out.bind(drive.usb_in);
+    }
+
+    bool send(u32 epno, bool in, u8* data, size_t len) {
+        usb_packet p = in ? usb_packet_in(0, epno, data, len)
+                          : usb_packet_out(0, epno, data, len);
+        usb_out.send(p);
+        return success(p);
+    }
+
+    bool command(u8 opcode, u64 lba, size_t len, bool in) {
+        u8 cbw[31]{};
+        u32 size = len;
+        u32 blocks = len / BLOCK_SIZE;
+        memcpy(cbw, "USBC", 4);
+        memcpy(cbw + 4, &tag, 4);
+        memcpy(cbw + 8, &size, 4);
+        cbw[12] = in ? 0x80 : 0x00;
+        cbw[14] = 10;
+        cbw[15] = opcode;
+        cbw[17] = lba >> 24;
+        cbw[18] = lba >> 16;
+        cbw[19] = lba >> 8;
+        cbw[20] = lba;
+        cbw[22] = blocks >> 8;
+        cbw[23] = blocks;
+        tag++;
+        return send(EP_OUT, false, cbw, sizeof(cbw));
+    }
+
+    bool status() {
+        u8 csw[13];
+        return send(EP_IN, true, csw, sizeof(csw)) && csw[12] == 0;
+    }
+
+    bool transfer(u8 opcode, bool in, size_t len, size_t psize) {
+        buffer.resize(len);
+        if (!command(opcode, 0, len, in))
+            return false;
+        for (size_t off = 0; off < len; off += psize) {
+            size_t n = min(psize, len - off);
+            if (!send(in ? EP_IN : EP_OUT, in, buffer.data() + off, n))
+                return false;
+        }
+
+        return status();
+    }
+};
+
+BENCH_FIXTURE(usb_fixture)
+
+static void usb_drive_xfer(benchmark::State& state, u8 opcode, bool in) {
+    auto& f = bench_fixture::get<usb_fixture>();
+    const size_t len = 1 * MiB;
+    const size_t psize = state.range(0);
+
+    for (auto _ : state) {
+        if (!f.transfer(opcode, in, len, psize)) {
+            state.SkipWithError("mass storage transfer failed");
+            break;
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+static void usb_drive_read(benchmark::State& state) {
+    usb_drive_xfer(state, block::SCSI_READ_10, true);
+}
+
+static void usb_drive_write(benchmark::State& state) {
+    usb_drive_xfer(state, block::SCSI_WRITE_10, false);
+}
+
+// 512 bytes mimics per-max-packet transfers, 1MiB one packet per TD
+BENCHMARK(usb_drive_read)->ArgName("psize")->Arg(512)->Arg(64 * KiB)->Arg(MiB);
+BENCHMARK(usb_drive_write)->ArgName("psize")->Arg(512)->Arg(64 * KiB)->Arg(MiB);
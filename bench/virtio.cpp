@@ -0,0 +1,279 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "bench.h"
+
+// Driver-side view of a split virtqueue living in host memory. Guest
+// addresses are offsets into the memory buffer, so DMI is trivial.
+class virtio_fixture : public bench_fixture
+{
+public:
+    enum : u32 {
+        QUEUE_SIZE = 256,
+        BUFFER_SIZE = 1536,
+    };
+
+    enum : u64 {
+        DESC_BASE = 0x0000,
+        DRIVER_BASE = 0x1000,
+        DEVICE_BASE = 0x2000,
+        BUFFER_BASE = 0x4000,
+        MEM_SIZE = BUFFER_BASE + QUEUE_SIZE * BUFFER_SIZE,
+    };
+
+    vector<u8> mem;
+    split_virtqueue* vq;
+
+    u16 avail_idx;
+
+    u8* dmi(u64 addr, u64 size, vcml_access acs) {
+        return addr + size <= mem.size() ? mem.data() + addr : nullptr;
+    }
+
+    template <typename T>
+    T& at(u64 addr) {
+        return *(T*)(mem.data() + addr);
+    }
+
+    virtio_fixture(const sc_module_name& nm):
+        bench_fixture(nm), mem(MEM_SIZE), vq(nullptr), avail_idx(0) {
+        virtio_queue_desc desc(0, QUEUE_SIZE);
+        desc.desc = DESC_BASE;
+        desc.driver = DRIVER_BASE;
+        desc.device = DEVICE_BASE;
+
+        // descriptor table: one device-writable buffer per descriptor
+        for (u64 i = 0; i < QUEUE_SIZE; i++) {
+            u64 entry = DESC_BASE + i * 16;
+            at<u64>(entry + 0) = BUFFER_BASE + i * BUFFER_SIZE;
+            at<u32>(entry + 8) = BUFFER_SIZE;
+            at<u16>(entry + 12) = 2; // F_WRITE
+            at<u16>(entry + 14) = 0;
+        }
+
+        vq = new split_virtqueue(desc, [this](u64 a, u64 s, vcml_access r) {
+            return dmi(a, s, r);
+        });
+    }
+
+    virtual ~virtio_fixture() { delete vq; }
+
+    void post_buffer() {
+        u16 idx = avail_idx++;
+        at<u16>(DRIVER_BASE + 4 + (idx % QUEUE_SIZE) * 2) = idx % QUEUE_SIZE;
+        at<u16>(DRIVER_BASE + 2) = avail_idx;
+    }
+};
+
+BENCH_FIXTURE(virtio_fixture)
+
+static void virtqueue_get_put(benchmark::State& state) {
+    auto& f = bench_fixture::get<virtio_fixture>();
+    const size_t copy = state.range(0);
+    vector<u8> payload(copy, 0xab);
+
+    vq_message msg;
+    for (auto _ : state) {
+        f.post_buffer();
+        if (!f.vq->get(msg)) {
+            state.SkipWithError("virtqueue get failed");
+            break;
+        }
+
+        if (copy > 0)
+            msg.copy_out(payload);
+
+        if (!f.vq->put(msg)) {
+            state.SkipWithError("virtqueue put failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * copy);
+}
+
+BENCHMARK(virtqueue_get_put)->ArgName("bytes")->Arg(0)->Arg(64)->Arg(1514);
+
+// Acts as transport and driver for a virtio::net device: the transmit queue
+// lives in host memory and is filled with prebuilt packets, frames sent by
+// the device end up in a sink that counts them. The sink does not accept
+// offloads, so TSO packets get segmented by the ethernet layer on the way.
+class net_fixture : public bench_fixture,
+                    public virtio_controller,
+                    public eth_host
+{
+public:
+    enum : u32 {
+        QUEUE_SIZE = 64,
+        HEADER_SIZE = 12,
+        MSS = 1448,
+    };
+
+    enum : u64 {
+        DESC_BASE = 0x0000,
+        DRIVER_BASE = 0x1000,
+        DEVICE_BASE = 0x2000,
+        BUFFER_BASE = 0x4000,
+        BUFFER_SIZE = 64 * KiB,
+        MEM_SIZE = BUFFER_BASE + QUEUE_SIZE * BUFFER_SIZE,
+    };
+
+    vector<u8> mem;
+    split_virtqueue* txq;
+    u16 avail_idx;
+
+    u64 rx_frames;
+    u64 rx_bytes;
+
+    virtio::net net;
+    virtio_initiator_socket virtio_out;
+    eth_target_socket eth_rx;
+
+    template <typename T>
+    T& at(u64 addr) {
+        return *(T*)(mem.data() + addr);
+    }
+
+    net_fixture(const sc_module_name& nm):
+        bench_fixture(nm),
+        virtio_controller(),
+        eth_host(),
+        mem(MEM_SIZE),
+        txq(nullptr),
+        avail_idx(0),
+        rx_frames(0),
+        rx_bytes(0),
+        net("net"),
+        virtio_out("virtio_out"),
+        eth_rx("eth_rx") {
+        virtio_out.bind(net.virtio_in);
+        net.eth_tx.bind(eth_rx);
+        net.eth_rx.stub();
+
+        virtio_queue_desc desc(virtio::net::VIRTQUEUE_TX, QUEUE_SIZE);
+        desc.desc = DESC_BASE;
+        desc.driver = DRIVER_BASE;
+        desc.device = DEVICE_BASE;
+
+        txq = new split_virtqueue(desc, [this](u64 a, u64 s, vcml_access) {
+            return a + s <= mem.size() ? mem.data() + a : nullptr;
+        });
+    }
+
+    virtual ~net_fixture() { delete txq; }
+
+    virtual bool put(u32 vqid, vq_message& msg) override {
+        return vqid == virtio::net::VIRTQUEUE_TX && txq->put(msg);
+    }
+
+    virtual bool get(u32 vqid, vq_message& msg) override {
+        return vqid == virtio::net::VIRTQUEUE_TX && txq->get(msg);
+    }
+
+    virtual bool notify() override { return true; }
+
+    virtual bool shm_map(u32 shmid, u64 id, u64 offset, void* ptr,
+                         u64 len) override {
+        return false;
+    }
+
+    virtual bool shm_unmap(u32 shmid, u64 id) override { return false; }
+
+    virtual void eth_receive(const eth_target_socket& socket,
+                             const eth_frame& frame) override {
+        rx_frames++;
+        rx_bytes += frame.size();
+    }
+
+    // fills every buffer with a virtio_net_hdr followed by a TCP/IPv4 frame
+    // carrying payload bytes; large packets are marked for segmentation
+    void setup(size_t payload) {
+        virtio_device_desc desc;
+        desc.reset();
+        virtio_out->identify(desc);
+
+        u64 features = 0;
+        virtio_out->read_features(features);
+        virtio_out->write_features(features);
+
+        size_t iplen = 20 + 20 + payload;
+        size_t len = HEADER_SIZE + 14 + iplen;
+        VCML_ERROR_ON(len > BUFFER_SIZE, "packet too big");
+
+        for (u64 i = 0; i < QUEUE_SIZE; i++) {
+            u64 buf = BUFFER_BASE + i * BUFFER_SIZE;
+            u8* hdr = mem.data() + buf;
+            u8* eth = hdr + HEADER_SIZE;
+            u8* ip = eth + 14;
+            u8* tcp = ip + 20;
+
+            // checksums are left to the device, large packets use TSO
+            memset(hdr, 0, HEADER_SIZE + 14 + 40);
+            hdr[0] = 1; // VIRTIO_NET_HDR_F_NEEDS_CSUM
+            hdr[1] = payload > MSS ? 1 : 0; // VIRTIO_NET_HDR_GSO_TCPV4
+            at<u16>(buf + 2) = 14 + 40; // hdr_len
+            at<u16>(buf + 4) = MSS; // gso_size
+            at<u16>(buf + 6) = 14 + 20; // csum_start
+            at<u16>(buf + 8) = 16; // csum_offset
+
+            memset(eth, 0xff, 6);
+            memset(eth + 6, 0x02, 6);
+            eth[12] = 0x08;
+            ip[0] = 0x45;
+            ip[2] = iplen >> 8;
+            ip[3] = iplen & 0xff;
+            ip[8] = 64;
+            ip[9] = eth_frame::IP_TCP;
+            ip[12] = ip[16] = 10;
+            ip[15] = 1;
+            ip[19] = 2;
+            tcp[12] = 5 << 4;
+            tcp[13] = 0x18;
+
+            at<u64>(DESC_BASE + i * 16 + 0) = buf;
+            at<u32>(DESC_BASE + i * 16 + 8) = len;
+            at<u16>(DESC_BASE + i * 16 + 12) = 0;
+            at<u16>(DESC_BASE + i * 16 + 14) = 0;
+        }
+    }
+
+    // posts all buffers, kicks the device and waits until it returned them
+    void transmit() {
+        for (u32 i = 0; i < QUEUE_SIZE; i++) {
+            u16 idx = avail_idx++;
+            at<u16>(DRIVER_BASE + 4 + (idx % QUEUE_SIZE) * 2) = i;
+        }
+
+        at<u16>(DRIVER_BASE + 2) = avail_idx;
+        virtio_out->notify(virtio::net::VIRTQUEUE_TX);
+
+        while (at<u16>(DEVICE_BASE + 2) != avail_idx)
+            wait(SC_ZERO_TIME);
+    }
+};
+
+BENCH_FIXTURE(net_fixture)
+
+static void virtio_net_tx(benchmark::State& state) {
+    auto& f = bench_fixture::get<net_fixture>();
+    const size_t payload = state.range(0) ? 45 * net_fixture::MSS : 1460;
+    f.setup(payload);
+    f.rx_frames = 0;
+    f.rx_bytes = 0;
+
+    for (auto _ : state)
+        f.transmit();
+
+    state.SetItemsProcessed(f.rx_frames);
+    state.SetBytesProcessed(f.rx_bytes);
+}
+
+BENCHMARK(virtio_net_tx)->ArgName("tso")->Arg(0)->Arg(1);
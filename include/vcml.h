@@ -28,6 +28,7 @@
 #include "vcml/core/model.h"
 
 #include "vcml/logging/logger.h"
+#include "vcml/logging/deferred.h"
 #include "vcml/logging/report.h"
 #include "vcml/logging/inscight.h"
 
@@ -37,11 +38,13 @@
 #include "vcml/tracing/tracer_file.h"
 #include "vcml/tracing/tracer_term.h"
 #include "vcml/tracing/tracer_inscight.h"
+#include "vcml/tracing/pcap.h"
 
 #include "vcml/properties/property_base.h"
 #include "vcml/properties/property.h"
 #include "vcml/properties/broker.h"
 #include "vcml/properties/broker_arg.h"
+#include "vcml/properties/broker_cache.h"
 #include "vcml/properties/broker_env.h"
 #include "vcml/properties/broker_file.h"
 #include "vcml/properties/broker_lua.h"
@@ -49,6 +52,9 @@
 #include "vcml/debugging/symtab.h"
 #include "vcml/debugging/target.h"
 #include "vcml/debugging/loader.h"
+#include "vcml/debugging/profiler.h"
+#include "vcml/debugging/hostprof.h"
+#include "vcml/debugging/metrics.h"
 #include "vcml/debugging/subscriber.h"
 #include "vcml/debugging/suspender.h"
 #include "vcml/debugging/rspserver.h"
@@ -59,10 +65,13 @@
 
 #include "vcml/ui/keymap.h"
 #include "vcml/ui/video.h"
+#include "vcml/ui/damage.h"
+#include "vcml/ui/capture.h"
 #include "vcml/ui/display.h"
 #include "vcml/ui/console.h"
 
 #include "vcml/audio/format.h"
+#include "vcml/audio/converter.h"
 #include "vcml/audio/driver.h"
 #include "vcml/audio/stream.h"
 #include "vcml/audio/istream.h"
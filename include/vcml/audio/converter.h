@@ -0,0 +1,119 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_AUDIO_CONVERTER_H
+#define VCML_AUDIO_CONVERTER_H
+
+#include "vcml/core/types.h"
+#include "vcml/audio/format.h"
+
+namespace vcml {
+namespace audio {
+
+bool format_is_valid(u32 format);
+
+// Converts interleaved sample streams between formats, channel layouts and
+// sample rates. Samples are decoded into 32bit floats, mixed, resampled
+// using a windowed-sinc filter and encoded again. Integer-only conversions
+// that keep channels and rate skip the float stage and convert directly.
+class converter
+{
+public:
+    typedef void (*decode_fn)(const u8* src, float* dst, size_t n);
+    typedef void (*encode_fn)(const float* src, u8* dst, size_t n);
+    typedef void (*unpack_fn)(const u8* src, i32* dst, size_t n);
+    typedef void (*pack_fn)(const i32* src, u8* dst, size_t n);
+
+    enum : size_t {
+        RESAMPLER_TAPS = 32,
+        RESAMPLER_PHASES = 256,
+    };
+
+private:
+    u32 m_src_format;
+    u32 m_src_channels;
+    u32 m_src_rate;
+    u32 m_dst_format;
+    u32 m_dst_channels;
+    u32 m_dst_rate;
+
+    decode_fn m_decode;
+    encode_fn m_encode;
+    unpack_fn m_unpack;
+    pack_fn m_pack;
+
+    vector<u8> m_partial;
+    vector<i32> m_unpacked;
+    vector<float> m_decoded;
+    vector<float> m_mixed;
+    vector<float> m_resampled;
+    vector<float> m_mixmat;
+
+    // resampler state: per-channel history and filter bank
+    vector<vector<float>> m_history;
+    vector<float> m_filter;
+    double m_step;
+    double m_pos;
+
+    void setup_mixer();
+    void setup_resampler();
+
+    void process(const u8* src, size_t frames, vector<u8>& dst);
+    void mix(const float* src, float* dst, size_t frames);
+    size_t resample(const float* src, size_t frames, vector<float>& dst);
+
+public:
+    u32 src_format() const { return m_src_format; }
+    u32 src_channels() const { return m_src_channels; }
+    u32 src_rate() const { return m_src_rate; }
+    u32 dst_format() const { return m_dst_format; }
+    u32 dst_channels() const { return m_dst_channels; }
+    u32 dst_rate() const { return m_dst_rate; }
+
+    size_t src_frame_size() const;
+    size_t dst_frame_size() const;
+
+    bool is_configured() const { return m_src_format != FORMAT_INVALID; }
+    bool is_identity() const;
+    bool needs_mixing() const { return m_src_channels != m_dst_channels; }
+    bool needs_resampling() const { return m_src_rate != m_dst_rate; }
+
+    converter();
+    converter(converter&&) = default;
+    converter(const converter&) = delete;
+    converter& operator=(converter&&) = default;
+    virtual ~converter() = default;
+
+    bool configure(u32 src_format, u32 src_channels, u32 src_rate,
+                   u32 dst_format, u32 dst_channels, u32 dst_rate);
+    void reset();
+
+    size_t input_size(size_t output_size) const;
+
+    size_t convert(const void* src, size_t len, vector<u8>& dst);
+};
+
+inline size_t converter::src_frame_size() const {
+    return format_bits(m_src_format) / 8 * m_src_channels;
+}
+
+inline size_t converter::dst_frame_size() const {
+    return format_bits(m_dst_format) / 8 * m_dst_channels;
+}
+
+inline bool converter::is_identity() const {
+    return m_src_format == m_dst_format && !needs_mixing() &&
+           !needs_resampling();
+}
+
+} // namespace audio
+} // namespace vcml
+
+#endif
@@ -25,16 +25,15 @@ namespace audio {
 
 class istream : public stream
 {
+private:
+    u32 m_format;
+    vector<u8> m_buffer;
+    vector<vector<u8>> m_pending;
+
 public:
     istream(const sc_module_name& nm);
     virtual ~istream();
 
-    virtual size_t min_channels() override;
-    virtual size_t max_channels() override;
-
-    virtual bool supports_format(u32 format) override;
-    virtual bool supports_rate(u32 rate) override;
-
     virtual bool configure(u32 format, u32 channels, u32 rate) override;
     virtual void start() override;
     virtual void stop() override;
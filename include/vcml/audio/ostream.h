@@ -25,16 +25,13 @@ namespace audio {
 
 class ostream : public stream
 {
+private:
+    vector<u8> m_buffer;
+
 public:
     ostream(const sc_module_name& nm);
     virtual ~ostream();
 
-    virtual size_t min_channels() override;
-    virtual size_t max_channels() override;
-
-    virtual bool supports_format(u32 format) override;
-    virtual bool supports_rate(u32 rate) override;
-
     virtual bool configure(u32 format, u32 channels, u32 rate) override;
     virtual void start() override;
     virtual void stop() override;
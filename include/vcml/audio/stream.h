@@ -19,6 +19,7 @@
 
 #include "vcml/audio/format.h"
 #include "vcml/audio/driver.h"
+#include "vcml/audio/converter.h"
 
 namespace vcml {
 namespace audio {
@@ -27,6 +28,10 @@ class stream : public module
 {
 protected:
     vector<driver*> m_drivers;
+    vector<converter> m_converters;
+
+    bool negotiate(driver& drv, bool output, u32& format, u32& channels,
+                   u32& rate);
 
 public:
     property<string> drivers;
@@ -34,11 +39,18 @@ public:
     stream(const sc_core::sc_module_name& nm);
     virtual ~stream();
 
-    virtual size_t min_channels() = 0;
-    virtual size_t max_channels() = 0;
+    enum : u32 {
+        MIN_CHANNELS = 1,
+        MAX_CHANNELS = 8,
+        MIN_RATE = 1000,
+        MAX_RATE = 384000,
+    };
+
+    virtual size_t min_channels() { return MIN_CHANNELS; }
+    virtual size_t max_channels() { return MAX_CHANNELS; }
 
-    virtual bool supports_format(u32 format) = 0;
-    virtual bool supports_rate(u32 rate) = 0;
+    virtual bool supports_format(u32 format);
+    virtual bool supports_rate(u32 rate);
 
     virtual bool configure(u32 format, u32 channels, u32 rate) = 0;
     virtual void start() = 0;
@@ -16,6 +16,7 @@
 #include "vcml/core/command.h"
 
 #include "vcml/logging/logger.h"
+#include "vcml/logging/deferred.h"
 #include "vcml/tracing/tracer.h"
 #include "vcml/properties/property.h"
 
@@ -30,6 +31,7 @@ private:
     bool cmd_cinfo(const vector<string>& args, ostream& os);
     bool cmd_abort(const vector<string>& args, ostream& os);
     bool cmd_version(const vector<string>& args, ostream& os);
+    bool cmd_hostprof(const vector<string>& args, ostream& os);
 
 public:
     property<bool> trace_all;
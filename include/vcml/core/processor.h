@@ -23,6 +23,8 @@
 
 #include "vcml/debugging/target.h"
 #include "vcml/debugging/gdbserver.h"
+#include "vcml/debugging/profiler.h"
+#include "vcml/debugging/metrics.h"
 
 namespace vcml {
 
@@ -45,14 +47,21 @@ private:
     std::unordered_map<sc_process_b*, u64> m_cycle_count;
 
     debugging::gdbserver* m_gdb;
+    debugging::profiler* m_profiler;
 
     unordered_map<size_t, irq_stats> m_irq_stats;
 
+    vector<unique_ptr<debugging::metric>> m_metrics;
+
+    void register_metrics();
+
     bool cmd_dump(const vector<string>& args, ostream& os);
     bool cmd_read(const vector<string>& args, ostream& os);
     bool cmd_gdb(const vector<string>& args, ostream& os);
+    bool cmd_profile(const vector<string>& args, ostream& os);
 
     void sample_callstack();
+    void write_profile();
 
     u64 simulate_cycles(size_t cycles);
     void processor_thread();
@@ -75,6 +84,12 @@ public:
 
     property<bool> trace_callstack;
 
+    property<bool> profile;
+    property<string> profile_mode;
+    property<u64> profile_period;
+    property<size_t> profile_depth;
+    property<string> profile_output;
+
     gpio_target_array<> irq;
 
     tlm_initiator_socket insn;
@@ -99,6 +114,8 @@ public:
 
     bool get_irq_stats(size_t irq, irq_stats& stats) const;
 
+    debugging::profiler* profiler() const { return m_profiler; }
+
     template <typename T>
     inline tlm_response_status fetch(u64 addr, T& data);
 
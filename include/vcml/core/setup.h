@@ -14,6 +14,7 @@
 #include "vcml/core/types.h"
 
 #include "vcml/logging/logger.h"
+#include "vcml/logging/deferred.h"
 #include "vcml/logging/inscight.h"
 
 #include "vcml/tracing/tracer.h"
@@ -24,6 +25,7 @@
 #include "vcml/properties/property.h"
 #include "vcml/properties/broker.h"
 #include "vcml/properties/broker_arg.h"
+#include "vcml/properties/broker_cache.h"
 #include "vcml/properties/broker_env.h"
 #include "vcml/properties/broker_file.h"
 #include "vcml/properties/broker_lua.h"
@@ -37,6 +39,7 @@ private:
     mwr::option<bool> m_log_stdout;
     mwr::option<bool> m_log_inscight;
     mwr::option<string> m_log_files;
+    mwr::option<bool> m_log_async;
 
     mwr::option<bool> m_trace_stdout;
     mwr::option<bool> m_trace_inscight;
@@ -44,6 +47,7 @@ private:
 
     mwr::option<string> m_config_files;
     mwr::option<string> m_config_options;
+    mwr::option<string> m_config_dump;
 
     mwr::option<bool> m_help;
     mwr::option<bool> m_version;
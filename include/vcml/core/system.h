@@ -39,6 +39,12 @@ public:
     property<sc_time> quantum;
     property<sc_time> duration;
 
+    property<bool> host_profile;
+    property<u32> host_profile_period;
+
+    property<string> metrics;
+    property<sc_time> metrics_interval;
+
     system() = delete;
     system(const system&) = delete;
     system(const sc_module_name& name);
@@ -46,6 +52,10 @@ public:
     VCML_KIND(system);
 
     virtual int run();
+
+protected:
+    virtual void start_of_simulation() override;
+    virtual void end_of_simulation() override;
 };
 
 } // namespace vcml
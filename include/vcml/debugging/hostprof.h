@@ -0,0 +1,106 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#ifndef VCML_DEBUGGING_HOSTPROF_H
+#define VCML_DEBUGGING_HOSTPROF_H
+
+#include "vcml/core/types.h"
+#include "vcml/core/systemc.h"
+
+namespace vcml {
+namespace debugging {
+
+// Accounts host time to sockets, asynchronous workers and SystemC processes.
+// Calls are counted exactly, but only every n-th call of a site on a host
+// thread is timed; the host time of a site is extrapolated from those. Times
+// are inclusive, i.e. a bus also accounts for the targets it forwards to.
+// SystemC processes are sampled by a background thread instead, so their
+// models need no instrumentation; time in which the kernel is blocked, e.g.
+// while suspended, is not charged to any process. Counters are kept per host
+// thread and are only summed up when a report is requested.
+class hostprof
+{
+public:
+    struct entry {
+        string name;
+        string module;
+        const char* kind;
+        u64 calls;
+        u64 nanos;
+    };
+
+    class site
+    {
+    private:
+        size_t m_id;
+
+    public:
+        size_t id() const { return m_id; }
+
+        site(const sc_object& obj, const char* kind);
+        site(const string& name, const string& module, const char* kind);
+        ~site() = default;
+
+        site(const site&) = delete;
+        site& operator=(const site&) = delete;
+    };
+
+    class scope
+    {
+    private:
+        void* m_slot;
+        u64 m_start;
+
+        void begin(const site& s);
+        void end();
+
+    public:
+        scope(const site& s): m_slot(nullptr), m_start(0) {
+            if (s_enabled)
+                begin(s);
+        }
+
+        ~scope() {
+            if (m_slot)
+                end();
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+    };
+
+    static bool is_enabled() { return s_enabled; }
+
+    // times every period-th call of each site per host thread and samples
+    // the current SystemC process every interval
+    static void enable(u32 period = 64,
+                       const sc_time& interval = sc_time(1, SC_MS));
+    static void disable();
+    static void reset();
+
+    // entries sorted by descending host time
+    static vector<entry> collect();
+    static vector<entry> collect(const sc_object& module);
+
+    // sums up the entries of each module
+    static vector<entry> summarize(const vector<entry>& entries);
+
+    static void write_report(ostream& os, const vector<entry>& entries,
+                             size_t limit = ~0ull);
+
+private:
+    static atomic<bool> s_enabled;
+};
+
+} // namespace debugging
+} // namespace vcml
+
+#endif
@@ -0,0 +1,182 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#ifndef VCML_DEBUGGING_METRICS_H
+#define VCML_DEBUGGING_METRICS_H
+
+#include "vcml/core/types.h"
+#include "vcml/core/systemc.h"
+
+namespace vcml {
+namespace debugging {
+
+enum metric_type {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM,
+};
+
+const char* metric_type_str(metric_type type);
+
+using metric_labels = vector<pair<string, string>>;
+
+struct metric_sample {
+    string name;
+    string help;
+    metric_type type;
+    metric_labels labels;
+    double value;
+    vector<double> bounds;
+    vector<u64> buckets; // cumulative, last one is +Inf
+    u64 count;
+    double sum;
+};
+
+// Base class of everything that can be exported. Derived metrics register
+// with a global registry once they are fully constructed and leave it before
+// their own members are destroyed. Several metrics may share a name as long
+// as their labels differ.
+class metric
+{
+private:
+    string m_name;
+    string m_help;
+    metric_type m_type;
+    metric_labels m_labels;
+
+protected:
+    void attach();
+    void detach();
+
+public:
+    const string& name() const { return m_name; }
+    const string& help() const { return m_help; }
+    metric_type type() const { return m_type; }
+    const metric_labels& labels() const { return m_labels; }
+
+    metric(const string& name, const string& help, metric_type type,
+           const metric_labels& labels);
+    virtual ~metric();
+
+    metric() = delete;
+    metric(const metric&) = delete;
+    metric& operator=(const metric&) = delete;
+
+    virtual void sample(metric_sample& s) const = 0;
+};
+
+// Monotonic counter, either incremented by its owner or read from existing
+// model statistics via a callback whenever a snapshot is taken.
+class counter : public metric
+{
+private:
+    atomic<u64> m_value;
+    function<u64(void)> m_fn;
+
+public:
+    u64 value() const { return m_fn ? m_fn() : m_value.load(); }
+
+    counter(const string& name, const string& help,
+            const metric_labels& labels = {},
+            function<u64(void)> fn = nullptr);
+    virtual ~counter();
+
+    void inc(u64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    void reset() { m_value = 0; }
+
+    virtual void sample(metric_sample& s) const override;
+};
+
+class gauge : public metric
+{
+private:
+    atomic<double> m_value;
+    function<double(void)> m_fn;
+
+public:
+    double value() const { return m_fn ? m_fn() : m_value.load(); }
+
+    gauge(const string& name, const string& help,
+          const metric_labels& labels = {},
+          function<double(void)> fn = nullptr);
+    virtual ~gauge();
+
+    void set(double val) { m_value.store(val, std::memory_order_relaxed); }
+
+    virtual void sample(metric_sample& s) const override;
+};
+
+// Counts observations into buckets with the given upper bounds. An
+// implicit +Inf bucket catches everything beyond the last bound.
+class histogram : public metric
+{
+private:
+    vector<double> m_bounds;
+    unique_ptr<atomic<u64>[]> m_buckets;
+    atomic<u64> m_count;
+    atomic<double> m_sum;
+
+public:
+    const vector<double>& bounds() const { return m_bounds; }
+    u64 count() const { return m_count; }
+    double sum() const { return m_sum; }
+
+    histogram(const string& name, const string& help,
+              const vector<double>& bounds, const metric_labels& labels = {});
+    virtual ~histogram();
+
+    void observe(double val);
+    void reset();
+
+    virtual void sample(metric_sample& s) const override;
+};
+
+// Periodically writes all registered metrics from a background thread, with
+// the interval given in host time. Values are sampled in the update phase
+// of the simulation, so that callbacks may safely read model state; while
+// the simulation is suspended, they are sampled directly with the suspension
+// held, so that it cannot resume meanwhile. Targets are given as a
+// comma separated list of <format>:<path> with format being one of
+//   prom: Prometheus text format, file is replaced atomically
+//   json: one JSON object per line, appended to the file
+//   shm:  Prometheus text in a POSIX shared memory segment, preceded by an
+//         shm_header that readers use to detect concurrent updates
+class metrics
+{
+public:
+    enum : u32 { SHM_MAGIC = 0x4d4d4356 }; // "VCMM"
+
+    struct shm_header {
+        u32 magic;
+        u32 seqlock; // odd while the segment is being written
+        u64 length;  // size of the text following the header
+    };
+
+    // must be called from the simulation thread or while it is idle
+    static vector<metric_sample> snapshot();
+
+    static void write_prometheus(ostream& os,
+                                 const vector<metric_sample>& samples);
+    static void write_json(ostream& os, const vector<metric_sample>& samples);
+
+    static void start(const string& targets,
+                      const sc_time& interval = sc_time(1, SC_SEC));
+    static void stop();
+    static bool is_exporting();
+
+    // samples and writes all targets once, e.g. at the end of simulation
+    static void flush();
+};
+
+} // namespace debugging
+} // namespace vcml
+
+#endif
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_DEBUGGING_PROFILER_H
+#define VCML_DEBUGGING_PROFILER_H
+
+#include "vcml/core/types.h"
+#include "vcml/debugging/symtab.h"
+#include "vcml/debugging/target.h"
+
+namespace vcml {
+namespace debugging {
+
+enum profile_mode {
+    PROFILE_CYCLES, // sample every n simulated cycles
+    PROFILE_HOST,   // sample every n host microseconds
+};
+
+const char* profile_mode_str(profile_mode mode);
+
+class profiler
+{
+public:
+    static constexpr size_t MAX_DEPTH = 32;
+
+    struct sample {
+        u64 weight;
+        size_t depth;
+        u64 frames[MAX_DEPTH]; // innermost frame first
+    };
+
+private:
+    target& m_target;
+    profile_mode m_mode;
+    u64 m_period;
+    size_t m_depth;
+
+    u64 m_last_cycles;
+    double m_last_host;
+
+    vector<sample> m_ring;
+    size_t m_head;
+
+    struct stack {
+        size_t offset; // first frame in m_stack_frames, innermost first
+        size_t depth;
+        u64 weight;
+        size_t next; // next stack with the same hash, or SIZE_MAX
+    };
+
+    u64 m_total;
+    vector<stack> m_stacks;
+    vector<u64> m_stack_frames;
+    unordered_map<u64, size_t> m_stack_index; // frame hash -> first stack
+
+    vector<stackframe> m_frames;
+
+    void record(u64 weight);
+    void drain();
+
+public:
+    target& owner() const { return m_target; }
+    profile_mode mode() const { return m_mode; }
+    u64 period() const { return m_period; }
+    size_t depth() const { return m_depth; }
+    u64 total_samples() const { return m_total; }
+
+    profiler(target& tgt, profile_mode mode, u64 period, size_t depth,
+             size_t capacity = 4096);
+    virtual ~profiler() = default;
+
+    profiler(const profiler&) = delete;
+    profiler& operator=(const profiler&) = delete;
+
+    void update(u64 cycles);
+
+    void write_folded(ostream& os);
+    void write_report(ostream& os, size_t limit = 20);
+};
+
+} // namespace debugging
+} // namespace vcml
+
+#endif
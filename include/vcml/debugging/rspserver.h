@@ -57,6 +57,7 @@ public:
 
     void send_packet(int client, const string& s);
     void send_packet(int client, const char* format, ...);
+    void send_notification(int client, const string& s);
     string recv_packet(int client);
     int recv_signal(int client, time_t timeoutms = ~0ull);
 
@@ -92,6 +93,9 @@ inline string rsp_error(int eno) {
     return mkstr("E%02x", eno);
 }
 
+// escapes the payload and frames it as <start><payload>#<checksum>
+string rsp_packet(const string& payload, char start = '$');
+
 } // namespace debugging
 } // namespace vcml
 
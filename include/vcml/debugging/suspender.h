@@ -15,13 +15,25 @@
 #include "vcml/core/systemc.h"
 
 namespace vcml {
+
+class module;
+
 namespace debugging {
 
 class suspender
 {
 private:
+    friend struct suspend_manager;
+
+    enum suspend_state : int {
+        SUSPEND_IDLE,
+        SUSPEND_WAITING,
+        SUSPEND_ACTIVE,
+    };
+
     string m_name;
     sc_object* m_owner;
+    atomic<int> m_state;
 
 public:
     const char* name() const { return m_name.c_str(); }
@@ -33,6 +45,10 @@ public:
 
     virtual bool check_suspension_point();
 
+    // called on the simulation thread once the simulation has come to a
+    // halt, before any of the waiting suspenders are released
+    virtual void notify_suspended();
+
     bool is_suspending() const;
 
     void suspend();
@@ -43,8 +59,20 @@ public:
     static void current(vector<suspender*>& v);
     static void quit();
     static bool simulation_suspended();
+
+    // keeps a suspended simulation from resuming until released, so that
+    // other threads can safely inspect model state; fails unless the
+    // simulation has fully come to a halt
+    static bool hold_suspension();
+    static void release_suspension();
+
     static bool suspenders_waiting();
     static void handle_requests();
+
+    // modules register themselves upon construction, so that their session
+    // hooks can be called without traversing the object hierarchy
+    static void register_module(module* mod);
+    static void unregister_module(module* mod);
 };
 
 } // namespace debugging
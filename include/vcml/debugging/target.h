@@ -87,10 +87,26 @@ private:
     symtab m_symbols;
 
     vector<subscriber*> m_steppers;
-    vector<subscriber*> m_bbtracer;
+    // immutable once published, replaced lists are only freed during the
+    // next update phase, when no processor can still be iterating them
+    atomic<const vector<subscriber*>*> m_bbtracer;
+
+    void publish_basic_block_tracers(const vector<subscriber*>* tracers);
 
     vector<breakpoint*> m_breakpoints;
+    unordered_map<u64, breakpoint*> m_breakpoint_index;
+
+    // sorted by start address, m_watchpoint_ends[i] holds the highest end
+    // address of all watchpoints up to and including m_watchpoints[i]
     vector<watchpoint*> m_watchpoints;
+    vector<u64> m_watchpoint_ends;
+
+    void insert_watchpoint_index(watchpoint* wp);
+    void remove_watchpoint_index(watchpoint* wp);
+    void update_watchpoint_index();
+
+    template <typename FN>
+    void for_each_watchpoint(const range& addr, FN&& fn) const;
 
     target(const target&) = delete;
     target(target&&) = delete;
@@ -221,6 +237,13 @@ public:
     const vector<watchpoint*>& watchpoints() const;
 
     const breakpoint* lookup_breakpoint(u64 addr);
+    const watchpoint* lookup_watchpoint(const range& mem);
+
+    bool has_breakpoints() const { return !m_breakpoints.empty(); }
+    bool has_watchpoints() const { return !m_watchpoints.empty(); }
+    bool has_watchpoint(const range& mem) const;
+    bool has_watchpoint_in_page(u64 addr, u64 pgsz) const;
+
     const breakpoint* insert_breakpoint(u64 addr, subscriber* subscr);
     bool remove_breakpoint(const breakpoint* bp, subscriber* subscr);
     bool remove_breakpoint(u64 addr, subscriber* subscr);
@@ -298,8 +321,14 @@ inline void target::cancel_singlestep(subscriber* subscr) {
 }
 
 inline bool target::is_tracing_basic_blocks() const {
-    lock_guard<mutex> guard(m_mtx);
-    return !m_bbtracer.empty();
+    auto* tracers = m_bbtracer.load(std::memory_order_acquire);
+    return tracers && !tracers->empty();
+}
+
+inline bool target::has_watchpoint_in_page(u64 addr, u64 pgsz) const {
+    VCML_ERROR_ON(!is_pow2(pgsz), "invalid page size: %llu", pgsz);
+    const u64 page = addr & ~(pgsz - 1);
+    return has_watchpoint({ page, page + pgsz - 1 });
 }
 
 } // namespace debugging
@@ -40,6 +40,19 @@ private:
     unordered_map<u64, const breakpoint*> m_breakpoints;
     unordered_map<u64, const watchpoint*> m_watchpoints;
 
+    struct subscription {
+        u64 id;
+        sc_attr_base* attr;
+        target* tgt;
+        const cpureg* reg;
+        string value;
+    };
+
+    u64 m_next_subscription;
+    vector<subscription> m_subscriptions;
+
+    static string read_subscription(const subscription& sub);
+
     void resume_simulation(const sc_time& duration);
     void pause_simulation(const string& reason);
 
@@ -67,6 +80,7 @@ public:
     virtual ~vspclient();
 
     void notify_step_complete();
+    bool collect_updates(string& notification);
 
     string handle_status(const string& command);
     string handle_resume(const string& command);
@@ -77,6 +91,8 @@ public:
     string handle_mkwp(const string& command);
     string handle_rmwp(const string& command);
     string handle_setsm(const string& command);
+    string handle_sub(const string& command);
+    string handle_unsub(const string& command);
 };
 
 } // namespace debugging
@@ -25,7 +25,7 @@ class vspclient;
 class vspserver : public rspserver, private suspender
 {
 private:
-    static constexpr int PROTOVER = 2;
+    static constexpr int PROTOVER = 3;
 
     string m_announce;
     sc_time m_duration;
@@ -59,12 +59,17 @@ private:
     string handle_pwrite(int client, const string& command);
     string handle_setsm(int client, const string& command);
     string handle_arch(int client, const string& command);
+    string handle_batch(int client, const string& command);
+    string handle_sub(int client, const string& command);
+    string handle_unsub(int client, const string& command);
+    string handle_hprof(int client, const string& command);
 
     void disconnect_all();
     void force_quit();
     void notify_step_complete();
 
     virtual bool check_suspension_point() override;
+    virtual void notify_suspended() override;
 
 public:
     vspserver() = delete;
@@ -0,0 +1,205 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#ifndef VCML_LOGGING_DEFERRED_H
+#define VCML_LOGGING_DEFERRED_H
+
+#include "vcml/core/types.h"
+#include "vcml/core/systemc.h"
+#include "vcml/logging/logger.h"
+
+namespace vcml {
+
+// Captures printf arguments by value, so that the message can be formatted
+// later on another thread. Strings are copied, everything else is stored as
+// a 64 bit value. Arguments that do not fit anymore are printed as "<?>".
+class log_args
+{
+public:
+    enum : size_t { CAPACITY = 192 };
+
+    enum arg_type : u8 {
+        ARG_INT,
+        ARG_UINT,
+        ARG_DOUBLE,
+        ARG_STRING,
+        ARG_POINTER,
+    };
+
+private:
+    u8 m_data[CAPACITY];
+    size_t m_size;
+
+    void put(arg_type type, const void* data, size_t size);
+    void put_str(const char* str, size_t len);
+
+public:
+    size_t size() const { return m_size; }
+
+    log_args(): m_size(0) {}
+
+    template <typename T>
+    void add(const T& val);
+
+    template <typename... ARGS>
+    void add_all(const ARGS&... args) {
+        (add(args), ...);
+    }
+
+    string format(const char* fmt) const;
+};
+
+template <typename T>
+void log_args::add(const T& val) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_array_v<T>) {
+        add((const std::remove_extent_t<T>*)val);
+    } else if constexpr (std::is_enum_v<U>) {
+        add((std::underlying_type_t<U>)val);
+    } else if constexpr (std::is_same_v<U, bool>) {
+        u64 v = val;
+        put(ARG_UINT, &v, sizeof(v));
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        i64 v = val;
+        put(ARG_INT, &v, sizeof(v));
+    } else if constexpr (std::is_integral_v<U>) {
+        u64 v = val;
+        put(ARG_UINT, &v, sizeof(v));
+    } else if constexpr (std::is_floating_point_v<U>) {
+        double v = val;
+        put(ARG_DOUBLE, &v, sizeof(v));
+    } else if constexpr (std::is_same_v<U, char*> ||
+                         std::is_same_v<U, const char*>) {
+        const char* str = val ? val : "(null)";
+        put_str(str, strlen(str));
+    } else if constexpr (std::is_same_v<U, string>) {
+        put_str(val.c_str(), val.length());
+    } else if constexpr (std::is_pointer_v<U>) {
+        u64 v = (u64)(uintptr_t)val;
+        put(ARG_POINTER, &v, sizeof(v));
+    } else {
+        static_assert(!sizeof(U), "unsupported log argument type");
+    }
+}
+
+// A call site of one of the rate limited logging macros. Each site admits
+// a burst of messages per interval of simulation time and counts the ones
+// it drops; that count is attached to the next message that gets through.
+class log_site
+{
+private:
+    const char* m_file;
+    int m_line;
+    atomic<u64> m_window;
+    atomic<u64> m_count;
+    atomic<u64> m_pending;
+    atomic<u64> m_suppressed;
+    log_site* m_next;
+
+    static atomic<u32> s_burst;
+    static atomic<u64> s_interval;
+
+public:
+    const char* file() const { return m_file; }
+    int line() const { return m_line; }
+    u64 suppressed() const { return m_suppressed; }
+
+    log_site(const char* file, int line);
+    ~log_site() = default;
+
+    log_site(const log_site&) = delete;
+    log_site& operator=(const log_site&) = delete;
+
+    // returns false if the message should be dropped; otherwise returns the
+    // number of messages dropped since the last one that got through
+    bool admit(u64 now, u64& dropped);
+
+    // a burst of zero disables rate limiting
+    static void set_ratelimit(u32 burst, const sc_time& interval);
+
+    // logs the number of messages each site dropped since its last message
+    // or report, together with the total number it has dropped so far
+    static void report_suppressed();
+};
+
+// Deferred log records are pushed into lock-free per-thread queues and are
+// formatted and published by a background thread. While no publisher
+// thread is running, records are formatted and published right away. If a
+// queue is full, its producer also falls back to publishing directly.
+class log_queue
+{
+public:
+    enum : size_t { CAPACITY = 1024 }; // records per thread
+
+    struct record {
+        logger* sender;
+        const log_site* site;
+        log_level level;
+        const char* format;
+        u64 timestamp;
+        u64 dropped;
+        log_args args;
+    };
+
+    static bool is_async() { return s_async; }
+
+    static void start();
+    static void stop();
+
+    // publishes all queued records on the calling thread
+    static void flush();
+
+    static void publish(const record& rec);
+    static void push(const record& rec);
+
+private:
+    static atomic<bool> s_async;
+};
+
+template <typename... ARGS>
+void log_deferred(logger& sender, log_site& site, log_level lvl,
+                  const char* fmt, const ARGS&... args) {
+    log_queue::record rec;
+    rec.timestamp = time_to_ns(sc_time_stamp());
+    if (!site.admit(rec.timestamp, rec.dropped))
+        return;
+
+    rec.sender = &sender;
+    rec.site = &site;
+    rec.level = lvl;
+    rec.format = fmt;
+    rec.args.add_all(args...);
+    log_queue::push(rec);
+}
+
+} // namespace vcml
+
+// Logs via the given logger, formats lazily and limits the message rate of
+// each call site. The format string must outlive the simulation.
+#define VCML_LOG_RATELIMITED(sender, lvl, ...)                          \
+    do {                                                                \
+        if ((sender).can_log(lvl)) {                                    \
+            static ::vcml::log_site vcml_log_site_(__FILE__, __LINE__); \
+            ::vcml::log_deferred(sender, vcml_log_site_, lvl,           \
+                                 __VA_ARGS__);                          \
+        }                                                               \
+    } while (0)
+
+#define log_error_ratelimited(...) \
+    VCML_LOG_RATELIMITED(log, ::vcml::LOG_ERROR, __VA_ARGS__)
+#define log_warn_ratelimited(...) \
+    VCML_LOG_RATELIMITED(log, ::vcml::LOG_WARN, __VA_ARGS__)
+#define log_info_ratelimited(...) \
+    VCML_LOG_RATELIMITED(log, ::vcml::LOG_INFO, __VA_ARGS__)
+#define log_debug_ratelimited(...) \
+    VCML_LOG_RATELIMITED(log, ::vcml::LOG_DEBUG, __VA_ARGS__)
+
+#endif
@@ -19,7 +19,9 @@ namespace vcml {
 class logger : public mwr::logger
 {
 private:
-    class module* m_parent;
+    // points to the loglvl property of the parent module, resolved once
+    // during construction so that level checks need no lookup
+    const log_level* m_level;
 
 public:
     virtual bool can_log(log_level lvl) const;
@@ -27,11 +29,21 @@ public:
     logger();
     logger(sc_object* parent);
     logger(const string& name);
+    virtual ~logger();
 
     logger(logger&&) = default;
     logger(const logger&) = default;
+
+    // publishes a preformatted message as if it had been logged at the
+    // given simulation time, used for deferred log records
+    void publish_at(log_level lvl, u64 timestamp_ns, const char* file,
+                    int line, const string& text);
 };
 
+inline bool logger::can_log(log_level lvl) const {
+    return lvl <= (m_level ? *m_level : level());
+}
+
 extern logger log;
 
 } // namespace vcml
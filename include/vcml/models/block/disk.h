@@ -16,6 +16,7 @@
 #include "vcml/core/module.h"
 
 #include "vcml/properties/property.h"
+#include "vcml/debugging/metrics.h"
 #include "vcml/models/block/backend.h"
 
 namespace vcml {
@@ -26,6 +27,9 @@ class disk : public module
 private:
     backend* m_backend;
 
+    debugging::counter m_bytes_read;
+    debugging::counter m_bytes_written;
+
     bool cmd_show_stats(const vector<string>& args, ostream& os);
     bool cmd_save_image(const vector<string>& args, ostream& os);
 
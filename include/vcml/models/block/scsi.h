@@ -53,11 +53,24 @@ const char* scsi_command_str(u8 opcode);
 bool scsi_command_transfers_to_device(u8 opcode);
 bool scsi_command_transfers_from_device(u8 opcode);
 
+struct scsi_span {
+    u8* data;
+    size_t size;
+};
+
+// Data is exchanged through payload, unless the caller attaches its own
+// buffers. READ and WRITE then transfer directly between disk and buffers;
+// length reports how many bytes were moved to or from them.
 struct scsi_request {
     u8 command[16];
     vector<u8> payload;
+    vector<scsi_span> buffers;
+    size_t length;
+    u32 tag;
 };
 
+size_t scsi_buffers_size(const scsi_request& req);
+
 enum scsi_response : u8 {
     SCSI_GOOD = 0x00,
     SCSI_CHECK_CONDITION = 0x02,
@@ -120,6 +133,7 @@ extern const scsi_sense SENSE_ILLEGAL_FIELD;
 extern const scsi_sense SENSE_ILLEGAL_PARAM;
 extern const scsi_sense SENSE_UNIT_ATTENTION;
 extern const scsi_sense SENSE_DATA_PROTECT;
+extern const scsi_sense SENSE_OVERLAPPED_CMD;
 
 struct scsi_block_limits {
     bool wnr;
@@ -164,8 +178,28 @@ void scsi_write_block_limits(u8* buf, size_t len, const scsi_block_limits& bl);
 
 class scsi_disk : public disk
 {
+public:
+    typedef function<void(scsi_request&, scsi_response)> scsi_callback;
+
 private:
+    struct scsi_task {
+        scsi_request* req;
+        scsi_callback done;
+    };
+
     scsi_sense m_sense;
+    std::deque<scsi_task> m_tasks;
+    sc_event m_taskev;
+    bool m_spawned;
+
+    void scsi_task_thread();
+
+    scsi_response scsi_execute(scsi_request& req);
+
+    scsi_response scsi_read_buffers(scsi_request& req, size_t len);
+    scsi_response scsi_write_buffers(scsi_request& req, size_t len);
+    void scsi_gather(scsi_request& req);
+    void scsi_scatter(scsi_request& req);
 
     scsi_response scsi_inquiry(scsi_request& req);
     scsi_response scsi_inquiry_vpd(scsi_request& req);
@@ -191,6 +225,8 @@ public:
     property<string> product;
     property<string> revision;
 
+    property<size_t> queue_depth;
+
     const scsi_sense& get_sense() const { return m_sense; }
     void set_sense(const scsi_sense& s) { m_sense = s; }
 
@@ -203,6 +239,10 @@ public:
     VCML_KIND(block::scsi_disk);
 
     virtual scsi_response scsi_handle_command(scsi_request& req);
+
+    size_t scsi_queued() const { return m_tasks.size(); }
+    scsi_response scsi_submit(scsi_request& req, scsi_callback done);
+    bool scsi_abort(u32 tag);
     virtual void scsi_write_mode_page(vector<u8>& data, u8 page, u8 control,
                                       bool all);
 };
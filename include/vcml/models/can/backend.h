@@ -42,6 +42,10 @@ public:
     virtual void send_to_host(const can_frame& frame) = 0;
     virtual void send_to_guest(can_frame frame);
 
+    // called for every frame the bridge delivers to the guest, regardless
+    // of the backend it came from, e.g. to capture both directions
+    virtual void monitor_to_guest(const can_frame& frame) {}
+
     using create_fn = function<backend*(bridge*, const vector<string>&)>;
     static void define(const string& type, create_fn fn);
     static backend* create(bridge* br, const string& type);
@@ -53,6 +57,10 @@ using recv_fn = function<void(u8* data, size_t s)>;
 void serialize(const can_frame& f, const send_fn& send);
 void deserialize(can_frame& f, const recv_fn& recv);
 
+// converts frames from and to the LINKTYPE_CAN_SOCKETCAN layout of pcap
+void to_socketcan(const can_frame& f, vector<u8>& raw);
+bool from_socketcan(can_frame& f, const u8* raw, size_t size);
+
 #define VCML_DEFINE_CAN_BACKEND(name, fn)        \
     MWR_CONSTRUCTOR(define_can_backend_##name) { \
         vcml::can::backend::define(#name, fn);   \
@@ -90,7 +90,10 @@ private:
         void reset() { clear(); }
 
         bool empty() const { return m_tags.empty(); }
-        bool empty(int tag) const { return m_queues.at(tag).empty(); }
+        bool empty(int tag) const {
+            auto it = m_queues.find(tag);
+            return it == m_queues.end() || it->second.empty();
+        }
 
         size_t size() const { return m_tags.size(); }
         size_t num_free() const { return m_max_sum - m_current_sum; }
@@ -104,6 +107,129 @@ private:
         size_t m_current_sum;
     };
 
+    // MFIFO storage, holds the data of each channel as a byte stream so
+    // that whole bursts can be pushed and popped with a single copy
+    class burst_fifo
+    {
+    public:
+        burst_fifo(size_t capacity):
+            m_lanes(), m_capacity(capacity), m_used(0) {
+            // nothing to do
+        }
+
+        bool push(u32 tag, const u8* data, size_t len) {
+            if (len > num_free())
+                return false;
+
+            lane& l = m_lanes[tag];
+            l.data.insert(l.data.end(), data, data + len);
+            m_used += len;
+            return true;
+        }
+
+        bool pop(u32 tag, u8* data, size_t len) {
+            auto it = m_lanes.find(tag);
+            if (it == m_lanes.end() || size(tag) < len)
+                return false;
+
+            lane& l = it->second;
+            memcpy(data, l.data.data() + l.head, len);
+            l.head += len;
+            m_used -= len;
+
+            if (l.head == l.data.size()) {
+                l.data.clear();
+                l.head = 0;
+            } else if (l.head > l.data.size() / 2) {
+                l.data.erase(l.data.begin(), l.data.begin() + l.head);
+                l.head = 0;
+            }
+
+            return true;
+        }
+
+        void remove_tagged(u32 tag) {
+            m_used -= size(tag);
+            m_lanes.erase(tag);
+        }
+
+        void reset() {
+            m_lanes.clear();
+            m_used = 0;
+        }
+
+        bool empty() const { return m_used == 0; }
+        bool empty(u32 tag) const { return size(tag) == 0; }
+
+        size_t size() const { return m_used; }
+        size_t num_free() const { return m_capacity - m_used; }
+
+        size_t size(u32 tag) const {
+            auto it = m_lanes.find(tag);
+            if (it == m_lanes.end())
+                return 0;
+            return it->second.data.size() - it->second.head;
+        }
+
+    private:
+        struct lane {
+            vector<u8> data;
+            size_t head = 0;
+        };
+
+        std::unordered_map<u32, lane> m_lanes;
+
+        size_t m_capacity;
+        size_t m_used;
+    };
+
+    // decoded channel microcode, indexed by program address; dropped
+    // whenever a DMAGO starts a new program or memory covered by cached
+    // instructions gets written or loses DMI
+    class insn_cache
+    {
+    public:
+        struct entry {
+            u8 code[6];
+            u8 size;
+            u8 index; // position in the channel instruction table
+        };
+
+        insn_cache(): m_entries(), m_range() {
+            // nothing to do
+        }
+
+        const entry* lookup(u32 pc) const {
+            auto it = m_entries.find(pc);
+            return it != m_entries.end() ? &it->second : nullptr;
+        }
+
+        const entry& insert(u32 pc, const entry& e) {
+            range r(pc, pc + e.size - 1);
+            if (m_entries.empty()) {
+                m_range = r;
+            } else {
+                m_range.start = min(m_range.start, r.start);
+                m_range.end = max(m_range.end, r.end);
+            }
+
+            return m_entries[pc] = e;
+        }
+
+        void invalidate() { m_entries.clear(); }
+
+        void invalidate(const range& mem) {
+            if (!m_entries.empty() && m_range.overlaps(mem))
+                invalidate();
+        }
+
+        size_t size() const { return m_entries.size(); }
+
+    private:
+        std::unordered_map<u32, entry> m_entries;
+        range m_range;
+    };
+
 public:
     enum amba_ids : u32 {
         AMBA_PID = 0x00241330, // Peripheral ID
@@ -119,11 +245,6 @@ public:
         u32 tag;
     };
 
-    struct mfifo_entry {
-        u8 buf;
-        u8 tag;
-    };
-
     class channel : public module
     {
     public:
@@ -178,7 +299,8 @@ public:
 
     tagged_queue<queue_entry> read_queue;
     tagged_queue<queue_entry> write_queue;
-    tagged_queue<mfifo_entry> mfifo;
+    burst_fifo mfifo;
+    insn_cache icache;
 
     sc_vector<channel> channels;
     manager manager;
@@ -219,6 +341,10 @@ public:
     VCML_KIND(dma::pl330);
     virtual void reset() override;
 
+protected:
+    virtual void invalidate_direct_mem_ptr(tlm_initiator_socket& origin,
+                                           u64 start, u64 end) override;
+
 private:
     [[noreturn]] void pl330_thread();
     void run_manager();
@@ -39,8 +39,17 @@ public:
     backend(const backend&) = delete;
     backend(backend&&) = default;
 
+    // backends that understand frame offloads get them passed as-is,
+    // all others receive segmented and checksummed frames
+    virtual bool offload() const { return false; }
+
     virtual void send_to_host(const eth_frame& frame) = 0;
     virtual void send_to_guest(eth_frame frame);
+    virtual void send_to_guest(vector<eth_frame>& frames);
+
+    // called for every frame the bridge delivers to the guest, regardless
+    // of the backend it came from, e.g. to capture both directions
+    virtual void monitor_to_guest(const eth_frame& frame) {}
 
     using create_fn = function<backend*(bridge*, const vector<string>&)>;
     static void define(const string& type, create_fn create);
@@ -33,7 +33,9 @@ private:
     vector<backend*> m_backends;
 
     mutable mutex m_mtx;
-    queue<eth_frame> m_rx;
+    vector<eth_frame> m_rx;
+    vector<eth_frame> m_pool;
+    vector<eth_frame> m_resolved;
     sc_event m_ev;
 
     bool cmd_create_backend(const vector<string>& args, ostream& os);
@@ -41,6 +43,8 @@ private:
     bool cmd_list_backends(const vector<string>& args, ostream& os);
 
     virtual void eth_receive(const eth_frame& frame) override;
+    virtual bool eth_rx_offload(const eth_target_socket& socket,
+                                const eth_frame& frame) const override;
 
     void eth_transmit();
 
@@ -56,8 +60,15 @@ public:
     virtual ~bridge();
     VCML_KIND(ethernet::bridge);
 
+    enum : size_t { POOL_SIZE = 256 };
+
     void send_to_host(const eth_frame& frame);
     void send_to_guest(eth_frame frame);
+    void send_to_guest(vector<eth_frame>& frames);
+
+    // hands out frames recycled after delivery, so that backends can fill
+    // them without allocating; safe to call from any thread
+    eth_frame alloc_frame();
 
     void attach(backend* b);
     void detach(backend* b);
@@ -16,23 +16,51 @@
 #include "vcml/core/module.h"
 #include "vcml/core/model.h"
 
+#include "vcml/properties/property.h"
 #include "vcml/protocols/eth.h"
+#include "vcml/debugging/metrics.h"
 
 namespace vcml {
 namespace ethernet {
 
 class network : public module, public eth_host
 {
+public:
+    struct port_stats {
+        u64 rx_frames;
+        u64 rx_bytes;
+        u64 tx_frames;
+        u64 tx_bytes;
+        u64 flooded;
+        u64 filtered;
+    };
+
 protected:
     size_t m_next_id;
 
+    unordered_map<u64, size_t> m_macs;
+    unordered_map<size_t, port_stats> m_stats;
+    vector<unique_ptr<debugging::counter>> m_metrics;
+
     const eth_initiator_socket& peer_of(const eth_target_socket& rx) const {
         return eth_tx[eth_rx.index_of(rx)];
     }
 
+    void forward(size_t port, const eth_frame& frame);
+    void flood(size_t port, const eth_frame& frame);
+
     void eth_receive(const eth_target_socket&, const eth_frame&) override;
 
+    virtual void end_of_elaboration() override;
+
+private:
+    bool cmd_show_stats(const vector<string>& args, ostream& os);
+    bool cmd_show_macs(const vector<string>& args, ostream& os);
+    bool cmd_flush_macs(const vector<string>& args, ostream& os);
+
 public:
+    property<bool> learning;
+
     eth_initiator_array<> eth_tx;
     eth_target_array<> eth_rx;
 
@@ -46,6 +74,10 @@ public:
     void connect(DEVICE& device) {
         bind(device.eth_tx, device.eth_rx);
     }
+
+    const port_stats& stats(size_t port) { return m_stats[port]; }
+    bool lookup_port(const mac_addr& addr, size_t& port) const;
+    void flush_macs() { m_macs.clear(); }
 };
 
 } // namespace ethernet
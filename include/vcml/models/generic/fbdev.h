@@ -18,6 +18,7 @@
 
 #include "vcml/protocols/tlm.h"
 #include "vcml/ui/console.h"
+#include "vcml/ui/damage.h"
 
 namespace vcml {
 namespace generic {
@@ -27,11 +28,13 @@ class fbdev : public component
 private:
     ui::console m_console;
     ui::videomode m_mode;
+    ui::damage m_damage;
     u8* m_vptr;
 
     void update();
 
     bool cmd_screenshot(const vector<string>& args, ostream& os);
+    bool cmd_phash(const vector<string>& args, ostream& os);
 
 public:
     u8* vptr() const { return m_vptr; }
@@ -78,6 +78,8 @@ protected:
                                   u8& data) override;
     virtual i2c_response i2c_write(const i2c_target_socket& socket,
                                    u8 data) override;
+    virtual i2c_response i2c_read_burst(const i2c_target_socket& socket,
+                                        u8* data, size_t& len) override;
 };
 
 } // namespace i2c
@@ -21,6 +21,7 @@
 
 #include "vcml/properties/property.h"
 #include "vcml/ui/console.h"
+#include "vcml/ui/damage.h"
 
 namespace vcml {
 namespace opencores {
@@ -34,9 +35,11 @@ private:
     };
 
     ui::console m_console;
+    ui::damage m_damage;
 
     const range m_palette_addr;
     u32 m_palette[PALETTE_SIZE];
+    bool m_palette_dirty;
 
     u8* m_fb;
 
@@ -60,11 +63,15 @@ private:
     sc_event m_enable;
 
     void create();
+    void convert(const u8* src, u8* dest);
+    void refresh(const tlm_sbi& info = SBI_NONE);
+    void probe();
     void render();
     void update();
 
     bool cmd_info(const vector<string>& args, ostream& os);
     bool cmd_screenshot(const vector<string>& args, ostream& os);
+    bool cmd_phash(const vector<string>& args, ostream& os);
 
     // disabled
     ocfbc();
@@ -102,9 +102,55 @@ private:
     static_assert(sizeof(pgreq) == 2 * sizeof(u64), "pgreq size");
     static_assert(sizeof(command) == 2 * sizeof(u64), "command size");
 
+    class iotlb_cache
+    {
+    private:
+        struct way {
+            iotlb entry;
+            u32 device_id;
+            u32 process_id;
+            u64 stamp;
+            bool valid;
+        };
+
+        size_t m_sets;
+        size_t m_ways;
+        u64 m_stamp;
+        vector<way> m_data;
+
+        way* lookup_set(u64 vpn) {
+            return m_data.data() + (vpn & (m_sets - 1)) * m_ways;
+        }
+
+    public:
+        u64 hits;
+        u64 misses;
+        u64 evictions;
+        u64 invalidations;
+
+        size_t sets() const { return m_sets; }
+        size_t ways() const { return m_ways; }
+
+        iotlb_cache();
+
+        void configure(size_t sets, size_t ways);
+
+        bool lookup(u64 vpn, u32 devid, u32 pid, u64 gscid, u64 pscid,
+                    bool wnr, iotlb& entry);
+        void insert(u32 devid, u32 pid, const iotlb& entry);
+
+        void invalidate(u64 vpn);
+        void invalidate_all();
+
+        template <typename PRED>
+        void invalidate_some(PRED&& pred);
+
+        void reset_stats();
+    };
+
     unordered_map<u64, context> m_contexts;
-    unordered_map<u64, iotlb> m_iotlb_s;
-    unordered_map<u64, iotlb> m_iotlb_g;
+    iotlb_cache m_iotlb_s;
+    iotlb_cache m_iotlb_g;
 
     u32 m_work;
     sc_event m_workev;
@@ -125,6 +171,8 @@ private:
     sc_time m_counter_start;
     sc_event m_counter_ovev;
 
+    bool cmd_iotlb(const vector<string>& args, ostream& os);
+
     template <typename T>
     tlm_response_status dma_readw(u64 addr, T& data, bool excl, bool dbg) {
         return dma_read(addr, &data, sizeof(T), excl, dbg);
@@ -189,6 +237,8 @@ private:
     void write_tr_req_iova(u64 val);
     void write_tr_req_ctl(u64 val);
 
+    void invalidate_dma_dmi(u64 vpn, bool all);
+
     void handle_iotinval(const command& cmd);
     void handle_iofence(const command& cmd);
     void handle_iodir(const command& cmd);
@@ -229,6 +279,9 @@ public:
     property<bool> pd20;
     property<bool> passthrough;
 
+    property<size_t> iotlb_sets;
+    property<size_t> iotlb_ways;
+
     reg<u64> caps;
     reg<u32> fctl;
     reg<u64> ddtp;
@@ -273,8 +326,8 @@ public:
     virtual void reset() override;
 
     void flush_contexts() { m_contexts.clear(); }
-    void flush_tlb_s() { m_iotlb_s.clear(); }
-    void flush_tlb_g() { m_iotlb_g.clear(); }
+    void flush_tlb_s() { m_iotlb_s.invalidate_all(); }
+    void flush_tlb_g() { m_iotlb_g.invalidate_all(); }
 
 protected:
     virtual unsigned int receive(tlm_generic_payload& tx, const tlm_sbi& info,
@@ -46,6 +46,7 @@ private:
     u8 m_curcmd;
     size_t m_curoff;
     size_t m_numblk;
+    bool m_dirty;
 
     enum state {
         IDLE = 0,
@@ -88,6 +89,7 @@ private:
     void init_sts();
 
     void update_status();
+    void flush_disk();
 
     void switch_function(u32 arg);
 
@@ -98,6 +100,9 @@ private:
     sd_status_tx do_data_read(u8& val);
     sd_status_rx do_data_write(u8 val);
 
+    sd_status_tx do_blocks_read(u8* data, size_t& len);
+    sd_status_rx do_blocks_write(const u8* data, size_t& len);
+
     // disabled
     card();
     card(const card&);
@@ -185,6 +190,8 @@ public:
                               sd_command& cmd) override;
     virtual void sd_transport(const sd_target_socket& socket,
                               sd_data& data) override;
+    virtual void sd_transport_blocks(const sd_target_socket& socket,
+                                     sd_data& data) override;
 };
 
 inline void card::update_status() {
@@ -192,6 +199,12 @@ inline void card::update_status() {
     m_status |= m_state << 9;
 }
 
+inline void card::flush_disk() {
+    if (m_dirty)
+        disk.flush();
+    m_dirty = false;
+}
+
 } // namespace sd
 } // namespace vcml
 
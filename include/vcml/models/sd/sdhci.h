@@ -60,10 +60,41 @@ private:
         ERR_DATA_TIMEOUT = bit(4),
         ERR_DATA_CRC = bit(5),
         ERR_DATA_END_BIT = bit(6),
+        ERR_ADMA = bit(9),
     };
 
     enum capabilities : u32 {
         CAPABILITY_VALUES_0 = 0x01000a8a,
+        CAPABILITY_ADMA2 = bit(19),
+        CAPABILITY_SDMA = bit(22),
+    };
+
+    enum host_control_bits : u8 {
+        DMA_SELECT_MASK = bitmask(2, 3),
+        DMA_SELECT_SDMA = 0 << 3,
+        DMA_SELECT_ADMA2 = 2 << 3,
+    };
+
+    enum adma_attributes : u32 {
+        ADMA_VALID = bit(0),
+        ADMA_END = bit(1),
+        ADMA_INT = bit(2),
+        ADMA_ACT_MASK = bitmask(2, 4),
+        ADMA_ACT_NOP = 0 << 4,
+        ADMA_ACT_TRAN = 2 << 4,
+        ADMA_ACT_LINK = 3 << 4,
+    };
+
+    enum adma_error_bits : u8 {
+        ADMA_ERR_ST_STOP = 0,
+        ADMA_ERR_ST_FDS = 1,
+        ADMA_ERR_ST_TFR = 3,
+        ADMA_ERR_LENGTH = bit(2),
+    };
+
+    enum spec_version : u16 {
+        SPEC_VERSION_100 = 0,
+        SPEC_VERSION_200 = 1,
     };
 
     sd_command m_cmd;
@@ -72,6 +103,15 @@ private:
     u16 m_bufptr;
     u8 m_buffer[4096];
 
+    u64 m_dma_addr;
+    size_t m_dma_seglen;
+    bool m_dma_segint;
+    bool m_dma_abort;
+    bool m_adma_end;
+
+    vector<u8> m_dma_buf;
+    size_t m_dma_bufpos;
+
     void reset_response(int response_reg_nr);
     void store_response();
     void set_present_state(unsigned int state);
@@ -89,13 +129,29 @@ private:
     void write_normal_int_stat(u16 val);
     void write_error_int_stat(u16 val);
     u32 read_capabilities();
+    u16 read_host_controller_version();
+    void write_sdma_system_address(u32 val);
+
+    bool is_adma2() const;
+    size_t sdma_boundary() const;
+
+    bool read_sd_blocks(u8* data, size_t len);
+    bool write_sd_blocks(const u8* data, size_t len);
+
+    void dma_advance(size_t len);
+    bool dma_next_segment();
+    void dma_segment_done();
+    bool dma_to_memory(size_t len);
+    bool dma_from_memory(size_t len);
+    bool adma_error(u8 status);
 
     void dma_thread();
 
-    tlm_response_status dma_read(u32 boundary);
-    tlm_response_status dma_write(u32 boundary);
+    bool dma_read();
+    bool dma_write();
 
     sc_event m_dma_start;
+    sc_event m_dma_resume;
 
 public:
     // Common SDHCI registers
@@ -128,6 +184,9 @@ public:
     reg<u32, 2> capabilities;
     reg<u32> max_curr_cap;
 
+    reg<u8> adma_error_status;
+    reg<u32> adma_system_address;
+
     reg<u16> host_controller_version;
 
     // Controller specific registers
@@ -135,6 +194,7 @@ public:
     reg<u32> f_sd_h30_esd_control;
 
     property<bool> dma_enabled;
+    property<bool> adma_enabled;
 
     gpio_initiator_socket irq;
     tlm_target_socket in;
@@ -150,6 +210,15 @@ public:
     virtual void reset() override;
 };
 
+inline bool sdhci::is_adma2() const {
+    return adma_enabled && (host_control_1 & DMA_SELECT_MASK) ==
+                               DMA_SELECT_ADMA2;
+}
+
+inline size_t sdhci::sdma_boundary() const {
+    return 4096ull << ((block_size >> 12) & 0x7);
+}
+
 } // namespace sd
 } // namespace vcml
 
@@ -48,6 +48,11 @@ public:
     virtual bool read(u8& val) = 0;
     virtual void write(u8 val) = 0;
 
+    // span-based transfers, default to the byte-wise functions above;
+    // backends that can move several characters at once should override
+    virtual size_t read(u8* buf, size_t len);
+    virtual void write(const u8* buf, size_t len);
+
     void capture_stdin();
     void release_stdin();
 
@@ -42,7 +42,10 @@ private:
     size_t m_next_id;
     unordered_map<size_t, backend*> m_backends;
     vector<backend*> m_listeners;
+    vector<u8> m_rxbuf;
+    vector<u8> m_txbuf;
     sc_event m_async_ev;
+    sc_event m_flush_ev;
 
     bool cmd_create_backend(const vector<string>& args, ostream& os);
     bool cmd_destroy_backend(const vector<string>& args, ostream& os);
@@ -50,6 +53,7 @@ private:
     bool cmd_history(const vector<string>& args, ostream& os);
 
     void serial_transmit();
+    void flush_backends();
 
     virtual void serial_receive(u8 data) override;
 
@@ -59,6 +63,9 @@ public:
     property<string> backends;
     property<string> config;
     property<bool> untimed;
+    property<size_t> burst;
+    property<size_t> flush_size;
+    property<sc_time> flush_interval;
 
     serial_initiator_socket serial_tx;
     serial_target_socket serial_rx;
@@ -67,6 +74,9 @@ public:
     virtual ~terminal();
     VCML_KIND(serial::terminal);
 
+    virtual void session_suspend() override;
+    virtual void end_of_simulation() override;
+
     void attach(backend* b);
     void detach(backend* b);
     void notify(backend* b);
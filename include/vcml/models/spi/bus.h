@@ -29,6 +29,9 @@ class bus : public component, public spi_host
 {
 private:
     unordered_map<unsigned int, bool> m_csmode;
+    vector<unsigned int> m_active;
+
+    void update_active();
 
     // disabled
     bus();
@@ -54,20 +57,27 @@ public:
 
     virtual void spi_transport(const spi_target_socket& socket,
                                spi_payload& spi) override;
+    virtual void spi_burst(const spi_target_socket& socket,
+                           spi_payload& spi) override;
 
     unsigned int next_free() const;
 
     void bind(spi_initiator_socket& initiator);
     unsigned int bind(spi_target_socket& target, gpio_initiator_socket& cs,
                       bool cs_active_high = true);
+
+protected:
+    virtual void gpio_notify(const gpio_target_socket& socket) override;
 };
 
 inline void bus::set_active_high(unsigned int port, bool set) {
     m_csmode[port] = set;
+    update_active();
 }
 
 inline void bus::set_active_low(unsigned int port, bool set) {
     m_csmode[port] = !set;
+    update_active();
 }
 
 } // namespace spi
@@ -72,13 +72,17 @@ private:
     u64 m_address;
 
     u8 m_buffer[16];
+    vector<u8> m_burst;
 
     void decode(u8 val);
     void complete();
     u8 process(u8 mosi);
+    size_t process_storage(spi_payload& tx, size_t offset);
 
     virtual void spi_transport(const spi_target_socket& socket,
                                spi_payload& tx) override;
+    virtual void spi_burst(const spi_target_socket& socket,
+                           spi_payload& tx) override;
 
 public:
     property<string> device;
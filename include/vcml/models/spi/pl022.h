@@ -29,11 +29,18 @@ namespace spi {
 class pl022 : public peripheral
 {
 private:
+    enum : size_t {
+        FIFO_SIZE = 8,
+    };
+
     sc_event m_ev;
 
     fifo<u16> m_txff;
     fifo<u16> m_rxff;
 
+    u32 m_mosi[FIFO_SIZE];
+    u32 m_miso[FIFO_SIZE];
+
     void update_cs(bool active);
     void update_irq();
     void update_sclk();
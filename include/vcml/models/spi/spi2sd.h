@@ -72,6 +72,8 @@ public:
 
     virtual void spi_transport(const spi_target_socket& socket,
                                spi_payload& spi) override;
+    virtual void spi_burst(const spi_target_socket& socket,
+                           spi_payload& spi) override;
 };
 
 } // namespace spi
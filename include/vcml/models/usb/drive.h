@@ -36,10 +36,12 @@ private:
     drive_mode m_mode;
     block::scsi_request m_req;
     size_t m_buflen;
+    size_t m_bufpos;
+    bool m_pending;
     u32 m_status;
     u32 m_tag;
 
-    u8 handle_command(u8* cmdbuf);
+    void execute(u8* buf, size_t len);
 
 public:
     property<bool> usb3;
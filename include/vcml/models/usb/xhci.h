@@ -41,6 +41,12 @@ public:
         size_t intr;
     };
 
+    struct sgentry {
+        u64 addr; // holds the data itself for immediate TRBs
+        u32 size;
+        bool imm;
+    };
+
     struct ring {
         u64 dequeue;
         bool ccs;
@@ -108,6 +114,9 @@ private:
 
     devslot m_slots[MAX_SLOTS];
 
+    vector<sgentry> m_sglist;
+    vector<u8> m_xferbuf;
+
     u64 get_mfindex() const;
 
     u32 read_hcsparams1();
@@ -139,7 +148,8 @@ private:
     void send_tr_event(size_t intr, u32 ccode, u32 slotid, u32 ep, u64 addr);
     void send_port_event(size_t intr, u32 ccode, u64 portid);
 
-    u32 handle_transmit(u32 slotid, u32 epid, trb& cmd);
+    u32 fetch_td(endpoint* ep, bool dirin, trb& request, u64& addr);
+    u32 handle_transmit(u32 slotid, u32 epid, bool dirin);
 
     void schedule_transfers();
     bool get_transfer(u32& slotid, u32& epid);
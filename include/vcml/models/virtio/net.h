@@ -33,15 +33,36 @@ public:
     };
 
     enum features : u64 {
+        VIRTIO_NET_F_CSUM = bit(0),
+        VIRTIO_NET_F_GUEST_CSUM = bit(1),
         VIRTIO_NET_F_MTU = bit(3),
         VIRTIO_NET_F_MAC = bit(5),
+        VIRTIO_NET_F_GUEST_TSO4 = bit(7),
+        VIRTIO_NET_F_GUEST_TSO6 = bit(8),
+        VIRTIO_NET_F_GUEST_ECN = bit(9),
+        VIRTIO_NET_F_GUEST_UFO = bit(10),
+        VIRTIO_NET_F_HOST_TSO4 = bit(11),
+        VIRTIO_NET_F_HOST_TSO6 = bit(12),
+        VIRTIO_NET_F_HOST_ECN = bit(13),
+        VIRTIO_NET_F_HOST_UFO = bit(14),
+        VIRTIO_NET_F_MRG_RXBUF = bit(15),
         VIRTIO_NET_F_STATUS = bit(16),
         VIRTIO_NET_F_CTRL_VQ = bit(17),
         VIRTIO_NET_F_CTRL_RX = bit(18),
         VIRTIO_NET_F_CTRL_VLAN = bit(19),
         VIRTIO_NET_F_CTRL_RX_EXTRA = bit(20),
         VIRTIO_NET_F_CTRL_ANNOUNCE = bit(21),
+        VIRTIO_NET_F_MQ = bit(22),
         VIRTIO_NET_F_CTRL_MAC_ADDR = bit(23),
+
+        VIRTIO_NET_F_OFFLOADS = VIRTIO_NET_F_CSUM | VIRTIO_NET_F_GUEST_CSUM |
+                                VIRTIO_NET_F_GUEST_TSO4 |
+                                VIRTIO_NET_F_GUEST_TSO6 |
+                                VIRTIO_NET_F_GUEST_ECN |
+                                VIRTIO_NET_F_GUEST_UFO |
+                                VIRTIO_NET_F_HOST_TSO4 |
+                                VIRTIO_NET_F_HOST_TSO6 |
+                                VIRTIO_NET_F_HOST_ECN | VIRTIO_NET_F_HOST_UFO,
     };
 
 private:
@@ -64,21 +85,45 @@ private:
     vector<mac_addr> m_unicast;
     vector<mac_addr> m_multicast;
 
-    sc_event m_rxev;
-    sc_event m_txev;
+    // each queue pair owns virtqueues 2n (rx) and 2n + 1 (tx) as well as
+    // the threads processing them
+    struct queue_pair {
+        u32 rxq;
+        u32 txq;
+        sc_event rxev;
+        sc_event txev;
+        deque<eth_frame> backlog;
+        vector<vq_message> rxbufs;
+        eth_frame txframe;
+    };
+
+    vector<unique_ptr<queue_pair>> m_pairs;
+    size_t m_active_pairs;
+    u64 m_features;
+
+    bool has_feature(u64 feature) const {
+        return (m_features & feature) == feature;
+    }
+
+    // without multiqueue, the control queue directly follows the first pair
+    u32 ctrlq() const {
+        return has_feature(VIRTIO_NET_F_MQ) ? 2 * m_pairs.size() : 2;
+    }
 
     bool filter(const eth_frame& frame);
+    size_t steer(const eth_frame& frame) const;
 
     void handle_ctrl();
     void handle_ctrl_rx(vq_message& msg);
     void handle_ctrl_announce(vq_message& msg);
     void handle_ctrl_mac_addr(vq_message& msg);
+    void handle_ctrl_mq(vq_message& msg);
 
-    bool handle_rx(vq_message& msg, eth_frame& frame);
-    bool handle_tx(vq_message& msg);
+    bool handle_rx(queue_pair& qp, const eth_frame& frame);
+    bool handle_tx(queue_pair& qp, vq_message& msg);
 
-    void rx_thread();
-    void tx_thread();
+    void rx_thread(queue_pair& qp);
+    void tx_thread(queue_pair& qp);
 
     virtual void identify(virtio_device_desc& desc) override;
     virtual bool notify(u32 vqid) override;
@@ -92,10 +137,14 @@ private:
     virtual void eth_link_up() override;
     virtual void eth_link_down() override;
     virtual void eth_receive(const eth_frame& frame) override;
+    virtual bool eth_rx_offload(const eth_target_socket& socket,
+                                const eth_frame& frame) const override;
 
 public:
     property<string> mac;
     property<u16> mtu;
+    property<u16> queues;
+    property<bool> offload;
 
     virtio_target_socket virtio_in;
     eth_initiator_socket eth_tx;
@@ -105,6 +154,8 @@ public:
     virtual ~net();
     VCML_KIND(virtio::net);
 
+    size_t active_queue_pairs() const { return m_active_pairs; }
+
     virtual void reset() override;
 };
 
@@ -29,12 +29,37 @@ protected:
 
     string expand(const string& s);
 
+    // dynamic brokers do not store their values in m_values, but produce
+    // them on demand in lookup, so they cannot be part of the index
+    broker(const string& name, bool insert_front, bool dynamic);
+
+    // defines key and value as they are, without expanding them
+    void insert(const string& key, const string& val, size_t uses);
+    void remove(const string& key);
+
+private:
+    // maps every property name to the value of the broker that takes
+    // precedence for it, among all brokers that are not dynamic
+    struct entry {
+        broker* owner;
+        struct value* val;
+    };
+
+    i64 m_rank;
+    bool m_dynamic;
+
+    static unordered_map<string, entry>& index();
+    static void reindex(const string& key);
+
 public:
     const char* name() const { return m_name.c_str(); }
     virtual const char* kind() const { return "vcml::broker"; }
 
+    bool is_dynamic() const { return m_dynamic; }
+
     broker(const string& name): broker(name, false) {}
-    broker(const string& name, bool insert_front);
+    broker(const string& name, bool insert_front):
+        broker(name, insert_front, false) {}
     virtual ~broker();
 
     virtual bool lookup(const string& key, string& value);
@@ -58,6 +83,7 @@ public:
     template <typename T>
     static T get_or_default(const string& key, const T& def = T());
 
+    static vector<pair<string, string>> collect_defined();
     static vector<pair<string, broker*>> collect_unused();
     static size_t report_unused();
 };
@@ -70,7 +96,7 @@ inline void broker::define(const string& key, const T& val, size_t uses) {
 template <>
 inline void broker::define(const string& key, const string& val, size_t uses) {
     if (!key.empty())
-        m_values[expand(key)] = { expand(val), uses };
+        insert(expand(key), expand(val), uses);
 }
 
 template <typename T>
@@ -92,7 +118,7 @@ inline void broker::define(const string& key, initializer_list<T> list,
 }
 
 inline void broker::undefine(const string& key) {
-    m_values.erase(key);
+    remove(key);
 }
 
 template <typename T>
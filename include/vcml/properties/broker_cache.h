@@ -0,0 +1,70 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_BROKER_CACHE_H
+#define VCML_BROKER_CACHE_H
+
+#include "vcml/properties/broker.h"
+
+namespace vcml {
+
+// Loads property values from binary files as written by --config-dump or
+// the Lua configuration cache. These are memory-mapped and defined without
+// any parsing or expansion. Besides the values, each file holds a stamp and
+// the files the values were derived from, with their modification times,
+// so that users can tell whether the contents are still current.
+class broker_cache : public broker
+{
+public:
+    struct source {
+        string path;
+        u64 mtime;
+    };
+
+    using value_fn = function<void(const string&, const string&)>;
+
+    broker_cache() = delete;
+    broker_cache(const string& filename);
+    virtual ~broker_cache();
+    VCML_KIND(broker_cache);
+
+    // true if the file looks like a binary property file
+    static bool is_cache(const string& filename);
+
+    // reads a binary property file and reports every value; fails if the
+    // file is malformed, a source file has changed or, if a stamp is given,
+    // the stamp of the file differs
+    static bool read(const string& filename, optional<u64> stamp,
+                     const value_fn& fn);
+    static bool read(const string& filename, const value_fn& fn);
+
+    static void write(const string& filename, u64 stamp,
+                      const vector<source>& sources,
+                      const vector<pair<string, string>>& values);
+
+    // writes the resolved value of every property defined in any broker
+    static void dump(const string& filename);
+
+    static u64 mtime(const string& path);
+    static u64 hash(const void* data, size_t size, u64 seed = 0);
+    static u64 hash(const string& s, u64 seed = 0);
+};
+
+inline bool broker_cache::read(const string& filename, const value_fn& fn) {
+    return read(filename, std::nullopt, fn);
+}
+
+inline u64 broker_cache::hash(const string& s, u64 seed) {
+    return hash(s.data(), s.length(), seed);
+}
+
+} // namespace vcml
+
+#endif
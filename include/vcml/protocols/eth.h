@@ -92,6 +92,30 @@ struct eth_frame : public vector<u8> {
         IP_UDP = 0x11,
     };
 
+    // offload requests travelling with a frame, encoded like the header
+    // of virtio and tap devices (struct virtio_net_hdr)
+    enum offload_flags : u8 {
+        OFFLOAD_NEEDS_CSUM = bit(0),
+        OFFLOAD_CSUM_VALID = bit(1),
+    };
+
+    enum offload_gso : u8 {
+        GSO_NONE = 0,
+        GSO_TCPV4 = 1,
+        GSO_UDP = 3,
+        GSO_TCPV6 = 4,
+        GSO_ECN = 0x80,
+    };
+
+    struct offload_desc {
+        u8 flags;
+        u8 gso_type;
+        u16 hdr_len;
+        u16 gso_size;
+        u16 csum_start;
+        u16 csum_offset;
+    } offload{};
+
     eth_frame() = default;
     eth_frame(eth_frame&&) = default;
     eth_frame(const eth_frame&) = default;
@@ -142,6 +166,15 @@ struct eth_frame : public vector<u8> {
         return size() >= FRAME_MIN_SIZE && size() <= FRAME_MAX_SIZE;
     }
 
+    u8 gso_type() const { return offload.gso_type & ~GSO_ECN; }
+    bool is_gso() const { return gso_type() != GSO_NONE; }
+    bool needs_csum() const { return offload.flags & OFFLOAD_NEEDS_CSUM; }
+    bool has_offloads() const { return is_gso() || needs_csum(); }
+
+    // hashes addresses and ports, so that all frames of a flow yield the
+    // same value; used to spread flows across queues
+    u32 flow_hash() const;
+
     string identify() const;
 
     bool is_nc() const;
@@ -154,6 +187,31 @@ struct eth_frame : public vector<u8> {
 ostream& operator<<(ostream& os, const mac_addr& addr);
 ostream& operator<<(ostream& os, const eth_frame& frame);
 
+// RFC 1071 internet checksum of data, optionally continuing a partial sum
+// that was accumulated in network byte order
+u16 eth_checksum(const u8* data, size_t len, u32 sum = 0);
+
+// Completes a checksum left open by a sender that offloaded it: sums up all
+// bytes from start to the end of the frame and stores the result at
+// start + offset, where the sender has placed its pseudo header sum.
+bool eth_checksum_offload(u8* frame, size_t len, size_t start, size_t offset);
+
+// Returns true if the frame holds a TCP or UDP packet over IPv4 or IPv6 and
+// its layer four checksum is correct.
+bool eth_checksum_valid(const u8* frame, size_t len);
+
+// Carries out the offloads requested by a frame: GSO frames get segmented
+// and pending checksums filled in. Frames without offloads are copied as-is.
+bool eth_resolve_offloads(const eth_frame& frame, vector<eth_frame>& out);
+
+// Splits an oversized frame into frames carrying at most mss payload bytes
+// each. TCP packets are segmented (TSO), UDP packets over IPv4 are split
+// into IP fragments (UFO). All headers and checksums of the resulting frames
+// are recomputed. Existing frames in segments are reused to avoid
+// allocations. Returns false if the frame cannot be segmented.
+bool eth_segment(const u8* frame, size_t len, size_t mss,
+                 vector<eth_frame>& segments);
+
 constexpr bool success(const eth_frame& frame) {
     return true;
 }
@@ -197,6 +255,11 @@ protected:
     virtual void eth_receive(const eth_frame& frame);
     virtual bool eth_rx_pop(eth_frame& frame);
 
+    // Hosts that can process a frame with offloads as-is return true. All
+    // others receive such frames segmented and with checksums filled in.
+    virtual bool eth_rx_offload(const eth_target_socket& socket,
+                                const eth_frame& frame) const;
+
     virtual void eth_link_up();
     virtual void eth_link_up(const eth_initiator_socket& sock);
     virtual void eth_link_up(const eth_target_socket& sock);
@@ -225,7 +288,7 @@ class eth_fw_transport_if : public sc_core::sc_interface
 public:
     typedef eth_frame protocol_types;
 
-    virtual void eth_transport(eth_frame& frame) = 0;
+    virtual void eth_transport(const eth_frame& frame) = 0;
 };
 
 class eth_bw_transport_if : public sc_core::sc_interface
@@ -302,7 +365,7 @@ public:
     VCML_KIND(eth_initiator_socket);
 
     void send(const vector<u8>& data);
-    void send(eth_frame& frame);
+    void send(const eth_frame& frame);
 };
 
 class eth_target_socket : public eth_base_target_socket
@@ -316,12 +379,14 @@ private:
         eth_fw_transport(eth_target_socket* t):
             eth_fw_transport_if(), socket(t) {}
         virtual ~eth_fw_transport() = default;
-        virtual void eth_transport(eth_frame& frame) override {
+        virtual void eth_transport(const eth_frame& frame) override {
             socket->eth_transport(frame);
         }
     } m_transport;
 
-    void eth_transport(eth_frame& frame);
+    vector<eth_frame> m_resolved;
+
+    void eth_transport(const eth_frame& frame);
 
 public:
     bool link_up() const { return m_link_up; }
@@ -343,7 +408,7 @@ public:
 class eth_target_stub : private eth_fw_transport_if
 {
 private:
-    virtual void eth_transport(eth_frame& frame) override;
+    virtual void eth_transport(const eth_frame& frame) override;
 
 public:
     eth_base_target_socket eth_rx;
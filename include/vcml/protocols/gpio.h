@@ -16,6 +16,7 @@
 #include "vcml/core/module.h"
 
 #include "vcml/protocols/base.h"
+#include "vcml/debugging/hostprof.h"
 
 namespace vcml {
 
@@ -207,6 +208,7 @@ private:
     unordered_map<gpio_vector, bool> m_state;
     gpio_base_initiator_socket* m_initiator;
     vector<gpio_base_target_socket*> m_targets;
+    debugging::hostprof::site m_hostprof;
 
     struct gpio_fw_transport : public gpio_fw_transport_if {
         mutable gpio_target_socket* socket;
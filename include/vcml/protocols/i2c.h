@@ -39,6 +39,14 @@ struct i2c_payload {
     i2c_command cmd;
     i2c_response resp;
     u8 data;
+
+    // optional I2C_DATA burst: when buffer is set, length bytes are read
+    // into or written from it instead of using data; on return, length
+    // holds the number of bytes the target has processed
+    u8* buffer = nullptr;
+    size_t length = 0;
+
+    bool is_burst() const { return buffer != nullptr; }
 };
 
 constexpr bool success(i2c_response resp) {
@@ -94,6 +102,11 @@ public:
     virtual i2c_response i2c_stop(const i2c_target_socket&);
     virtual i2c_response i2c_read(const i2c_target_socket&, u8& data);
     virtual i2c_response i2c_write(const i2c_target_socket&, u8 data);
+
+    virtual i2c_response i2c_read_burst(const i2c_target_socket&, u8* data,
+                                        size_t& len);
+    virtual i2c_response i2c_write_burst(const i2c_target_socket&,
+                                         const u8* data, size_t& len);
 };
 
 class i2c_fw_transport_if : public sc_core::sc_interface
@@ -176,6 +189,7 @@ public:
     i2c_response start(u8 address, tlm_command cmd = TLM_IGNORE_COMMAND);
     i2c_response stop();
     i2c_response transport(u8& data);
+    i2c_response transport(u8* data, size_t& len);
 
     void transport(i2c_payload& tx);
 };
@@ -72,6 +72,13 @@ struct sd_data {
         sd_status_tx read;
         sd_status_rx write;
     } status;
+
+    // block transfers move whole data blocks without CRC tokens; on return
+    // length holds the number of bytes actually transferred
+    u8* buffer = nullptr;
+    size_t length = 0;
+
+    bool is_block() const { return buffer != nullptr; }
 };
 
 void sd_init_read(sd_data& data);
@@ -155,6 +162,10 @@ public:
     virtual ~sd_host() = default;
     virtual void sd_transport(const sd_target_socket&, sd_command&) = 0;
     virtual void sd_transport(const sd_target_socket&, sd_data&) = 0;
+
+    // hosts that cannot transfer whole blocks leave the status incomplete,
+    // initiators then fall back to byte-wise transport
+    virtual void sd_transport_blocks(const sd_target_socket&, sd_data&) {}
 };
 
 struct sd_protocol_types {
@@ -244,6 +255,9 @@ public:
 
     sd_status_tx read_data(u8& data);
     sd_status_rx write_data(u8 data);
+
+    sd_status_tx read_blocks(u8* data, size_t& len);
+    sd_status_rx write_blocks(const u8* data, size_t& len);
 };
 
 class sd_target_socket : public sd_base_target_socket
@@ -23,10 +23,43 @@ struct spi_payload {
     u32 miso;
     u32 mask;
 
-    spi_payload(): mosi(), miso(), mask(0xff) {}
-    spi_payload(u32 init): mosi(init), miso(), mask(0xff) {}
+    // optional burst: when mosi_buf is set, length words are shifted out
+    // back-to-back from mosi_buf and the received words are stored in
+    // miso_buf (if not null) instead of using the mosi and miso fields
+    const u32* mosi_buf;
+    u32* miso_buf;
+    size_t length;
+
+    spi_payload():
+        mosi(),
+        miso(),
+        mask(0xff),
+        mosi_buf(nullptr),
+        miso_buf(nullptr),
+        length(0) {}
+    spi_payload(u32 init):
+        mosi(init),
+        miso(),
+        mask(0xff),
+        mosi_buf(nullptr),
+        miso_buf(nullptr),
+        length(0) {}
     spi_payload(u32 mosi_init, u32 miso_init, u32 mask_init = 0xff):
-        mosi(mosi_init), miso(miso_init), mask(mask_init) {}
+        mosi(mosi_init),
+        miso(miso_init),
+        mask(mask_init),
+        mosi_buf(nullptr),
+        miso_buf(nullptr),
+        length(0) {}
+    spi_payload(const u32* tx, u32* rx, size_t len, u32 mask_init = 0xff):
+        mosi(),
+        miso(),
+        mask(mask_init),
+        mosi_buf(tx),
+        miso_buf(rx),
+        length(len) {}
+
+    bool is_burst() const { return mosi_buf != nullptr; }
 
     bool operator==(const spi_payload& o) const {
         return mosi == o.mosi && miso == o.miso;
@@ -50,6 +83,7 @@ public:
     spi_host() = default;
     virtual ~spi_host() = default;
     virtual void spi_transport(const spi_target_socket&, spi_payload&) = 0;
+    virtual void spi_burst(const spi_target_socket&, spi_payload&);
 };
 
 class spi_fw_transport_if : public sc_core::sc_interface
@@ -128,6 +162,7 @@ public:
     VCML_KIND(spi_initiator_socket);
 
     void transport(spi_payload& spi);
+    void transport(const u32* mosi, u32* miso, size_t len, u32 mask = 0xff);
 };
 
 class spi_target_socket : public spi_base_target_socket
@@ -27,6 +27,8 @@
 
 #include "vcml/properties/property.h"
 #include "vcml/tracing/tracer.h"
+#include "vcml/debugging/hostprof.h"
+#include "vcml/debugging/metrics.h"
 
 namespace vcml {
 
@@ -45,6 +47,11 @@ private:
     module* m_parent;
     module* m_adapter;
 
+    u64 m_sent;
+    u64 m_dmi_hits;
+    debugging::counter m_num_sent;
+    debugging::counter m_num_dmi;
+
     void trace_fw(const tlm_generic_payload& tx, const sc_time& t);
     void trace_bw(const tlm_generic_payload& tx, const sc_time& t);
 
@@ -84,6 +91,9 @@ public:
     void map_dmi(const tlm_dmi& dmi);
     void unmap_dmi(u64 start, u64 end);
 
+    u64 num_sent() const { return m_sent; }
+    u64 num_dmi_hits() const { return m_dmi_hits; }
+
     void b_transport(tlm_generic_payload& tx, sc_time& t);
 
     unsigned int send(tlm_generic_payload& tx, const tlm_sbi& info = SBI_NONE);
@@ -298,6 +308,9 @@ private:
     per_thread<tlm_generic_payload*> m_payload;
     per_thread<tlm_sbi> m_sideband;
 
+    debugging::hostprof::site m_hostprof;
+    debugging::counter m_num_received;
+
     void wait_free();
 
     void trace_fw(const tlm_generic_payload& tx, const sc_time& t);
@@ -327,6 +340,8 @@ public:
 
     tlm_dmi_cache& dmi_cache();
     tlm_exmon& exmon() { return m_exmon; }
+    const debugging::hostprof::site& hostprof() const { return m_hostprof; }
+    u64 num_received() const { return m_num_received.value(); }
 
     void map_dmi(const tlm_dmi& dmi);
     void unmap_dmi(const range& mem);
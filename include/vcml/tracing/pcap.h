@@ -0,0 +1,128 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_TRACING_PCAP_H
+#define VCML_TRACING_PCAP_H
+
+#include "vcml/core/types.h"
+#include "vcml/core/systemc.h"
+
+namespace vcml {
+
+enum pcap_linktype : u16 {
+    PCAP_LINKTYPE_ETHERNET = 1,
+    PCAP_LINKTYPE_CAN_SOCKETCAN = 227,
+};
+
+// direction as seen from the guest, matches the pcapng epb_flags encoding
+enum pcap_direction : u32 {
+    PCAP_UNKNOWN = 0,
+    PCAP_INBOUND = 1,  // host to guest
+    PCAP_OUTBOUND = 2, // guest to host
+};
+
+// Writes packets into pcapng files with nanosecond timestamps. Packets are
+// collected in memory and written in chunks of BUFFER_SIZE. If a rotation
+// limit is given, a new file is started once the current one would exceed
+// it; rotated files get a sequence number before their extension, e.g.
+// "net.pcapng", "net.1.pcapng", "net.2.pcapng", ...
+class pcap_writer
+{
+private:
+    string m_path;
+    string m_ifname;
+    pcap_linktype m_linktype;
+    u64 m_limit;
+    u64 m_size;
+    u64 m_start;
+    size_t m_index;
+    size_t m_packets;
+    vector<u8> m_buffer;
+    ofstream m_file;
+
+    void open();
+    void rotate();
+
+public:
+    enum : size_t { BUFFER_SIZE = 64 * KiB };
+
+    const string& path() const { return m_path; }
+    pcap_linktype linktype() const { return m_linktype; }
+    size_t packets() const { return m_packets; }
+    size_t files() const { return m_index + 1; }
+    bool is_open() const { return m_file.is_open(); }
+
+    pcap_writer(const string& path, pcap_linktype linktype,
+                const string& ifname = "", u64 rotate = 0);
+    virtual ~pcap_writer();
+
+    pcap_writer(const pcap_writer&) = delete;
+    pcap_writer& operator=(const pcap_writer&) = delete;
+
+    void write(const sc_time& t, const u8* data, size_t len,
+               pcap_direction dir = PCAP_UNKNOWN);
+    void flush();
+
+    static string rotated_path(const string& path, size_t index);
+};
+
+// Reads packets from pcapng files as well as from classic pcap files in
+// microsecond or nanosecond resolution and either byte order.
+class pcap_reader
+{
+public:
+    struct packet {
+        sc_time timestamp;
+        pcap_linktype linktype;
+        pcap_direction direction;
+        vector<u8> data;
+    };
+
+private:
+    struct iface {
+        pcap_linktype linktype;
+        u64 tsrate; // timestamp ticks per second
+    };
+
+    string m_path;
+    ifstream m_file;
+    bool m_ng;
+    bool m_swap;
+    vector<iface> m_ifaces;
+    vector<u8> m_block;
+
+    u16 get16(const u8* p) const;
+    u32 get32(const u8* p) const;
+
+    bool read_header();
+    bool read_block(u32& type);
+    bool next_pcap(packet& pkt);
+    bool next_pcapng(packet& pkt);
+
+    void parse_idb();
+    static sc_time timestamp(u64 ticks, u64 rate);
+
+public:
+    const string& path() const { return m_path; }
+    bool is_open() const { return m_file.is_open(); }
+
+    pcap_reader(const string& path);
+    virtual ~pcap_reader() = default;
+
+    pcap_reader(const pcap_reader&) = delete;
+    pcap_reader& operator=(const pcap_reader&) = delete;
+
+    // returns false once the end of the file or a malformed record is hit
+    bool next(packet& pkt);
+};
+
+} // namespace vcml
+
+#endif
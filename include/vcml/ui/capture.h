@@ -0,0 +1,91 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_UI_CAPTURE_H
+#define VCML_UI_CAPTURE_H
+
+#include "vcml/core/types.h"
+#include "vcml/ui/video.h"
+
+namespace vcml {
+namespace ui {
+
+// converts a framebuffer of the given mode into packed 8bit RGB triplets
+void convert_rgb24(const videomode& mode, const u8* fb, u8* rgb);
+
+// encodes packed 8bit RGB triplets as PNG, comment goes into a tEXt chunk
+void encode_png(const u8* rgb, u32 width, u32 height, vector<u8>& png,
+                const string& comment = "");
+
+// 64bit difference hash of the framebuffer contents; images that look alike
+// produce hashes with a small hamming distance, even if scaled or recolored
+u64 phash(const videomode& mode, const u8* fb);
+
+inline u32 phash_distance(u64 a, u64 b) {
+    return popcnt(a ^ b);
+}
+
+// Stores screenshots and video frames on a worker thread. Frames are copied
+// on submission, so the framebuffer may change right after. Videos are
+// written as a stream of concatenated PNG images, each carrying its capture
+// time as a comment, e.g. for playback via "ffmpeg -f png_pipe -i <file>".
+class capture
+{
+private:
+    enum job_kind {
+        JOB_SCREENSHOT,
+        JOB_VIDEO_OPEN,
+        JOB_VIDEO_FRAME,
+        JOB_VIDEO_CLOSE,
+    };
+
+    struct job {
+        job_kind kind;
+        string path;
+        string comment;
+        videomode mode;
+        vector<u8> data;
+    };
+
+    mutex m_mtx;
+    condition_variable m_cv;
+    deque<job> m_jobs;
+    size_t m_active;
+    bool m_running;
+    thread m_worker;
+
+    void submit(job&& j);
+    void work();
+    void process(job& j, ofstream& video);
+
+public:
+    enum : size_t { MAX_PENDING = 16 };
+
+    capture();
+    virtual ~capture();
+
+    capture(const capture&) = delete;
+    capture& operator=(const capture&) = delete;
+
+    void screenshot(const string& path, const videomode& mode, const u8* fb,
+                    const string& comment = "");
+
+    void start(const string& path);
+    void record(const videomode& mode, const u8* fb, const string& comment);
+    void stop();
+
+    // blocks until all submitted jobs have been written
+    void flush();
+};
+
+} // namespace ui
+} // namespace vcml
+
+#endif
@@ -12,8 +12,11 @@
 #define VCML_UI_CONSOLE_H
 
 #include "vcml/core/types.h"
+#include "vcml/core/systemc.h"
 
 #include "vcml/ui/video.h"
+#include "vcml/ui/damage.h"
+#include "vcml/ui/capture.h"
 #include "vcml/ui/keymap.h"
 #include "vcml/ui/input.h"
 #include "vcml/ui/display.h"
@@ -33,10 +36,20 @@ private:
     unordered_set<input*> m_inputs;
     unordered_set<shared_ptr<display>> m_displays;
 
+    mutable unique_ptr<capture> m_capture;
+    damage m_capture_damage;
+    sc_time m_capture_interval;
+    sc_time m_capture_next;
+    bool m_capturing;
+
+    capture& capturer() const;
+
 public:
     property<vector<string>> displays;
 
     bool has_display() const { return !m_displays.empty(); }
+    bool has_clients() const;
+    bool is_capturing() const { return m_capturing; }
 
     const videomode& mode() const { return m_mode; }
     const u8* framebuffer() const { return m_fbptr; }
@@ -56,7 +69,21 @@ public:
     void render();
     void shutdown();
 
+    // files ending in .png are encoded and written asynchronously
     bool screenshot(const string& path) const;
+
+    // stores changed frames, at most one per interval, into a PNG stream;
+    // models call sample() once per refresh to feed frames into it
+    bool start_capture(const string& path, const sc_time& interval);
+    void stop_capture();
+    void sample();
+
+    void flush_capture() const;
+
+    // command handler for models: capture <file> [interval] | capture stop
+    bool cmd_capture(const vector<string>& args, ostream& os);
+
+    u64 phash() const;
 };
 
 inline u32 console::read_pixel(u32 x, u32 y) const {
@@ -0,0 +1,53 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_UI_DAMAGE_H
+#define VCML_UI_DAMAGE_H
+
+#include "vcml/core/types.h"
+#include "vcml/core/range.h"
+
+namespace vcml {
+namespace ui {
+
+// Detects changes in framebuffer memory by hashing it in pages and
+// comparing against the hashes of the previous check. The first check after
+// construction or invalidate() always reports the entire buffer as changed.
+class damage
+{
+private:
+    size_t m_pagesize;
+    vector<u64> m_hashes;
+    bool m_valid;
+
+public:
+    size_t pagesize() const { return m_pagesize; }
+
+    damage(size_t pagesize = 4 * KiB);
+    virtual ~damage() = default;
+
+    void invalidate() { m_valid = false; }
+
+    // returns true if data changed, changed receives the modified offsets
+    bool check(const u8* data, size_t size, range& changed);
+    bool check(const u8* data, size_t size);
+
+    static u64 hash(const u8* data, size_t size);
+};
+
+inline bool damage::check(const u8* data, size_t size) {
+    range changed;
+    return check(data, size, changed);
+}
+
+} // namespace ui
+} // namespace vcml
+
+#endif
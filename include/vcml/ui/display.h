@@ -58,6 +58,9 @@ public:
     u64 framebuffer_size() const { return m_mode.size; }
     bool has_framebuffer() const { return m_mode.size > 0; }
 
+    // true if somebody is currently looking at the display output
+    virtual bool has_clients() const { return false; }
+
     display() = delete;
     display(const display&) = delete;
     display(const string& type, u32 nr);
@@ -0,0 +1,533 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/audio/converter.h"
+
+#include <cmath>
+
+namespace vcml {
+namespace audio {
+
+// The sample kernels below are plain loops over contiguous arrays without
+// data-dependent branches, so that the compiler can vectorize them. Loads
+// and stores go through memcpy, since guest buffers need not be aligned.
+
+constexpr bool SWAP_LE = !format_is_native_endian(AUDIO_ENDIAN_LITTLE);
+constexpr bool SWAP_BE = !format_is_native_endian(AUDIO_ENDIAN_BIG);
+
+template <typename T>
+static inline T load(const u8* ptr) {
+    T val;
+    memcpy(&val, ptr, sizeof(T));
+    return val;
+}
+
+template <typename T>
+static inline void store(u8* ptr, T val) {
+    memcpy(ptr, &val, sizeof(T));
+}
+
+template <typename T, bool SWAP>
+static inline T swap_if(T val) {
+    if constexpr (SWAP && sizeof(T) > 1)
+        return bswap(val);
+    else
+        return val;
+}
+
+template <typename T, bool SWAP, bool UNSIGNED>
+static void decode_int(const u8* src, float* dst, size_t n) {
+    typedef std::make_signed_t<T> S;
+    constexpr T sign = (T)1 << (sizeof(T) * 8 - 1);
+    constexpr float scale = 1.0f / (float)sign;
+    for (size_t i = 0; i < n; i++) {
+        T val = swap_if<T, SWAP>(load<T>(src + i * sizeof(T)));
+        if constexpr (UNSIGNED)
+            val ^= sign;
+        dst[i] = (float)(S)val * scale;
+    }
+}
+
+template <bool SWAP>
+static void decode_float(const u8* src, float* dst, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        u32 val = swap_if<u32, SWAP>(load<u32>(src + i * sizeof(u32)));
+        memcpy(dst + i, &val, sizeof(val));
+    }
+}
+
+template <typename T, bool SWAP, bool UNSIGNED>
+static void encode_int(const float* src, u8* dst, size_t n) {
+    typedef std::make_signed_t<T> S;
+    typedef std::conditional_t<(sizeof(T) < 4), float, double> R;
+    constexpr T sign = (T)1 << (sizeof(T) * 8 - 1);
+    constexpr R lo = -(R)sign;
+    constexpr R hi = (R)sign - 1;
+    for (size_t i = 0; i < n; i++) {
+        R x = (R)src[i] * (R)sign;
+        x = x == x ? x : 0; // NaN
+        x = x < lo ? lo : (x > hi ? hi : x);
+        x = x < 0 ? x - (R)0.5 : x + (R)0.5;
+        T val = (T)(S)x;
+        if constexpr (UNSIGNED)
+            val ^= sign;
+        store(dst + i * sizeof(T), swap_if<T, SWAP>(val));
+    }
+}
+
+template <bool SWAP>
+static void encode_float(const float* src, u8* dst, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        u32 val;
+        memcpy(&val, src + i, sizeof(val));
+        store(dst + i * sizeof(u32), swap_if<u32, SWAP>(val));
+    }
+}
+
+template <typename T, bool SWAP, bool UNSIGNED>
+static void unpack_int(const u8* src, i32* dst, size_t n) {
+    constexpr T sign = (T)1 << (sizeof(T) * 8 - 1);
+    constexpr u32 shift = 32 - sizeof(T) * 8;
+    for (size_t i = 0; i < n; i++) {
+        T val = swap_if<T, SWAP>(load<T>(src + i * sizeof(T)));
+        if constexpr (UNSIGNED)
+            val ^= sign;
+        dst[i] = (i32)((u32)val << shift);
+    }
+}
+
+template <typename T, bool SWAP, bool UNSIGNED>
+static void pack_int(const i32* src, u8* dst, size_t n) {
+    constexpr T sign = (T)1 << (sizeof(T) * 8 - 1);
+    constexpr u32 shift = 32 - sizeof(T) * 8;
+    for (size_t i = 0; i < n; i++) {
+        T val = (T)((u32)src[i] >> shift);
+        if constexpr (UNSIGNED)
+            val ^= sign;
+        store(dst + i * sizeof(T), swap_if<T, SWAP>(val));
+    }
+}
+
+static converter::decode_fn lookup_decoder(u32 format) {
+    switch (format) {
+    case FORMAT_U8:
+        return &decode_int<u8, false, true>;
+    case FORMAT_S8:
+        return &decode_int<u8, false, false>;
+    case FORMAT_U16LE:
+        return &decode_int<u16, SWAP_LE, true>;
+    case FORMAT_U16BE:
+        return &decode_int<u16, SWAP_BE, true>;
+    case FORMAT_S16LE:
+        return &decode_int<u16, SWAP_LE, false>;
+    case FORMAT_S16BE:
+        return &decode_int<u16, SWAP_BE, false>;
+    case FORMAT_U32LE:
+        return &decode_int<u32, SWAP_LE, true>;
+    case FORMAT_U32BE:
+        return &decode_int<u32, SWAP_BE, true>;
+    case FORMAT_S32LE:
+        return &decode_int<u32, SWAP_LE, false>;
+    case FORMAT_S32BE:
+        return &decode_int<u32, SWAP_BE, false>;
+    case FORMAT_F32LE:
+        return &decode_float<SWAP_LE>;
+    case FORMAT_F32BE:
+        return &decode_float<SWAP_BE>;
+    default:
+        return nullptr;
+    }
+}
+
+static converter::encode_fn lookup_encoder(u32 format) {
+    switch (format) {
+    case FORMAT_U8:
+        return &encode_int<u8, false, true>;
+    case FORMAT_S8:
+        return &encode_int<u8, false, false>;
+    case FORMAT_U16LE:
+        return &encode_int<u16, SWAP_LE, true>;
+    case FORMAT_U16BE:
+        return &encode_int<u16, SWAP_BE, true>;
+    case FORMAT_S16LE:
+        return &encode_int<u16, SWAP_LE, false>;
+    case FORMAT_S16BE:
+        return &encode_int<u16, SWAP_BE, false>;
+    case FORMAT_U32LE:
+        return &encode_int<u32, SWAP_LE, true>;
+    case FORMAT_U32BE:
+        return &encode_int<u32, SWAP_BE, true>;
+    case FORMAT_S32LE:
+        return &encode_int<u32, SWAP_LE, false>;
+    case FORMAT_S32BE:
+        return &encode_int<u32, SWAP_BE, false>;
+    case FORMAT_F32LE:
+        return &encode_float<SWAP_LE>;
+    case FORMAT_F32BE:
+        return &encode_float<SWAP_BE>;
+    default:
+        return nullptr;
+    }
+}
+
+static converter::unpack_fn lookup_unpacker(u32 format) {
+    switch (format) {
+    case FORMAT_U8:
+        return &unpack_int<u8, false, true>;
+    case FORMAT_S8:
+        return &unpack_int<u8, false, false>;
+    case FORMAT_U16LE:
+        return &unpack_int<u16, SWAP_LE, true>;
+    case FORMAT_U16BE:
+        return &unpack_int<u16, SWAP_BE, true>;
+    case FORMAT_S16LE:
+        return &unpack_int<u16, SWAP_LE, false>;
+    case FORMAT_S16BE:
+        return &unpack_int<u16, SWAP_BE, false>;
+    case FORMAT_U32LE:
+        return &unpack_int<u32, SWAP_LE, true>;
+    case FORMAT_U32BE:
+        return &unpack_int<u32, SWAP_BE, true>;
+    case FORMAT_S32LE:
+        return &unpack_int<u32, SWAP_LE, false>;
+    case FORMAT_S32BE:
+        return &unpack_int<u32, SWAP_BE, false>;
+    default:
+        return nullptr; // float formats are not packed
+    }
+}
+
+static converter::pack_fn lookup_packer(u32 format) {
+    switch (format) {
+    case FORMAT_U8:
+        return &pack_int<u8, false, true>;
+    case FORMAT_S8:
+        return &pack_int<u8, false, false>;
+    case FORMAT_U16LE:
+        return &pack_int<u16, SWAP_LE, true>;
+    case FORMAT_U16BE:
+        return &pack_int<u16, SWAP_BE, true>;
+    case FORMAT_S16LE:
+        return &pack_int<u16, SWAP_LE, false>;
+    case FORMAT_S16BE:
+        return &pack_int<u16, SWAP_BE, false>;
+    case FORMAT_U32LE:
+        return &pack_int<u32, SWAP_LE, true>;
+    case FORMAT_U32BE:
+        return &pack_int<u32, SWAP_BE, true>;
+    case FORMAT_S32LE:
+        return &pack_int<u32, SWAP_LE, false>;
+    case FORMAT_S32BE:
+        return &pack_int<u32, SWAP_BE, false>;
+    default:
+        return nullptr;
+    }
+}
+
+bool format_is_valid(u32 format) {
+    return lookup_decoder(format) != nullptr;
+}
+
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+
+    return sum;
+}
+
+static double kaiser(double x, double beta) {
+    if (x < -1.0 || x > 1.0)
+        return 0.0;
+    return bessel_i0(beta * std::sqrt(1.0 - x * x)) / bessel_i0(beta);
+}
+
+static double sinc(double x) {
+    constexpr double pi = 3.14159265358979323846;
+    if (std::fabs(x) < 1e-9)
+        return 1.0;
+    return std::sin(pi * x) / (pi * x);
+}
+
+void converter::setup_mixer() {
+    const u32 src = m_src_channels;
+    const u32 dst = m_dst_channels;
+
+    m_mixmat.assign(src * dst, 0.0f);
+
+    // upmixing repeats the source channels cyclically, downmixing averages
+    // all source channels that map onto the same destination channel
+    if (dst >= src) {
+        for (u32 j = 0; j < dst; j++)
+            m_mixmat[j * src + j % src] = 1.0f;
+    } else {
+        vector<u32> count(dst, 0);
+        for (u32 i = 0; i < src; i++)
+            count[i % dst]++;
+        for (u32 i = 0; i < src; i++)
+            m_mixmat[(i % dst) * src + i] = 1.0f / count[i % dst];
+    }
+}
+
+void converter::setup_resampler() {
+    const size_t taps = RESAMPLER_TAPS;
+    const size_t phases = RESAMPLER_PHASES;
+    const double beta = 7.0;
+
+    // lower the cutoff below the new nyquist frequency when downsampling
+    double cutoff = min(1.0, (double)m_dst_rate / m_src_rate) * 0.95;
+
+    m_step = (double)m_src_rate / m_dst_rate;
+    m_filter.assign((phases + 1) * taps, 0.0f);
+
+    for (size_t p = 0; p <= phases; p++) {
+        double frac = (double)p / phases;
+        double sum = 0.0;
+        float* row = m_filter.data() + p * taps;
+        for (size_t k = 0; k < taps; k++) {
+            double x = (double)k - (taps / 2 - 1) - frac;
+            double h = cutoff * sinc(cutoff * x) * kaiser(x / (taps / 2), beta);
+            row[k] = (float)h;
+            sum += h;
+        }
+
+        for (size_t k = 0; k < taps; k++)
+            row[k] = (float)(row[k] / sum); // unity gain at DC
+    }
+}
+
+void converter::mix(const float* src, float* dst, size_t frames) {
+    const u32 sch = m_src_channels;
+    const u32 dch = m_dst_channels;
+    const float* mat = m_mixmat.data();
+
+    if (sch == 1) {
+        for (size_t f = 0; f < frames; f++)
+            for (u32 j = 0; j < dch; j++)
+                dst[f * dch + j] = src[f];
+        return;
+    }
+
+    for (size_t f = 0; f < frames; f++) {
+        for (u32 j = 0; j < dch; j++) {
+            float sum = 0.0f;
+            for (u32 i = 0; i < sch; i++)
+                sum += mat[j * sch + i] * src[f * sch + i];
+            dst[f * dch + j] = sum;
+        }
+    }
+}
+
+size_t converter::resample(const float* src, size_t frames,
+                           vector<float>& dst) {
+    const size_t taps = RESAMPLER_TAPS;
+    const size_t phases = RESAMPLER_PHASES;
+    const u32 channels = m_dst_channels;
+
+    for (u32 c = 0; c < channels; c++) {
+        vector<float>& hist = m_history[c];
+        size_t offset = hist.size();
+        hist.resize(offset + frames);
+        for (size_t f = 0; f < frames; f++)
+            hist[offset + f] = src[f * channels + c];
+    }
+
+    const size_t avail = m_history[0].size();
+    const size_t estimate = (size_t)(frames / m_step) + 2;
+    dst.resize(estimate * channels);
+
+    size_t n = 0;
+    while ((size_t)m_pos + taps / 2 + 1 <= avail) {
+        size_t base = (size_t)m_pos - (taps / 2 - 1);
+        double pf = (m_pos - std::floor(m_pos)) * phases;
+        size_t phase = (size_t)pf;
+        float frac = (float)(pf - phase);
+
+        const float* h0 = m_filter.data() + phase * taps;
+        const float* h1 = h0 + taps;
+
+        if (n >= estimate) {
+            dst.resize((n + 1) * channels);
+        }
+
+        for (u32 c = 0; c < channels; c++) {
+            const float* x = m_history[c].data() + base;
+            float a = 0.0f, b = 0.0f;
+            for (size_t k = 0; k < taps; k++) {
+                a += h0[k] * x[k];
+                b += h1[k] * x[k];
+            }
+
+            dst[n * channels + c] = a + (b - a) * frac;
+        }
+
+        m_pos += m_step;
+        n++;
+    }
+
+    // drop all samples that no future output frame will need again
+    size_t drop = min((size_t)m_pos - (taps / 2 - 1), avail);
+    for (u32 c = 0; c < channels; c++) {
+        vector<float>& hist = m_history[c];
+        hist.erase(hist.begin(), hist.begin() + drop);
+    }
+
+    m_pos -= drop;
+    dst.resize(n * channels);
+    return n;
+}
+
+void converter::process(const u8* src, size_t frames, vector<u8>& dst) {
+    if (frames == 0)
+        return;
+
+    const size_t dst_bytes = format_bits(m_dst_format) / 8;
+    size_t samples = frames * m_src_channels;
+    size_t start = dst.size();
+
+    if (m_unpack && m_pack) {
+        m_unpacked.resize(samples);
+        m_unpack(src, m_unpacked.data(), samples);
+        dst.resize(start + samples * dst_bytes);
+        m_pack(m_unpacked.data(), dst.data() + start, samples);
+        return;
+    }
+
+    m_decoded.resize(samples);
+    m_decode(src, m_decoded.data(), samples);
+    const float* data = m_decoded.data();
+
+    if (needs_mixing()) {
+        m_mixed.resize(frames * m_dst_channels);
+        mix(data, m_mixed.data(), frames);
+        data = m_mixed.data();
+    }
+
+    if (needs_resampling()) {
+        frames = resample(data, frames, m_resampled);
+        data = m_resampled.data();
+    }
+
+    samples = frames * m_dst_channels;
+    dst.resize(start + samples * dst_bytes);
+    m_encode(data, dst.data() + start, samples);
+}
+
+converter::converter():
+    m_src_format(FORMAT_INVALID),
+    m_src_channels(0),
+    m_src_rate(0),
+    m_dst_format(FORMAT_INVALID),
+    m_dst_channels(0),
+    m_dst_rate(0),
+    m_decode(nullptr),
+    m_encode(nullptr),
+    m_unpack(nullptr),
+    m_pack(nullptr),
+    m_partial(),
+    m_unpacked(),
+    m_decoded(),
+    m_mixed(),
+    m_resampled(),
+    m_mixmat(),
+    m_history(),
+    m_filter(),
+    m_step(1.0),
+    m_pos(0.0) {
+    // nothing to do
+}
+
+bool converter::configure(u32 src_format, u32 src_channels, u32 src_rate,
+                          u32 dst_format, u32 dst_channels, u32 dst_rate) {
+    if (!format_is_valid(src_format) || !format_is_valid(dst_format))
+        return false;
+    if (!src_channels || !dst_channels || !src_rate || !dst_rate)
+        return false;
+
+    m_src_format = src_format;
+    m_src_channels = src_channels;
+    m_src_rate = src_rate;
+    m_dst_format = dst_format;
+    m_dst_channels = dst_channels;
+    m_dst_rate = dst_rate;
+
+    m_decode = lookup_decoder(src_format);
+    m_encode = lookup_encoder(dst_format);
+
+    m_unpack = nullptr;
+    m_pack = nullptr;
+    if (!needs_mixing() && !needs_resampling()) {
+        m_unpack = lookup_unpacker(src_format);
+        m_pack = lookup_packer(dst_format);
+    }
+
+    if (needs_mixing())
+        setup_mixer();
+    if (needs_resampling())
+        setup_resampler();
+
+    reset();
+    return true;
+}
+
+void converter::reset() {
+    m_partial.clear();
+    m_history.assign(needs_resampling() ? m_dst_channels : 0,
+                     vector<float>(RESAMPLER_TAPS / 2 - 1, 0.0f));
+    m_pos = RESAMPLER_TAPS / 2 - 1;
+}
+
+size_t converter::input_size(size_t output_size) const {
+    if (!is_configured())
+        return output_size;
+
+    size_t frames = (output_size + dst_frame_size() - 1) / dst_frame_size();
+    frames = (frames * m_src_rate + m_dst_rate - 1) / m_dst_rate;
+    return frames * src_frame_size();
+}
+
+size_t converter::convert(const void* src, size_t len, vector<u8>& dst) {
+    VCML_ERROR_ON(!is_configured(), "audio converter not configured");
+
+    const u8* ptr = (const u8*)src;
+    const size_t start = dst.size();
+    const size_t framesz = src_frame_size();
+
+    if (is_identity()) {
+        dst.insert(dst.end(), ptr, ptr + len);
+        return len;
+    }
+
+    if (!m_partial.empty()) {
+        size_t n = min(framesz - m_partial.size(), len);
+        m_partial.insert(m_partial.end(), ptr, ptr + n);
+        ptr += n;
+        len -= n;
+
+        if (m_partial.size() == framesz) {
+            process(m_partial.data(), 1, dst);
+            m_partial.clear();
+        }
+    }
+
+    size_t frames = len / framesz;
+    process(ptr, frames, dst);
+
+    ptr += frames * framesz;
+    len -= frames * framesz;
+    m_partial.insert(m_partial.end(), ptr, ptr + len);
+
+    return dst.size() - start;
+}
+
+} // namespace audio
+} // namespace vcml
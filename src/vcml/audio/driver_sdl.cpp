@@ -79,13 +79,15 @@ SDL_AudioDeviceID driver_sdl::open(bool capture, u32 format, u32 channels,
         if (format == m_format && channels == m_channels && m_rate == rate)
             return device;
 
-        SDL_CloseAudioDevice(m_output);
+        SDL_CloseAudioDevice(device);
         m_format = FORMAT_INVALID;
         m_channels = 0;
         m_rate = 0;
     }
 
-    if (!output_supports_format(format))
+    bool supported = capture ? input_supports_format(format)
+                             : output_supports_format(format);
+    if (!supported)
         return 0;
 
     SDL_AudioSpec spec{};
@@ -45,34 +45,42 @@ const char* format_str(u32 format) {
 }
 
 void fill_silence(void* buf, size_t len, u32 format) {
-    switch (format_bits(format)) {
-    case 8: {
+    u8* ptr = (u8*)buf;
+    size_t width = format_bits(format) / 8;
+    if (len < width)
+        return;
+
+    switch (width) {
+    case 1: {
         u8 fill = format_is_signed(format) ? 0 : 0x7f;
         memset(buf, fill, len);
-        break;
+        return;
     }
 
-    case 16: {
+    case 2: {
         u16 fill = format_is_signed(format) ? 0 : 0x7fff;
         if (!format_is_native_endian(format))
             fill = bswap(fill);
-        for (size_t i = 0; i < len; i += sizeof(u16))
-            *(u16*)((u8*)buf + i) = fill;
+        memcpy(ptr, &fill, sizeof(fill));
         break;
     }
 
-    case 32: {
+    case 4: {
         u32 fill = format_is_signed(format) ? 0 : 0x7fffffff;
         if (!format_is_native_endian(format))
             fill = bswap(fill);
-        for (size_t i = 0; i < len; i += sizeof(u32))
-            *(u32*)((u8*)buf + i) = fill;
+        memcpy(ptr, &fill, sizeof(fill));
         break;
     }
 
     default:
         VCML_ERROR("unsupported format: 0x%x", format);
     }
+
+    // replicate the first sample in exponentially growing blocks
+    len -= len % width;
+    for (size_t done = width; done < len; done *= 2)
+        memcpy(ptr + done, ptr, min(done, len - done));
 }
 
 size_t buffer_size(const sc_time& len, u32 format, u32 channels, u32 rate) {
@@ -13,7 +13,11 @@
 namespace vcml {
 namespace audio {
 
-istream::istream(const sc_module_name& nm): stream(nm) {
+istream::istream(const sc_module_name& nm):
+    stream(nm),
+    m_format(FORMAT_INVALID),
+    m_buffer(),
+    m_pending(m_drivers.size()) {
     // nothing to do
 }
 
@@ -21,45 +25,33 @@ istream::~istream() {
     // nothing to do
 }
 
-size_t istream::min_channels() {
-    size_t min_channels = 1;
-    for (auto* drv : m_drivers)
-        min_channels = max(min_channels, drv->input_min_channels());
-    return min_channels;
-}
-
-size_t istream::max_channels() {
-    size_t max_channels = 8;
-    for (auto* drv : m_drivers)
-        max_channels = min(max_channels, drv->input_max_channels());
-    return max_channels;
-}
-
-bool istream::supports_format(u32 format) {
-    if (format == FORMAT_INVALID)
-        return false;
-
-    for (auto* drv : m_drivers) {
-        if (!drv->input_supports_format(format))
-            return false;
-    }
-
-    return true;
-}
-
-bool istream::supports_rate(u32 rate) {
-    for (auto* drv : m_drivers) {
-        if (!drv->input_supports_rate(rate))
-            return false;
-    }
-
-    return true;
-}
-
 bool istream::configure(u32 format, u32 channels, u32 rate) {
     bool ok = true;
-    for (driver* drv : m_drivers)
-        ok &= drv->input_configure(format, channels, rate);
+    m_format = format;
+    for (size_t i = 0; i < m_drivers.size(); i++) {
+        u32 drv_format = format;
+        u32 drv_channels = channels;
+        u32 drv_rate = rate;
+
+        m_pending[i].clear();
+        if (!negotiate(*m_drivers[i], false, drv_format, drv_channels,
+                       drv_rate) ||
+            !m_drivers[i]->input_configure(drv_format, drv_channels,
+                                           drv_rate) ||
+            !m_converters[i].configure(drv_format, drv_channels, drv_rate,
+                                       format, channels, rate)) {
+            m_converters[i] = converter();
+            ok = false;
+            continue;
+        }
+
+        if (!m_converters[i].is_identity()) {
+            log_debug("converting %s/%uch/%uHz to %s/%uch/%uHz",
+                      format_str(drv_format), drv_channels, drv_rate,
+                      format_str(format), channels, rate);
+        }
+    }
+
     return ok;
 }
 
@@ -79,8 +71,28 @@ void istream::shutdown() {
 }
 
 void istream::xfer(void* buf, size_t len) {
-    for (driver* drv : m_drivers)
-        drv->input_xfer(buf, len);
+    for (size_t i = 0; i < m_drivers.size(); i++) {
+        converter& conv = m_converters[i];
+        if (!conv.is_configured() || conv.is_identity()) {
+            m_drivers[i]->input_xfer(buf, len);
+            continue;
+        }
+
+        // the resampler does not produce output at a fixed ratio, so keep
+        // excess samples for the next transfer and pad shortfalls
+        vector<u8>& pending = m_pending[i];
+        if (pending.size() < len) {
+            m_buffer.resize(conv.input_size(len - pending.size()));
+            m_drivers[i]->input_xfer(m_buffer.data(), m_buffer.size());
+            conv.convert(m_buffer.data(), m_buffer.size(), pending);
+        }
+
+        size_t n = min(pending.size(), len);
+        memcpy(buf, pending.data(), n);
+        pending.erase(pending.begin(), pending.begin() + n);
+        if (n < len)
+            fill_silence((u8*)buf + n, len - n, m_format);
+    }
 }
 
 } // namespace audio
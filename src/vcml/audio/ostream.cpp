@@ -13,7 +13,7 @@
 namespace vcml {
 namespace audio {
 
-ostream::ostream(const sc_module_name& nm): stream(nm) {
+ostream::ostream(const sc_module_name& nm): stream(nm), m_buffer() {
     // nothing to do
 }
 
@@ -21,48 +21,32 @@ ostream::~ostream() {
     // nothing to do
 }
 
-size_t ostream::min_channels() {
-    size_t min_channels = 1;
-    for (auto* drv : m_drivers)
-        min_channels = max(min_channels, drv->output_min_channels());
-    return min_channels;
-}
-
-size_t ostream::max_channels() {
-    size_t max_channels = 8;
-    for (auto* drv : m_drivers)
-        max_channels = min(max_channels, drv->output_max_channels());
-    return max_channels;
-}
-
-bool ostream::supports_format(u32 format) {
-    if (format == FORMAT_INVALID)
-        return false;
-
-    for (auto* drv : m_drivers) {
-        if (!drv->output_supports_format(format))
-            return false;
-    }
-
-    return true;
-}
-
-bool ostream::supports_rate(u32 rate) {
-    for (auto* drv : m_drivers) {
-        if (!drv->output_supports_rate(rate))
-            return false;
-    }
-
-    return true;
-}
-
 bool ostream::configure(u32 format, u32 channels, u32 rate) {
     bool ok = true;
-    for (driver* drv : m_drivers) {
-        ok &= drv->output_configure(format, channels, rate);
-        if (!ok)
+    for (size_t i = 0; i < m_drivers.size(); i++) {
+        u32 drv_format = format;
+        u32 drv_channels = channels;
+        u32 drv_rate = rate;
+
+        if (!negotiate(*m_drivers[i], true, drv_format, drv_channels,
+                       drv_rate) ||
+            !m_drivers[i]->output_configure(drv_format, drv_channels,
+                                            drv_rate) ||
+            !m_converters[i].configure(format, channels, rate, drv_format,
+                                       drv_channels, drv_rate)) {
             log_warn("config failed");
+            m_converters[i] = converter();
+            ok = false;
+            continue;
+        }
+
+        if (!m_converters[i].is_identity()) {
+            log_debug("converting %s/%uch/%uHz to %s/%uch/%uHz",
+                      format_str(format), channels, rate,
+                      format_str(drv_format), drv_channels, drv_rate);
+        }
     }
+
     return ok;
 }
 
@@ -82,8 +66,18 @@ void ostream::shutdown() {
 }
 
 void ostream::xfer(const void* buf, size_t len) {
-    for (driver* drv : m_drivers)
-        drv->output_xfer(buf, len);
+    for (size_t i = 0; i < m_drivers.size(); i++) {
+        converter& conv = m_converters[i];
+        if (!conv.is_configured() || conv.is_identity()) {
+            m_drivers[i]->output_xfer(buf, len);
+            continue;
+        }
+
+        m_buffer.clear();
+        conv.convert(buf, len, m_buffer);
+        if (!m_buffer.empty())
+            m_drivers[i]->output_xfer(m_buffer.data(), m_buffer.size());
+    }
 }
 
 } // namespace audio
@@ -14,12 +14,13 @@ namespace vcml {
 namespace audio {
 
 stream::stream(const sc_module_name& nm):
-    module(nm), m_drivers(), drivers("drivers") {
+    module(nm), m_drivers(), m_converters(), drivers("drivers") {
     vector<string> types = split(drivers);
     for (const auto& type : types) {
         try {
             driver* drv = driver::create(*this, type);
             m_drivers.push_back(drv);
+            m_converters.emplace_back();
         } catch (std::exception& ex) {
             log.warn(ex);
         }
@@ -31,5 +32,70 @@ stream::~stream() {
         delete drv;
 }
 
+bool stream::supports_format(u32 format) {
+    return format_is_valid(format);
+}
+
+bool stream::supports_rate(u32 rate) {
+    return rate >= MIN_RATE && rate <= MAX_RATE;
+}
+
+static bool driver_supports_format(driver& drv, bool output, u32 format) {
+    return output ? drv.output_supports_format(format)
+                  : drv.input_supports_format(format);
+}
+
+static bool driver_supports_rate(driver& drv, bool output, u32 rate) {
+    return output ? drv.output_supports_rate(rate)
+                  : drv.input_supports_rate(rate);
+}
+
+bool stream::negotiate(driver& drv, bool output, u32& format, u32& channels,
+                       u32& rate) {
+    constexpr bool le = host_endian() == ENDIAN_LITTLE;
+    const u32 formats[] = {
+        format,
+        le ? FORMAT_F32LE : FORMAT_F32BE,
+        le ? FORMAT_S32LE : FORMAT_S32BE,
+        le ? FORMAT_S16LE : FORMAT_S16BE,
+        FORMAT_S16LE,
+        FORMAT_U8,
+    };
+
+    const u32 rates[] = { rate, 48000, 44100, 96000, 22050, 16000, 8000 };
+
+    size_t minch = output ? drv.output_min_channels()
+                          : drv.input_min_channels();
+    size_t maxch = output ? drv.output_max_channels()
+                          : drv.input_max_channels();
+    if (minch > maxch)
+        return false;
+
+    channels = (u32)std::clamp<size_t>(channels, minch, maxch);
+
+    u32 fmt = FORMAT_INVALID;
+    for (u32 candidate : formats) {
+        if (driver_supports_format(drv, output, candidate)) {
+            fmt = candidate;
+            break;
+        }
+    }
+
+    u32 hz = 0;
+    for (u32 candidate : rates) {
+        if (driver_supports_rate(drv, output, candidate)) {
+            hz = candidate;
+            break;
+        }
+    }
+
+    if (fmt == FORMAT_INVALID || hz == 0)
+        return false;
+
+    format = fmt;
+    rate = hz;
+    return true;
+}
+
 } // namespace audio
 } // namespace vcml
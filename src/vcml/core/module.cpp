@@ -12,6 +12,9 @@
 #include "vcml/core/module.h"
 #include "vcml/core/model.h"
 
+#include "vcml/debugging/hostprof.h"
+#include "vcml/debugging/suspender.h"
+
 namespace vcml {
 
 bool module::cmd_clist(const vector<string>& args, ostream& os) {
@@ -41,6 +44,21 @@ bool module::cmd_version(const vector<string>& args, ostream& os) {
     return true;
 }
 
+bool module::cmd_hostprof(const vector<string>& args, ostream& os) {
+    using debugging::hostprof;
+    if (!hostprof::is_enabled()) {
+        os << "host profiling disabled, set system.host_profile to enable";
+        return false;
+    }
+
+    size_t limit = ~0ull;
+    if (!args.empty())
+        limit = from_string<size_t>(args[0]);
+
+    hostprof::write_report(os, hostprof::collect(*this), limit);
+    return true;
+}
+
 // clang-format-15 seems to get confused when your class is named 'module', so
 // we need to disable formatting here. If we rename this to module1::module1,
 // no errors are reported. If we rename it back, the errors return...
@@ -64,10 +82,16 @@ module::module(const sc_module_name& nm):
                      "immediately aborts the simulation");
     register_command("version", 0, &module::cmd_version,
                      "print version information about this module");
+    register_command("hostprof", 0, &module::cmd_hostprof,
+                     "prints the host time spent in this module and its "
+                     "children: hostprof [limit]");
+
+    debugging::suspender::register_module(this);
 }
 // clang-format on
 
 module::~module() {
+    debugging::suspender::unregister_module(this);
     for (const auto& it : m_commands)
         delete it.second;
 }
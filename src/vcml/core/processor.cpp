@@ -103,6 +103,20 @@ bool processor::cmd_gdb(const vector<string>& args, ostream& os) {
     return true;
 }
 
+bool processor::cmd_profile(const vector<string>& args, ostream& os) {
+    if (m_profiler == nullptr) {
+        os << "profiling disabled, set " << profile.name() << " to enable";
+        return false;
+    }
+
+    size_t limit = 20;
+    if (args.size() > 0)
+        limit = strtoull(args[0].c_str(), NULL, 0);
+
+    m_profiler->write_report(os, limit);
+    return true;
+}
+
 void processor::sample_callstack() {
 #if defined(HAVE_INSCIGHT) && defined(INSCIGHT_CPU_CALL_STACK)
     if (!trace_callstack)
@@ -121,6 +135,24 @@ void processor::sample_callstack() {
 #endif
 }
 
+void processor::write_profile() {
+    if (!profile_output.get().empty()) {
+        ofstream of(profile_output.get());
+        if (of.good()) {
+            m_profiler->write_folded(of);
+            log_info("wrote profile to %s", profile_output.get().c_str());
+        } else {
+            log_warn("cannot open %s", profile_output.get().c_str());
+        }
+    }
+
+    stringstream ss;
+    m_profiler->write_report(ss);
+    string line;
+    while (std::getline(ss, line))
+        log_info("%s", line.c_str());
+}
+
 u64 processor::simulate_cycles(size_t cycles) {
     if (trace_callstack)
         sample_callstack();
@@ -131,6 +163,10 @@ u64 processor::simulate_cycles(size_t cycles) {
     simulate(cycles);
     set_suspendable(true);
     m_run_time += mwr::timestamp() - start;
+
+    if (m_profiler)
+        m_profiler->update(cycle_count());
+
     return cycle_count() - count;
 }
 
@@ -243,6 +279,31 @@ bool processor::processor_thread_sync() {
     return true;
 }
 
+void processor::register_metrics() {
+    using debugging::counter;
+    using debugging::gauge;
+
+    m_metrics.push_back(std::make_unique<counter>(
+        "vcml_cpu_cycles_total", "Simulated processor cycles",
+        debugging::metric_labels{ { "cpu", name() } },
+        [this]() -> u64 { return cycle_count(); }));
+
+    m_metrics.push_back(std::make_unique<gauge>(
+        "vcml_cpu_mips", "Million simulated cycles per host second",
+        debugging::metric_labels{ { "cpu", name() } }, [this]() -> double {
+            return m_run_time > 0.0 ? get_cps() / 1e6 : 0.0;
+        }));
+
+    for (auto it : irq) {
+        size_t irqno = it.first;
+        m_metrics.push_back(std::make_unique<counter>(
+            "vcml_cpu_irqs_total", "Interrupts raised per processor line",
+            debugging::metric_labels{ { "cpu", name() },
+                                      { "irq", std::to_string(irqno) } },
+            [this, irqno]() -> u64 { return m_irq_stats[irqno].irq_count; }));
+    }
+}
+
 processor::processor(const sc_module_name& nm, const string& cpuarch):
     component(nm),
     target(*(module*)this),
@@ -251,7 +312,9 @@ processor::processor(const sc_module_name& nm, const string& cpuarch):
     m_cycle_mtx(),
     m_cycle_count(0),
     m_gdb(nullptr),
+    m_profiler(nullptr),
     m_irq_stats(),
+    m_metrics(),
     cpuarch("arch", cpuarch),
     symbols("symbols"),
     gdb_wait("gdb_wait", false),
@@ -263,6 +326,11 @@ processor::processor(const sc_module_name& nm, const string& cpuarch):
     async_rate("async_rate", 5),
     async_affinity("async_affinity", -1),
     trace_callstack("trace_callstack", false),
+    profile("profile", false),
+    profile_mode("profile_mode", "cycles"),
+    profile_period("profile_period", 10000),
+    profile_depth("profile_depth", 16),
+    profile_output("profile_output", ""),
     irq("irq"),
     insn("insn"),
     data("data") {
@@ -292,11 +360,15 @@ processor::processor(const sc_module_name& nm, const string& cpuarch):
                      "read memory from INSN or DATA ports");
     register_command("gdb", 0, &processor::cmd_gdb,
                      "opens a new gdb debug session");
+    register_command("profile", 0, &processor::cmd_profile,
+                     "prints the guest profile: profile [limit]");
 }
 
 processor::~processor() {
     if (m_gdb)
         delete m_gdb;
+    if (m_profiler)
+        delete m_profiler;
 }
 
 void processor::reset() {
@@ -425,6 +497,19 @@ void processor::end_of_elaboration() {
         stats.irq_longest = SC_ZERO_TIME;
     }
 
+    register_metrics();
+
+    if (profile) {
+        debugging::profile_mode mode = debugging::PROFILE_CYCLES;
+        if (profile_mode.get() == "host")
+            mode = debugging::PROFILE_HOST;
+        else if (profile_mode.get() != "cycles")
+            log_warn("unknown profile mode '%s'", profile_mode.get().c_str());
+
+        m_profiler = new debugging::profiler(*this, mode, profile_period,
+                                             profile_depth);
+    }
+
     if (gdb_port >= 0) {
         try {
             auto run = gdb_wait ? debugging::GDB_STOPPED
@@ -449,6 +534,12 @@ void processor::end_of_simulation() {
     if (async)
         sc_join_async();
 
+    if (m_profiler)
+        write_profile();
+
+    // the callbacks use cycle_count, which is gone once we are destroyed
+    m_metrics.clear();
+
     component::end_of_simulation();
 }
 
@@ -82,11 +82,13 @@ setup::setup(int argc, char** argv):
     m_log_stdout("--log-stdout", "Send log output to stdout"),
     m_log_inscight("--log-inscight", "Send log output to InSCight database"),
     m_log_files("--log-file", "-l", "Send log output to file"),
+    m_log_async("--log-async", "Format and publish log output in background"),
     m_trace_stdout("--trace-stdout", "Send tracing output to stdout"),
     m_trace_inscight("--trace-inscight", "Send tracing output to InSCight"),
     m_trace_files("--trace", "-t", "Send tracing output to file"),
     m_config_files("--file", "-f", "Load configuration from file"),
     m_config_options("--config", "-c", "Specify individual property values"),
+    m_config_dump("--config-dump", "Write resolved configuration to file"),
     m_help("--help", "-h", "Prints this message", exit_usage),
     m_version("--version", "Prints module version information", exit_version),
     m_license("--license", "Prints module license information", exit_license),
@@ -135,6 +137,9 @@ setup::setup(int argc, char** argv):
         m_publishers.push_back(pub);
     }
 
+    if (m_log_async.value())
+        log_queue::start();
+
     for (const string& file : m_trace_files.values()) {
         tracer* t = new tracer_file(file);
         m_tracers.push_back(t);
@@ -157,11 +162,18 @@ setup::setup(int argc, char** argv):
 
     try {
         for (const string& file : m_config_files.values()) {
-            if (mwr::ends_with(file, ".lua"))
+            if (broker_cache::is_cache(file))
+                m_brokers.push_back(new broker_cache(file));
+            else if (mwr::ends_with(file, ".lua"))
                 m_brokers.push_back(new broker_lua(file));
             else
                 m_brokers.push_back(new broker_file(file));
         }
+
+        if (m_config_dump.has_value()) {
+            broker_cache::dump(m_config_dump.value());
+            exit(EXIT_SUCCESS);
+        }
     } catch (std::exception& ex) {
         log.error(ex);
         exit(EXIT_FAILURE);
@@ -171,6 +183,9 @@ setup::setup(int argc, char** argv):
 setup::~setup() {
     s_instance = nullptr;
 
+    log_queue::stop();
+    log_site::report_suppressed();
+
     for (auto broker : m_brokers)
         delete broker;
 
@@ -9,6 +9,8 @@
  ******************************************************************************/
 
 #include "vcml/core/system.h"
+#include "vcml/debugging/hostprof.h"
+#include "vcml/debugging/metrics.h"
 
 namespace vcml {
 
@@ -76,10 +78,17 @@ system::system(const sc_module_name& nm):
     session_debug("session_debug", false),
     session_host("session_host", "localhost"),
     quantum("quantum", sc_time(1, SC_US)),
-    duration("duration", SC_ZERO_TIME) {
+    duration("duration", SC_ZERO_TIME),
+    host_profile("host_profile", false),
+    host_profile_period("host_profile_period", 64),
+    metrics("metrics", ""),
+    metrics_interval("metrics_interval", sc_time(1, SC_SEC)) {
     if (backtrace)
         mwr::report_segfaults();
 
+    if (host_profile)
+        debugging::hostprof::enable(host_profile_period);
+
     if (duration > SC_ZERO_TIME) {
         SC_THREAD(timeout);
         if (quantum > duration) {
@@ -96,6 +105,41 @@ system::~system() {
     // nothing to do
 }
 
+void system::start_of_simulation() {
+    module::start_of_simulation();
+
+    // only export once all models and their metrics have been constructed
+    if (!metrics.get().empty())
+        debugging::metrics::start(metrics, metrics_interval);
+}
+
+void system::end_of_simulation() {
+    module::end_of_simulation();
+
+    // models drop their metrics once their simulation ends, so write the
+    // final values before that happens
+    if (debugging::metrics::is_exporting()) {
+        debugging::metrics::flush();
+        debugging::metrics::stop();
+    }
+
+    using debugging::hostprof;
+    if (!hostprof::is_enabled())
+        return;
+
+    hostprof::disable();
+    vector<hostprof::entry> entries = hostprof::collect();
+
+    stringstream ss;
+    ss << "host time per module:" << std::endl;
+    hostprof::write_report(ss, hostprof::summarize(entries), 20);
+    ss << "host time per socket and process:" << std::endl;
+    hostprof::write_report(ss, entries, 50);
+
+    for (const string& line : split(ss.str(), '\n'))
+        log_info("%s", line.c_str());
+}
+
 int system::run() {
     if (list_properties) {
         list_object_properties(this);
@@ -12,6 +12,7 @@
 #include "vcml/core/systemc.h"
 
 #include "vcml/debugging/suspender.h"
+#include "vcml/debugging/hostprof.h"
 #include "vcml/protocols/tlm_sbi.h"
 
 namespace vcml {
@@ -638,6 +639,8 @@ struct async_worker {
 
     sc_time sc_thread_pos;
 
+    debugging::hostprof::site hostprof;
+
     struct sim_terminated_exception {};
 
     async_worker(size_t worker_id, sc_process_b* worker_proc):
@@ -654,7 +657,8 @@ struct async_worker {
         mtx(),
         notify(),
         worker(&async_worker::work, this),
-        sc_thread_pos(sc_time_stamp()) {
+        sc_thread_pos(sc_time_stamp()),
+        hostprof(*worker_proc, "async") {
         VCML_ERROR_ON(!process, "invalid parent process");
     }
 
@@ -714,6 +718,7 @@ struct async_worker {
             mtx.unlock();
             pre_run();
             try {
+                debugging::hostprof::scope profile(hostprof);
                 task();
             } catch (sim_terminated_exception& ex) {
                 (void)ex;
@@ -0,0 +1,377 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#include "vcml/debugging/hostprof.h"
+#include "vcml/debugging/suspender.h"
+
+#include <chrono>
+
+namespace vcml {
+namespace debugging {
+
+atomic<bool> hostprof::s_enabled(false);
+
+static u64 hostprof_now() {
+    using namespace std::chrono;
+    auto t = steady_clock::now().time_since_epoch();
+    return duration_cast<nanoseconds>(t).count();
+}
+
+// counters of one site on one host thread; only that thread writes them,
+// so plain loads and stores suffice and readers never see torn values
+struct hostprof_slot {
+    atomic<u64> calls{ 0 };
+    atomic<u64> samples{ 0 };
+    atomic<u64> nanos{ 0 };
+};
+
+static void hostprof_add(atomic<u64>& ctr, u64 delta) {
+    ctr.store(ctr.load(std::memory_order_relaxed) + delta,
+              std::memory_order_relaxed);
+}
+
+enum : size_t {
+    HOSTPROF_CHUNK = 256,
+};
+
+// chunks never move once allocated, so the owning thread only needs the
+// lock when it adds chunks, and readers only need it to walk the list
+struct hostprof_table {
+    mutex mtx;
+    vector<unique_ptr<hostprof_slot[]>> chunks;
+};
+
+struct hostprof_site_info {
+    string name;
+    string module;
+    const char* kind;
+};
+
+struct hostprof_state {
+    mutex mtx;
+    vector<hostprof_site_info> sites;
+    vector<shared_ptr<hostprof_table>> tables;
+    atomic<u32> period;
+    u64 start;
+
+    thread sampler;
+    atomic<bool> sampling;
+    mutex sample_mtx;
+    unordered_map<const sc_process_b*, u64> samples;
+
+    hostprof_state():
+        mtx(),
+        sites(),
+        tables(),
+        period(64),
+        start(hostprof_now()),
+        sampler(),
+        sampling(false),
+        sample_mtx(),
+        samples() {}
+
+    ~hostprof_state() { stop_sampling(); }
+
+    void sample(sc_core::sc_simcontext* simc, u64 interval);
+    void start_sampling(const sc_time& interval);
+    void stop_sampling();
+
+    static hostprof_state& instance() {
+        static hostprof_state state;
+        return state;
+    }
+};
+
+static thread_local hostprof_table* t_table = nullptr;
+
+void hostprof_state::sample(sc_core::sc_simcontext* simc, u64 interval) {
+    mwr::set_thread_name("vcml_hostprof");
+
+    u64 last = hostprof_now();
+    while (sampling) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(interval));
+        u64 now = hostprof_now();
+
+        // while the kernel is blocked, e.g. suspended in a debugger or
+        // paused between sc_start calls, nobody should be charged for it;
+        // the status is read racily, just like the process below
+        if (!sim_running() || suspender::simulation_suspended() ||
+            simc->get_status() != sc_core::SC_RUNNING) {
+            last = now;
+            continue;
+        }
+
+        // Note: this read races with the kernel switching processes. It
+        // only ever replaces the pointer, so on common hosts we observe
+        // either the previous or the next process, which is acceptable for
+        // a statistical profile, but it is not synchronized in any way.
+        const sc_process_b* proc = (const sc_process_b*)simc
+                                       ->get_curr_proc_info()
+                                       ->process_handle;
+
+        if (proc != nullptr) {
+            lock_guard<mutex> guard(sample_mtx);
+            samples[proc] += now - last;
+        }
+
+        last = now;
+    }
+}
+
+void hostprof_state::start_sampling(const sc_time& interval) {
+    if (sampling || interval == SC_ZERO_TIME)
+        return;
+
+    sampling = true;
+    sampler = thread(&hostprof_state::sample, this,
+                     sc_core::sc_get_curr_simcontext(), time_to_ns(interval));
+}
+
+void hostprof_state::stop_sampling() {
+    sampling = false;
+    if (sampler.joinable())
+        sampler.join();
+}
+
+static hostprof_slot& hostprof_alloc(size_t id) {
+    if (t_table == nullptr) {
+        auto table = std::make_shared<hostprof_table>();
+        hostprof_state& state = hostprof_state::instance();
+        lock_guard<mutex> guard(state.mtx);
+        state.tables.push_back(table);
+        t_table = table.get();
+    }
+
+    lock_guard<mutex> guard(t_table->mtx);
+    while (t_table->chunks.size() <= id / HOSTPROF_CHUNK) {
+        t_table->chunks.push_back(
+            unique_ptr<hostprof_slot[]>(new hostprof_slot[HOSTPROF_CHUNK]));
+    }
+
+    return t_table->chunks[id / HOSTPROF_CHUNK][id % HOSTPROF_CHUNK];
+}
+
+static hostprof_slot& hostprof_local(size_t id) {
+    hostprof_table* table = t_table;
+    if (table && id / HOSTPROF_CHUNK < table->chunks.size())
+        return table->chunks[id / HOSTPROF_CHUNK][id % HOSTPROF_CHUNK];
+    return hostprof_alloc(id);
+}
+
+hostprof::site::site(const sc_object& obj, const char* kind): m_id() {
+    sc_object* parent = obj.get_parent_object();
+    sc_module* mod = hierarchy_search<sc_module>(parent);
+    hostprof_state& state = hostprof_state::instance();
+    lock_guard<mutex> guard(state.mtx);
+    m_id = state.sites.size();
+    state.sites.push_back({ obj.name(), mod ? mod->name() : "", kind });
+}
+
+hostprof::site::site(const string& name, const string& module,
+                     const char* kind):
+    m_id() {
+    hostprof_state& state = hostprof_state::instance();
+    lock_guard<mutex> guard(state.mtx);
+    m_id = state.sites.size();
+    state.sites.push_back({ name, module, kind });
+}
+
+void hostprof::scope::begin(const site& s) {
+    hostprof_slot& slot = hostprof_local(s.id());
+    u64 calls = slot.calls.load(std::memory_order_relaxed);
+    hostprof_add(slot.calls, 1);
+
+    // count down per site, a thread-wide countdown would always land on
+    // the same site of a fixed call pattern, e.g. a bus and its targets
+    if (calls % hostprof_state::instance().period)
+        return;
+
+    m_slot = &slot;
+    m_start = hostprof_now();
+}
+
+void hostprof::scope::end() {
+    hostprof_slot* slot = (hostprof_slot*)m_slot;
+    hostprof_add(slot->nanos, hostprof_now() - m_start);
+    hostprof_add(slot->samples, 1);
+}
+
+void hostprof::enable(u32 period, const sc_time& interval) {
+    hostprof_state& state = hostprof_state::instance();
+    state.period = max<u32>(period, 1);
+    state.start_sampling(interval);
+    s_enabled = true;
+}
+
+void hostprof::disable() {
+    s_enabled = false;
+    hostprof_state::instance().stop_sampling();
+}
+
+void hostprof::reset() {
+    hostprof_state& state = hostprof_state::instance();
+    lock_guard<mutex> guard(state.mtx);
+    for (auto& table : state.tables) {
+        lock_guard<mutex> table_guard(table->mtx);
+        for (auto& chunk : table->chunks) {
+            for (size_t i = 0; i < HOSTPROF_CHUNK; i++) {
+                chunk[i].calls = 0;
+                chunk[i].samples = 0;
+                chunk[i].nanos = 0;
+            }
+        }
+    }
+
+    lock_guard<mutex> sample_guard(state.sample_mtx);
+    state.samples.clear();
+    state.start = hostprof_now();
+}
+
+typedef unordered_map<const sc_process_b*, sc_object*> hostprof_procmap;
+
+static void hostprof_processes(sc_object* obj, hostprof_procmap& procs) {
+    const auto& children = obj ? obj->get_child_objects()
+                               : sc_core::sc_get_top_level_objects();
+    for (sc_object* child : children) {
+        if (auto* proc = dynamic_cast<sc_process_b*>(child))
+            procs[proc] = child;
+        hostprof_processes(child, procs);
+    }
+}
+
+vector<hostprof::entry> hostprof::collect() {
+    hostprof_state& state = hostprof_state::instance();
+    vector<entry> entries;
+
+    {
+        lock_guard<mutex> guard(state.mtx);
+        vector<u64> samples(state.sites.size(), 0);
+        for (const auto& info : state.sites)
+            entries.push_back({ info.name, info.module, info.kind, 0, 0 });
+
+        for (auto& table : state.tables) {
+            lock_guard<mutex> table_guard(table->mtx);
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (i / HOSTPROF_CHUNK >= table->chunks.size())
+                    break;
+                const auto& slot = table->chunks[i / HOSTPROF_CHUNK]
+                                                [i % HOSTPROF_CHUNK];
+                entries[i].calls += slot.calls;
+                entries[i].nanos += slot.nanos;
+                samples[i] += slot.samples;
+            }
+        }
+
+        // extrapolate the time of the sampled calls to all calls
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (samples[i] > 0) {
+                double scale = (double)entries[i].calls / samples[i];
+                entries[i].nanos = (u64)(entries[i].nanos * scale);
+            }
+        }
+    }
+
+    stl_remove_if(entries, [](const entry& e) { return e.calls == 0; });
+
+    hostprof_procmap procs;
+    hostprof_processes(nullptr, procs);
+
+    entry terminated{ "(terminated processes)", "", "process", 0, 0 };
+    lock_guard<mutex> sample_guard(state.sample_mtx);
+    for (auto [proc, nanos] : state.samples) {
+        auto it = procs.find(proc);
+        if (it == procs.end()) {
+            terminated.nanos += nanos;
+            continue;
+        }
+
+        sc_object* parent = it->second->get_parent_object();
+        sc_module* mod = hierarchy_search<sc_module>(parent);
+        entries.push_back({ it->second->name(), mod ? mod->name() : "",
+                            "process", 0, nanos });
+    }
+
+    if (terminated.nanos > 0)
+        entries.push_back(terminated);
+
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const entry& a, const entry& b) -> bool {
+                         return a.nanos > b.nanos;
+                     });
+
+    return entries;
+}
+
+vector<hostprof::entry> hostprof::collect(const sc_object& module) {
+    string prefix = string(module.name()) + SC_HIERARCHY_CHAR;
+    vector<entry> entries = collect();
+    stl_remove_if(entries, [&](const entry& e) -> bool {
+        return e.module != module.name() && !starts_with(e.module, prefix);
+    });
+
+    return entries;
+}
+
+vector<hostprof::entry> hostprof::summarize(const vector<entry>& entries) {
+    vector<entry> modules;
+    unordered_map<string, size_t> index;
+    for (const entry& e : entries) {
+        auto it = index.find(e.module);
+        if (it == index.end()) {
+            index[e.module] = modules.size();
+            modules.push_back({ e.module, e.module, "module", 0, 0 });
+            it = index.find(e.module);
+        }
+
+        modules[it->second].calls += e.calls;
+        modules[it->second].nanos += e.nanos;
+    }
+
+    std::stable_sort(modules.begin(), modules.end(),
+                     [](const entry& a, const entry& b) -> bool {
+                         return a.nanos > b.nanos;
+                     });
+
+    return modules;
+}
+
+static string hostprof_time(u64 nanos) {
+    if (nanos >= 1000000000ull)
+        return mkstr("%.3fs", nanos / 1e9);
+    if (nanos >= 1000000ull)
+        return mkstr("%.3fms", nanos / 1e6);
+    if (nanos >= 1000ull)
+        return mkstr("%.3fus", nanos / 1e3);
+    return mkstr("%lluns", nanos);
+}
+
+void hostprof::write_report(ostream& os, const vector<entry>& entries,
+                            size_t limit) {
+    hostprof_state& state = hostprof_state::instance();
+    u64 total = max<u64>(hostprof_now() - state.start, 1);
+
+    os << mkstr("%12s %7s %12s %10s  %-8s %s", "host time", "share", "calls",
+                "average", "kind", "name")
+       << std::endl;
+
+    for (size_t i = 0; i < entries.size() && i < limit; i++) {
+        const entry& e = entries[i];
+        string calls = e.calls ? mkstr("%llu", e.calls) : "-";
+        string avg = e.calls ? hostprof_time(e.nanos / e.calls) : "-";
+        os << mkstr("%12s %6.2f%% %12s %10s  %-8s %s",
+                    hostprof_time(e.nanos).c_str(), 100.0 * e.nanos / total,
+                    calls.c_str(), avg.c_str(), e.kind, e.name.c_str())
+           << std::endl;
+    }
+}
+
+} // namespace debugging
+} // namespace vcml
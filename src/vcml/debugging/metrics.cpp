@@ -0,0 +1,677 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#include "vcml/debugging/metrics.h"
+#include "vcml/debugging/suspender.h"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+
+#ifndef MWR_MSVC
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace vcml {
+namespace debugging {
+
+const char* metric_type_str(metric_type type) {
+    switch (type) {
+    case METRIC_COUNTER:
+        return "counter";
+    case METRIC_GAUGE:
+        return "gauge";
+    case METRIC_HISTOGRAM:
+        return "histogram";
+    default:
+        return "untyped";
+    }
+}
+
+struct metrics_registry {
+    mutex mtx;
+    vector<metric*> metrics;
+
+    static metrics_registry& instance() {
+        static metrics_registry registry;
+        return registry;
+    }
+};
+
+metric::metric(const string& name, const string& help, metric_type type,
+               const metric_labels& labels):
+    m_name(name), m_help(help), m_type(type), m_labels(labels) {
+    VCML_ERROR_ON(name.empty(), "metric name must not be empty");
+}
+
+metric::~metric() {
+    detach();
+}
+
+void metric::attach() {
+    metrics_registry& registry = metrics_registry::instance();
+    lock_guard<mutex> guard(registry.mtx);
+    registry.metrics.push_back(this);
+}
+
+void metric::detach() {
+    metrics_registry& registry = metrics_registry::instance();
+    lock_guard<mutex> guard(registry.mtx);
+    stl_remove(registry.metrics, this);
+}
+
+counter::counter(const string& name, const string& help,
+                 const metric_labels& labels, function<u64(void)> fn):
+    metric(name, help, METRIC_COUNTER, labels),
+    m_value(0),
+    m_fn(std::move(fn)) {
+    attach();
+}
+
+counter::~counter() {
+    detach();
+}
+
+void counter::sample(metric_sample& s) const {
+    s.count = value();
+    s.value = (double)s.count;
+}
+
+gauge::gauge(const string& name, const string& help,
+             const metric_labels& labels, function<double(void)> fn):
+    metric(name, help, METRIC_GAUGE, labels),
+    m_value(0.0),
+    m_fn(std::move(fn)) {
+    attach();
+}
+
+gauge::~gauge() {
+    detach();
+}
+
+void gauge::sample(metric_sample& s) const {
+    s.value = value();
+}
+
+histogram::histogram(const string& name, const string& help,
+                     const vector<double>& bounds,
+                     const metric_labels& labels):
+    metric(name, help, METRIC_HISTOGRAM, labels),
+    m_bounds(bounds),
+    m_buckets(new atomic<u64>[bounds.size() + 1]),
+    m_count(0),
+    m_sum(0.0) {
+    VCML_ERROR_ON(!std::is_sorted(bounds.begin(), bounds.end()),
+                  "histogram bounds of %s must be ascending", name.c_str());
+    reset();
+    attach();
+}
+
+histogram::~histogram() {
+    detach();
+}
+
+void histogram::observe(double val) {
+    auto it = std::lower_bound(m_bounds.begin(), m_bounds.end(), val);
+    m_buckets[it - m_bounds.begin()].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+
+    double sum = m_sum.load(std::memory_order_relaxed);
+    while (!m_sum.compare_exchange_weak(sum, sum + val,
+                                        std::memory_order_relaxed)) {
+        // sum has been reloaded, try again
+    }
+}
+
+void histogram::reset() {
+    for (size_t i = 0; i <= m_bounds.size(); i++)
+        m_buckets[i] = 0;
+    m_count = 0;
+    m_sum = 0.0;
+}
+
+void histogram::sample(metric_sample& s) const {
+    s.bounds = m_bounds;
+    s.buckets.resize(m_bounds.size() + 1);
+
+    u64 total = 0;
+    for (size_t i = 0; i <= m_bounds.size(); i++)
+        s.buckets[i] = total += m_buckets[i].load(std::memory_order_relaxed);
+
+    s.count = total;
+    s.sum = m_sum;
+    s.value = m_sum;
+}
+
+vector<metric_sample> metrics::snapshot() {
+    vector<metric_sample> samples;
+
+    metrics_registry& registry = metrics_registry::instance();
+    lock_guard<mutex> guard(registry.mtx);
+    samples.reserve(registry.metrics.size());
+    for (const metric* m : registry.metrics) {
+        metric_sample& s = samples.emplace_back();
+        s.name = m->name();
+        s.help = m->help();
+        s.type = m->type();
+        s.labels = m->labels();
+        s.value = 0.0;
+        s.count = 0;
+        s.sum = 0.0;
+        m->sample(s);
+    }
+
+    std::sort(samples.begin(), samples.end(),
+              [](const metric_sample& a, const metric_sample& b) -> bool {
+                  if (a.name != b.name)
+                      return a.name < b.name;
+                  return a.labels < b.labels;
+              });
+
+    return samples;
+}
+
+static string metrics_number(double val) {
+    if (std::isnan(val))
+        return "NaN";
+    if (std::isinf(val))
+        return val < 0.0 ? "-Inf" : "+Inf";
+
+    // shortest representation that still reads back as the same value
+    string str = mkstr("%.15g", val);
+    if (strtod(str.c_str(), nullptr) != val)
+        str = mkstr("%.17g", val);
+    return str;
+}
+
+static string metrics_escape(const string& str, bool quotes) {
+    string res;
+    res.reserve(str.length());
+    for (char c : str) {
+        if (c == '\\')
+            res += "\\\\";
+        else if (c == '\n')
+            res += "\\n";
+        else if (c == '"' && quotes)
+            res += "\\\"";
+        else
+            res += c;
+    }
+
+    return res;
+}
+
+static void metrics_labels(ostream& os, const metric_labels& labels,
+                           const string& le = "") {
+    if (labels.empty() && le.empty())
+        return;
+
+    os << "{";
+    for (size_t i = 0; i < labels.size(); i++) {
+        os << (i ? "," : "") << labels[i].first << "=\""
+           << metrics_escape(labels[i].second, true) << "\"";
+    }
+
+    if (!le.empty())
+        os << (labels.empty() ? "" : ",") << "le=\"" << le << "\"";
+    os << "}";
+}
+
+void metrics::write_prometheus(ostream& os,
+                               const vector<metric_sample>& samples) {
+    const string* last = nullptr;
+    for (const metric_sample& s : samples) {
+        if (!last || *last != s.name) {
+            if (!s.help.empty())
+                os << "# HELP " << s.name << " "
+                   << metrics_escape(s.help, false) << "\n";
+            os << "# TYPE " << s.name << " " << metric_type_str(s.type)
+               << "\n";
+            last = &s.name;
+        }
+
+        switch (s.type) {
+        case METRIC_COUNTER:
+            os << s.name;
+            metrics_labels(os, s.labels);
+            os << " " << s.count << "\n";
+            break;
+
+        case METRIC_GAUGE:
+            os << s.name;
+            metrics_labels(os, s.labels);
+            os << " " << metrics_number(s.value) << "\n";
+            break;
+
+        case METRIC_HISTOGRAM:
+            for (size_t i = 0; i < s.buckets.size(); i++) {
+                bool inf = i >= s.bounds.size();
+                os << s.name << "_bucket";
+                metrics_labels(os, s.labels,
+                               inf ? "+Inf" : metrics_number(s.bounds[i]));
+                os << " " << s.buckets[i] << "\n";
+            }
+
+            os << s.name << "_sum";
+            metrics_labels(os, s.labels);
+            os << " " << metrics_number(s.sum) << "\n";
+            os << s.name << "_count";
+            metrics_labels(os, s.labels);
+            os << " " << s.count << "\n";
+            break;
+
+        default:
+            VCML_ERROR("unknown metric type %d", (int)s.type);
+        }
+    }
+}
+
+static string metrics_json_str(const string& str) {
+    string res = "\"";
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            res += string("\\") + c;
+        else if ((unsigned char)c < 0x20)
+            res += mkstr("\\u%04x", (unsigned int)c);
+        else
+            res += c;
+    }
+
+    return res + "\"";
+}
+
+static string metrics_json_num(double val) {
+    return std::isfinite(val) ? metrics_number(val) : "null";
+}
+
+void metrics::write_json(ostream& os, const vector<metric_sample>& samples) {
+    using namespace std::chrono;
+    auto now = system_clock::now().time_since_epoch();
+
+    os << "{\"timestamp\":" << duration_cast<milliseconds>(now).count()
+       << ",\"metrics\":[";
+
+    for (size_t i = 0; i < samples.size(); i++) {
+        const metric_sample& s = samples[i];
+        os << (i ? "," : "") << "{\"name\":" << metrics_json_str(s.name)
+           << ",\"type\":\"" << metric_type_str(s.type) << "\"";
+
+        if (!s.labels.empty()) {
+            os << ",\"labels\":{";
+            for (size_t j = 0; j < s.labels.size(); j++) {
+                os << (j ? "," : "") << metrics_json_str(s.labels[j].first)
+                   << ":" << metrics_json_str(s.labels[j].second);
+            }
+            os << "}";
+        }
+
+        switch (s.type) {
+        case METRIC_COUNTER:
+            os << ",\"value\":" << s.count;
+            break;
+
+        case METRIC_GAUGE:
+            os << ",\"value\":" << metrics_json_num(s.value);
+            break;
+
+        case METRIC_HISTOGRAM:
+            os << ",\"count\":" << s.count
+               << ",\"sum\":" << metrics_json_num(s.sum) << ",\"buckets\":[";
+            for (size_t j = 0; j < s.buckets.size(); j++) {
+                bool inf = j >= s.bounds.size();
+                os << (j ? "," : "") << "{\"le\":"
+                   << (inf ? "\"+Inf\"" : metrics_json_num(s.bounds[j]))
+                   << ",\"count\":" << s.buckets[j] << "}";
+            }
+            os << "]";
+            break;
+
+        default:
+            VCML_ERROR("unknown metric type %d", (int)s.type);
+        }
+
+        os << "}";
+    }
+
+    os << "]}\n";
+}
+
+class metrics_exporter
+{
+private:
+    struct target {
+        string format;
+        string path;
+        ofstream file;
+        int fd;
+        u8* map;
+        size_t size;
+    };
+
+    // filled in by the simulation thread on behalf of the exporter
+    struct request {
+        mutex mtx;
+        condition_variable cv;
+        bool done = false;
+        vector<metric_sample> samples;
+    };
+
+    vector<unique_ptr<target>> m_targets;
+    u64 m_interval;
+
+    mutex m_mtx;
+    mutex m_write_mtx;
+    condition_variable m_cv;
+    atomic<bool> m_stop;
+    thread m_thread;
+
+    std::chrono::steady_clock::time_point m_start;
+    gauge m_sim_time;
+    gauge m_host_time;
+
+    void open_shm(target& t);
+    void close_shm(target& t);
+    void write_shm(target& t, const string& text);
+    void write_prom(target& t, const string& text);
+    void write_json(target& t, const vector<metric_sample>& samples);
+
+    bool sample_suspended(vector<metric_sample>& samples);
+    bool sample(vector<metric_sample>& samples);
+    void run();
+
+public:
+    metrics_exporter(const string& targets, const sc_time& interval);
+    ~metrics_exporter();
+
+    void write(const vector<metric_sample>& samples);
+};
+
+metrics_exporter::metrics_exporter(const string& targets,
+                                   const sc_time& interval):
+    m_targets(),
+    m_interval(time_to_ns(interval)),
+    m_mtx(),
+    m_write_mtx(),
+    m_cv(),
+    m_stop(false),
+    m_thread(),
+    m_start(std::chrono::steady_clock::now()),
+    m_sim_time("vcml_sim_time_seconds", "Simulated time", {},
+               []() -> double { return sc_time_stamp().to_seconds(); }),
+    m_host_time("vcml_host_time_seconds", "Host time since export started",
+                {}, [this]() -> double {
+                    auto t = std::chrono::steady_clock::now() - m_start;
+                    return std::chrono::duration<double>(t).count();
+                }) {
+    VCML_REPORT_ON(m_interval == 0, "metrics interval must not be zero");
+
+    for (const string& spec : split(targets, ',')) {
+        size_t pos = spec.find(':');
+        VCML_REPORT_ON(pos == string::npos, "invalid metrics target '%s'",
+                       spec.c_str());
+
+        auto t = std::make_unique<target>();
+        t->format = to_lower(trim(spec.substr(0, pos)));
+        t->path = trim(spec.substr(pos + 1));
+        t->fd = -1;
+        t->map = nullptr;
+        t->size = 0;
+
+        VCML_REPORT_ON(t->path.empty(), "missing path in metrics target '%s'",
+                       spec.c_str());
+
+        if (t->format == "json") {
+            t->file.open(t->path, std::ios::app);
+            VCML_REPORT_ON(!t->file, "cannot open '%s'", t->path.c_str());
+        } else if (t->format == "shm") {
+            open_shm(*t);
+        } else if (t->format != "prom") {
+            VCML_REPORT("unknown metrics format '%s'", t->format.c_str());
+        }
+
+        m_targets.push_back(std::move(t));
+    }
+
+    m_thread = thread(&metrics_exporter::run, this);
+}
+
+metrics_exporter::~metrics_exporter() {
+    {
+        lock_guard<mutex> guard(m_mtx);
+        m_stop = true;
+    }
+
+    m_cv.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();
+
+    for (auto& t : m_targets) {
+        if (t->format == "shm")
+            close_shm(*t);
+    }
+}
+
+#ifdef MWR_MSVC
+void metrics_exporter::open_shm(target& t) {
+    VCML_REPORT("shared memory metrics not supported on this platform");
+}
+
+void metrics_exporter::close_shm(target& t) {
+    // nothing to do
+}
+
+void metrics_exporter::write_shm(target& t, const string& text) {
+    // nothing to do
+}
+#else
+void metrics_exporter::open_shm(target& t) {
+    if (!starts_with(t.path, "/"))
+        t.path = "/" + t.path;
+
+    t.fd = shm_open(t.path.c_str(), O_CREAT | O_RDWR, 0644);
+    VCML_REPORT_ON(t.fd < 0, "cannot open shared memory '%s': %s",
+                   t.path.c_str(), strerror(errno));
+}
+
+void metrics_exporter::close_shm(target& t) {
+    if (t.map)
+        munmap(t.map, t.size);
+    if (t.fd >= 0) {
+        ::close(t.fd);
+        shm_unlink(t.path.c_str());
+    }
+
+    t.map = nullptr;
+    t.fd = -1;
+}
+
+void metrics_exporter::write_shm(target& t, const string& text) {
+    size_t needed = sizeof(metrics::shm_header) + text.length();
+    if (needed > t.size) {
+        // readers notice the larger length and remap the segment
+        size_t size = (needed + 64 * KiB - 1) & ~(64 * KiB - 1);
+        if (ftruncate(t.fd, size) < 0) {
+            log_warn("cannot resize shared memory '%s'", t.path.c_str());
+            return;
+        }
+
+        if (t.map)
+            munmap(t.map, t.size);
+        t.map = nullptr;
+        t.size = 0;
+
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          t.fd, 0);
+        if (addr == MAP_FAILED) {
+            log_warn("cannot map shared memory '%s'", t.path.c_str());
+            return;
+        }
+
+        t.map = (u8*)addr;
+        t.size = size;
+    }
+
+    auto* hdr = (metrics::shm_header*)t.map;
+    u32 seq = __atomic_load_n(&hdr->seqlock, __ATOMIC_RELAXED) | 1;
+    __atomic_store_n(&hdr->seqlock, seq, __ATOMIC_RELAXED);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    hdr->magic = metrics::SHM_MAGIC;
+    hdr->length = text.length();
+    memcpy(t.map + sizeof(*hdr), text.data(), text.length());
+
+    __atomic_store_n(&hdr->seqlock, seq + 1, __ATOMIC_RELEASE);
+}
+#endif
+
+void metrics_exporter::write_prom(target& t, const string& text) {
+    // scrapers must never see a partially written file
+    string temp = mkstr("%s.%d", t.path.c_str(), (int)mwr::getpid());
+    ofstream os(temp, std::ios::trunc);
+    os << text;
+    os.close();
+
+    std::error_code ec;
+    if (os)
+        std::filesystem::rename(temp, t.path, ec);
+    if (!os || ec) {
+        std::filesystem::remove(temp, ec);
+        log_warn("failed to write metrics to '%s'", t.path.c_str());
+    }
+}
+
+void metrics_exporter::write_json(target& t,
+                                  const vector<metric_sample>& samples) {
+    metrics::write_json(t.file, samples);
+    t.file.flush();
+}
+
+void metrics_exporter::write(const vector<metric_sample>& samples) {
+    lock_guard<mutex> guard(m_write_mtx);
+
+    string text;
+    for (auto& t : m_targets) {
+        if (t->format == "json") {
+            write_json(*t, samples);
+            continue;
+        }
+
+        if (text.empty()) {
+            stringstream ss;
+            metrics::write_prometheus(ss, samples);
+            text = ss.str();
+        }
+
+        if (t->format == "prom")
+            write_prom(*t, text);
+        else
+            write_shm(*t, text);
+    }
+}
+
+bool metrics_exporter::sample_suspended(vector<metric_sample>& samples) {
+    if (!suspender::hold_suspension())
+        return false;
+
+    samples = metrics::snapshot();
+    suspender::release_suspension();
+    return true;
+}
+
+bool metrics_exporter::sample(vector<metric_sample>& samples) {
+    if (sample_suspended(samples))
+        return true;
+
+    auto req = std::make_shared<request>();
+    on_next_update([req]() -> void {
+        vector<metric_sample> samples = metrics::snapshot();
+        lock_guard<mutex> guard(req->mtx);
+        req->samples = std::move(samples);
+        req->done = true;
+        req->cv.notify_all();
+    });
+
+    unique_lock<mutex> lock(req->mtx);
+    while (!req->done) {
+        if (m_stop)
+            return false;
+
+        // the update phase never comes while the simulation is suspended,
+        // in which case we sample directly while keeping it suspended
+        if (suspender::simulation_suspended()) {
+            lock.unlock();
+            bool sampled = sample_suspended(samples);
+            lock.lock();
+            if (sampled)
+                return true;
+        }
+
+        req->cv.wait_for(lock, std::chrono::milliseconds(100));
+    }
+
+    samples = std::move(req->samples);
+    return true;
+}
+
+void metrics_exporter::run() {
+    mwr::set_thread_name("vcml_metrics");
+
+    auto interval = std::chrono::nanoseconds(m_interval);
+    auto next = std::chrono::steady_clock::now() + interval;
+
+    unique_lock<mutex> lock(m_mtx);
+    while (!m_stop) {
+        if (m_cv.wait_until(lock, next, [&]() { return m_stop.load(); }))
+            break;
+
+        lock.unlock();
+        vector<metric_sample> samples;
+        if (sample(samples))
+            write(samples);
+        lock.lock();
+
+        // skip intervals that were missed while waiting for the simulation
+        auto now = std::chrono::steady_clock::now();
+        while (next <= now)
+            next += interval;
+    }
+}
+
+static mutex g_metrics_mtx;
+static unique_ptr<metrics_exporter> g_metrics_exporter;
+
+void metrics::start(const string& targets, const sc_time& interval) {
+    lock_guard<mutex> guard(g_metrics_mtx);
+    g_metrics_exporter.reset();
+    g_metrics_exporter.reset(new metrics_exporter(targets, interval));
+}
+
+void metrics::stop() {
+    lock_guard<mutex> guard(g_metrics_mtx);
+    g_metrics_exporter.reset();
+}
+
+bool metrics::is_exporting() {
+    lock_guard<mutex> guard(g_metrics_mtx);
+    return g_metrics_exporter != nullptr;
+}
+
+void metrics::flush() {
+    lock_guard<mutex> guard(g_metrics_mtx);
+    if (g_metrics_exporter)
+        g_metrics_exporter->write(snapshot());
+}
+
+} // namespace debugging
+} // namespace vcml
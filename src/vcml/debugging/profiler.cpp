@@ -0,0 +1,211 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/debugging/profiler.h"
+
+namespace vcml {
+namespace debugging {
+
+const char* profile_mode_str(profile_mode mode) {
+    switch (mode) {
+    case PROFILE_CYCLES:
+        return "cycles";
+    case PROFILE_HOST:
+        return "host";
+    default:
+        return "unknown";
+    }
+}
+
+static string symbolize(const symtab& syms, u64 addr) {
+    const symbol* sym = syms.find_function(addr);
+    if (sym != nullptr)
+        return sym->name();
+    return mkstr("0x%llx", addr);
+}
+
+void profiler::record(u64 weight) {
+    m_frames.clear();
+    m_target.stacktrace(m_frames, m_depth);
+    if (m_frames.empty())
+        return;
+
+    sample& s = m_ring[m_head++];
+    s.weight = weight;
+    s.depth = min(m_frames.size(), m_depth);
+    for (size_t i = 0; i < s.depth; i++)
+        s.frames[i] = m_frames[i].program_counter;
+
+    m_total += weight;
+
+    if (m_head == m_ring.size())
+        drain();
+}
+
+static u64 hash_frames(const u64* frames, size_t depth) {
+    u64 hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < depth; i++) {
+        hash ^= frames[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash ^ depth;
+}
+
+void profiler::drain() {
+    for (size_t i = 0; i < m_head; i++) {
+        const sample& s = m_ring[i];
+        const u64 hash = hash_frames(s.frames, s.depth);
+
+        auto head = m_stack_index.find(hash);
+        size_t idx = head != m_stack_index.end() ? head->second : SIZE_MAX;
+        while (idx != SIZE_MAX) {
+            const stack& st = m_stacks[idx];
+            if (st.depth == s.depth &&
+                std::equal(s.frames, s.frames + s.depth,
+                           m_stack_frames.begin() + st.offset))
+                break;
+            idx = st.next;
+        }
+
+        if (idx == SIZE_MAX) {
+            idx = m_stacks.size();
+            size_t next = head != m_stack_index.end() ? head->second
+                                                      : SIZE_MAX;
+            m_stacks.push_back({ m_stack_frames.size(), s.depth, 0, next });
+            m_stack_frames.insert(m_stack_frames.end(), s.frames,
+                                  s.frames + s.depth);
+            m_stack_index[hash] = idx;
+        }
+
+        m_stacks[idx].weight += s.weight;
+    }
+
+    m_head = 0;
+}
+
+profiler::profiler(target& tgt, profile_mode mode, u64 period, size_t depth,
+                   size_t capacity):
+    m_target(tgt),
+    m_mode(mode),
+    m_period(max<u64>(period, 1)),
+    m_depth(min(max<size_t>(depth, 1), MAX_DEPTH)),
+    m_last_cycles(0),
+    m_last_host(mwr::timestamp()),
+    m_ring(max<size_t>(capacity, 1)),
+    m_head(0),
+    m_total(0),
+    m_stacks(),
+    m_stack_frames(),
+    m_stack_index(),
+    m_frames() {
+    m_frames.reserve(m_depth);
+}
+
+void profiler::update(u64 cycles) {
+    u64 weight = 0;
+
+    switch (m_mode) {
+    case PROFILE_CYCLES: {
+        if (cycles < m_last_cycles) // processor has been reset
+            m_last_cycles = cycles;
+        if (cycles - m_last_cycles < m_period)
+            return;
+
+        weight = (cycles - m_last_cycles) / m_period;
+        m_last_cycles += weight * m_period;
+        break;
+    }
+
+    case PROFILE_HOST: {
+        double now = mwr::timestamp();
+        double delta = (now - m_last_host) * 1e6;
+        if (delta < m_period)
+            return;
+
+        weight = (u64)(delta / m_period);
+        m_last_host += weight * m_period * 1e-6;
+        break;
+    }
+
+    default:
+        VCML_ERROR("invalid profile mode: %d", (int)m_mode);
+    }
+
+    record(weight);
+}
+
+void profiler::write_folded(ostream& os) {
+    drain();
+
+    const symtab& syms = m_target.symbols();
+    std::map<string, u64> folded;
+    for (const stack& st : m_stacks) {
+        const u64* frames = m_stack_frames.data() + st.offset;
+        string line;
+        for (size_t i = st.depth; i > 0; i--) {
+            if (!line.empty())
+                line += ";";
+            line += symbolize(syms, frames[i - 1]);
+        }
+
+        folded[line] += st.weight;
+    }
+
+    for (const auto& [line, weight] : folded)
+        os << line << " " << weight << "\n";
+}
+
+void profiler::write_report(ostream& os, size_t limit) {
+    drain();
+
+    struct entry {
+        u64 self;
+        u64 total;
+    };
+
+    const symtab& syms = m_target.symbols();
+    unordered_map<string, entry> funcs;
+    for (const stack& st : m_stacks) {
+        const u64* frames = m_stack_frames.data() + st.offset;
+        unordered_set<string> seen;
+        for (size_t i = 0; i < st.depth; i++) {
+            string func = symbolize(syms, frames[i]);
+            entry& e = funcs[func];
+            if (i == 0)
+                e.self += st.weight;
+            if (seen.insert(func).second)
+                e.total += st.weight;
+        }
+    }
+
+    vector<pair<string, entry>> sorted(funcs.begin(), funcs.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.self != b.second.self ? a.second.self > b.second.self
+                                              : a.first < b.first;
+    });
+
+    os << "Profile of " << m_target.target_name() << ": " << m_total
+       << " samples, one every " << m_period
+       << (m_mode == PROFILE_CYCLES ? " cycles" : "us");
+
+    if (m_total == 0)
+        return;
+
+    os << "\n   self   total  function";
+    for (size_t i = 0; i < sorted.size() && i < limit; i++) {
+        const auto& [func, e] = sorted[i];
+        os << mkstr("\n%6.2f%% %6.2f%%  %s", 100.0 * e.self / m_total,
+                    100.0 * e.total / m_total, func.c_str());
+    }
+}
+
+} // namespace debugging
+} // namespace vcml
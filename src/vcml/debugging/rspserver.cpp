@@ -32,13 +32,27 @@ static string rsp_escape(const string& s) {
     return ss.str();
 }
 
-static u8 checksum(const char* str) {
+static u8 checksum(const string& str) {
     u8 result = 0;
-    while (str && *str)
-        result += static_cast<u8>(*str++);
+    for (char c : str)
+        result += static_cast<u8>(c);
     return result;
 }
 
+string rsp_packet(const string& payload, char start) {
+    string esc = rsp_escape(payload);
+    u8 sum = checksum(esc);
+
+    string packet;
+    packet.reserve(esc.length() + 4);
+    packet += start;
+    packet += esc;
+    packet += '#';
+    packet += to_hex_ascii(sum >> 4);
+    packet += to_hex_ascii(sum);
+    return packet;
+}
+
 rspserver::rspserver(const string& host, u16 port, size_t max_clients):
     m_sock(max_clients, port, host),
     m_port(m_sock.port()),
@@ -77,11 +91,7 @@ void rspserver::send_packet(int client, const char* format, ...) {
 
 void rspserver::send_packet(int client, const string& s) {
     VCML_REPORT_ON(!is_connected(), "no connection established");
-    string esc = rsp_escape(s);
-
-    stringstream ss;
-    u8 sum = checksum(esc.c_str());
-    ss << "$" << esc << "#" << to_hex_ascii(sum >> 4) << to_hex_ascii(sum);
+    string packet = rsp_packet(s);
 
     char ack;
     size_t attempts = 10;
@@ -94,9 +104,9 @@ void rspserver::send_packet(int client, const string& s) {
         }
 
         if (m_echo)
-            log_debug("sending packet '%s'", ss.str().c_str());
+            log_debug("sending packet '%s'", packet.c_str());
 
-        m_sock.send(client, ss.str());
+        m_sock.send(client, packet);
 
         do {
             ack = m_sock.recv_char(client);
@@ -107,6 +117,18 @@ void rspserver::send_packet(int client, const string& s) {
     } while (ack != '+');
 }
 
+void rspserver::send_notification(int client, const string& s) {
+    VCML_REPORT_ON(!is_connected(), "no connection established");
+    string packet = rsp_packet(s, '%');
+
+    lock_guard<mutex> lock(m_mutex);
+    if (m_echo)
+        log_debug("sending notification '%s'", packet.c_str());
+
+    // notifications are not acknowledged by the client
+    m_sock.send(client, packet);
+}
+
 string rspserver::recv_packet(int client) {
     lock_guard<mutex> lock(m_mutex);
     VCML_REPORT_ON(!is_connected(), "no connection established");
@@ -20,6 +20,11 @@ struct suspend_manager {
     atomic<bool> is_quitting;
     atomic<bool> is_suspended;
 
+    // set while the simulation thread waits for the last suspender to
+    // resume, holders keep it waiting even after that has happened
+    bool is_paused;
+    size_t holders;
+
     mutable mutex suspender_lock;
     std::condition_variable_any cv_pause;
     std::condition_variable_any cv_resume;
@@ -27,19 +32,31 @@ struct suspend_manager {
     vector<suspender*> waiting_suspenders;
     vector<suspender*> active_suspenders;
 
+    // modules in order of construction, only touched during elaboration
+    // and teardown, and copied into session_modules before notifying
+    mutex module_lock;
+    vector<module*> modules;
+    vector<module*> session_modules;
+
     void request_pause(suspender* s);
     void request_resume(suspender* s);
     void request_yield(suspender* s);
 
     bool is_suspending(const suspender* s) const;
 
+    bool hold();
+    void release();
+
     suspender* current() const;
     void current(vector<suspender*>& v) const;
 
     void quit();
 
-    void notify_suspend(sc_object* obj = nullptr);
-    void notify_resume(sc_object* obj = nullptr);
+    void register_module(module* mod);
+    void unregister_module(module* mod);
+
+    void notify_suspend();
+    void notify_resume();
 
     void handle_requests();
 
@@ -61,20 +78,21 @@ void suspend_manager::request_pause(suspender* s) {
 
     suspender_lock.lock();
 
-    if (stl_contains(active_suspenders, s) ||
-        stl_contains(waiting_suspenders, s)) {
+    if (s->m_state != suspender::SUSPEND_IDLE) {
         // another thread already called suspend on this suspender, release
         // the lock and yield until we are paused
     } else if (!active_suspenders.empty() && s->check_suspension_point()) {
         // if the simulation is already suspended, and we like the current
         // suspension point, we just join the active suspenders
-        stl_add_unique(active_suspenders, s);
+        active_suspenders.push_back(s);
+        s->m_state = suspender::SUSPEND_ACTIVE;
     } else {
         // no active suspenders, queue ourselves into the waiting queue
         // and schedule a handle_request if nobody was there to do it before
         if (waiting_suspenders.empty())
             on_next_update([&]() { handle_requests(); });
-        stl_add_unique(waiting_suspenders, s);
+        waiting_suspenders.push_back(s);
+        s->m_state = suspender::SUSPEND_WAITING;
     }
 
     suspender_lock.unlock();
@@ -85,13 +103,22 @@ void suspend_manager::request_pause(suspender* s) {
 
 void suspend_manager::request_resume(suspender* s) {
     lock_guard<mutex> guard(suspender_lock);
-    stl_remove(waiting_suspenders, s);
-    if (!stl_contains(active_suspenders, s))
-        return;
+    switch (s->m_state) {
+    case suspender::SUSPEND_WAITING:
+        stl_remove(waiting_suspenders, s);
+        break;
+
+    case suspender::SUSPEND_ACTIVE:
+        stl_remove(active_suspenders, s);
+        if (active_suspenders.empty())
+            cv_resume.notify_all();
+        break;
+
+    default:
+        break;
+    }
 
-    stl_remove(active_suspenders, s);
-    if (active_suspenders.empty())
-        cv_resume.notify_all();
+    s->m_state = suspender::SUSPEND_IDLE;
 }
 
 void suspend_manager::request_yield(suspender* s) {
@@ -101,20 +128,36 @@ void suspend_manager::request_yield(suspender* s) {
     suspender_lock.lock();
 
     // no point in yielding when we are already suspended
-    if (!stl_contains(active_suspenders, s)) {
+    if (s->m_state != suspender::SUSPEND_ACTIVE) {
         // must have at least queued a suspend request before yielding
-        if (!stl_contains(waiting_suspenders, s))
+        if (s->m_state != suspender::SUSPEND_WAITING)
             VCML_ERROR("cannot call yield without suspend");
-        cv_pause.wait(suspender_lock,
-                      [&] { return stl_contains(active_suspenders, s); });
+        cv_pause.wait(suspender_lock, [&] {
+            return s->m_state == suspender::SUSPEND_ACTIVE;
+        });
     }
 
     suspender_lock.unlock();
 }
 
 bool suspend_manager::is_suspending(const suspender* s) const {
+    return s->m_state == suspender::SUSPEND_ACTIVE;
+}
+
+bool suspend_manager::hold() {
     lock_guard<mutex> guard(suspender_lock);
-    return stl_contains(active_suspenders, s);
+    if (!is_paused)
+        return false;
+
+    holders++;
+    return true;
+}
+
+void suspend_manager::release() {
+    lock_guard<mutex> guard(suspender_lock);
+    VCML_ERROR_ON(!holders, "release without hold");
+    if (--holders == 0)
+        cv_resume.notify_all();
 }
 
 suspender* suspend_manager::current() const {
@@ -135,36 +178,43 @@ void suspend_manager::quit() {
         on_next_update(request_stop);
 
     is_quitting = true;
+    for (suspender* s : waiting_suspenders)
+        s->m_state = suspender::SUSPEND_IDLE;
+    for (suspender* s : active_suspenders)
+        s->m_state = suspender::SUSPEND_IDLE;
     waiting_suspenders.clear();
     active_suspenders.clear();
     cv_resume.notify_all();
 }
 
-void suspend_manager::notify_suspend(sc_object* obj) {
-    const auto& children = obj ? obj->get_child_objects()
-                               : sc_core::sc_get_top_level_objects();
-    for (auto child : children)
-        notify_suspend(child);
-
-    if (obj == nullptr)
-        return;
+void suspend_manager::register_module(module* mod) {
+    lock_guard<mutex> guard(module_lock);
+    modules.push_back(mod);
+}
 
-    module* mod = dynamic_cast<module*>(obj);
-    if (mod != nullptr)
-        mod->session_suspend();
+void suspend_manager::unregister_module(module* mod) {
+    lock_guard<mutex> guard(module_lock);
+    // children are destroyed before their parents, so we usually find the
+    // module right at the end of the list
+    auto it = std::find(modules.rbegin(), modules.rend(), mod);
+    if (it != modules.rend())
+        modules.erase(std::next(it).base());
 }
 
-void suspend_manager::notify_resume(sc_object* obj) {
-    const auto& children = obj ? obj->get_child_objects()
-                               : sc_core::sc_get_top_level_objects();
-    for (auto child : children)
-        notify_resume(child);
+// children get notified before their parents, as with the hierarchical
+// traversal used before, i.e. in reverse order of construction
+void suspend_manager::notify_suspend() {
+    {
+        lock_guard<mutex> guard(module_lock);
+        session_modules.assign(modules.rbegin(), modules.rend());
+    }
 
-    if (obj == nullptr)
-        return;
+    for (module* mod : session_modules)
+        mod->session_suspend();
+}
 
-    module* mod = dynamic_cast<module*>(obj);
-    if (mod != nullptr)
+void suspend_manager::notify_resume() {
+    for (module* mod : session_modules)
         mod->session_resume();
 }
 
@@ -177,16 +227,21 @@ void suspend_manager::handle_requests() {
     vector<suspender*> suspenders;
     std::swap(suspenders, waiting_suspenders);
     for (suspender* s : suspenders) {
-        if (s->check_suspension_point())
+        if (s->check_suspension_point()) {
             active_suspenders.push_back(s);
-        else
+            s->m_state = suspender::SUSPEND_ACTIVE;
+        } else {
             waiting_suspenders.push_back(s);
+        }
     }
 
     if (!active_suspenders.empty()) {
         is_suspended = true;
+        vector<suspender*> active = active_suspenders;
         suspender_lock.unlock();
         notify_suspend();
+        for (suspender* s : active)
+            s->notify_suspended();
         suspender_lock.lock();
 
         cv_pause.notify_all();
@@ -195,9 +250,11 @@ void suspend_manager::handle_requests() {
         INSCIGHT_KTHREAD_SUSPENDED();
 #endif
 
+        is_paused = true;
         cv_resume.wait(suspender_lock, [&]() {
-            return active_suspenders.empty() || is_quitting;
+            return (active_suspenders.empty() || is_quitting) && !holders;
         });
+        is_paused = false;
 
 #ifdef INSCIGHT_KTHREAD_RESUMED
         INSCIGHT_KTHREAD_RESUMED();
@@ -220,9 +277,14 @@ size_t suspend_manager::num_waiting() const {
 suspend_manager::suspend_manager():
     is_quitting(false),
     is_suspended(false),
+    is_paused(false),
+    holders(0),
     suspender_lock(),
     waiting_suspenders(),
-    active_suspenders() {
+    active_suspenders(),
+    module_lock(),
+    modules(),
+    session_modules() {
 }
 
 suspend_manager& suspend_manager::instance() {
@@ -231,13 +293,13 @@ suspend_manager& suspend_manager::instance() {
 }
 
 suspender::suspender(const string& name):
-    m_name(name), m_owner(hierarchy_top()) {
+    m_name(name), m_owner(hierarchy_top()), m_state(SUSPEND_IDLE) {
     if (m_owner != nullptr)
         m_name = mkstr("%s%c", m_owner->name(), SC_HIERARCHY_CHAR) + name;
 }
 
 suspender::~suspender() {
-    if (is_suspending())
+    if (m_state != SUSPEND_IDLE)
         resume();
 }
 
@@ -245,6 +307,10 @@ bool suspender::check_suspension_point() {
     return true;
 }
 
+void suspender::notify_suspended() {
+    // to be overloaded
+}
+
 bool suspender::is_suspending() const {
     return suspend_manager::instance().is_suspending(this);
 }
@@ -277,6 +343,14 @@ bool suspender::simulation_suspended() {
     return suspend_manager::instance().is_suspended;
 }
 
+bool suspender::hold_suspension() {
+    return suspend_manager::instance().hold();
+}
+
+void suspender::release_suspension() {
+    suspend_manager::instance().release();
+}
+
 bool suspender::suspenders_waiting() {
     return suspend_manager::instance().num_waiting() > 0;
 }
@@ -285,5 +359,13 @@ void suspender::handle_requests() {
     suspend_manager::instance().handle_requests();
 }
 
+void suspender::register_module(module* mod) {
+    suspend_manager::instance().register_module(mod);
+}
+
+void suspender::unregister_module(module* mod) {
+    suspend_manager::instance().unregister_module(mod);
+}
+
 } // namespace debugging
 } // namespace vcml
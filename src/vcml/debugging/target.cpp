@@ -14,6 +14,34 @@
 namespace vcml {
 namespace debugging {
 
+// collects watchpoint hits without touching the heap in the common case,
+// subscribers may remove watchpoints while being notified
+class watchpoint_hits
+{
+private:
+    watchpoint* m_buffer[8];
+    size_t m_count;
+    vector<watchpoint*> m_overflow;
+
+public:
+    watchpoint_hits(): m_count(0), m_overflow() {}
+
+    void add(watchpoint* wp) {
+        if (m_count < std::size(m_buffer))
+            m_buffer[m_count++] = wp;
+        else
+            m_overflow.push_back(wp);
+    }
+
+    template <typename FN>
+    void for_each(FN&& fn) const {
+        for (size_t i = 0; i < m_count; i++)
+            fn(m_buffer[i]);
+        for (watchpoint* wp : m_overflow)
+            fn(wp);
+    }
+};
+
 bool cpureg::read(void* buf, size_t len) const {
     VCML_ERROR_ON(!host, "cpureg %s has no target", name.c_str());
     if (len < total_size() || !is_readable())
@@ -402,23 +430,72 @@ bool target::try_remove_watchpoint(const watchpoint& wp, vcml_access prot) {
     return remove_watchpoint(wp.address(), prot);
 }
 
+void target::insert_watchpoint_index(watchpoint* wp) {
+    auto it = std::upper_bound(m_watchpoints.begin(), m_watchpoints.end(), wp,
+                               [](const watchpoint* a, const watchpoint* b) {
+                                   return a->address().start <
+                                          b->address().start;
+                               });
+    m_watchpoints.insert(it, wp);
+    update_watchpoint_index();
+}
+
+void target::remove_watchpoint_index(watchpoint* wp) {
+    stl_remove(m_watchpoints, wp);
+    update_watchpoint_index();
+}
+
+void target::update_watchpoint_index() {
+    m_watchpoint_ends.resize(m_watchpoints.size());
+    u64 end = 0;
+    for (size_t i = 0; i < m_watchpoints.size(); i++) {
+        end = max(end, m_watchpoints[i]->address().end);
+        m_watchpoint_ends[i] = end;
+    }
+}
+
+template <typename FN>
+void target::for_each_watchpoint(const range& addr, FN&& fn) const {
+    auto it = std::upper_bound(m_watchpoints.begin(), m_watchpoints.end(),
+                               addr.end, [](u64 a, const watchpoint* wp) {
+                                   return a < wp->address().start;
+                               });
+
+    // walk backwards until no earlier watchpoint can reach addr.start
+    for (size_t i = it - m_watchpoints.begin(); i > 0; i--) {
+        if (m_watchpoint_ends[i - 1] < addr.start)
+            break;
+        if (m_watchpoints[i - 1]->address().overlaps(addr))
+            fn(m_watchpoints[i - 1]);
+    }
+}
+
 void target::notify_breakpoint_hit(u64 pc, const sc_time& t) {
-    for (auto& bp : m_breakpoints)
-        if (bp->address() == pc)
-            bp->notify(t);
+    if (m_breakpoint_index.empty())
+        return;
+
+    auto it = m_breakpoint_index.find(pc);
+    if (it != m_breakpoint_index.end())
+        it->second->notify(t);
 }
 
 void target::notify_watchpoint_read(const range& addr, const sc_time& t) {
-    for (auto& wp : m_watchpoints)
-        if (wp->address().overlaps(addr))
-            wp->notify_read(addr, t);
+    if (m_watchpoints.empty())
+        return;
+
+    watchpoint_hits hits;
+    for_each_watchpoint(addr, [&](watchpoint* wp) { hits.add(wp); });
+    hits.for_each([&](watchpoint* wp) { wp->notify_read(addr, t); });
 }
 
 void target::notify_watchpoint_write(const range& addr, const void* newval,
                                      const sc_time& t) {
-    for (auto& wp : m_watchpoints)
-        if (wp->address().overlaps(addr))
-            wp->notify_write(addr, newval, t);
+    if (m_watchpoints.empty())
+        return;
+
+    watchpoint_hits hits;
+    for_each_watchpoint(addr, [&](watchpoint* wp) { hits.add(wp); });
+    hits.for_each([&](watchpoint* wp) { wp->notify_write(addr, newval, t); });
 }
 
 void target::notify_singlestep(const sc_time& t) {
@@ -434,11 +511,11 @@ void target::notify_singlestep(const sc_time& t) {
 
 void target::notify_basic_block(u64 pc, size_t blksz, size_t icount,
                                 const sc_time& t) {
-    m_mtx.lock();
-    vector<subscriber*> local(m_bbtracer);
-    m_mtx.unlock();
+    auto* tracers = m_bbtracer.load(std::memory_order_acquire);
+    if (tracers == nullptr)
+        return;
 
-    for (auto s : local)
+    for (auto s : *tracers)
         s->notify_basic_block(*this, pc, blksz, icount, t);
 }
 
@@ -453,9 +530,11 @@ target::target(sc_object& host, const string& group):
     m_cpuregs(),
     m_symbols(),
     m_steppers(),
-    m_bbtracer(),
+    m_bbtracer(nullptr),
     m_breakpoints(),
-    m_watchpoints() {
+    m_breakpoint_index(),
+    m_watchpoints(),
+    m_watchpoint_ends() {
     if (stl_contains(s_targets, m_name))
         VCML_ERROR("debug target '%s' already exists", m_name.c_str());
     s_targets[m_name] = this;
@@ -489,6 +568,7 @@ target::~target() {
         delete bp;
     for (auto wp : m_watchpoints)
         delete wp;
+    delete m_bbtracer.load();
     s_targets.erase(m_name);
 }
 
@@ -714,18 +794,32 @@ bool target::disassemble(const range& addr, vector<disassembly>& s) {
 }
 
 const breakpoint* target::lookup_breakpoint(u64 addr) {
-    for (auto& bp : m_breakpoints)
-        if (bp->address() == addr)
-            return bp;
-    return nullptr;
+    auto it = m_breakpoint_index.find(addr);
+    return it != m_breakpoint_index.end() ? it->second : nullptr;
+}
+
+const watchpoint* target::lookup_watchpoint(const range& mem) {
+    const watchpoint* res = nullptr;
+    for_each_watchpoint(mem, [&](const watchpoint* wp) {
+        if (wp->address() == mem)
+            res = wp;
+    });
+
+    return res;
+}
+
+bool target::has_watchpoint(const range& mem) const {
+    bool found = false;
+    for_each_watchpoint(mem, [&](const watchpoint* wp) { found = true; });
+    return found;
 }
 
 const breakpoint* target::insert_breakpoint(u64 addr, subscriber* subscr) {
-    for (auto& bp : m_breakpoints)
-        if (bp->address() == addr) {
-            bp->subscribe(subscr);
-            return bp;
-        }
+    auto it = m_breakpoint_index.find(addr);
+    if (it != m_breakpoint_index.end()) {
+        it->second->subscribe(subscr);
+        return it->second;
+    }
 
     u64 user_id = USER_ID_NONE;
     if (!insert_breakpoint_id(addr, user_id))
@@ -735,63 +829,43 @@ const breakpoint* target::insert_breakpoint(u64 addr, subscriber* subscr) {
     breakpoint* newbp = new breakpoint(*this, addr, func, user_id);
     newbp->subscribe(subscr);
     m_breakpoints.push_back(newbp);
+    m_breakpoint_index[addr] = newbp;
     return newbp;
 }
 
 bool target::remove_breakpoint(const breakpoint* bp, subscriber* subscr) {
-    if (bp == nullptr)
-        return false;
-
-    auto it = std::find(m_breakpoints.begin(), m_breakpoints.end(), bp);
-    if (it == m_breakpoints.end())
+    if (bp == nullptr || lookup_breakpoint(bp->address()) != bp)
         return false;
 
-    if (!(*it)->unsubscribe(subscr))
-        return false;
-
-    if ((*it)->has_subscribers())
-        return true;
-
-    if (!try_remove_breakpoint(**it))
-        return false;
-
-    delete *it;
-    m_breakpoints.erase(it);
-    return true;
+    return remove_breakpoint(bp->address(), subscr);
 }
 
 bool target::remove_breakpoint(u64 addr, subscriber* subscr) {
-    auto it = std::find_if(m_breakpoints.begin(), m_breakpoints.end(),
-                           [addr](const breakpoint* bp) -> bool {
-                               return bp->address() == addr;
-                           });
-
-    if (it == m_breakpoints.end())
+    auto it = m_breakpoint_index.find(addr);
+    if (it == m_breakpoint_index.end())
         return false;
 
-    if (!(*it)->unsubscribe(subscr))
+    breakpoint* bp = it->second;
+    if (!bp->unsubscribe(subscr))
         return false;
 
-    if ((*it)->has_subscribers())
+    if (bp->has_subscribers())
         return true;
 
-    if (!try_remove_breakpoint(**it))
+    if (!try_remove_breakpoint(*bp))
         return false;
 
-    delete *it;
-    m_breakpoints.erase(it);
+    m_breakpoint_index.erase(it);
+    stl_remove(m_breakpoints, bp);
+    delete bp;
     return true;
 }
 
 const watchpoint* target::insert_watchpoint(const range& addr,
                                             vcml_access prot,
                                             subscriber* subscr) {
-    auto wp = std::find_if(m_watchpoints.begin(), m_watchpoints.end(),
-                           [addr](const watchpoint* wp) -> bool {
-                               return wp->address() == addr;
-                           });
-
-    if (wp == m_watchpoints.end()) {
+    watchpoint* wp = const_cast<watchpoint*>(lookup_watchpoint(addr));
+    if (wp == nullptr) {
         u64 id_r = USER_ID_NONE;
         u64 id_w = USER_ID_NONE;
         if (is_read_allowed(prot)) {
@@ -812,116 +886,117 @@ const watchpoint* target::insert_watchpoint(const range& addr,
         }
 
         const symbol* obj = m_symbols.find_object(addr.start);
-        watchpoint* newwp = new watchpoint(*this, addr, obj, id_r, id_w);
-        m_watchpoints.push_back(newwp);
-        wp = m_watchpoints.end() - 1;
-        (*wp)->subscribe(prot, subscr);
-        return *wp;
+        wp = new watchpoint(*this, addr, obj, id_r, id_w);
+        insert_watchpoint_index(wp);
+        wp->subscribe(prot, subscr);
+        return wp;
     }
 
-    if (is_read_allowed(prot) && !(*wp)->has_read_subscribers()) {
-        if (!insert_watchpoint_id(addr, VCML_ACCESS_READ, (*wp)->user_id_r))
+    if (is_read_allowed(prot) && !wp->has_read_subscribers()) {
+        if (!insert_watchpoint_id(addr, VCML_ACCESS_READ, wp->user_id_r))
             return nullptr;
     }
 
-    if (is_write_allowed(prot) && !(*wp)->has_write_subscribers()) {
-        if (!insert_watchpoint_id(addr, VCML_ACCESS_WRITE, (*wp)->user_id_w)) {
-            if (is_read_allowed(prot) && !(*wp)->has_read_subscribers()) {
-                try_remove_watchpoint(**wp, VCML_ACCESS_READ);
-                (*wp)->user_id_r = 0;
+    if (is_write_allowed(prot) && !wp->has_write_subscribers()) {
+        if (!insert_watchpoint_id(addr, VCML_ACCESS_WRITE, wp->user_id_w)) {
+            if (is_read_allowed(prot) && !wp->has_read_subscribers()) {
+                try_remove_watchpoint(*wp, VCML_ACCESS_READ);
+                wp->user_id_r = 0;
             }
             return nullptr;
         }
     }
 
     if (is_read_allowed(prot))
-        (*wp)->subscribe(VCML_ACCESS_READ, subscr);
+        wp->subscribe(VCML_ACCESS_READ, subscr);
 
     if (is_write_allowed(prot))
-        (*wp)->subscribe(VCML_ACCESS_WRITE, subscr);
+        wp->subscribe(VCML_ACCESS_WRITE, subscr);
 
-    return *wp;
+    return wp;
 }
 
 bool target::remove_watchpoint(const watchpoint* wp, vcml_access prot,
                                subscriber* subscr) {
-    if (wp == nullptr)
+    if (wp == nullptr || lookup_watchpoint(wp->address()) != wp)
         return false;
 
-    auto it = std::find(m_watchpoints.begin(), m_watchpoints.end(), wp);
-    if (it == m_watchpoints.end())
+    return remove_watchpoint(wp->address(), prot, subscr);
+}
+
+bool target::remove_watchpoint(const range& addr, vcml_access prot,
+                               subscriber* subscr) {
+    watchpoint* wp = const_cast<watchpoint*>(lookup_watchpoint(addr));
+    if (wp == nullptr)
         return false;
 
     if (is_read_allowed(prot)) {
-        (*it)->unsubscribe(VCML_ACCESS_READ, subscr);
-        if (!(*it)->has_read_subscribers())
-            if (!try_remove_watchpoint(**it, VCML_ACCESS_READ))
+        wp->unsubscribe(VCML_ACCESS_READ, subscr);
+        if (!wp->has_read_subscribers())
+            if (!try_remove_watchpoint(*wp, VCML_ACCESS_READ))
                 return false;
     }
 
     if (is_write_allowed(prot)) {
-        (*it)->unsubscribe(VCML_ACCESS_WRITE, subscr);
-        if (!(*it)->has_write_subscribers())
-            if (!try_remove_watchpoint(**it, VCML_ACCESS_WRITE))
+        wp->unsubscribe(VCML_ACCESS_WRITE, subscr);
+        if (!wp->has_write_subscribers())
+            if (!try_remove_watchpoint(*wp, VCML_ACCESS_WRITE))
                 return false;
     }
 
-    if (!(*it)->has_any_subscribers()) {
-        delete *it;
-        m_watchpoints.erase(it);
+    if (!wp->has_any_subscribers()) {
+        remove_watchpoint_index(wp);
+        delete wp;
     }
 
     return true;
 }
 
-bool target::remove_watchpoint(const range& addr, vcml_access prot,
-                               subscriber* subscr) {
-    auto wp = std::find_if(m_watchpoints.begin(), m_watchpoints.end(),
-                           [addr](const watchpoint* wp) -> bool {
-                               return wp->address() == addr;
-                           });
-
-    if (wp == m_watchpoints.end())
-        return false;
-
-    if (is_read_allowed(prot)) {
-        (*wp)->unsubscribe(VCML_ACCESS_READ, subscr);
-        if (!(*wp)->has_read_subscribers())
-            if (!try_remove_watchpoint(**wp, VCML_ACCESS_READ))
-                return false;
-    }
-
-    if (is_write_allowed(prot)) {
-        (*wp)->unsubscribe(VCML_ACCESS_WRITE, subscr);
-        if (!(*wp)->has_write_subscribers())
-            if (!try_remove_watchpoint(**wp, VCML_ACCESS_WRITE))
-                return false;
-    }
+void target::publish_basic_block_tracers(const vector<subscriber*>* tracers) {
+    auto* prev = m_bbtracer.exchange(tracers, std::memory_order_acq_rel);
+    if (prev == nullptr)
+        return;
 
-    if (!(*wp)->has_any_subscribers()) {
-        delete *wp;
-        m_watchpoints.erase(wp);
+    if (!sim_running()) {
+        delete prev;
+        return;
     }
 
-    return true;
+    on_next_update([prev]() { delete prev; });
 }
 
 bool target::trace_basic_blocks(subscriber* subscr) {
     lock_guard<mutex> guard(m_mtx);
-    if (m_bbtracer.empty() && !start_basic_block_trace())
-        return false;
+    auto* tracers = m_bbtracer.load(std::memory_order_acquire);
+    if (tracers && stl_contains(*tracers, subscr))
+        return true;
 
-    stl_add_unique(m_bbtracer, subscr);
+    if (!tracers || tracers->empty()) {
+        if (!start_basic_block_trace())
+            return false;
+    }
+
+    auto* update = tracers ? new vector<subscriber*>(*tracers)
+                           : new vector<subscriber*>();
+    update->push_back(subscr);
+    publish_basic_block_tracers(update);
     return true;
 }
 
 bool target::untrace_basic_blocks(subscriber* subscr) {
     lock_guard<mutex> guard(m_mtx);
-    if (!mwr::stl_contains(m_bbtracer, subscr))
+    auto* tracers = m_bbtracer.load(std::memory_order_acquire);
+    if (!tracers || !mwr::stl_contains(*tracers, subscr))
         return false;
 
-    stl_remove(m_bbtracer, subscr);
-    if (m_bbtracer.empty() && !stop_basic_block_trace())
+    vector<subscriber*>* update = nullptr;
+    if (tracers->size() > 1) {
+        update = new vector<subscriber*>(*tracers);
+        stl_remove(*update, subscr);
+    }
+
+    publish_basic_block_tracers(update);
+    if (update == nullptr && !stop_basic_block_trace())
         return false;
 
     return true;
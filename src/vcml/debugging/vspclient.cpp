@@ -31,6 +31,27 @@ static string hexstr(const u8* bytes, size_t len) {
     return res;
 }
 
+string vspclient::read_subscription(const subscription& sub) {
+    if (sub.attr != nullptr) {
+        property_base* prop = dynamic_cast<property_base*>(sub.attr);
+        return escape(prop ? prop->str() : sub.attr->name(), ",");
+    }
+
+    // registers are reported as hex digits, lowest addressed byte first
+    vector<u8> data(sub.reg->total_size());
+    if (!sub.reg->read(data.data(), data.size()))
+        return "";
+
+    string res;
+    res.reserve(data.size() * 2);
+    for (u8 val : data) {
+        res += to_hex_ascii(val >> 4);
+        res += to_hex_ascii(val);
+    }
+
+    return res;
+}
+
 void vspclient::resume_simulation(const sc_time& duration) {
     m_stop_reason.clear();
     if (duration < sc_max_time())
@@ -96,7 +117,9 @@ vspclient::vspclient(vspserver& server, int clientid, const string& peer,
     m_stop_reason("user"),
     m_mtx(),
     m_breakpoints(),
-    m_watchpoints() {
+    m_watchpoints(),
+    m_next_subscription(0),
+    m_subscriptions() {
     // nothing to do
 }
 
@@ -113,6 +136,29 @@ void vspclient::notify_step_complete() {
         pause_simulation("step");
 }
 
+bool vspclient::collect_updates(string& notification) {
+    lock_guard<mutex> guard(m_mtx);
+    if (m_subscriptions.empty())
+        return false;
+
+    // notify,<time>,<id>:<value>[,<id>:<value>]...
+    notification = mkstr("notify,%llu", time_to_ns(sc_time_stamp()));
+    bool changed = false;
+
+    for (subscription& sub : m_subscriptions) {
+        string value = read_subscription(sub);
+        if (value == sub.value)
+            continue;
+
+        notification += mkstr(",%llu:", sub.id);
+        notification += value;
+        sub.value = std::move(value);
+        changed = true;
+    }
+
+    return changed;
+}
+
 string vspclient::handle_status(const string& command) {
     lock_guard<mutex> guard(m_mtx);
     u64 delta = sc_delta_count();
@@ -307,5 +353,61 @@ string vspclient::handle_setsm(const string& command) {
     return "OK";
 }
 
+string vspclient::handle_sub(const string& command) {
+    if (!is_stopped())
+        return "E,simulation running";
+
+    vector<string> args = split(command, ',');
+    if (args.size() < 3)
+        return mkstr("E,insufficient arguments %zu", args.size());
+
+    subscription sub{ m_next_subscription, nullptr, nullptr, nullptr, "" };
+
+    if (args[1] == "a") {
+        sub.attr = find_attribute(args[2]);
+        if (sub.attr == nullptr)
+            return mkstr("E,attribute '%s' not found", args[2].c_str());
+    } else if (args[1] == "r") {
+        if (args.size() < 4)
+            return mkstr("E,insufficient arguments %zu", args.size());
+
+        sub.tgt = target::find(args[2]);
+        if (sub.tgt == nullptr)
+            return mkstr("E,no such target: %s", args[2].c_str());
+
+        sub.reg = sub.tgt->find_cpureg(args[3]);
+        if (sub.reg == nullptr)
+            return mkstr("E,no such register: %s", args[3].c_str());
+    } else {
+        return mkstr("E,unknown subscription type '%s'", args[1].c_str());
+    }
+
+    sub.value = read_subscription(sub);
+    string response = mkstr("OK,%llu,", sub.id) + sub.value;
+
+    lock_guard<mutex> guard(m_mtx);
+    m_subscriptions.push_back(std::move(sub));
+    m_next_subscription++;
+    return response;
+}
+
+string vspclient::handle_unsub(const string& command) {
+    vector<string> args = split(command, ',');
+    if (args.size() < 2)
+        return mkstr("E,insufficient arguments %zu", args.size());
+
+    u64 id = from_string<u64>(args[1]);
+
+    lock_guard<mutex> guard(m_mtx);
+    for (auto it = m_subscriptions.begin(); it != m_subscriptions.end(); it++) {
+        if (it->id == id) {
+            m_subscriptions.erase(it);
+            return "OK";
+        }
+    }
+
+    return mkstr("E,invalid subscription id: %llu", id);
+}
+
 } // namespace debugging
 } // namespace vcml
@@ -16,6 +16,7 @@
 #include "vcml/debugging/vspserver.h"
 #include "vcml/debugging/target.h"
 #include "vcml/debugging/loader.h"
+#include "vcml/debugging/hostprof.h"
 
 #include "vcml/protocols/base.h"
 #include "vcml/ui/input.h"
@@ -82,6 +83,57 @@ static string json_escape(const string& s) {
     return escape(ss.str(), ",");
 }
 
+static string hex_response(const vector<u8>& data) {
+    string res = "OK";
+    res.reserve(res.size() + data.size() * 5);
+    for (u8 val : data) {
+        res += ",0x";
+        res += to_hex_ascii(val >> 4);
+        res += to_hex_ascii(val);
+    }
+
+    return res;
+}
+
+static string bin_response(const vector<u8>& data) {
+    string res = "OK,";
+    res.append((const char*)data.data(), data.size());
+    return res;
+}
+
+static bool is_binary_format(const vector<string>& args, size_t idx) {
+    return args.size() > idx && to_lower(args[idx]) == "bin";
+}
+
+// batch,<length>:<command>[,<length>:<command>]...
+static bool parse_batch(const string& cmd, vector<string>& commands) {
+    size_t pos = cmd.find(',');
+    while (pos != string::npos) {
+        size_t sep = cmd.find(':', ++pos);
+        if (sep == string::npos || sep == pos)
+            return false;
+
+        size_t len = 0;
+        for (size_t i = pos; i < sep; i++) {
+            if (!isdigit(cmd[i]) || len > cmd.length())
+                return false;
+            len = len * 10 + (cmd[i] - '0');
+        }
+
+        if (len > cmd.length() - sep - 1)
+            return false;
+
+        commands.push_back(cmd.substr(sep + 1, len));
+        pos = sep + 1 + len;
+        if (pos == cmd.length())
+            return true;
+        if (cmd[pos] != ',')
+            return false;
+    }
+
+    return true;
+}
+
 static string attr_type(const sc_attr_base* attr) {
     const property_base* prop = dynamic_cast<const property_base*>(attr);
     return prop != nullptr ? prop->type() : "unknown";
@@ -526,11 +578,7 @@ string vspserver::handle_getr(int client, const string& cmd) {
     if (!reg->read(data.data(), data.size()))
         return mkstr("E,error reading %s", args[2].c_str());
 
-    stringstream ss;
-    ss << "OK";
-    for (u8 ch : data)
-        ss << mkstr(",0x%02hhx", ch);
-    return ss.str();
+    return hex_response(data);
 }
 
 string vspserver::handle_setr(int client, const string& cmd) {
@@ -600,11 +648,10 @@ string vspserver::handle_vread(int client, const string& cmd) {
     vector<u8> data(size);
     tgt->read_vmem_dbg(addr, data.data(), data.size());
 
-    stringstream ss;
-    ss << "OK";
-    for (u8 ch : data)
-        ss << mkstr(",0x%02hhx", ch);
-    return ss.str();
+    if (is_binary_format(args, 4))
+        return bin_response(data);
+
+    return hex_response(data);
 }
 
 string vspserver::handle_vwrite(int client, const string& cmd) {
@@ -649,11 +696,10 @@ string vspserver::handle_pread(int client, const string& cmd) {
     vector<u8> data(size);
     tgt->read_pmem_dbg(addr, data.data(), data.size());
 
-    stringstream ss;
-    ss << "OK";
-    for (u8 ch : data)
-        ss << mkstr(",0x%02hhx", ch);
-    return ss.str();
+    if (is_binary_format(args, 4))
+        return bin_response(data);
+
+    return hex_response(data);
 }
 
 string vspserver::handle_pwrite(int client, const string& cmd) {
@@ -697,6 +743,58 @@ string vspserver::handle_arch(int client, const string& cmd) {
     return mkstr("OK,%s", arch);
 }
 
+string vspserver::handle_batch(int client, const string& cmd) {
+    vector<string> commands;
+    if (!parse_batch(cmd, commands))
+        return "E,malformed batch";
+
+    string response = "OK";
+    for (const string& command : commands) {
+        if (starts_with(command, "batch"))
+            return "E,nested batch";
+
+        string reply = handle_command(client, command);
+        response += mkstr(",%zu:", reply.length());
+        response += reply;
+    }
+
+    return response;
+}
+
+string vspserver::handle_sub(int client, const string& cmd) {
+    return find_client(client).handle_sub(cmd);
+}
+
+string vspserver::handle_unsub(int client, const string& cmd) {
+    return find_client(client).handle_unsub(cmd);
+}
+
+string vspserver::handle_hprof(int client, const string& cmd) {
+    if (is_running())
+        return "E,simulation running";
+
+    if (!hostprof::is_enabled())
+        return "E,host profiling disabled";
+
+    vector<string> args = split(cmd, ',');
+    size_t limit = ~0ull;
+    if (args.size() > 1)
+        limit = from_string<size_t>(args[1]);
+
+    vector<hostprof::entry> entries = hostprof::collect();
+    if (entries.size() > limit)
+        entries.resize(limit);
+
+    string response = "OK";
+    for (const auto& entry : entries) {
+        response += mkstr(",%s:%llu:%llu:", entry.kind, entry.calls,
+                          entry.nanos);
+        response += escape(entry.name, ",");
+    }
+
+    return response;
+}
+
 void vspserver::disconnect_all() {
     for (auto [id, client] : m_clients) {
         delete client;
@@ -733,6 +831,18 @@ bool vspserver::check_suspension_point() {
     return true;
 }
 
+void vspserver::notify_suspended() {
+    string notification;
+    for (auto [id, client] : m_clients) {
+        try {
+            if (client->collect_updates(notification))
+                send_notification(id, notification);
+        } catch (std::exception& ex) {
+            log_debug("client%d: %s", id, ex.what());
+        }
+    }
+}
+
 vspserver::vspserver(const string& server_host, u16 server_port):
     rspserver(server_host, server_port, 16),
     suspender("vspserver"),
@@ -769,6 +879,10 @@ vspserver::vspserver(const string& server_host, u16 server_port):
     register_handler("pwrite", &vspserver::handle_pwrite);
     register_handler("setsm", &vspserver::handle_setsm);
     register_handler("arch", &vspserver::handle_arch);
+    register_handler("batch", &vspserver::handle_batch);
+    register_handler("sub", &vspserver::handle_sub);
+    register_handler("unsub", &vspserver::handle_unsub);
+    register_handler("hprof", &vspserver::handle_hprof);
 
     // Create announce file
     ofstream of(m_announce.c_str());
@@ -0,0 +1,424 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#include "vcml/logging/deferred.h"
+
+#include <chrono>
+
+namespace vcml {
+
+void log_args::put(arg_type type, const void* data, size_t size) {
+    if (m_size + 1 + size > CAPACITY) {
+        m_size = CAPACITY; // drop this and all further arguments
+        return;
+    }
+
+    m_data[m_size++] = type;
+    memcpy(m_data + m_size, data, size);
+    m_size += size;
+}
+
+void log_args::put_str(const char* str, size_t len) {
+    if (m_size + 1 + sizeof(u16) > CAPACITY) {
+        m_size = CAPACITY;
+        return;
+    }
+
+    // strings are truncated to whatever space is left
+    u16 n = min<size_t>(len, CAPACITY - m_size - 1 - sizeof(u16));
+    m_data[m_size++] = ARG_STRING;
+    memcpy(m_data + m_size, &n, sizeof(n));
+    memcpy(m_data + m_size + sizeof(n), str, n);
+    m_size += sizeof(n) + n;
+}
+
+class log_args_reader
+{
+private:
+    const u8* m_ptr;
+    const u8* m_end;
+
+public:
+    log_args_reader(const u8* data, size_t size):
+        m_ptr(data), m_end(data + size) {}
+
+    bool next(log_args::arg_type& type, u64& val, string& str) {
+        if (m_ptr >= m_end)
+            return false;
+
+        type = (log_args::arg_type)*m_ptr++;
+        if (type == log_args::ARG_STRING) {
+            u16 n;
+            memcpy(&n, m_ptr, sizeof(n));
+            str.assign((const char*)m_ptr + sizeof(n), n);
+            m_ptr += sizeof(n) + n;
+        } else {
+            memcpy(&val, m_ptr, sizeof(val));
+            m_ptr += sizeof(val);
+        }
+
+        return true;
+    }
+
+    bool next_int(i64& val) {
+        log_args::arg_type type;
+        u64 raw = 0;
+        string str;
+        if (!next(type, raw, str))
+            return false;
+
+        double d;
+        memcpy(&d, &raw, sizeof(d));
+        val = type == log_args::ARG_DOUBLE ? (i64)d : (i64)raw;
+        return type != log_args::ARG_STRING;
+    }
+};
+
+template <typename T>
+static void log_args_append(string& out, const string& spec, T val) {
+    int n = snprintf(nullptr, 0, spec.c_str(), val);
+    if (n <= 0)
+        return;
+
+    size_t pos = out.length();
+    out.resize(pos + n + 1);
+    snprintf(&out[pos], n + 1, spec.c_str(), val);
+    out.resize(pos + n);
+}
+
+string log_args::format(const char* fmt) const {
+    log_args_reader reader(m_data, min<size_t>(m_size, CAPACITY));
+    string out;
+
+    for (const char* p = fmt; *p; p++) {
+        if (*p != '%') {
+            out += *p;
+            continue;
+        }
+
+        if (p[1] == '%') {
+            out += '%';
+            p++;
+            continue;
+        }
+
+        string spec = "%";
+        const char* q = p + 1;
+        while (*q && strchr("-+ #0", *q))
+            spec += *q++;
+
+        i64 star;
+        if (*q == '*') {
+            spec += reader.next_int(star) ? std::to_string(star) : "";
+            q++;
+        }
+
+        while (isdigit((unsigned char)*q))
+            spec += *q++;
+
+        if (*q == '.') {
+            spec += *q++;
+            if (*q == '*') {
+                spec += reader.next_int(star) ? std::to_string(star) : "0";
+                q++;
+            }
+
+            while (isdigit((unsigned char)*q))
+                spec += *q++;
+        }
+
+        // arguments have been widened to 64 bits already
+        while (*q && strchr("hljztLq", *q))
+            q++;
+
+        if (*q == '\0')
+            break;
+
+        p = q;
+        char conv = *q;
+
+        arg_type type;
+        u64 raw = 0;
+        string str;
+        if (!reader.next(type, raw, str)) {
+            out += "<?>";
+            continue;
+        }
+
+        double dbl;
+        memcpy(&dbl, &raw, sizeof(dbl));
+
+        switch (conv) {
+        case 'd':
+        case 'i':
+            if (type == ARG_STRING)
+                out += "<?>";
+            else
+                log_args_append(out, spec + "lld",
+                                type == ARG_DOUBLE ? (long long)dbl
+                                                   : (long long)raw);
+            break;
+
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            if (type == ARG_STRING)
+                out += "<?>";
+            else
+                log_args_append(out, spec + "ll" + conv,
+                                type == ARG_DOUBLE ? (unsigned long long)dbl
+                                                   : (unsigned long long)raw);
+            break;
+
+        case 'c':
+            if (type == ARG_STRING)
+                out += "<?>";
+            else
+                log_args_append(out, spec + "c", (int)raw);
+            break;
+
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if (type == ARG_STRING)
+                out += "<?>";
+            else if (type != ARG_DOUBLE)
+                log_args_append(out, spec + conv,
+                                type == ARG_INT ? (double)(i64)raw
+                                                : (double)raw);
+            else
+                log_args_append(out, spec + conv, dbl);
+            break;
+
+        case 's':
+            if (type == ARG_STRING)
+                log_args_append(out, spec + "s", str.c_str());
+            else
+                out += "<?>";
+            break;
+
+        case 'p':
+            log_args_append(out, spec + "p", (void*)(uintptr_t)raw);
+            break;
+
+        default:
+            out += "<?>";
+            break;
+        }
+    }
+
+    return out;
+}
+
+atomic<u32> log_site::s_burst(10);
+atomic<u64> log_site::s_interval(1000000000ull); // 1s
+
+static atomic<log_site*> g_log_sites(nullptr);
+
+log_site::log_site(const char* file, int line):
+    m_file(file),
+    m_line(line),
+    m_window(0),
+    m_count(0),
+    m_pending(0),
+    m_suppressed(0),
+    m_next(g_log_sites.load()) {
+    while (!g_log_sites.compare_exchange_weak(m_next, this)) {
+        // m_next has been reloaded, try again
+    }
+}
+
+bool log_site::admit(u64 now, u64& dropped) {
+    dropped = 0;
+
+    u32 burst = s_burst.load(std::memory_order_relaxed);
+    if (burst == 0)
+        return true;
+
+    u64 start = m_window.load(std::memory_order_relaxed);
+    u64 interval = s_interval.load(std::memory_order_relaxed);
+    if (now < start || now - start >= interval) {
+        if (m_window.compare_exchange_strong(start, now)) {
+            m_count.store(0, std::memory_order_relaxed);
+            dropped = m_pending.exchange(0);
+        }
+    }
+
+    if (m_count.fetch_add(1, std::memory_order_relaxed) < burst)
+        return true;
+
+    m_pending.fetch_add(dropped + 1);
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    dropped = 0;
+    return false;
+}
+
+void log_site::set_ratelimit(u32 burst, const sc_time& interval) {
+    s_burst = burst;
+    s_interval = time_to_ns(interval);
+}
+
+void log_site::report_suppressed() {
+    for (log_site* site = g_log_sites; site; site = site->m_next) {
+        u64 n = site->m_pending.exchange(0);
+        if (n > 0) {
+            log_warn("suppressed %llu messages from %s:%d, %llu in total", n,
+                     site->m_file, site->m_line, site->suppressed());
+        }
+    }
+}
+
+// single producer, single consumer ring; consumers take the drain lock
+struct log_ring {
+    atomic<size_t> head;
+    atomic<size_t> tail;
+    atomic<bool> orphaned;
+    unique_ptr<log_queue::record[]> records;
+
+    log_ring():
+        head(0),
+        tail(0),
+        orphaned(false),
+        records(new log_queue::record[log_queue::CAPACITY]) {}
+};
+
+struct log_queue_state {
+    mutex mtx;
+    vector<shared_ptr<log_ring>> rings;
+    mutex drain_mtx;
+
+    mutex wake_mtx;
+    condition_variable wake;
+    mutex publisher_mtx;
+    thread publisher;
+
+    static log_queue_state& instance() {
+        static log_queue_state state;
+        return state;
+    }
+};
+
+// marks the ring of an exiting thread, so that the publisher can drop it
+// once it has been drained
+struct log_ring_owner {
+    shared_ptr<log_ring> ring;
+
+    ~log_ring_owner() {
+        if (ring)
+            ring->orphaned = true;
+    }
+};
+
+static thread_local log_ring_owner t_log_ring;
+
+atomic<bool> log_queue::s_async(false);
+
+static void log_queue_run() {
+    mwr::set_thread_name("vcml_log");
+
+    log_queue_state& state = log_queue_state::instance();
+    while (log_queue::is_async()) {
+        log_queue::flush();
+
+        unique_lock<mutex> lock(state.wake_mtx);
+        state.wake.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+void log_queue::start() {
+    log_queue_state& state = log_queue_state::instance();
+    lock_guard<mutex> guard(state.publisher_mtx);
+    if (s_async.exchange(true))
+        return;
+
+    state.publisher = thread(log_queue_run);
+}
+
+void log_queue::stop() {
+    log_queue_state& state = log_queue_state::instance();
+    lock_guard<mutex> guard(state.publisher_mtx);
+    if (!s_async.exchange(false))
+        return;
+
+    state.wake.notify_all();
+    if (state.publisher.joinable())
+        state.publisher.join();
+
+    flush();
+}
+
+void log_queue::flush() {
+    log_queue_state& state = log_queue_state::instance();
+    lock_guard<mutex> drain(state.drain_mtx);
+
+    vector<shared_ptr<log_ring>> rings;
+    {
+        lock_guard<mutex> guard(state.mtx);
+        rings = state.rings;
+    }
+
+    for (auto& ring : rings) {
+        size_t tail = ring->tail.load(std::memory_order_relaxed);
+        size_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            publish(ring->records[tail % CAPACITY]);
+            ring->tail.store(tail + 1, std::memory_order_release);
+        }
+
+        if (ring->orphaned && ring->tail == ring->head) {
+            lock_guard<mutex> guard(state.mtx);
+            stl_remove(state.rings, ring);
+        }
+    }
+}
+
+void log_queue::publish(const record& rec) {
+    string text = rec.args.format(rec.format);
+    if (rec.dropped > 0)
+        text += mkstr("\n(suppressed %llu similar messages)", rec.dropped);
+    rec.sender->publish_at(rec.level, rec.timestamp, rec.site->file(),
+                           rec.site->line(), text);
+}
+
+void log_queue::push(const record& rec) {
+    if (!s_async) {
+        publish(rec);
+        return;
+    }
+
+    if (!t_log_ring.ring) {
+        t_log_ring.ring = std::make_shared<log_ring>();
+        log_queue_state& state = log_queue_state::instance();
+        lock_guard<mutex> guard(state.mtx);
+        state.rings.push_back(t_log_ring.ring);
+    }
+
+    log_ring& ring = *t_log_ring.ring;
+    size_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= CAPACITY) {
+        publish(rec); // queue is full, publisher cannot keep up
+        return;
+    }
+
+    ring.records[head % CAPACITY] = rec;
+    ring.head.store(head + 1, std::memory_order_release);
+
+    if (head == ring.tail.load(std::memory_order_relaxed))
+        log_queue_state::instance().wake.notify_one();
+}
+
+} // namespace vcml
@@ -11,28 +11,61 @@
 #include "vcml/core/module.h"
 #include "vcml/core/systemc.h"
 #include "vcml/logging/logger.h"
+#include "vcml/logging/deferred.h"
 
 namespace vcml {
 
-logger::logger(): mwr::logger(), m_parent(nullptr) {
+static const log_level* logger_level(module* parent) {
+    return parent ? &parent->loglvl.get() : nullptr;
+}
+
+logger::logger(): mwr::logger(), m_level(nullptr) {
 }
 
 logger::logger(sc_object* parent):
-    mwr::logger(parent->name()), m_parent(hierarchy_search<module>(parent)) {
+    mwr::logger(parent->name()),
+    m_level(logger_level(hierarchy_search<module>(parent))) {
 }
 
 logger::logger(const string& name):
-    mwr::logger(name), m_parent(hierarchy_search<module>()) {
+    mwr::logger(name), m_level(logger_level(hierarchy_search<module>())) {
+}
+
+logger::~logger() {
+    // deferred records still refer to us
+    if (log_queue::is_async())
+        log_queue::flush();
 }
 
-bool logger::can_log(log_level lvl) const {
-    log_level mylvl = m_parent ? m_parent->loglvl : level();
-    return lvl <= mylvl;
+static thread_local const u64* t_log_timestamp = nullptr;
+
+void logger::publish_at(log_level lvl, u64 timestamp_ns, const char* file,
+                        int line, const string& text) {
+    t_log_timestamp = &timestamp_ns;
+
+    switch (lvl) {
+    case LOG_ERROR:
+        error(file, line, "%s", text.c_str());
+        break;
+    case LOG_WARN:
+        warn(file, line, "%s", text.c_str());
+        break;
+    case LOG_INFO:
+        info(file, line, "%s", text.c_str());
+        break;
+    default:
+        debug(file, line, "%s", text.c_str());
+        break;
+    }
+
+    t_log_timestamp = nullptr;
 }
 
 logger log; // global default logger
 
 u64 log_systemc_time() {
+    if (t_log_timestamp)
+        return *t_log_timestamp;
     return time_to_ns(sc_time_stamp());
 }
 
@@ -61,6 +61,12 @@ static string default_serial() {
 disk::disk(const sc_module_name& nm, const string& img, bool ro, bool wi):
     module(nm),
     m_backend(nullptr),
+    m_bytes_read("vcml_disk_read_bytes_total", "Bytes read from disk",
+                 { { "disk", name() } },
+                 [this]() -> u64 { return stats.num_bytes_read; }),
+    m_bytes_written("vcml_disk_written_bytes_total", "Bytes written to disk",
+                    { { "disk", name() } },
+                    [this]() -> u64 { return stats.num_bytes_written; }),
     stats(),
     image("image", img),
     serial("serial", default_serial()),
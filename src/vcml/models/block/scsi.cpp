@@ -75,6 +75,8 @@ bool scsi_command_transfers_to_device(u8 opcode) {
     switch (opcode) {
     case SCSI_WRITE_10:
     case SCSI_WRITE_12:
+    case SCSI_WRITE_SAME_10:
+    case SCSI_WRITE_SAME_16:
     case SCSI_MODE_SELECT:
     case SCSI_FORMAT_UNIT:
         return true;
@@ -125,6 +127,14 @@ const scsi_sense SENSE_ILLEGAL_FIELD{ SCSI_ILLEGAL_REQUEST, 0x24, 0x00 };
 const scsi_sense SENSE_ILLEGAL_PARAM{ SCSI_ILLEGAL_REQUEST, 0x26, 0x00 };
 const scsi_sense SENSE_UNIT_ATTENTION{ SCSI_UNIT_ATTENTION, 0x28, 0x00 };
 const scsi_sense SENSE_DATA_PROTECT{ SCSI_DATA_PROTECT, 0x27, 0x00 };
+const scsi_sense SENSE_OVERLAPPED_CMD{ SCSI_ABORTED_COMMAND, 0x4e, 0x00 };
+
+size_t scsi_buffers_size(const scsi_request& req) {
+    size_t size = 0;
+    for (const scsi_span& buf : req.buffers)
+        size += buf.size;
+    return size;
+}
 
 u64 scsi_read(const u8* ptr, size_t len) {
     VCML_ERROR_ON(len > 8, "attempt to read more than 8 bytes");
@@ -415,9 +425,16 @@ scsi_response scsi_disk::scsi_handle_read(scsi_request& req, bool is12) {
         return SCSI_CHECK_CONDITION;
     }
 
-    req.payload.assign(len, 0);
+    if (!seek(off)) {
+        m_sense = SENSE_MEDIUM_ERROR;
+        return SCSI_CHECK_CONDITION;
+    }
+
+    if (!req.buffers.empty())
+        return scsi_read_buffers(req, len);
 
-    if (!seek(off) || !read(req.payload.data(), req.payload.size())) {
+    req.payload.resize(len);
+    if (!read(req.payload.data(), req.payload.size())) {
         m_sense = SENSE_MEDIUM_ERROR;
         return SCSI_CHECK_CONDITION;
     }
@@ -443,16 +460,93 @@ scsi_response scsi_disk::scsi_handle_write(scsi_request& req, bool is12) {
         return SCSI_CHECK_CONDITION;
     }
 
-    if (writeignore)
+    if (writeignore) {
+        req.length = min(len, scsi_buffers_size(req));
         return SCSI_GOOD;
+    }
+
+    if (!seek(off)) {
+        m_sense = SENSE_MEDIUM_ERROR;
+        return SCSI_CHECK_CONDITION;
+    }
 
-    if (seek(off) && write(req.payload.data(), req.payload.size()))
+    if (!req.buffers.empty())
+        return scsi_write_buffers(req, len);
+
+    if (write(req.payload.data(), req.payload.size()))
         return SCSI_GOOD;
 
     m_sense = SENSE_MEDIUM_ERROR;
     return SCSI_CHECK_CONDITION;
 }
 
+scsi_response scsi_disk::scsi_read_buffers(scsi_request& req, size_t len) {
+    if (scsi_buffers_size(req) < len) {
+        log_warn("read buffers too small: %zu/%zu", scsi_buffers_size(req),
+                 len);
+        m_sense = SENSE_ILLEGAL_FIELD;
+        return SCSI_CHECK_CONDITION;
+    }
+
+    for (const scsi_span& buf : req.buffers) {
+        if (req.length >= len)
+            break;
+
+        size_t n = min(buf.size, len - req.length);
+        if (!read(buf.data, n)) {
+            m_sense = SENSE_MEDIUM_ERROR;
+            return SCSI_CHECK_CONDITION;
+        }
+
+        req.length += n;
+    }
+
+    return SCSI_GOOD;
+}
+
+scsi_response scsi_disk::scsi_write_buffers(scsi_request& req, size_t len) {
+    if (scsi_buffers_size(req) < len) {
+        log_warn("write buffers too small: %zu/%zu", scsi_buffers_size(req),
+                 len);
+        m_sense = SENSE_ILLEGAL_FIELD;
+        return SCSI_CHECK_CONDITION;
+    }
+
+    for (const scsi_span& buf : req.buffers) {
+        if (req.length >= len)
+            break;
+
+        size_t n = min(buf.size, len - req.length);
+        if (!write(buf.data, n)) {
+            m_sense = SENSE_MEDIUM_ERROR;
+            return SCSI_CHECK_CONDITION;
+        }
+
+        req.length += n;
+    }
+
+    return SCSI_GOOD;
+}
+
+void scsi_disk::scsi_gather(scsi_request& req) {
+    req.payload.resize(scsi_buffers_size(req));
+    for (const scsi_span& buf : req.buffers) {
+        memcpy(req.payload.data() + req.length, buf.data, buf.size);
+        req.length += buf.size;
+    }
+}
+
+void scsi_disk::scsi_scatter(scsi_request& req) {
+    for (const scsi_span& buf : req.buffers) {
+        if (req.length >= req.payload.size())
+            break;
+
+        size_t n = min(buf.size, req.payload.size() - req.length);
+        memcpy(buf.data, req.payload.data() + req.length, n);
+        req.length += n;
+    }
+}
+
 static bool is_zero(const vector<u8>& data) {
     for (u8 byte : data) {
         if (byte)
@@ -515,6 +609,9 @@ scsi_disk::scsi_disk(const sc_module_name& nm, const string& image,
                      bool readonly, bool writeignore, bool remov):
     disk(nm, image, readonly, writeignore),
     m_sense(SENSE_NOTHING),
+    m_tasks(),
+    m_taskev("taskev"),
+    m_spawned(false),
     removable("removable", remov),
     blockbits("blockbits", 9),
     device_wwn("device_wwn", 0),
@@ -522,7 +619,8 @@ scsi_disk::scsi_disk(const sc_module_name& nm, const string& image,
     port_idx("port_idx", 0),
     vendor("vendor", "MWARE"),
     product("product", "VCML-SCSIDRIVE"),
-    revision("revision", "1.0") {
+    revision("revision", "1.0"),
+    queue_depth("queue_depth", 32) {
     // nothing to do
 }
 
@@ -530,7 +628,93 @@ scsi_disk::~scsi_disk() {
     // nothing to do
 }
 
+static bool scsi_is_read_write(u8 opcode) {
+    switch (opcode) {
+    case SCSI_READ_10:
+    case SCSI_READ_12:
+    case SCSI_WRITE_10:
+    case SCSI_WRITE_12:
+        return true;
+    default:
+        return false;
+    }
+}
+
 scsi_response scsi_disk::scsi_handle_command(scsi_request& req) {
+    u8 opcode = req.command[0];
+    req.length = 0;
+
+    // only READ and WRITE access attached buffers directly, all other
+    // commands still operate on the payload vector
+    bool staged = !req.buffers.empty() && !scsi_is_read_write(opcode);
+    if (staged && scsi_command_transfers_to_device(opcode))
+        scsi_gather(req);
+    else if (staged)
+        req.payload.clear();
+
+    scsi_response resp = scsi_execute(req);
+
+    if (staged && scsi_command_transfers_from_device(opcode)) {
+        req.length = 0;
+        scsi_scatter(req);
+    }
+
+    return resp;
+}
+
+scsi_response scsi_disk::scsi_submit(scsi_request& req, scsi_callback done) {
+    if (m_tasks.size() >= queue_depth)
+        return SCSI_TASK_SET_FULL;
+
+    for (const scsi_task& task : m_tasks) {
+        if (task.req->tag == req.tag) {
+            log_warn("overlapped command with tag %u", req.tag);
+            m_sense = SENSE_OVERLAPPED_CMD;
+            return SCSI_CHECK_CONDITION;
+        }
+    }
+
+    // the worker is only spawned for disks that actually queue commands
+    if (!m_spawned) {
+        string name = mkstr("%s_tasks", basename());
+        sc_spawn([&]() -> void { scsi_task_thread(); }, name.c_str());
+        m_spawned = true;
+    }
+
+    m_tasks.push_back({ &req, std::move(done) });
+    m_taskev.notify(SC_ZERO_TIME);
+    return SCSI_GOOD;
+}
+
+bool scsi_disk::scsi_abort(u32 tag) {
+    for (auto it = m_tasks.begin(); it != m_tasks.end(); it++) {
+        if (it->req->tag == tag) {
+            scsi_task task = *it;
+            m_tasks.erase(it);
+            if (task.done)
+                task.done(*task.req, SCSI_TASK_ABORTED);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void scsi_disk::scsi_task_thread() {
+    while (true) {
+        while (m_tasks.empty())
+            wait(m_taskev);
+
+        scsi_task task = m_tasks.front();
+        m_tasks.pop_front();
+
+        scsi_response resp = scsi_handle_command(*task.req);
+        if (task.done)
+            task.done(*task.req, resp);
+    }
+}
+
+scsi_response scsi_disk::scsi_execute(scsi_request& req) {
     log_debug("received command %s", scsi_command_str(req.command[0]));
     switch (req.command[0]) {
     case SCSI_TEST_UNIT_READY: {
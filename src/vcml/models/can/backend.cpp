@@ -12,6 +12,8 @@
 #include "vcml/models/can/backend.h"
 #include "vcml/models/can/backend_file.h"
 #include "vcml/models/can/backend_tcp.h"
+#include "vcml/models/can/backend_pcap.h"
+#include "vcml/models/can/backend_replay.h"
 
 #ifdef HAVE_SOCKETCAN
 #include "vcml/models/can/backend_socket.h"
@@ -47,6 +49,8 @@ void backend::define(const string& type, create_fn fn) {
 
 VCML_DEFINE_CAN_BACKEND(file, backend_file::create)
 VCML_DEFINE_CAN_BACKEND(tcp, backend_tcp::create)
+VCML_DEFINE_CAN_BACKEND(pcap, backend_pcap::create)
+VCML_DEFINE_CAN_BACKEND(replay, backend_replay::create)
 #ifdef HAVE_SOCKETCAN
 VCML_DEFINE_CAN_BACKEND(socket, backend_socket::create)
 #endif
@@ -160,5 +164,130 @@ void deserialize(can_frame& f, const recv_fn& recv) {
     recv(f.data.data(), f.data.size());
 }
 
+enum socketcan_flags : u32 {
+    SOCKETCAN_EFF = bit(31),
+    SOCKETCAN_RTR = bit(30),
+    SOCKETCAN_ERR = bit(29),
+    SOCKETCAN_FD_BRS = bit(0),
+    SOCKETCAN_FD_ESI = bit(1),
+    SOCKETCAN_FD_FDF = bit(2),
+    SOCKETCAN_XL_SEC = bit(0),
+    SOCKETCAN_XL_RRS = bit(1),
+    SOCKETCAN_XL_XLF = bit(7),
+};
+
+enum socketcan_sizes : size_t {
+    SOCKETCAN_HDR_SIZE = 8,
+    SOCKETCAN_XL_HDR_SIZE = 12,
+    SOCKETCAN_FD_MAX_LEN = 64,
+};
+
+// CAN CC/FD headers store the identifier in big endian, followed by length,
+// FD flags, two reserved bytes (the last one holding the DLC of 8 byte CAN
+// CC frames with a DLC > 8) and payload; CAN XL headers use little endian
+// and are identified by XLF being set where CC/FD keep the payload length
+void to_socketcan(const can_frame& f, vector<u8>& raw) {
+    if (f.is_canxl()) {
+        u32 prio = cpu_to_le32((f.canid & CAN_MSG_ID_SID) | (u32)f.vcid << 16);
+        u16 len = cpu_to_le16(f.length());
+        u32 af = cpu_to_le32(f.af);
+
+        raw.resize(SOCKETCAN_XL_HDR_SIZE + f.length());
+        memcpy(raw.data() + 0, &prio, sizeof(prio));
+        raw[4] = SOCKETCAN_XL_XLF;
+        if (f.sec)
+            raw[4] |= SOCKETCAN_XL_SEC;
+        if (f.rrs)
+            raw[4] |= SOCKETCAN_XL_RRS;
+        raw[5] = f.sdt;
+        memcpy(raw.data() + 6, &len, sizeof(len));
+        memcpy(raw.data() + 8, &af, sizeof(af));
+        memcpy(raw.data() + SOCKETCAN_XL_HDR_SIZE, f.data.data(), f.length());
+        return;
+    }
+
+    u32 id = f.id();
+    if (f.eff)
+        id |= SOCKETCAN_EFF;
+    if (f.rtr)
+        id |= SOCKETCAN_RTR;
+    if (f.err)
+        id |= SOCKETCAN_ERR;
+    id = cpu_to_be32(id);
+
+    size_t len = min<size_t>(f.length(), SOCKETCAN_FD_MAX_LEN);
+    raw.assign(SOCKETCAN_HDR_SIZE + len, 0);
+    memcpy(raw.data(), &id, sizeof(id));
+    raw[4] = len;
+
+    if (f.is_canfd()) {
+        raw[5] = SOCKETCAN_FD_FDF;
+        if (f.brs)
+            raw[5] |= SOCKETCAN_FD_BRS;
+        if (f.esi)
+            raw[5] |= SOCKETCAN_FD_ESI;
+    } else if (len == 8 && f.dlc > 8) {
+        raw[7] = f.dlc;
+    }
+
+    memcpy(raw.data() + SOCKETCAN_HDR_SIZE, f.data.data(), len);
+}
+
+bool from_socketcan(can_frame& f, const u8* raw, size_t size) {
+    f = can_frame();
+
+    if (size >= SOCKETCAN_XL_HDR_SIZE && (raw[4] & SOCKETCAN_XL_XLF)) {
+        u32 prio, af;
+        u16 len;
+        memcpy(&prio, raw + 0, sizeof(prio));
+        memcpy(&len, raw + 6, sizeof(len));
+        memcpy(&af, raw + 8, sizeof(af));
+        prio = le32_to_cpu(prio);
+        len = le16_to_cpu(len);
+        if (len == 0 || size < SOCKETCAN_XL_HDR_SIZE + len)
+            return false;
+
+        f.xlf = 1;
+        f.canid = prio & CAN_MSG_ID_SID;
+        f.vcid = (prio >> 16) & 0xff;
+        f.sec = !!(raw[4] & SOCKETCAN_XL_SEC);
+        f.rrs = !!(raw[4] & SOCKETCAN_XL_RRS);
+        f.sdt = raw[5];
+        f.af = le32_to_cpu(af);
+        f.dlc = len2dlc(len, true);
+        f.data.assign(raw + SOCKETCAN_XL_HDR_SIZE,
+                      raw + SOCKETCAN_XL_HDR_SIZE + len);
+        return true;
+    }
+
+    if (size < SOCKETCAN_HDR_SIZE)
+        return false;
+
+    u32 id;
+    memcpy(&id, raw, sizeof(id));
+    id = be32_to_cpu(id);
+
+    size_t len = raw[4];
+    if (len > SOCKETCAN_FD_MAX_LEN || size < SOCKETCAN_HDR_SIZE + len)
+        return false;
+
+    f.eff = !!(id & SOCKETCAN_EFF);
+    f.rtr = !!(id & SOCKETCAN_RTR);
+    f.err = !!(id & SOCKETCAN_ERR);
+    f.canid = id & (f.eff ? CAN_MSG_ID_EID : CAN_MSG_ID_SID);
+    f.fdf = (raw[5] & SOCKETCAN_FD_FDF) || len > 8;
+    if (f.fdf) {
+        f.brs = !!(raw[5] & SOCKETCAN_FD_BRS);
+        f.esi = !!(raw[5] & SOCKETCAN_FD_ESI);
+    }
+
+    f.dlc = len2dlc(len);
+    if (!f.fdf && len == 8 && raw[7] > 8 && raw[7] < 16)
+        f.dlc = raw[7];
+
+    f.data.assign(raw + SOCKETCAN_HDR_SIZE, raw + SOCKETCAN_HDR_SIZE + len);
+    return true;
+}
+
 } // namespace can
 } // namespace vcml
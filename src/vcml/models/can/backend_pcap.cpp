@@ -0,0 +1,54 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/models/can/backend_pcap.h"
+
+namespace vcml {
+namespace can {
+
+void backend_pcap::capture(const can_frame& frame, pcap_direction dir) {
+    to_socketcan(frame, m_raw);
+    m_writer.write(sc_time_stamp(), m_raw.data(), m_raw.size(), dir);
+}
+
+backend_pcap::backend_pcap(bridge* br, const string& path, u64 rotate):
+    backend(br),
+    m_writer(path, PCAP_LINKTYPE_CAN_SOCKETCAN, br->name(), rotate),
+    m_raw() {
+    m_type = mkstr("pcap:%s", path.c_str());
+}
+
+backend_pcap::~backend_pcap() {
+    log_debug("captured %zu frames into %zu file(s)", m_writer.packets(),
+              m_writer.files());
+}
+
+void backend_pcap::send_to_host(const can_frame& frame) {
+    capture(frame, PCAP_OUTBOUND);
+}
+
+void backend_pcap::monitor_to_guest(const can_frame& frame) {
+    capture(frame, PCAP_INBOUND);
+}
+
+backend* backend_pcap::create(bridge* br, const vector<string>& args) {
+    string path = mkstr("%s.pcapng", br->name());
+    if (!args.empty())
+        path = args[0];
+
+    u64 rotate = 0;
+    if (args.size() > 1)
+        rotate = from_string<u64>(args[1]);
+
+    return new backend_pcap(br, path, rotate);
+}
+
+} // namespace can
+} // namespace vcml
@@ -0,0 +1,47 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_CAN_BACKEND_PCAP_H
+#define VCML_CAN_BACKEND_PCAP_H
+
+#include "vcml/core/types.h"
+#include "vcml/core/systemc.h"
+
+#include "vcml/logging/logger.h"
+#include "vcml/tracing/pcap.h"
+
+#include "vcml/models/can/backend.h"
+#include "vcml/models/can/bridge.h"
+
+namespace vcml {
+namespace can {
+
+class backend_pcap : public backend
+{
+private:
+    pcap_writer m_writer;
+    vector<u8> m_raw;
+
+    void capture(const can_frame& frame, pcap_direction dir);
+
+public:
+    backend_pcap(bridge* br, const string& path, u64 rotate);
+    virtual ~backend_pcap();
+
+    virtual void send_to_host(const can_frame& frame) override;
+    virtual void monitor_to_guest(const can_frame& frame) override;
+
+    static backend* create(bridge* br, const vector<string>& args);
+};
+
+} // namespace can
+} // namespace vcml
+
+#endif
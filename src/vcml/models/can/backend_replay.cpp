@@ -0,0 +1,72 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/models/can/backend_replay.h"
+
+namespace vcml {
+namespace can {
+
+void backend_replay::schedule() {
+    while (m_reader.next(m_next)) {
+        if (m_next.linktype != PCAP_LINKTYPE_CAN_SOCKETCAN)
+            continue;
+        if (m_next.direction == PCAP_OUTBOUND)
+            continue;
+
+        const vector<u8>& raw = m_next.data;
+        if (!from_socketcan(m_frame, raw.data(), raw.size())) {
+            log_warn("skipping malformed CAN frame in %s",
+                     m_reader.path().c_str());
+            continue;
+        }
+
+        sc_time now = sc_time_stamp();
+        m_timer.reset(m_next.timestamp > now ? m_next.timestamp - now
+                                             : SC_ZERO_TIME);
+        return;
+    }
+
+    log_debug("replay of %s finished after %zu frames",
+              m_reader.path().c_str(), m_count);
+}
+
+void backend_replay::replay() {
+    send_to_guest(std::move(m_frame));
+    m_count++;
+    schedule();
+}
+
+backend_replay::backend_replay(bridge* br, const string& path):
+    backend(br),
+    m_reader(path),
+    m_next(),
+    m_frame(),
+    m_timer([&](async_timer&) -> void { replay(); }),
+    m_count(0) {
+    m_type = mkstr("replay:%s", path.c_str());
+    schedule();
+}
+
+backend_replay::~backend_replay() {
+    m_timer.cancel();
+}
+
+void backend_replay::send_to_host(const can_frame& frame) {
+    // replayed traffic does not react to the guest
+}
+
+backend* backend_replay::create(bridge* br, const vector<string>& args) {
+    if (args.empty())
+        VCML_REPORT("usage: replay:<file>");
+    return new backend_replay(br, args[0]);
+}
+
+} // namespace can
+} // namespace vcml
@@ -0,0 +1,54 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_CAN_BACKEND_REPLAY_H
+#define VCML_CAN_BACKEND_REPLAY_H
+
+#include "vcml/core/types.h"
+#include "vcml/core/systemc.h"
+
+#include "vcml/logging/logger.h"
+#include "vcml/tracing/pcap.h"
+
+#include "vcml/models/can/backend.h"
+#include "vcml/models/can/bridge.h"
+
+namespace vcml {
+namespace can {
+
+// Injects the inbound frames of a SocketCAN pcap or pcapng file into the
+// guest at their recorded simulation time, see ethernet::backend_replay.
+class backend_replay : public backend
+{
+private:
+    pcap_reader m_reader;
+    pcap_reader::packet m_next;
+    can_frame m_frame;
+    async_timer m_timer;
+    size_t m_count;
+
+    void schedule();
+    void replay();
+
+public:
+    size_t count() const { return m_count; }
+
+    backend_replay(bridge* br, const string& path);
+    virtual ~backend_replay();
+
+    virtual void send_to_host(const can_frame& frame) override;
+
+    static backend* create(bridge* br, const vector<string>& args);
+};
+
+} // namespace can
+} // namespace vcml
+
+#endif
@@ -72,6 +72,8 @@ void bridge::can_transmit() {
         while (!m_rx.empty()) {
             can_frame frame = std::move(m_rx.front());
             m_rx.pop();
+            for (backend* b : m_backends)
+                b->monitor_to_guest(frame);
             can_tx.send(frame);
         }
     }
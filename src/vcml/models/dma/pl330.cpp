@@ -293,6 +293,9 @@ static void pl330_insn_dmago(pl330* dma, pl330::channel* ch, u8 opcode,
     set_bit<CSR_CNS>(channel.csr, ns);
     channel.cpc = pc;
     channel.set_state(CHS_EXECUTING);
+
+    // software may have placed a new program at an address seen before
+    dma->icache.invalidate();
 }
 
 static void pl330_insn_dmakill(pl330* dma, pl330::channel* ch, u8 opcode,
@@ -762,6 +765,121 @@ static const insn_descr* find_insn(u8 opcode, const insn_descr (&insns)[N]) {
     return nullptr;
 }
 
+static const insn_descr* fetch_cached(pl330& dma, u32 pc, u8* code) {
+    const pl330::insn_cache::entry* entry = dma.icache.lookup(pc);
+    if (!entry) {
+        pl330::insn_cache::entry fresh{};
+        if (failed(dma.dma.read(pc, fresh.code, 1)))
+            return nullptr;
+
+        const insn_descr* insn = find_insn(fresh.code[0], CH_INSN_DESCR);
+        if (!insn)
+            return nullptr;
+
+        if (insn->size > 1 &&
+            failed(dma.dma.read(pc + 1, fresh.code + 1, insn->size - 1)))
+            return nullptr;
+
+        fresh.size = insn->size;
+        fresh.index = insn - CH_INSN_DESCR;
+        entry = &dma.icache.insert(pc, fresh);
+    }
+
+    // copy out, executing the instruction may invalidate the cache
+    memcpy(code, entry->code, entry->size);
+    return &CH_INSN_DESCR[entry->index];
+}
+
+// Completes the remaining iterations of a plain copy loop in one go, i.e. a
+// loop whose body only holds a DMALD followed by a DMAST with incrementing
+// addresses, if both source and destination are DMI-capable memory. The
+// loop counter is cleared afterwards so that DMALPEND falls through.
+static bool collapse_loop(pl330& dma, pl330::channel& ch, u32 pc,
+                          const u8* code) {
+    bool nf = code[0] & 0b1'0000;
+    bool lc = code[0] & 0b100;
+    u8 bs = code[0] & 0b11;
+    u32 iterations = lc ? ch.lc1 : ch.lc0;
+    if (!nf || bs != 0 || iterations == 0)
+        return false;
+
+    if (!(ch.ccr & CCR_SRC_INC) || !(ch.ccr & CCR_DST_INC) ||
+        ch.ccr.get_field<CCR_ENDIAN_SWAP_SIZE>() != 0)
+        return false;
+
+    u32 src_size = bit(ch.ccr.get_field<CCR_SRC_BURST_SIZE>());
+    u32 dst_size = bit(ch.ccr.get_field<CCR_DST_BURST_SIZE>());
+    u32 src_burst = src_size * (ch.ccr.get_field<CCR_SRC_BURST_LEN>() + 1);
+    u32 dst_burst = dst_size * (ch.ccr.get_field<CCR_DST_BURST_LEN>() + 1);
+    if (src_burst != dst_burst || (ch.sar & (src_size - 1)) ||
+        (ch.dar & (dst_size - 1)))
+        return false;
+
+    // data of earlier iterations must have been written out completely
+    if (!dma.mfifo.empty(ch.chid) || !dma.read_queue.empty(ch.chid) ||
+        !dma.write_queue.empty(ch.chid))
+        return false;
+
+    bool ld = false, st = false;
+    for (u32 addr = pc - code[1]; addr < pc;) {
+        u8 body[PL330_INSN_MAXSIZE];
+        const insn_descr* insn = fetch_cached(dma, addr, body);
+        if (!insn)
+            return false;
+
+        switch (body[0]) {
+        case 0x04: // DMALD
+            if (ld || st)
+                return false;
+            ld = true;
+            break;
+
+        case 0x08: // DMAST
+            if (!ld || st)
+                return false;
+            st = true;
+            break;
+
+        case 0x12: // DMARMB
+        case 0x13: // DMAWMB
+        case 0x18: // DMANOP
+            break;
+
+        default:
+            return false;
+        }
+
+        addr += insn->size;
+    }
+
+    u64 len = (u64)iterations * src_burst;
+    if (!ld || !st || ch.sar + len > 1ull << 32 ||
+        ch.dar + len > 1ull << 32)
+        return false;
+
+    range src(ch.sar, ch.sar + len - 1);
+    range dst(ch.dar, ch.dar + len - 1);
+    if (src.overlaps(dst))
+        return false;
+
+    const u8* src_ptr = dma.dma.lookup_dmi_ptr(src, VCML_ACCESS_READ);
+    u8* dst_ptr = dma.dma.lookup_dmi_ptr(dst, VCML_ACCESS_WRITE);
+    if (!src_ptr || !dst_ptr)
+        return false;
+
+    memcpy(dst_ptr, src_ptr, len);
+    dma.icache.invalidate(dst);
+
+    ch.sar += (u32)len;
+    ch.dar += (u32)len;
+    if (lc)
+        ch.lc1 = 0;
+    else
+        ch.lc0 = 0;
+
+    return true;
+}
+
 template <size_t N>
 static const insn_descr* fetch_and_exec(pl330& dma, pl330::channel* channel,
                                         u32 pc,
@@ -791,12 +909,18 @@ static int channel_execute_one_insn(pl330& dma, pl330::channel& channel) {
 
     channel.stall = false;
 
-    auto insn = fetch_and_exec(dma, &channel, channel.cpc, CH_INSN_DESCR);
+    u8 insn_buf[PL330_INSN_MAXSIZE];
+    const insn_descr* insn = fetch_cached(dma, channel.cpc, insn_buf);
     if (!insn) {
         pl330_handle_ch_fault(dma, channel, FTR_INSTR_FETCH_ERR);
         return 0;
     }
 
+    if (insn->exec == pl330_insn_dmalpend)
+        collapse_loop(dma, channel, channel.cpc, insn_buf);
+
+    insn->exec(&dma, &channel, insn_buf[0], &insn_buf[1], insn->size - 1);
+
     if (!channel.stall && !channel.is_state(CHS_STOPPED)) {
         channel.cpc += insn->size;
         channel.watchdog_timer = 0;
@@ -813,73 +937,68 @@ static int channel_execute_one_insn(pl330& dma, pl330::channel& channel) {
 }
 
 static u32 process_read_queue(pl330& dma, pl330::channel& channel) {
-    if (!dma.read_queue.empty() &&
-        dma.read_queue.front().data_len <= dma.mfifo.num_free()) {
-        auto& insn = dma.read_queue.front();
-        u32 len = insn.data_len * insn.burst_len_counter;
-        // crop length in case of an unaligned address
-        len = len - (insn.data_addr & (insn.data_len - 1));
-
-        u8 data[PL330_MAX_BURST_LEN];
-        if (insn.inc || insn.burst_len_counter == 1) {
-            if (failed(dma.dma.read(insn.data_addr, data, len)))
-                dma.log.error("DMA channel read failed");
-        } else {
-            // stream I/O reads
-            tlm_generic_payload tx;
-            tx_setup(tx, TLM_READ_COMMAND, insn.data_addr, data, len);
-            tx.set_streaming_width(insn.data_len);
-            if (failed(dma.dma.send(tx)))
-                dma.log.error("DMA channel read failed");
-        }
+    if (dma.read_queue.empty())
+        return 0;
 
-        if (dma.mfifo.num_free() >= len) {
-            for (u32 i = 0; i < len; i++) {
-                pl330::mfifo_entry entry{ data[i], (u8)channel.chid };
-                dma.mfifo.push(entry);
-            }
+    auto& insn = dma.read_queue.front();
+    u32 len = insn.data_len * insn.burst_len_counter;
+    // crop length in case of an unaligned address
+    len = len - (insn.data_addr & (insn.data_len - 1));
+    if (len > dma.mfifo.num_free())
+        return 0;
 
-            dma.read_queue.pop();
-            return 1;
-        }
+    u8 data[PL330_MAX_BURST_LEN];
+    if (insn.inc || insn.burst_len_counter == 1) {
+        if (failed(dma.dma.read(insn.data_addr, data, len)))
+            VCML_LOG_RATELIMITED(dma.log, LOG_ERROR,
+                                 "DMA channel read failed");
+    } else {
+        // stream I/O reads
+        tlm_generic_payload tx;
+        tx_setup(tx, TLM_READ_COMMAND, insn.data_addr, data, len);
+        tx.set_streaming_width(insn.data_len);
+        if (failed(dma.dma.send(tx)))
+            VCML_LOG_RATELIMITED(dma.log, LOG_ERROR,
+                                 "DMA channel read failed");
     }
 
-    return 0;
+    dma.mfifo.push(insn.tag, data, len);
+    dma.read_queue.pop();
+    return 1;
 }
 
 static u32 process_write_queue(pl330& dma, pl330::channel& channel) {
-    if (!dma.write_queue.empty() && dma.mfifo.front().tag == channel.chid) {
-        auto& insn = dma.write_queue.front();
-        int len = insn.data_len * insn.burst_len_counter;
-        // crop length in case of an unaligned address
-        len = len - (insn.data_addr & (insn.data_len - 1));
-
-        u8 data[PL330_MAX_BURST_LEN];
-        if (insn.zero_flag)
-            std::fill_n(data, len, 0);
-        else {
-            assert(len <= static_cast<int>(dma.mfifo.size()));
-            std::generate_n(data, len,
-                            [&]() { return dma.mfifo.pop().value().buf; });
-        }
-
-        if (insn.inc || insn.burst_len_counter == 1) {
-            if (failed(dma.dma.write(insn.data_addr, data, len)))
-                dma.log.error("DMA channel write failed");
-        } else {
-            // stream I/O writes
-            tlm_generic_payload tx;
-            tx_setup(tx, TLM_WRITE_COMMAND, insn.data_addr, data, len);
-            tx.set_streaming_width(insn.data_len);
-            if (failed(dma.dma.send(tx)))
-                dma.log.error("DMA channel write failed");
-        }
+    if (dma.write_queue.empty())
+        return 0;
 
-        dma.write_queue.pop();
-        return 1;
+    auto& insn = dma.write_queue.front();
+    u32 len = insn.data_len * insn.burst_len_counter;
+    // crop length in case of an unaligned address
+    len = len - (insn.data_addr & (insn.data_len - 1));
+
+    u8 data[PL330_MAX_BURST_LEN];
+    if (insn.zero_flag)
+        std::fill_n(data, len, 0);
+    else if (!dma.mfifo.pop(insn.tag, data, len))
+        return 0; // wait for the burst to arrive in the mfifo
+
+    if (insn.inc || insn.burst_len_counter == 1) {
+        if (failed(dma.dma.write(insn.data_addr, data, len)))
+            VCML_LOG_RATELIMITED(dma.log, LOG_ERROR,
+                                 "DMA channel write failed");
+    } else {
+        // stream I/O writes
+        tlm_generic_payload tx;
+        tx_setup(tx, TLM_WRITE_COMMAND, insn.data_addr, data, len);
+        tx.set_streaming_width(insn.data_len);
+        if (failed(dma.dma.send(tx)))
+            VCML_LOG_RATELIMITED(dma.log, LOG_ERROR,
+                                 "DMA channel write failed");
     }
 
-    return 0;
+    dma.icache.invalidate(range(insn.data_addr, insn.data_addr + len - 1));
+    dma.write_queue.pop();
+    return 1;
 }
 
 void pl330::run_channels() {
@@ -1052,6 +1171,7 @@ void pl330::reset() {
     read_queue.reset();
     write_queue.reset();
     mfifo.reset();
+    icache.invalidate();
 
     // reset id registers
     for (size_t i = 0; i < periph_id.count(); i++)
@@ -1061,6 +1181,13 @@ void pl330::reset() {
         pcell_id[i] = (AMBA_CID >> (i * 8)) & 0xff;
 }
 
+void pl330::invalidate_direct_mem_ptr(tlm_initiator_socket& origin, u64 start,
+                                      u64 end) {
+    peripheral::invalidate_direct_mem_ptr(origin, start, end);
+    if (&origin == &dma)
+        icache.invalidate(range(start, end));
+}
+
 pl330::pl330(const sc_module_name& nm):
     peripheral(nm),
     enable_periph("enable_periph", false),
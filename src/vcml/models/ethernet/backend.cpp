@@ -11,6 +11,8 @@
 #include "vcml/models/ethernet/bridge.h"
 #include "vcml/models/ethernet/backend.h"
 #include "vcml/models/ethernet/backend_file.h"
+#include "vcml/models/ethernet/backend_pcap.h"
+#include "vcml/models/ethernet/backend_replay.h"
 
 #ifdef HAVE_TAP
 #include "vcml/models/ethernet/backend_tap.h"
@@ -36,6 +38,10 @@ void backend::send_to_guest(eth_frame frame) {
     m_parent->send_to_guest(std::move(frame));
 }
 
+void backend::send_to_guest(vector<eth_frame>& frames) {
+    m_parent->send_to_guest(frames);
+}
+
 static unordered_map<string, backend::create_fn>& all_backends() {
     static unordered_map<string, backend::create_fn> instance;
     return instance;
@@ -49,6 +55,8 @@ void backend::define(const string& type, create_fn create) {
 }
 
 VCML_DEFINE_ETHERNET_BACKEND(file, backend_file::create)
+VCML_DEFINE_ETHERNET_BACKEND(pcap, backend_pcap::create)
+VCML_DEFINE_ETHERNET_BACKEND(replay, backend_replay::create)
 
 #ifdef HAVE_TAP
 VCML_DEFINE_ETHERNET_BACKEND(tap, backend_tap::create)
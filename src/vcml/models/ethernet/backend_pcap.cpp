@@ -0,0 +1,50 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/models/ethernet/backend_pcap.h"
+
+namespace vcml {
+namespace ethernet {
+
+backend_pcap::backend_pcap(bridge* br, const string& path, u64 rotate):
+    backend(br),
+    m_writer(path, PCAP_LINKTYPE_ETHERNET, br->name(), rotate) {
+    m_type = mkstr("pcap:%s", path.c_str());
+}
+
+backend_pcap::~backend_pcap() {
+    log_debug("captured %zu frames into %zu file(s)", m_writer.packets(),
+              m_writer.files());
+}
+
+void backend_pcap::send_to_host(const eth_frame& frame) {
+    m_writer.write(sc_time_stamp(), frame.data(), frame.size(),
+                   PCAP_OUTBOUND);
+}
+
+void backend_pcap::monitor_to_guest(const eth_frame& frame) {
+    m_writer.write(sc_time_stamp(), frame.data(), frame.size(),
+                   PCAP_INBOUND);
+}
+
+backend* backend_pcap::create(bridge* br, const vector<string>& args) {
+    string path = mkstr("%s.pcapng", br->name());
+    if (args.size() > 0)
+        path = args[0];
+
+    u64 rotate = 0;
+    if (args.size() > 1)
+        rotate = from_string<u64>(args[1]);
+
+    return new backend_pcap(br, path, rotate);
+}
+
+} // namespace ethernet
+} // namespace vcml
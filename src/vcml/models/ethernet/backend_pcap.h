@@ -0,0 +1,44 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef VCML_ETHERNET_BACKEND_PCAP_H
+#define VCML_ETHERNET_BACKEND_PCAP_H
+
+#include "vcml/core/types.h"
+#include "vcml/core/systemc.h"
+
+#include "vcml/logging/logger.h"
+#include "vcml/tracing/pcap.h"
+
+#include "vcml/models/ethernet/backend.h"
+#include "vcml/models/ethernet/bridge.h"
+
+namespace vcml {
+namespace ethernet {
+
+class backend_pcap : public backend
+{
+private:
+    pcap_writer m_writer;
+
+public:
+    backend_pcap(bridge* br, const string& path, u64 rotate);
+    virtual ~backend_pcap();
+
+    virtual void send_to_host(const eth_frame& frame) override;
+    virtual void monitor_to_guest(const eth_frame& frame) override;
+
+    static backend* create(bridge* br, const vector<string>& args);
+};
+
+} // namespace ethernet
+} // namespace vcml
+
+#endif
@@ -12,6 +12,7 @@
 #include <sys/stat.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <linux/if.h>
 #include <linux/if_tun.h>
 #include <unistd.h>
@@ -23,54 +24,128 @@
 namespace vcml {
 namespace ethernet {
 
-static bool tap_read(int fd, vector<u8>& buf) {
-    size_t len;
-    buf.resize(eth_frame::FRAME_MAX_SIZE);
+// layout of struct virtio_net_hdr_mrg_rxbuf, which prefixes every frame
+// read from or written to a tap device opened with IFF_VNET_HDR
+struct tap_vnet_hdr {
+    u8 flags;
+    u8 gso_type;
+    u16 hdr_len;
+    u16 gso_size;
+    u16 csum_start;
+    u16 csum_offset;
+    u16 num_buffers;
+};
+
+static_assert(sizeof(tap_vnet_hdr) == 12, "vnet header size mismatch");
+
+void backend_tap::open_queue(tap_queue& q, const string& name,
+                             bool multiqueue) {
+    q.fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    VCML_REPORT_ON(q.fd < 0, "error opening tundev: %s", strerror(errno));
 
-    do {
-        len = read(fd, buf.data(), buf.size());
-    } while (len < 0 && errno == EINTR);
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI | IFF_VNET_HDR;
+    if (multiqueue)
+        ifr.ifr_flags |= IFF_MULTI_QUEUE;
+    snprintf(ifr.ifr_name, IFNAMSIZ, "%s", name.c_str());
 
-    if (len < 0)
-        return false;
+    int err = ioctl(q.fd, TUNSETIFF, (void*)&ifr);
+    VCML_REPORT_ON(err < 0, "error creating tapdev: %s", strerror(errno));
+
+    int hdrsz = sizeof(tap_vnet_hdr);
+    err = ioctl(q.fd, TUNSETVNETHDRSZ, &hdrsz);
+    VCML_REPORT_ON(err < 0, "error setting vnet header: %s", strerror(errno));
+
+    // allow the host to pass unsegmented frames with partial checksums;
+    // older kernels know UFO, newer ones refuse it
+    unsigned int offloads = TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6 |
+                            TUN_F_TSO_ECN | TUN_F_UFO;
+    if (ioctl(q.fd, TUNSETOFFLOAD, offloads) < 0 &&
+        ioctl(q.fd, TUNSETOFFLOAD, offloads & ~TUN_F_UFO) < 0) {
+        log_warn("tap offloading unavailable: %s", strerror(errno));
+    }
 
-    buf.resize(len);
-    return true;
+    q.buffer.resize(MAX_FRAME_SIZE);
+    q.batch.reserve(RX_BURST);
 }
 
-void backend_tap::close_tap() {
-    if (m_fd >= 0) {
-        mwr::aio_cancel(m_fd);
-        close(m_fd);
-        m_fd = -1;
+void backend_tap::receive(tap_queue& q) {
+    while (q.batch.size() < RX_BURST) {
+        tap_vnet_hdr hdr;
+        struct iovec iov[2] = {
+            { &hdr, sizeof(hdr) },
+            { q.buffer.data(), q.buffer.size() },
+        };
+
+        ssize_t len;
+        do {
+            len = readv(q.fd, iov, 2);
+        } while (len < 0 && errno == EINTR);
+
+        if (len < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                log_error("error reading tap device: %s", strerror(errno));
+                mwr::aio_cancel(q.fd);
+            }
+
+            break;
+        }
+
+        if (len <= (ssize_t)sizeof(hdr))
+            continue;
+
+        // frames come from a pool kept by the bridge, so the only copy
+        // happens here and no memory gets allocated in the steady state
+        eth_frame frame = m_parent->alloc_frame();
+        frame.assign(q.buffer.data(), q.buffer.data() + len - sizeof(hdr));
+
+        frame.offload.flags = hdr.flags & (eth_frame::OFFLOAD_NEEDS_CSUM |
+                                           eth_frame::OFFLOAD_CSUM_VALID);
+        frame.offload.gso_type = hdr.gso_type;
+        frame.offload.hdr_len = hdr.hdr_len;
+        frame.offload.gso_size = hdr.gso_size;
+        frame.offload.csum_start = hdr.csum_start;
+        frame.offload.csum_offset = hdr.csum_offset;
+
+        if (frame.size() < eth_frame::FRAME_MIN_SIZE)
+            frame.resize(eth_frame::FRAME_MIN_SIZE);
+
+        q.batch.push_back(std::move(frame));
     }
+
+    send_to_guest(q.batch);
 }
 
-backend_tap::backend_tap(bridge* br, int devno): backend(br) {
-    m_fd = open("/dev/net/tun", O_RDWR);
-    VCML_REPORT_ON(m_fd < 0, "error opening tundev: %s", strerror(errno));
+void backend_tap::close_tap() {
+    for (tap_queue& q : m_queues) {
+        if (q.fd >= 0) {
+            mwr::aio_cancel(q.fd);
+            close(q.fd);
+            q.fd = -1;
+        }
+    }
+}
 
-    struct ifreq ifr;
-    memset(&ifr, 0, sizeof(ifr));
-    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
-    snprintf(ifr.ifr_name, IFNAMSIZ, "tap%d", devno);
+backend_tap::backend_tap(bridge* br, int devno, size_t queues):
+    backend(br), m_queues(max<size_t>(queues, 1)) {
+    string name = mkstr("tap%d", devno);
+    for (tap_queue& q : m_queues)
+        q.fd = -1;
 
-    int err = ioctl(m_fd, TUNSETIFF, (void*)&ifr);
-    VCML_REPORT_ON(err < 0, "error creating tapdev: %s", strerror(errno));
-    log_info("using tap device %s", ifr.ifr_name);
+    for (tap_queue& q : m_queues)
+        open_queue(q, name, m_queues.size() > 1);
 
-    m_type = mkstr("tap:%d", devno);
+    log_info("using tap device %s with %zu queues", name.c_str(),
+             m_queues.size());
 
-    mwr::aio_notify(m_fd, [&](int fd) -> void {
-        eth_frame frame;
-        if (!tap_read(fd, frame)) {
-            log_error("error reading tap device: %s", strerror(errno));
-            mwr::aio_cancel(fd);
-            return;
-        }
+    m_type = mkstr("tap:%d,%zu", devno, m_queues.size());
 
-        send_to_guest(std::move(frame));
-    });
+    // queues are not touched anymore, so the pointers remain valid
+    for (tap_queue& q : m_queues) {
+        tap_queue* qp = &q;
+        mwr::aio_notify(q.fd, [this, qp](int fd) -> void { receive(*qp); });
+    }
 }
 
 backend_tap::~backend_tap() {
@@ -78,15 +153,46 @@ backend_tap::~backend_tap() {
 }
 
 void backend_tap::send_to_host(const eth_frame& frame) {
-    if (m_fd >= 0)
-        mwr::fd_write(m_fd, frame.data(), frame.size());
+    size_t idx = 0;
+    if (m_queues.size() > 1)
+        idx = frame.flow_hash() % m_queues.size();
+
+    tap_queue& q = m_queues[idx];
+    if (q.fd < 0)
+        return;
+
+    tap_vnet_hdr hdr{};
+    hdr.flags = frame.offload.flags & eth_frame::OFFLOAD_NEEDS_CSUM;
+    hdr.gso_type = frame.offload.gso_type;
+    hdr.hdr_len = frame.offload.hdr_len;
+    hdr.gso_size = frame.offload.gso_size;
+    hdr.csum_start = frame.offload.csum_start;
+    hdr.csum_offset = frame.offload.csum_offset;
+
+    // each write to a tap device transfers exactly one frame, writev at
+    // least spares us from copying header and frame into one buffer
+    struct iovec iov[2] = {
+        { &hdr, sizeof(hdr) },
+        { (void*)frame.data(), frame.size() },
+    };
+
+    ssize_t len;
+    do {
+        len = writev(q.fd, iov, 2);
+    } while (len < 0 && errno == EINTR);
+
+    if (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        log_warn("error writing tap device: %s", strerror(errno));
 }
 
 backend* backend_tap::create(bridge* br, const vector<string>& args) {
     int devno = 0;
-    if (!args.empty())
+    size_t queues = 1;
+    if (args.size() > 0)
         devno = from_string<int>(args[0]);
-    return new backend_tap(br, devno);
+    if (args.size() > 1)
+        queues = from_string<size_t>(args[1]);
+    return new backend_tap(br, devno, queues);
 }
 
 } // namespace ethernet
@@ -23,14 +23,28 @@ namespace ethernet {
 class backend_tap : public backend
 {
 private:
-    int m_fd;
+    struct tap_queue {
+        int fd;
+        vector<u8> buffer;
+        vector<eth_frame> batch;
+    };
 
+    vector<tap_queue> m_queues;
+
+    void open_queue(tap_queue& q, const string& name, bool multiqueue);
+    void receive(tap_queue& q);
     void close_tap();
 
 public:
-    backend_tap(bridge* br, int devno);
+    enum : size_t {
+        RX_BURST = 64,
+        MAX_FRAME_SIZE = 64 * KiB + eth_frame::FRAME_HEADER_SIZE,
+    };
+
+    backend_tap(bridge* br, int devno, size_t queues = 1);
     virtual ~backend_tap();
 
+    virtual bool offload() const override { return true; }
     virtual void send_to_host(const eth_frame& frame) override;
 
     static backend* create(bridge* br, const vector<string>& args);
@@ -64,16 +64,36 @@ void bridge::eth_receive(const eth_frame& frame) {
     send_to_host(frame);
 }
 
+bool bridge::eth_rx_offload(const eth_target_socket& socket,
+                            const eth_frame& frame) const {
+    return true; // resolved per backend in send_to_host
+}
+
 void bridge::eth_transmit() {
+    vector<eth_frame> frames;
     while (true) {
         wait(m_ev);
 
-        lock_guard<mutex> guard(m_mtx);
-        while (!m_rx.empty()) {
-            eth_frame frame = std::move(m_rx.front());
-            m_rx.pop();
+        // do not hold the lock while sending, so that backends can keep
+        // queueing frames in the meantime
+        m_mtx.lock();
+        frames.swap(m_rx);
+        m_mtx.unlock();
+
+        for (const eth_frame& frame : frames) {
+            for (backend* b : m_backends)
+                b->monitor_to_guest(frame);
             eth_tx.send(frame);
         }
+
+        lock_guard<mutex> guard(m_mtx);
+        for (eth_frame& frame : frames) {
+            if (m_pool.size() >= POOL_SIZE)
+                break;
+            m_pool.push_back(std::move(frame));
+        }
+
+        frames.clear();
     }
 }
 
@@ -90,6 +110,8 @@ bridge::bridge(const sc_module_name& nm):
     m_backends(),
     m_mtx(),
     m_rx(),
+    m_pool(),
+    m_resolved(),
     m_ev("rxev"),
     backends("backends", ""),
     eth_tx("eth_tx"),
@@ -126,16 +148,52 @@ bridge::~bridge() {
 }
 
 void bridge::send_to_host(const eth_frame& frame) {
-    for (backend* b : m_backends)
-        b->send_to_host(frame);
+    bool resolved = false;
+    for (backend* b : m_backends) {
+        if (!frame.has_offloads() || b->offload()) {
+            b->send_to_host(frame);
+            continue;
+        }
+
+        if (!resolved && !eth_resolve_offloads(frame, m_resolved)) {
+            log_warn("failed to resolve frame offloads");
+            m_resolved.clear();
+        }
+
+        resolved = true;
+        for (const eth_frame& segment : m_resolved)
+            b->send_to_host(segment);
+    }
 }
 
 void bridge::send_to_guest(eth_frame frame) {
     lock_guard<mutex> guard(m_mtx);
-    m_rx.push(std::move(frame));
+    m_rx.push_back(std::move(frame));
     on_next_update([&]() -> void { m_ev.notify(SC_ZERO_TIME); });
 }
 
+void bridge::send_to_guest(vector<eth_frame>& frames) {
+    if (frames.empty())
+        return;
+
+    lock_guard<mutex> guard(m_mtx);
+    for (eth_frame& frame : frames)
+        m_rx.push_back(std::move(frame));
+    frames.clear();
+    on_next_update([&]() -> void { m_ev.notify(SC_ZERO_TIME); });
+}
+
+eth_frame bridge::alloc_frame() {
+    lock_guard<mutex> guard(m_mtx);
+    if (m_pool.empty())
+        return eth_frame();
+
+    eth_frame frame = std::move(m_pool.back());
+    m_pool.pop_back();
+    frame.offload = {};
+    return frame;
+}
+
 void bridge::attach(backend* b) {
     if (stl_contains(m_backends, b))
         VCML_ERROR("attempt to attach backend twice");
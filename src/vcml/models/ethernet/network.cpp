@@ -13,17 +13,119 @@
 namespace vcml {
 namespace ethernet {
 
-void network::eth_receive(const eth_target_socket& rx, const eth_frame& fr) {
-    const eth_initiator_socket& sender = peer_of(rx);
+bool network::cmd_show_stats(const vector<string>& args, ostream& os) {
+    os << "port     rx frames  rx bytes  tx frames  tx bytes  flooded  filtered";
+    for (const auto& tx : eth_tx) {
+        const port_stats& st = stats(tx.first);
+        os << mkstr("\n%4zu %13llu %9llu %10llu %9llu %8llu %9llu", tx.first,
+                    st.rx_frames, st.rx_bytes, st.tx_frames, st.tx_bytes,
+                    st.flooded, st.filtered);
+    }
+
+    return true;
+}
+
+bool network::cmd_show_macs(const vector<string>& args, ostream& os) {
+    std::map<size_t, vector<u64>> ports;
+    for (const auto& [mac, port] : m_macs)
+        ports[port].push_back(mac);
+
+    os << "learned " << m_macs.size() << " addresses";
+    for (auto& [port, macs] : ports) {
+        std::sort(macs.begin(), macs.end());
+        for (u64 mac : macs) {
+            mac_addr addr(mac >> 40, mac >> 32, mac >> 24, mac >> 16,
+                          mac >> 8, mac);
+            os << mkstr("\n%4zu ", port) << addr;
+        }
+    }
+
+    return true;
+}
+
+bool network::cmd_flush_macs(const vector<string>& args, ostream& os) {
+    os << "flushed " << m_macs.size() << " addresses";
+    flush_macs();
+    return true;
+}
+
+void network::forward(size_t port, const eth_frame& frame) {
+    port_stats& st = m_stats[port];
+    st.tx_frames++;
+    st.tx_bytes += frame.size();
+    eth_tx[port].send(frame);
+}
+
+void network::flood(size_t port, const eth_frame& frame) {
+    m_stats[port].flooded++;
     for (auto& tx : eth_tx) {
-        if (tx.second != &sender)
-            tx.second->send(fr);
+        if (tx.first != port)
+            forward(tx.first, frame);
+    }
+}
+
+void network::eth_receive(const eth_target_socket& rx, const eth_frame& fr) {
+    size_t port = eth_rx.index_of(rx);
+    port_stats& st = m_stats[port];
+    st.rx_frames++;
+    st.rx_bytes += fr.size();
+
+    if (!learning || fr.size() < eth_frame::FRAME_HEADER_SIZE) {
+        flood(port, fr);
+        return;
+    }
+
+    mac_addr src = fr.source();
+    if (src.is_unicast())
+        m_macs[(u64)src] = port;
+
+    size_t dest = 0;
+    if (!fr.is_unicast() || !lookup_port(fr.destination(), dest)) {
+        flood(port, fr);
+        return;
+    }
+
+    if (dest == port) {
+        st.filtered++; // destination is on the same segment as the sender
+        return;
+    }
+
+    forward(dest, fr);
+}
+
+void network::end_of_elaboration() {
+    module::end_of_elaboration();
+
+    for (auto it : eth_rx) {
+        size_t port = it.first;
+        debugging::metric_labels labels{ { "network", name() },
+                                         { "port", std::to_string(port) } };
+
+        m_metrics.push_back(std::make_unique<debugging::counter>(
+            "vcml_net_rx_bytes_total", "Bytes received per network port",
+            labels, [this, port]() -> u64 { return m_stats[port].rx_bytes; }));
+        m_metrics.push_back(std::make_unique<debugging::counter>(
+            "vcml_net_tx_bytes_total", "Bytes sent per network port", labels,
+            [this, port]() -> u64 { return m_stats[port].tx_bytes; }));
     }
 }
 
 network::network(const sc_module_name& nm):
-    module(nm), eth_host(), m_next_id(0), eth_tx("eth_tx"), eth_rx("eth_rx") {
-    // nothing to do
+    module(nm),
+    eth_host(),
+    m_next_id(0),
+    m_macs(),
+    m_stats(),
+    m_metrics(),
+    learning("learning", false),
+    eth_tx("eth_tx"),
+    eth_rx("eth_rx") {
+    register_command("show_stats", 0, &network::cmd_show_stats,
+                     "shows frame and byte counters for each port");
+    register_command("show_macs", 0, &network::cmd_show_macs,
+                     "shows the learned MAC addresses of each port");
+    register_command("flush_macs", 0, &network::cmd_flush_macs,
+                     "forgets all learned MAC addresses");
 }
 
 void network::bind(eth_initiator_socket& tx, eth_target_socket& rx) {
@@ -35,6 +137,15 @@ void network::bind(eth_initiator_socket& tx, eth_target_socket& rx) {
     m_next_id++;
 }
 
+bool network::lookup_port(const mac_addr& addr, size_t& port) const {
+    auto it = m_macs.find((u64)addr);
+    if (it == m_macs.end() || !eth_tx.exists(it->second))
+        return false;
+
+    port = it->second;
+    return true;
+}
+
 VCML_EXPORT_MODEL(vcml::ethernet::network, name, args) {
     return new network(name);
 }
@@ -16,7 +16,21 @@ namespace generic {
 void fbdev::update() {
     while (true) {
         wait_clock_cycle();
-        m_console.render();
+        m_console.sample();
+
+        // nobody is watching, redraw everything once somebody connects
+        if (m_vptr == nullptr || !m_console.has_clients()) {
+            m_damage.invalidate();
+            continue;
+        }
+
+        range changed;
+        if (!m_damage.check(m_vptr, size(), changed))
+            continue;
+
+        u32 y0 = changed.start / stride();
+        u32 y1 = changed.end / stride();
+        m_console.render(0, y0, m_mode.xres, y1 - y0 + 1);
     }
 }
 
@@ -34,10 +48,17 @@ bool fbdev::cmd_screenshot(const vector<string>& args, ostream& os) {
     return false;
 }
 
+bool fbdev::cmd_phash(const vector<string>& args, ostream& os) {
+    os << "0x" << std::hex << std::setw(16) << std::setfill('0')
+       << m_console.phash();
+    return true;
+}
+
 fbdev::fbdev(const sc_module_name& nm, u32 defx, u32 defy):
     component(nm),
     m_console(),
     m_mode(),
+    m_damage(),
     m_vptr(nullptr),
     addr("addr", 0),
     xres("xres", defx),
@@ -76,6 +97,11 @@ fbdev::fbdev(const sc_module_name& nm, u32 defx, u32 defy):
 
     register_command("screenshot", 0, &fbdev::cmd_screenshot,
                      "store a screenshot of the framebuffer");
+    register_command("capture", 1, &m_console, &ui::console::cmd_capture,
+                     "capture changed frames into a PNG stream, usage: "
+                     "capture <file> [interval] or capture stop");
+    register_command("phash", 0, &fbdev::cmd_phash,
+                     "print a perceptual hash of the framebuffer contents");
 }
 
 fbdev::~fbdev() {
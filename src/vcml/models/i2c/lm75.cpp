@@ -204,6 +204,19 @@ i2c_response lm75::i2c_read(const i2c_target_socket& socket, u8& data) {
     return I2C_ACK;
 }
 
+i2c_response lm75::i2c_read_burst(const i2c_target_socket& socket, u8* data,
+                                  size_t& len) {
+    size_t n = 0;
+    if (m_len < sizeof(m_buf)) {
+        n = min(len, sizeof(m_buf) - m_len);
+        memcpy(data, m_buf + m_len, n);
+        m_len += n;
+    }
+
+    memset(data + n, 0xff, len - n);
+    return I2C_ACK;
+}
+
 i2c_response lm75::i2c_write(const i2c_target_socket& socket, u8 data) {
     if (m_len == 0) {
         pointer = data;
@@ -131,6 +131,7 @@ tlm_response_status ocfbc::write(const range& addr, const void* ptr,
 
     u8* palette = (u8*)m_palette + addr.start - PALETTE_ADDR;
     memcpy(palette, ptr, addr.length());
+    m_palette_dirty = true;
     return TLM_OK_RESPONSE;
 }
 
@@ -185,10 +186,17 @@ void ocfbc::create() {
         VCML_ERROR("unknown mode: %ubpp", m_bpp * 8);
     }
 
+    if (m_fb != nullptr) {
+        delete[] m_fb;
+        m_fb = nullptr;
+    }
+
+    m_damage.invalidate();
+
     // cannot use DMI with pseudocolor
     if (!vram || m_pc) {
         log_debug("copying vnc framebuffer from vram");
-        m_fb = new u8[mode.size];
+        m_fb = new u8[mode.size]();
         m_console.setup(mode, m_fb);
     } else {
         log_debug("mapping vnc framebuffer into vram");
@@ -197,62 +205,116 @@ void ocfbc::create() {
     }
 }
 
-void ocfbc::render() {
-    if (m_fb != nullptr) { // need to copy data to framebuffer manually
-        tlm_response_status rs;
+void ocfbc::convert(const u8* src, u8* dest) {
+    u32 linesz = m_xres * m_bpp;
+    if (!m_pc) {
+        memcpy(dest, src, linesz);
+        return;
+    }
+
+    const u32* palette = m_palette;
+    if (stat & STAT_ACMP)
+        palette = m_palette + 0x100;
 
-        u32 burstsz = OCFBC_VBL(ctlr);
-        u32 linesz = m_xres * m_bpp;
+    for (u32 x = 0; x < linesz; x++) {
+        u32 color = to_host_endian(palette[src[x]]);
+        *dest++ = (color >> 0) & 0xff;  // b
+        *dest++ = (color >> 8) & 0xff;  // g
+        *dest++ = (color >> 16) & 0xff; // r
+        *dest++ = 0xff;                 // a
+    }
+}
 
-        u8* linebuf = new u8[linesz];
-        memset(linebuf, 0, linesz);
+void ocfbc::refresh(const tlm_sbi& info) {
+    if (m_fb == nullptr) { // vram is mapped, only need to look for changes
+        const u8* fb = m_console.framebuffer();
+        if (fb && m_damage.check(fb, m_console.mode().size))
+            m_console.render();
+        return;
+    }
 
-        u8* fb = m_fb;
+    u32 base = (stat & STAT_AVMP) ? vbarb : vbara;
+    u32 linesz = m_xres * m_bpp;
+    u32 fbline = m_console.mode().stride;
+    u32 size = linesz * m_yres;
 
-        for (u32 y = 0; y < m_yres; y++) {
-            // burst-read one horizontal line of pixels into buffer
-            for (u32 x = 0; x < linesz; x += burstsz) {
-                u32 base = (stat & STAT_AVMP) ? vbarb : vbara;
-                u32 addr = base + y * linesz + x;
-                u8* dest = m_pc ? linebuf : fb;
-                if (failed(rs = out.read(addr, dest + x, burstsz))) {
-                    log_debug("failed to read vmem at 0x%08x: %s", addr,
-                              tlm_response_to_str(rs));
-                    stat |= STAT_SINT;
-                    irq = true;
-                }
-            }
+    const u8* vram = nullptr;
+    if (allow_dmi)
+        vram = out.lookup_dmi_ptr(base, size, VCML_ACCESS_READ);
 
-            if (!m_pc) {
-                fb += linesz; // done, data is already copied
-            } else {
-                u32* palette = m_palette;
-                if (stat & STAT_ACMP)
-                    palette = m_palette + 0x100;
-
-                for (u32 x = 0; x < linesz; x++) {
-                    u32 color = to_host_endian(palette[linebuf[x]]);
-                    *fb++ = (color >> 0) & 0xff;  // b
-                    *fb++ = (color >> 8) & 0xff;  // g
-                    *fb++ = (color >> 16) & 0xff; // r
-                    *fb++ = 0xff;                 // a
-                }
-            }
+    if (vram != nullptr) {
+        if (!m_damage.check(vram, size) && !m_palette_dirty)
+            return; // nothing changed since the last frame
 
-            // Note that the HSYNC interrupt will only be triggered when
-            // DMI is not used. Otherwise, this is never executed
-            if (ctlr & CTLR_HIE) {
-                stat |= STAT_HINT;
+        for (u32 y = 0; y < m_yres; y++)
+            convert(vram + y * linesz, m_fb + y * fbline);
+    } else {
+        vector<u8> linebuf(linesz);
+        for (u32 y = 0; y < m_yres; y++) {
+            // read one horizontal line of pixels at once
+            u32 addr = base + y * linesz;
+            tlm_response_status rs = out.read(addr, linebuf.data(), linesz,
+                                              info);
+            if (failed(rs)) {
+                log_debug("failed to read vmem at 0x%08x: %s", addr,
+                          tlm_response_to_str(rs));
+                stat |= STAT_SINT;
                 irq = true;
             }
+
+            convert(linebuf.data(), m_fb + y * fbline);
+        }
+    }
+
+    m_palette_dirty = false;
+    m_console.render(); // output image
+}
+
+void ocfbc::probe() {
+    u32 base = (stat & STAT_AVMP) ? vbarb : vbara;
+    u32 size = m_xres * m_bpp * m_yres;
+
+    if (allow_dmi && out.lookup_dmi_ptr(base, size, VCML_ACCESS_READ))
+        return;
+
+    // only touch both ends of vram, enough to catch a bad base address
+    u8 data;
+    for (u32 addr : { base, base + size - 1 }) {
+        tlm_response_status rs = out.read(addr, &data, sizeof(data));
+        if (failed(rs)) {
+            log_debug("failed to read vmem at 0x%08x: %s", addr,
+                      tlm_response_to_str(rs));
+            stat |= STAT_SINT;
+            irq = true;
+            return;
         }
+    }
+}
+
+void ocfbc::render() {
+    // skip reading vram while no display client is watching, but still
+    // report bad vram addresses to the guest
+    if (m_console.has_clients()) {
+        refresh();
+    } else {
+        m_damage.invalidate();
+        if (m_fb != nullptr)
+            probe();
+    }
+
+    m_console.sample();
 
-        delete[] linebuf;
+    // Note that the HSYNC interrupt will only be triggered when DMI is not
+    // used to map vram directly into the display
+    if (m_fb != nullptr && (ctlr & CTLR_HIE)) {
+        stat |= STAT_HINT;
+        irq = true;
     }
 
     if (ctlr & CTLR_CBSWE) {
         stat ^= STAT_ACMP;   // toggle ACMP bit
         ctlr &= ~CTLR_CBSWE; // clear CBSWE bit
+        m_palette_dirty = true;
         if (ctlr & CTLR_CBSIE)
             irq = true;
     }
@@ -260,6 +322,7 @@ void ocfbc::render() {
     if (ctlr & CTLR_VBSWE) {
         stat ^= STAT_AVMP;   // toggle AVMP bit
         ctlr &= ~CTLR_VBSWE; // clear VBSWE bit
+        m_damage.invalidate();
         if (ctlr & CTLR_VBSIE)
             irq = true;
     }
@@ -268,8 +331,6 @@ void ocfbc::render() {
         stat |= STAT_VINT;
         irq = true; // VSYNC interrupt
     }
-
-    m_console.render(); // output image
 }
 
 void ocfbc::update() {
@@ -306,6 +367,10 @@ bool ocfbc::cmd_screenshot(const vector<string>& args, ostream& os) {
     if (args.size() > 0)
         path = args[0];
 
+    // copied framebuffer may be stale if no display client is connected
+    if (m_fb != nullptr && !m_console.has_clients())
+        refresh(SBI_DEBUG);
+
     if (m_console.screenshot(path)) {
         os << "screenshot stored in '" << path << "'";
         return true;
@@ -315,10 +380,22 @@ bool ocfbc::cmd_screenshot(const vector<string>& args, ostream& os) {
     return false;
 }
 
+bool ocfbc::cmd_phash(const vector<string>& args, ostream& os) {
+    if (m_fb != nullptr && !m_console.has_clients())
+        refresh(SBI_DEBUG);
+
+    os << "0x" << std::hex << std::setw(16) << std::setfill('0')
+       << m_console.phash();
+    return true;
+}
+
 ocfbc::ocfbc(const sc_module_name& nm):
     peripheral(nm),
+    m_console(),
+    m_damage(),
     m_palette_addr(PALETTE_ADDR, PALETTE_ADDR + sizeof(m_palette)),
     m_palette(),
+    m_palette_dirty(true),
     m_fb(nullptr),
     m_xres(0),
     m_yres(0),
@@ -356,6 +433,11 @@ ocfbc::ocfbc(const sc_module_name& nm):
                      "shows information about the framebuffer");
     register_command("screenshot", 0, &ocfbc::cmd_screenshot,
                      "store a screenshot of the framebuffer");
+    register_command("capture", 1, &m_console, &ui::console::cmd_capture,
+                     "capture changed frames into a PNG stream, usage: "
+                     "capture <file> [interval] or capture stop");
+    register_command("phash", 0, &ocfbc::cmd_phash,
+                     "print a perceptual hash of the framebuffer contents");
 }
 
 ocfbc::~ocfbc() {
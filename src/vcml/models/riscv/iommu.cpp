@@ -772,6 +772,133 @@ bool iommu::check_msi(const context& ctx, u64 addr) const {
     return !(((addr >> 12) ^ ctx.msi_addr_pattern) & ~ctx.msi_addr_mask);
 }
 
+iommu::iotlb_cache::iotlb_cache():
+    m_sets(1),
+    m_ways(1),
+    m_stamp(0),
+    m_data(1),
+    hits(0),
+    misses(0),
+    evictions(0),
+    invalidations(0) {
+}
+
+void iommu::iotlb_cache::configure(size_t sets, size_t ways) {
+    VCML_ERROR_ON(!sets || !is_pow2(sets), "invalid iotlb sets: %zu", sets);
+    VCML_ERROR_ON(!ways, "invalid iotlb ways: %zu", ways);
+
+    m_sets = sets;
+    m_ways = ways;
+    m_data.assign(sets * ways, way());
+    m_stamp = 0;
+}
+
+bool iommu::iotlb_cache::lookup(u64 vpn, u32 devid, u32 pid, u64 gscid,
+                                u64 pscid, bool wnr, iotlb& entry) {
+    way* set = lookup_set(vpn);
+    for (size_t i = 0; i < m_ways; i++) {
+        way& w = set[i];
+        if (!w.valid || w.entry.vpn != vpn)
+            continue;
+        if (w.device_id != devid || w.process_id != pid)
+            continue;
+        if (w.entry.gscid != gscid || w.entry.pscid != pscid)
+            continue;
+        if (wnr && !w.entry.w)
+            continue;
+
+        w.stamp = ++m_stamp;
+        entry = w.entry;
+        hits++;
+        return true;
+    }
+
+    misses++;
+    return false;
+}
+
+void iommu::iotlb_cache::insert(u32 devid, u32 pid, const iotlb& entry) {
+    way* set = lookup_set(entry.vpn);
+    way* victim = set;
+    for (size_t i = 0; i < m_ways; i++) {
+        way& w = set[i];
+        if (w.valid && w.entry.vpn == entry.vpn && w.device_id == devid &&
+            w.process_id == pid && w.entry.gscid == entry.gscid &&
+            w.entry.pscid == entry.pscid) {
+            victim = &w; // replace stale translation
+            break;
+        }
+
+        if (!w.valid) {
+            if (victim->valid)
+                victim = &w;
+        } else if (victim->valid && w.stamp < victim->stamp) {
+            victim = &w;
+        }
+    }
+
+    if (victim->valid && victim->entry.vpn != entry.vpn)
+        evictions++;
+
+    victim->entry = entry;
+    victim->device_id = devid;
+    victim->process_id = pid;
+    victim->stamp = ++m_stamp;
+    victim->valid = true;
+}
+
+void iommu::iotlb_cache::invalidate(u64 vpn) {
+    way* set = lookup_set(vpn);
+    for (size_t i = 0; i < m_ways; i++) {
+        if (set[i].valid && set[i].entry.vpn == vpn) {
+            set[i].valid = false;
+            invalidations++;
+        }
+    }
+}
+
+void iommu::iotlb_cache::invalidate_all() {
+    for (way& w : m_data) {
+        if (w.valid) {
+            w.valid = false;
+            invalidations++;
+        }
+    }
+}
+
+template <typename PRED>
+void iommu::iotlb_cache::invalidate_some(PRED&& pred) {
+    for (way& w : m_data) {
+        if (w.valid && pred(w.entry)) {
+            w.valid = false;
+            invalidations++;
+        }
+    }
+}
+
+void iommu::iotlb_cache::reset_stats() {
+    hits = misses = evictions = invalidations = 0;
+}
+
+bool iommu::cmd_iotlb(const vector<string>& args, ostream& os) {
+    const iotlb_cache* caches[] = { &m_iotlb_s, &m_iotlb_g };
+    const char* names[] = { "first-stage", "second-stage" };
+    for (int i = 0; i < 2; i++) {
+        const iotlb_cache& c = *caches[i];
+        u64 total = c.hits + c.misses;
+        os << names[i] << " iotlb (" << c.sets() << " sets, " << c.ways()
+           << " ways):\n";
+        os << "  hits:          " << c.hits;
+        if (total > 0)
+            os << mkstr(" (%.1f%%)", 100.0 * c.hits / total);
+        os << "\n  misses:        " << c.misses
+           << "\n  evictions:     " << c.evictions
+           << "\n  invalidations: " << c.invalidations << "\n";
+    }
+
+    return true;
+}
+
 int iommu::fetch_context(const tlm_sbi& info, bool dmi, context& ctx) {
     bool dbg = info.is_debug || dmi;
     bool ats = info.atype != SBI_ATYPE_UX;
@@ -996,13 +1123,9 @@ int iommu::fetch_iotlb(context& ctx, tlm_generic_payload& tx,
         return 0;
     }
 
-    if (!pgreq && stl_contains(m_iotlb_s, vpn)) {
-        iotlb& cache = m_iotlb_s[vpn];
-        if (cache.gscid == gscid && cache.pscid == pscid &&
-            (cache.w || !wnr)) {
-            entry = cache;
-            return 0;
-        }
+    if (!pgreq && m_iotlb_s.lookup(vpn, ctx.device_id, ctx.process_id, gscid,
+                                   pscid, wnr, entry)) {
+        return 0;
     }
 
     if (!dbg) {
@@ -1010,7 +1133,7 @@ int iommu::fetch_iotlb(context& ctx, tlm_generic_payload& tx,
         increment_counter(ctx, IOMMU_EVENT_TLB_MISS);
     }
 
-    iotlb iotlb_s;
+    iotlb iotlb_s{};
     int fault = tablewalk(ctx, virt, false, super, wnr, false, dbg, iotlb_s);
     if (fault == TWALK_FAULT_G_STAGE)
         return IOMMU_PAGE_FAULT_R;
@@ -1026,21 +1149,18 @@ int iommu::fetch_iotlb(context& ctx, tlm_generic_payload& tx,
     if (!pgreq && !dbg && check_msi(ctx, gpa))
         return translate_msi(ctx, tx, info, gpa, entry);
 
-    if (stl_contains(m_iotlb_g, iotlb_s.ppn)) {
-        iotlb& cache = m_iotlb_g[iotlb_s.ppn];
-        if (cache.gscid == gscid && cache.pscid == pscid &&
-            (cache.w || !wnr)) {
-            entry = cache;
-            return 0;
-        }
-    }
-
-    iotlb iotlb_g;
-    if (tablewalk(ctx, gpa, true, false, wnr, false, dbg, iotlb_g))
-        return iommu_page_fault(wnr);
+    // second-stage translations belong to the guest, not to its processes
+    iotlb iotlb_g{};
+    if (!m_iotlb_g.lookup(iotlb_s.ppn, ctx.device_id, 0, gscid, 0, wnr,
+                          iotlb_g)) {
+        if (tablewalk(ctx, gpa, true, false, wnr, false, dbg, iotlb_g))
+            return iommu_page_fault(wnr);
 
-    if (!dbg)
-        m_iotlb_g[iotlb_g.vpn] = iotlb_g;
+        iotlb_g.gscid = gscid;
+        iotlb_g.pscid = 0;
+        if (!dbg)
+            m_iotlb_g.insert(ctx.device_id, 0, iotlb_g);
+    }
 
     entry.vpn = iotlb_s.vpn;
     entry.ppn = iotlb_g.ppn;
@@ -1051,7 +1171,7 @@ int iommu::fetch_iotlb(context& ctx, tlm_generic_payload& tx,
     entry.pbmt = iotlb_s.pbmt | iotlb_g.pbmt;
 
     if (!dbg)
-        m_iotlb_s[vpn] = entry;
+        m_iotlb_s.insert(ctx.device_id, ctx.process_id, entry);
 
     return 0;
 }
@@ -1551,7 +1671,9 @@ void iommu::write_ddtp(u64 val) {
         return;
 
     m_contexts.clear();
-    m_iotlb_s.clear();
+    m_iotlb_s.invalidate_all();
+    m_iotlb_g.invalidate_all();
+    invalidate_dma_dmi(0, true);
 
     ddtp = (ddtp & ~mask) | (val & mask);
 }
@@ -1711,11 +1833,6 @@ inline void invalidate_all(MAP& map) {
     map.clear();
 }
 
-template <typename MAP, typename KEY>
-inline void invalidate_key(MAP& map, const KEY& key) {
-    map.erase(key);
-}
-
 template <typename MAP, typename PRED>
 inline void invalidate_some(MAP& map, PRED&& pred) {
     for (auto it = map.begin(); it != map.end();) {
@@ -1726,6 +1843,22 @@ inline void invalidate_some(MAP& map, PRED&& pred) {
     }
 }
 
+void iommu::invalidate_dma_dmi(u64 vpn, bool all) {
+    if (passthrough || m_dmi_hi < m_dmi_lo)
+        return; // no translated dmi regions handed out
+
+    if (all) {
+        m_dmi_lo = ~0ull;
+        m_dmi_hi = 0;
+        dma.dmi_cache().invalidate(0ull, ~0ull);
+        dma->invalidate_direct_mem_ptr(0ull, ~0ull);
+    } else {
+        u64 page = vpn << PAGE_BITS;
+        dma.dmi_cache().invalidate(page, page + PAGE_MASK);
+        dma->invalidate_direct_mem_ptr(page, page + PAGE_MASK);
+    }
+}
+
 void iommu::handle_iotinval(const command& cmd) {
     bool inval_s = false;
     bool inval_g = false;
@@ -1753,14 +1886,14 @@ void iommu::handle_iotinval(const command& cmd) {
     if (!gv && !pscv) {
         if (av) {
             if (inval_s)
-                invalidate_key(m_iotlb_s, vpn);
+                m_iotlb_s.invalidate(vpn);
             if (inval_g)
-                invalidate_key(m_iotlb_g, vpn);
+                m_iotlb_g.invalidate(vpn);
         } else {
             if (inval_s)
-                invalidate_all(m_iotlb_s);
+                m_iotlb_s.invalidate_all();
             if (inval_g)
-                invalidate_all(m_iotlb_g);
+                m_iotlb_g.invalidate_all();
         }
     } else {
         auto filter = [=](const iotlb& entry) -> bool {
@@ -1773,11 +1906,23 @@ void iommu::handle_iotinval(const command& cmd) {
             return true;
         };
 
+        // second-stage entries carry no PSCID, only match on the GSCID
+        auto filter_g = [=](const iotlb& entry) -> bool {
+            if (av && entry.vpn != vpn)
+                return false;
+            if (gv && entry.gscid != gscid)
+                return false;
+            return true;
+        };
+
         if (inval_s)
-            invalidate_some(m_iotlb_s, filter);
+            m_iotlb_s.invalidate_some(filter);
         if (inval_g)
-            invalidate_some(m_iotlb_g, filter);
+            m_iotlb_g.invalidate_some(filter_g);
     }
+
+    // second-stage invalidations may affect any translated page
+    invalidate_dma_dmi(vpn, !av || inval_g);
 }
 
 void iommu::handle_iofence(const command& cmd) {
@@ -2237,6 +2382,8 @@ iommu::iommu(const sc_module_name& nm, bool passthrough):
     pd17("pd17", true),
     pd20("pd20", true),
     passthrough("passthrough", passthrough),
+    iotlb_sets("iotlb_sets", 64),
+    iotlb_ways("iotlb_ways", 4),
     caps("caps", 0x0, 0),
     fctl("fctl", 0x8, 0),
     ddtp("ddtp", 0x10, 0),
@@ -2365,6 +2512,12 @@ iommu::iommu(const sc_module_name& nm, bool passthrough):
 
     load_capabilities();
 
+    m_iotlb_s.configure(iotlb_sets, iotlb_ways);
+    m_iotlb_g.configure(iotlb_sets, iotlb_ways);
+
+    register_command("iotlb", 0, &iommu::cmd_iotlb,
+                     "shows iotlb configuration and statistics");
+
     SC_HAS_PROCESS(iommu);
     SC_THREAD(worker);
     SC_METHOD(overflow);
@@ -2380,7 +2533,10 @@ void iommu::reset() {
     peripheral::reset();
     load_capabilities();
     m_contexts.clear();
-    m_iotlb_s.clear();
+    m_iotlb_s.invalidate_all();
+    m_iotlb_g.invalidate_all();
+    m_iotlb_s.reset_stats();
+    m_iotlb_g.reset_stats();
     invalidate_direct_mem_ptr(0ull, ~0ull);
     restart_counter(0);
 }
@@ -864,21 +864,108 @@ sd_status_rx card::do_data_write(u8 val) {
 
     disk.seek(m_curoff);
     disk.write(m_buffer, blklen);
-    disk.flush();
 
     m_numblk++;
+    m_dirty = true;
 
-    if (m_curcmd == 24) // writing only single block?
+    if (m_curcmd == 24) { // writing only single block?
+        flush_disk();
         return SDRX_OK_COMPLETE;
+    }
 
     size_t offset = m_curoff + blklen;
-    if (offset + blklen > disk.capacity()) // reached end of card memory?
+    if (offset + blklen > disk.capacity()) { // reached end of card memory?
+        flush_disk();
         return SDRX_OK_COMPLETE;
+    }
 
     setup_rx_blk(offset); // continue writing
     return SDRX_OK_BLK_DONE;
 }
 
+sd_status_tx card::do_blocks_read(u8* data, size_t& len) {
+    if (m_state != SENDING) {
+        log_debug("attempt to read from card that is not sending");
+        len = 0;
+        return SDTX_ERR_ILLEGAL;
+    }
+
+    // only whole blocks can be transferred in one go, partially read blocks
+    // must be finished byte-wise first
+    size_t blklen = is_sdhc() ? SDHC_BLKLEN : m_blklen;
+    if (m_bufptr != m_buffer || len < blklen) {
+        len = 0;
+        return SDTX_INCOMPLETE;
+    }
+
+    size_t count = m_curcmd == 18 ? len / blklen : 1;
+    count = min(count, (disk.capacity() - m_curoff) / blklen);
+
+    // the first block has already been fetched by setup_tx_blk
+    memcpy(data, m_buffer, blklen);
+    if (count > 1) {
+        disk.seek(m_curoff + blklen);
+        disk.read(data + blklen, (count - 1) * blklen);
+    }
+
+    len = count * blklen;
+    m_numblk += count;
+    m_state = TRANSFER;
+    m_bufptr = nullptr;
+    m_bufend = nullptr;
+
+    if (m_curcmd != 18)
+        return SDTX_OK_COMPLETE;
+
+    size_t offset = m_curoff + len;
+    if (offset >= disk.capacity())
+        return SDTX_OK_COMPLETE;
+
+    setup_tx_blk(offset);
+    return SDTX_OK_BLK_DONE;
+}
+
+sd_status_rx card::do_blocks_write(const u8* data, size_t& len) {
+    if (m_state != RECEIVING) {
+        log_debug("attempt to write to card that is not receiving");
+        len = 0;
+        return SDRX_ERR_ILLEGAL;
+    }
+
+    size_t blklen = is_sdhc() ? SDHC_BLKLEN : m_blklen;
+    if (m_bufptr != m_buffer || len < blklen) {
+        len = 0;
+        return SDRX_INCOMPLETE;
+    }
+
+    if ((m_curcmd != 24) && (m_curcmd != 25)) // WRITE or WRITE_MULTIPLE
+        VCML_ERROR("unsupported write CMD%hhu", m_curcmd);
+
+    size_t count = m_curcmd == 25 ? len / blklen : 1;
+    count = min(count, (disk.capacity() - m_curoff) / blklen);
+
+    // block transfers carry no CRC, the data never crossed a wire
+    disk.seek(m_curoff);
+    disk.write(data, count * blklen);
+
+    len = count * blklen;
+    m_numblk += count;
+    m_dirty = true;
+    m_state = TRANSFER;
+    update_status();
+    m_bufptr = nullptr;
+    m_bufend = nullptr;
+
+    size_t offset = m_curoff + len;
+    if (m_curcmd == 24 || offset + blklen > disk.capacity()) {
+        flush_disk();
+        return SDRX_OK_COMPLETE;
+    }
+
+    setup_rx_blk(offset);
+    return SDRX_OK_BLK_DONE;
+}
+
 card::card(const sc_module_name& nm, const string& img, bool ro, bool wi):
     component(nm),
     sd_host(),
@@ -900,6 +987,7 @@ card::card(const sc_module_name& nm, const string& img, bool ro, bool wi):
     m_curcmd(),
     m_curoff(),
     m_numblk(),
+    m_dirty(false),
     m_state(IDLE),
     image("image", img),
     readonly("readonly", ro),
@@ -917,10 +1005,11 @@ card::card(const sc_module_name& nm, const string& img, bool ro, bool wi):
 }
 
 card::~card() {
-    // nothing to do
+    flush_disk();
 }
 
 void card::reset() {
+    flush_disk();
     m_status = 0;
     m_state = IDLE;
 
@@ -947,7 +1036,10 @@ void card::sd_transport(const sd_target_socket& socket, sd_command& tx) {
     tx.appcmd = (m_status & APP_CMD);
     tx.resp_len = 0;
 
+    // any command ends an open multi-block transfer, writes to the disk are
+    // only flushed once that happens instead of after every block
     if (m_state == SENDING || m_state == RECEIVING) {
+        flush_disk();
         m_state = TRANSFER;
         update_status();
     }
@@ -1009,6 +1101,13 @@ void card::sd_transport(const sd_target_socket& socket, sd_data& tx) {
         tx.status.write = do_data_write(tx.data);
 }
 
+void card::sd_transport_blocks(const sd_target_socket& socket, sd_data& tx) {
+    if (tx.mode == SD_READ)
+        tx.status.read = do_blocks_read(tx.buffer, tx.length);
+    if (tx.mode == SD_WRITE)
+        tx.status.write = do_blocks_write(tx.buffer, tx.length);
+}
+
 VCML_EXPORT_MODEL(vcml::sd::card, name, args) {
     if (args.empty())
         return new card(name);
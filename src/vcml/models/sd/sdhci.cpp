@@ -209,8 +209,8 @@ void sdhci::write_cmd(u16 val) {
         break;
 
     case SD_OK_TX_RDY:
-        transfer_data_from_sd();
         if (!dma_enabled) {
+            transfer_data_from_sd();
             set_present_state(BUFFER_READ_ENABLE);
         } else {
             set_present_state(DAT_LINE_ACTIVE);
@@ -337,6 +337,8 @@ void sdhci::write_software_reset(u8 val) {
         break;
 
     case RESET_DAT_LINE:
+        m_dma_abort = true;
+        m_dma_resume.notify(SC_ZERO_TIME);
         present_state &= ~0x00000F06;
         normal_int_stat &= ~0x003E;
         break;
@@ -366,103 +368,342 @@ void sdhci::write_error_int_stat(u16 val) {
 }
 
 u32 sdhci::read_capabilities() {
-    u32 caps = capabilities;
-    return dma_enabled ? (caps | 0x00400000) : (caps & ~0x00400000);
+    u32 caps = capabilities & ~(CAPABILITY_SDMA | CAPABILITY_ADMA2);
+    if (dma_enabled)
+        caps |= CAPABILITY_SDMA;
+    if (dma_enabled && adma_enabled)
+        caps |= CAPABILITY_ADMA2;
+    return caps;
 }
 
-void sdhci::dma_thread() {
-    u32 boundary = 0;
-    tlm_response_status rs;
+u16 sdhci::read_host_controller_version() {
+    // drivers only consider ADMA2 on spec version 2.00 controllers
+    u16 version = host_controller_version & ~0xff;
+    if (dma_enabled && adma_enabled)
+        return version | SPEC_VERSION_200;
+    return version | SPEC_VERSION_100;
+}
 
-    while (true) {
-        wait(m_dma_start);
+void sdhci::write_sdma_system_address(u32 val) {
+    // writing the address resumes a transfer paused at an SDMA boundary
+    sdma_system_address = val;
+    m_dma_resume.notify(SC_ZERO_TIME);
+}
 
-        // normally the boundary should be 512K-12 bytes, i.e. 524276 bytes
-        boundary = (4096 << ((block_size & 0x7000) >> 12)) - 12;
+bool sdhci::read_sd_blocks(u8* data, size_t len) {
+    size_t blksz = block_size & 0xfff;
+    while (len > 0) {
+        size_t n = len;
+        sd_status_tx rs = sd_out.read_blocks(data, n);
+        if (rs == SDTX_INCOMPLETE) {
+            // card cannot transfer whole blocks, fetch them byte-wise
+            transfer_data_from_sd();
+            memcpy(data, m_buffer, blksz);
+            n = blksz;
+        } else if (failed(rs) || n == 0) {
+            log_warn("card returned %s", sd_status_str(rs));
+            return false;
+        }
 
-        if (m_cmd.status == SD_OK_TX_RDY) {
-            rs = dma_read(boundary);
-        } else if (m_cmd.status == SD_OK_RX_RDY) {
-            rs = dma_write(boundary);
-        } else {
-            VCML_ERROR("illegal state for DMA command");
+        block_count_16_bit -= n / blksz;
+        data += n;
+        len -= n;
+
+        if (rs == SDTX_OK_COMPLETE && len > 0) {
+            log_warn("card completed transfer %zu bytes early", len);
+            return false;
         }
+    }
 
-        if (failed(rs))
-            log_warn("DMA failed: %s", tlm_response_to_str(rs));
+    return true;
+}
 
-        set_present_state(~DAT_LINE_ACTIVE);
-        normal_int_stat |= INT_TRANSFER_COMPLETE;
-        irq.write(true);
+bool sdhci::write_sd_blocks(const u8* data, size_t len) {
+    size_t blksz = block_size & 0xfff;
+    while (len > 0) {
+        size_t n = len;
+        sd_status_rx rs = sd_out.write_blocks(data, n);
+        if (rs == SDRX_INCOMPLETE) {
+            memcpy(m_buffer, data, blksz);
+            u16 crc = crc16(m_buffer, blksz);
+            m_buffer[blksz + 0] = (u8)(crc >> 8);
+            m_buffer[blksz + 1] = (u8)(crc >> 0);
+            transfer_data_to_sd();
+            n = blksz;
+        } else if (failed(rs) || n == 0) {
+            log_warn("card returned %s", sd_status_str(rs));
+            return false;
+        }
+
+        block_count_16_bit -= n / blksz;
+        data += n;
+        len -= n;
+
+        if (rs == SDRX_OK_COMPLETE && len > 0) {
+            log_warn("card completed transfer %zu bytes early", len);
+            return false;
+        }
     }
+
+    return true;
+}
+
+void sdhci::dma_advance(size_t len) {
+    m_dma_addr += len;
+    m_dma_seglen -= len;
+    if (!is_adma2())
+        sdma_system_address = (u32)m_dma_addr;
 }
 
-tlm_response_status sdhci::dma_read(u32 boundary) {
-    u32 offset = 0;
-    u32 blksz = block_size & 0xfff;
-    tlm_response_status rs;
+bool sdhci::adma_error(u8 status) {
+    adma_error_status = status;
+    error_int_stat |= ERR_ADMA;
+    return false;
+}
 
-    while (true) {
-        if (offset + blksz >= boundary) {
-            // this never happens with Linux...
-            VCML_ERROR("SDMA boundary exceeded, not implemented");
+bool sdhci::dma_next_segment() {
+    if (!is_adma2()) {
+        // SDMA pauses at every boundary until the driver has written the
+        // address from where to continue
+        if (m_dma_segint) {
+            normal_int_stat |= INT_DMA_INTERRUPT;
+            irq.write(true);
+            wait(m_dma_resume);
+            if (m_dma_abort)
+                return false;
+            m_dma_addr = sdma_system_address;
+        }
+
+        size_t boundary = sdma_boundary();
+        m_dma_seglen = boundary - (m_dma_addr % boundary);
+        m_dma_segint = true;
+        return true;
+    }
+
+    m_dma_segint = false;
+
+    // bound the number of descriptors to not get stuck in link loops
+    for (size_t i = 0; i < 4096; i++) {
+        if (m_adma_end)
+            return adma_error(ADMA_ERR_ST_TFR | ADMA_ERR_LENGTH);
+
+        u32 desc[2];
+        if (failed(out.read(adma_system_address, desc, sizeof(desc)))) {
+            log_warn("failed to fetch ADMA descriptor at 0x%08x",
+                     (u32)adma_system_address);
+            return adma_error(ADMA_ERR_ST_FDS);
+        }
+
+        u32 attr = desc[0] & 0xffff;
+        u32 length = desc[0] >> 16;
+
+        if (!(attr & ADMA_VALID)) {
+            log_warn("invalid ADMA descriptor at 0x%08x",
+                     (u32)adma_system_address);
+            return adma_error(ADMA_ERR_ST_FDS);
         }
 
-        rs = out.write(sdma_system_address, m_buffer, blksz);
-        if (failed(rs))
+        m_adma_end = attr & ADMA_END;
+
+        switch (attr & ADMA_ACT_MASK) {
+        case ADMA_ACT_LINK:
+            adma_system_address = desc[1];
             break;
 
-        sdma_system_address += blksz;
-        offset += blksz;
+        case ADMA_ACT_TRAN:
+            adma_system_address += sizeof(desc);
+            m_dma_addr = desc[1];
+            m_dma_seglen = length ? length : 65536;
+            m_dma_segint = attr & ADMA_INT;
+            return true;
 
-        block_count_16_bit -= 1;
-        if (block_count_16_bit == 0)
+        default:
+            adma_system_address += sizeof(desc);
             break;
+        }
+    }
 
-        transfer_data_from_sd();
+    log_warn("too many ADMA descriptors without data transfer");
+    return adma_error(ADMA_ERR_ST_FDS);
+}
+
+void sdhci::dma_segment_done() {
+    // ADMA2 descriptors with the INT attribute interrupt once their data
+    // has moved, this includes the last one before the transfer completes
+    if (!is_adma2() || !m_dma_segint)
+        return;
+
+    normal_int_stat |= INT_DMA_INTERRUPT;
+    irq.write(true);
+    m_dma_segint = false;
+}
+
+bool sdhci::dma_to_memory(size_t len) {
+    size_t blksz = block_size & 0xfff;
+    while (len > 0) {
+        if (m_dma_bufpos == m_dma_buf.size()) {
+            // whole blocks move straight from the card into guest memory
+            size_t n = len - len % blksz;
+            u8* ptr = nullptr;
+            if (n > 0)
+                ptr = out.lookup_dmi_ptr(m_dma_addr, n, VCML_ACCESS_WRITE);
+
+            if (ptr) {
+                if (!read_sd_blocks(ptr, n))
+                    return false;
+                dma_advance(n);
+                len -= n;
+                continue;
+            }
+
+            size_t nblk = (len + blksz - 1) / blksz;
+            m_dma_buf.resize(nblk * blksz);
+            m_dma_bufpos = 0;
+            if (!read_sd_blocks(m_dma_buf.data(), m_dma_buf.size()))
+                return false;
+        }
+
+        size_t n = min(len, m_dma_buf.size() - m_dma_bufpos);
+        tlm_response_status rs = out.write(m_dma_addr,
+                                           m_dma_buf.data() + m_dma_bufpos, n);
+        if (failed(rs)) {
+            log_warn("DMA failed: %s", tlm_response_to_str(rs));
+            return false;
+        }
+
+        m_dma_bufpos += n;
+        dma_advance(n);
+        len -= n;
     }
 
-    return rs;
+    return true;
 }
 
-tlm_response_status sdhci::dma_write(u32 boundary) {
-    u32 offset = 0;
-    u32 blksz = block_size & 0xfff;
-    u16 crc;
-    tlm_response_status rs;
+bool sdhci::dma_from_memory(size_t len) {
+    size_t blksz = block_size & 0xfff;
+    while (len > 0) {
+        if (m_dma_buf.empty() && len >= blksz) {
+            // whole blocks move straight from guest memory onto the card
+            size_t n = len - len % blksz;
+            u8* ptr = out.lookup_dmi_ptr(m_dma_addr, n, VCML_ACCESS_READ);
+            if (ptr) {
+                if (!write_sd_blocks(ptr, n))
+                    return false;
+                dma_advance(n);
+                len -= n;
+                continue;
+            }
+        }
+
+        size_t pos = m_dma_buf.size();
+        m_dma_buf.resize(pos + len);
+        tlm_response_status rs = out.read(m_dma_addr, m_dma_buf.data() + pos,
+                                          len);
+        if (failed(rs)) {
+            log_warn("DMA failed: %s", tlm_response_to_str(rs));
+            return false;
+        }
+
+        dma_advance(len);
+        len = 0;
 
+        size_t n = m_dma_buf.size() - m_dma_buf.size() % blksz;
+        if (n > 0) {
+            if (!write_sd_blocks(m_dma_buf.data(), n))
+                return false;
+            m_dma_buf.erase(m_dma_buf.begin(), m_dma_buf.begin() + n);
+        }
+    }
+
+    return true;
+}
+
+void sdhci::dma_thread() {
     while (true) {
-        if (offset + blksz >= boundary) {
-            // this is never happens with Linux...
-            VCML_ERROR("SDMA boundary exceeded, not implemented");
+        wait(m_dma_start);
+
+        m_dma_addr = sdma_system_address;
+        m_dma_seglen = 0;
+        m_dma_segint = false;
+        m_dma_abort = false;
+        m_adma_end = false;
+        m_dma_buf.clear();
+        m_dma_bufpos = 0;
+
+        bool ok = false;
+        if (m_cmd.status == SD_OK_TX_RDY) {
+            ok = dma_read();
+        } else if (m_cmd.status == SD_OK_RX_RDY) {
+            ok = dma_write();
+        } else {
+            VCML_ERROR("illegal state for DMA command");
         }
 
-        rs = out.read(sdma_system_address, m_buffer, blksz);
-        if (failed(rs))
-            break;
+        if (m_dma_abort)
+            continue;
 
-        sdma_system_address += blksz;
-        offset += blksz;
+        set_present_state(~DAT_LINE_ACTIVE);
+        if (ok || !(error_int_stat & ERR_ADMA))
+            normal_int_stat |= INT_TRANSFER_COMPLETE;
+        else
+            normal_int_stat |= INT_ERROR;
+        irq.write(true);
+    }
+}
 
-        crc = crc16(m_buffer, blksz);
-        m_buffer[blksz + 0] = (u8)(crc >> 8);
-        m_buffer[blksz + 1] = (u8)(crc >> 0);
+bool sdhci::dma_read() {
+    size_t blksz = block_size & 0xfff;
+    size_t remaining = block_count_16_bit * blksz;
 
-        transfer_data_to_sd();
+    while (remaining > 0) {
+        if (m_dma_seglen == 0 && !dma_next_segment())
+            return false;
 
-        block_count_16_bit -= 1;
-        if (block_count_16_bit == 0)
-            break;
+        size_t len = min(m_dma_seglen, remaining);
+        if (!dma_to_memory(len))
+            return false;
+
+        remaining -= len;
+        if (m_dma_seglen == 0 || remaining == 0)
+            dma_segment_done();
     }
 
-    return rs;
+    return true;
+}
+
+bool sdhci::dma_write() {
+    size_t blksz = block_size & 0xfff;
+    size_t remaining = block_count_16_bit * blksz;
+
+    while (remaining > 0) {
+        if (m_dma_seglen == 0 && !dma_next_segment())
+            return false;
+
+        size_t len = min(m_dma_seglen, remaining);
+        if (!dma_from_memory(len))
+            return false;
+
+        remaining -= len;
+        if (m_dma_seglen == 0 || remaining == 0)
+            dma_segment_done();
+    }
+
+    return true;
 }
 
 sdhci::sdhci(const sc_module_name& nm):
     peripheral(nm),
     m_cmd(),
     m_bufptr(0),
+    m_dma_addr(0),
+    m_dma_seglen(0),
+    m_dma_segint(false),
+    m_dma_abort(false),
+    m_adma_end(false),
+    m_dma_buf(),
+    m_dma_bufpos(0),
     m_dma_start("dma_start"),
+    m_dma_resume("dma_resume"),
     sdma_system_address("sdma_system_address", 0x000, 0x00000000),
     block_size("block_size", 0x004, 0x0000),
     block_count_16_bit("block_count_16_bit", 0x006, 0x0000),
@@ -485,16 +726,20 @@ sdhci::sdhci(const sc_module_name& nm):
     error_int_sig_enable("error_int_sig_enable", 0x03a, 0x0000),
     capabilities("capabilities", 0x040, 0x00000000),
     max_curr_cap("max_curr_cap", 0x048, 0x00000001),
+    adma_error_status("adma_error_status", 0x054, 0x00),
+    adma_system_address("adma_system_address", 0x058, 0x00000000),
     host_controller_version("host_controller_version", 0x0fe, 0x0000),
     f_sd_h30_ahb_config("f_sd_h30_ahb_config", 0x100, 0x00),
     f_sd_h30_esd_control("f_sd_h30_esd_control", 0x124, 0x00),
     dma_enabled("dma_enabled", true),
+    adma_enabled("adma_enabled", true),
     irq("irq"),
     in("in"),
     out("out"),
     sd_out("sd_out") {
     sdma_system_address.sync_on_write();
     sdma_system_address.allow_read_write();
+    sdma_system_address.on_write(&sdhci::write_sdma_system_address);
 
     block_size.sync_never();
     block_size.allow_read_write();
@@ -568,8 +813,15 @@ sdhci::sdhci(const sc_module_name& nm):
     max_curr_cap.sync_never();
     max_curr_cap.allow_read_only();
 
-    host_controller_version.sync_never();
+    adma_error_status.sync_never();
+    adma_error_status.allow_read_only();
+
+    adma_system_address.sync_never();
+    adma_system_address.allow_read_write();
+
+    host_controller_version.sync_always();
     host_controller_version.allow_read_only();
+    host_controller_version.on_read(&sdhci::read_host_controller_version);
 
     f_sd_h30_ahb_config.sync_never();
     f_sd_h30_ahb_config.allow_read_write();
@@ -588,6 +840,9 @@ sdhci::~sdhci() {
 void sdhci::reset() {
     peripheral::reset();
     capabilities[0] = CAPABILITY_VALUES_0;
+
+    m_dma_abort = true;
+    m_dma_resume.notify(SC_ZERO_TIME);
 }
 
 VCML_EXPORT_MODEL(vcml::sd::sdhci, name, args) {
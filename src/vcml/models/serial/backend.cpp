@@ -31,6 +31,18 @@ backend::~backend() {
         m_term->detach(this);
 }
 
+size_t backend::read(u8* buf, size_t len) {
+    size_t n = 0;
+    while (n < len && read(buf[n]))
+        n++;
+    return n;
+}
+
+void backend::write(const u8* buf, size_t len) {
+    for (size_t i = 0; i < len; i++)
+        write(buf[i]);
+}
+
 static backend* stdin_owner = nullptr;
 
 void backend::capture_stdin() {
@@ -29,6 +29,14 @@ void backend_fd::write(u8 val) {
     mwr::fd_write(m_fd, &val, sizeof(val));
 }
 
+size_t backend_fd::read(u8* buf, size_t len) {
+    return 0;
+}
+
+void backend_fd::write(const u8* buf, size_t len) {
+    mwr::fd_write(m_fd, buf, len);
+}
+
 backend* backend_fd::create_stdout(terminal* term, const vector<string>& a) {
     return new backend_fd(term, STDOUT_FDNO);
 }
@@ -32,6 +32,9 @@ public:
     virtual bool read(u8& val) override;
     virtual void write(u8 val) override;
 
+    virtual size_t read(u8* buf, size_t len) override;
+    virtual void write(const u8* buf, size_t len) override;
+
     static backend* create_stdout(terminal* term, const vector<string>& args);
     static backend* create_stderr(terminal* term, const vector<string>& args);
 };
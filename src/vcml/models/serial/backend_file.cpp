@@ -39,6 +39,18 @@ bool backend_file::read(u8& val) {
 }
 
 void backend_file::write(u8 val) {
+    write(&val, sizeof(val));
+}
+
+size_t backend_file::read(u8* buf, size_t len) {
+    if (!m_rx.is_open() || !m_rx.good())
+        return 0;
+
+    m_rx.read(reinterpret_cast<char*>(buf), len);
+    return m_rx.gcount();
+}
+
+void backend_file::write(const u8* buf, size_t len) {
     if (!m_tx && !m_tx_file.empty()) {
         auto mode = ofstream::binary | ofstream::app | ofstream::out;
         m_tx.open(m_tx_file, mode);
@@ -49,7 +61,7 @@ void backend_file::write(u8 val) {
     }
 
     if (m_tx) {
-        m_tx.write(reinterpret_cast<const char*>(&val), sizeof(val));
+        m_tx.write(reinterpret_cast<const char*>(buf), len);
         m_tx.flush();
     }
 }
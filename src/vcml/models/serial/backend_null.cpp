@@ -29,6 +29,14 @@ void backend_null::write(u8 val) {
     // nothing to do
 }
 
+size_t backend_null::read(u8* buf, size_t len) {
+    return 0;
+}
+
+void backend_null::write(const u8* buf, size_t len) {
+    // nothing to do
+}
+
 backend* backend_null::create(terminal* term, const vector<string>& args) {
     return new backend_null(term);
 }
@@ -67,9 +67,24 @@ bool backend_tcp::read(u8& val) {
 }
 
 void backend_tcp::write(u8 val) {
+    write(&val, sizeof(val));
+}
+
+size_t backend_tcp::read(u8* buf, size_t len) {
+    lock_guard<mutex> guard(m_mtx);
+    size_t n = 0;
+    for (; n < len && !m_fifo.empty(); n++) {
+        buf[n] = m_fifo.front();
+        m_fifo.pop();
+    }
+
+    return n;
+}
+
+void backend_tcp::write(const u8* buf, size_t len) {
     for (int client : m_socket.clients()) {
         try {
-            m_socket.send_char(client, val);
+            m_socket.send(client, buf, len);
         } catch (...) {
             // nothing to do
         }
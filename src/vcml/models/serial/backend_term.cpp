@@ -112,6 +112,21 @@ void backend_term::write(u8 val) {
     mwr::fd_write(m_fdout, &val, sizeof(val));
 }
 
+size_t backend_term::read(u8* buf, size_t len) {
+    lock_guard<mutex> lock(m_mtx);
+    size_t n = 0;
+    for (; n < len && !m_fifo.empty(); n++) {
+        buf[n] = m_fifo.front();
+        m_fifo.pop();
+    }
+
+    return n;
+}
+
+void backend_term::write(const u8* buf, size_t len) {
+    mwr::fd_write(m_fdout, buf, len);
+}
+
 backend* backend_term::create(terminal* term, const vector<string>& args) {
     return new backend_term(term);
 }
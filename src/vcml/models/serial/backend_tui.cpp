@@ -187,15 +187,37 @@ bool backend_tui::read(u8& value) {
 }
 
 void backend_tui::write(u8 val) {
+    write(&val, sizeof(val));
+}
+
+size_t backend_tui::read(u8* buf, size_t len) {
+    lock_guard<mutex> lock(m_mtx);
+    size_t n = 0;
+    for (; n < len && !m_fifo.empty(); n++) {
+        buf[n] = m_fifo.front();
+        m_fifo.pop();
+    }
+
+    return n;
+}
+
+void backend_tui::write(const u8* buf, size_t len) {
     lock_guard<mutex> lock(m_mtx);
-    if (val == '\n' || m_linebuf.length() >= max_cols) {
-        string line = mkstr("\r\x1b[K%s\n", m_linebuf.c_str());
-        mwr::fd_write(m_fdout, line.data(), line.size());
-        m_linebuf.clear();
-    } else {
-        m_linebuf.push_back(val);
+
+    // collect all completed lines and emit them with a single write
+    string lines;
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] == '\n' || m_linebuf.length() >= max_cols) {
+            lines += mkstr("\r\x1b[K%s\n", m_linebuf.c_str());
+            m_linebuf.clear();
+        } else {
+            m_linebuf.push_back(buf[i]);
+        }
     }
 
+    if (!lines.empty())
+        mwr::fd_write(m_fdout, lines.data(), lines.size());
+
     draw_statusbar();
 }
 
@@ -119,11 +119,13 @@ bool terminal::cmd_history(const vector<string>& args, ostream& os) {
 void terminal::serial_transmit() {
     while (true) {
         for (backend* b : m_listeners) {
-            u8 data = 0xff;
-            while (b->read(data)) {
-                serial_tx.send(data);
+            m_txbuf.resize(max<size_t>(burst, 1));
+            size_t n = 0;
+            while ((n = b->read(m_txbuf.data(), m_txbuf.size())) > 0) {
+                for (size_t i = 0; i < n; i++)
+                    serial_tx.send(m_txbuf[i]);
                 if (!untimed)
-                    wait(serial_tx.cycle());
+                    wait(serial_tx.cycle() * (double)n);
             }
         }
 
@@ -131,10 +133,24 @@ void terminal::serial_transmit() {
     }
 }
 
+void terminal::flush_backends() {
+    m_flush_ev.cancel();
+    if (m_rxbuf.empty())
+        return;
+
+    for (backend* b : m_listeners)
+        b->write(m_rxbuf.data(), m_rxbuf.size());
+    m_rxbuf.clear();
+}
+
 void terminal::serial_receive(u8 data) {
     m_hist.insert(data);
-    for (backend* b : m_listeners)
-        b->write(data);
+    m_rxbuf.push_back(data);
+
+    if (m_rxbuf.size() >= flush_size || flush_interval == SC_ZERO_TIME)
+        flush_backends();
+    else
+        m_flush_ev.notify(flush_interval);
 }
 
 unordered_map<string, terminal*>& terminal::terminals() {
@@ -148,10 +164,16 @@ terminal::terminal(const sc_module_name& nm):
     m_next_id(),
     m_backends(),
     m_listeners(),
+    m_rxbuf(),
+    m_txbuf(),
     m_async_ev("async_ev"),
+    m_flush_ev("flush_ev"),
     backends("backends", ""),
     config("config", "9600N8"),
     untimed("untimed", false),
+    burst("burst", 1),
+    flush_size("flush_size", 64),
+    flush_interval("flush_interval", sc_time(1.0, SC_MS)),
     serial_tx("serial_tx"),
     serial_rx("serial_rx") {
     if (stl_contains(terminals(), string(name())))
@@ -193,15 +215,30 @@ terminal::terminal(const sc_module_name& nm):
 
     SC_HAS_PROCESS(terminal);
     SC_THREAD(serial_transmit);
+
+    SC_METHOD(flush_backends);
+    sensitive << m_flush_ev;
+    dont_initialize();
 }
 
 terminal::~terminal() {
+    flush_backends();
     for (auto it : m_backends)
         delete it.second;
 
     terminals().erase(name());
 }
 
+void terminal::session_suspend() {
+    module::session_suspend();
+    flush_backends();
+}
+
+void terminal::end_of_simulation() {
+    flush_backends();
+    module::end_of_simulation();
+}
+
 void terminal::attach(backend* b) {
     if (stl_contains(m_listeners, b))
         VCML_ERROR("attempt to attach backend twice");
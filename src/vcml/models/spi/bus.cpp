@@ -13,8 +13,22 @@
 namespace vcml {
 namespace spi {
 
+void bus::update_active() {
+    m_active.clear();
+    for (const auto& port : cs) {
+        if (is_active(port.first))
+            m_active.push_back(port.first);
+    }
+}
+
 bus::bus(const sc_module_name& nm):
-    component(nm), spi_host(), spi_in("spi_in"), spi_out("spi_out"), cs("cs") {
+    component(nm),
+    spi_host(),
+    m_csmode(),
+    m_active(),
+    spi_in("spi_in"),
+    spi_out("spi_out"),
+    cs("cs") {
 }
 
 bus::~bus() {
@@ -23,6 +37,7 @@ bus::~bus() {
 
 void bus::reset() {
     component::reset();
+    update_active();
 }
 
 bool bus::is_valid(unsigned int port) const {
@@ -52,10 +67,12 @@ bool bus::is_active_low(unsigned int port) const {
 }
 
 void bus::spi_transport(const spi_target_socket&, spi_payload& spi) {
-    for (auto port : cs) {
-        if (is_active(port.first))
-            spi_out[port.first].transport(spi);
-    }
+    for (unsigned int port : m_active)
+        spi_out[port].transport(spi);
+}
+
+void bus::spi_burst(const spi_target_socket& socket, spi_payload& spi) {
+    spi_transport(socket, spi);
 }
 
 unsigned int bus::next_free() const {
@@ -75,9 +92,14 @@ unsigned int bus::bind(spi_target_socket& target, gpio_initiator_socket& s,
     spi_out[port].bind(target);
     s.bind(cs[port]);
     m_csmode[port] = cs_active_high;
+    update_active();
     return port;
 }
 
+void bus::gpio_notify(const gpio_target_socket& socket) {
+    update_active();
+}
+
 VCML_EXPORT_MODEL(vcml::spi::bus, name, args) {
     return new bus(name);
 }
@@ -192,11 +192,55 @@ u8 flash::process(u8 mosi) {
     }
 }
 
+size_t flash::process_storage(spi_payload& tx, size_t offset) {
+    size_t n = min<u64>(tx.length - offset, size() - m_address);
+    m_burst.resize(n);
+    disk.seek(m_address);
+
+    if (m_state == STATE_READING_STORAGE) {
+        disk.read(m_burst.data(), n);
+        if (tx.miso_buf) {
+            for (size_t i = 0; i < n; i++)
+                tx.miso_buf[offset + i] = m_burst[i] & tx.mask;
+        }
+    } else {
+        for (size_t i = 0; i < n; i++)
+            m_burst[i] = tx.mosi_buf[offset + i] & tx.mask;
+        disk.write(m_burst.data(), n);
+        if (tx.miso_buf)
+            memset(tx.miso_buf + offset, 0, n * sizeof(*tx.miso_buf));
+    }
+
+    m_address = (m_address + n) % size();
+    return n;
+}
+
 void flash::spi_transport(const spi_target_socket& socket, spi_payload& tx) {
     if (cs_in)
         tx.miso = process(tx.mosi & tx.mask) & tx.mask;
 }
 
+void flash::spi_burst(const spi_target_socket& socket, spi_payload& tx) {
+    if (!cs_in)
+        return;
+
+    size_t pos = 0;
+    while (pos < tx.length) {
+        // storage reads and programming consume the rest of the burst, so
+        // they are served with one disk access up to the end of the flash
+        if (m_state == STATE_READING_STORAGE ||
+            (m_state == STATE_PROGRAMMING && m_write_enable)) {
+            pos += process_storage(tx, pos);
+            continue;
+        }
+
+        u8 miso = process(tx.mosi_buf[pos] & tx.mask) & tx.mask;
+        if (tx.miso_buf)
+            tx.miso_buf[pos] = miso;
+        pos++;
+    }
+}
+
 flash::flash(const sc_module_name& nm, const string& dev):
     component(nm),
     spi_host(),
@@ -209,6 +253,7 @@ flash::flash(const sc_module_name& nm, const string& dev):
     m_write_enable(),
     m_address(),
     m_buffer(),
+    m_burst(),
     device("device", dev),
     image("image", ""),
     readonly("readonly", false),
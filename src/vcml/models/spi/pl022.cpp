@@ -130,20 +130,28 @@ void pl022::transmit() {
         sr |= SR_BSY;
 
         while (!m_txff.empty() && (cr1 & CR1_SSE)) {
-            spi_payload tx;
-            tx.mosi = m_txff.pop();
-            tx.mask = pl022_data_mask(cr0);
-            wait(sc_time(1.0 / sclk, SC_SEC));
-
-            if (cr1 & CR1_LBM)
-                tx.miso = tx.mosi;
-            else
+            // send the whole fifo content as one burst and account for
+            // the time of all frames at once
+            size_t n = 0;
+            while (!m_txff.empty() && n < FIFO_SIZE)
+                m_mosi[n++] = m_txff.pop();
+
+            wait(sc_time((double)n / sclk, SC_SEC));
+
+            if (cr1 & CR1_LBM) {
+                memcpy(m_miso, m_mosi, n * sizeof(m_mosi[0]));
+            } else {
+                memset(m_miso, 0, n * sizeof(m_miso[0]));
+                spi_payload tx(m_mosi, m_miso, n, pl022_data_mask(cr0));
                 spi_out->spi_transport(tx);
-
-            if (!m_rxff.full())
-                m_rxff.push(tx.miso);
-            else
-                ris |= IRQ_ROR;
+            }
+
+            for (size_t i = 0; i < n; i++) {
+                if (!m_rxff.full())
+                    m_rxff.push(m_miso[i]);
+                else
+                    ris |= IRQ_ROR;
+            }
         }
 
         sr &= ~SR_BSY;
@@ -280,8 +288,10 @@ void pl022::write_dmacr(u16 val, bool debug) {
 pl022::pl022(const sc_module_name& nm):
     peripheral(nm),
     m_ev("ev"),
-    m_txff(8),
-    m_rxff(8),
+    m_txff(FIFO_SIZE),
+    m_rxff(FIFO_SIZE),
+    m_mosi(),
+    m_miso(),
     cr0("cr0", 0x00, 0x0000),
     cr1("cr1", 0x04, 0x0000),
     dr("dr", 0x08, 0x0000),
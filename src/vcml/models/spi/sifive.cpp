@@ -229,6 +229,9 @@ constexpr u8 format_data(u8 data, u32 fmt) {
 }
 
 void sifive::transmit() {
+    u32 mosi[FIFO_CAPACITY];
+    u32 miso[FIFO_CAPACITY];
+
     while (true) {
         wait(m_ev);
 
@@ -239,13 +242,27 @@ void sifive::transmit() {
             if (mode != CSMODE_OFF)
                 update_cs(true);
 
-            spi_payload tx;
-            tx.mask = 0xff;
-            tx.mosi = format_data(m_txff.pop(), fmt);
-            spi_out.transport(tx);
-
-            if (!m_rxff.full() && !(fmt & FMT_DIR))
-                m_rxff.push(tx.miso);
+            // chip select only toggles between frames in auto mode, all
+            // other modes allow sending the whole fifo as one burst
+            size_t n = 0;
+            do {
+                mosi[n++] = format_data(m_txff.pop(), fmt);
+            } while (mode != CSMODE_AUTO && !m_txff.empty() &&
+                     n < FIFO_CAPACITY);
+
+            if (n > 1) {
+                memset(miso, 0, sizeof(miso));
+                spi_out.transport(mosi, miso, n);
+            } else {
+                spi_payload tx(mosi[0]);
+                spi_out.transport(tx);
+                miso[0] = tx.miso;
+            }
+
+            for (size_t i = 0; i < n; i++) {
+                if (!m_rxff.full() && !(fmt & FMT_DIR))
+                    m_rxff.push(miso[i]);
+            }
 
             if (mode == CSMODE_AUTO)
                 update_cs(false);
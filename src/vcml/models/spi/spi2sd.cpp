@@ -185,6 +185,17 @@ void spi2sd::spi_transport(const spi_target_socket& socket, spi_payload& spi) {
         spi.miso = do_spi_transport(spi.mosi & spi.mask);
 }
 
+void spi2sd::spi_burst(const spi_target_socket& socket, spi_payload& spi) {
+    if (cs != cs_active_high)
+        return;
+
+    for (size_t i = 0; i < spi.length; i++) {
+        u8 miso = do_spi_transport(spi.mosi_buf[i] & spi.mask);
+        if (spi.miso_buf)
+            spi.miso_buf[i] = miso;
+    }
+}
+
 VCML_EXPORT_MODEL(vcml::spi::spi2sd, name, args) {
     return new spi2sd(name);
 }
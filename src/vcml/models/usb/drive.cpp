@@ -119,6 +119,8 @@ drive::drive(const sc_module_name& nm, const string& img, bool ro, bool wi):
     m_mode(MODE_CBW),
     m_req(),
     m_buflen(),
+    m_bufpos(),
+    m_pending(),
     m_status(),
     m_tag(),
     usb3("usb3", true),
@@ -153,6 +155,17 @@ drive::~drive() {
     // nothing to do
 }
 
+void drive::execute(u8* buf, size_t len) {
+    m_req.buffers.clear();
+    if (buf != nullptr)
+        m_req.buffers.push_back({ buf, len });
+
+    if (failed(disk.scsi_handle_command(m_req)))
+        m_status = STS_ERROR;
+
+    m_req.buffers.clear();
+}
+
 usb_result drive::get_data(u32 ep, u8* data, size_t len) {
     if (ep != 1) {
         log_warn("invalid input endpoint: %u", ep);
@@ -177,11 +190,29 @@ usb_result drive::get_data(u32 ep, u8* data, size_t len) {
     }
 
     case MODE_DATA_IN: {
+        if (m_pending) {
+            m_pending = false;
+
+            // the host fetches all data at once: read straight into its
+            // packet buffer instead of staging the data in the payload
+            if (len >= m_buflen) {
+                execute(data, m_buflen);
+                if (m_status != STS_SUCCESS)
+                    memset(data, 0xee, m_buflen);
+                m_mode = MODE_CSW;
+                return USB_RESULT_SUCCESS;
+            }
+
+            execute(nullptr, 0);
+            if (m_status != STS_SUCCESS)
+                m_req.payload.assign(m_buflen, 0xee);
+        }
+
         auto& buf = m_req.payload;
-        len = min(len, buf.size());
-        memcpy(data, buf.data(), len);
-        buf.erase(buf.begin(), buf.begin() + len);
-        if (buf.empty())
+        len = min(len, buf.size() - m_bufpos);
+        memcpy(data, buf.data() + m_bufpos, len);
+        m_bufpos += len;
+        if (m_bufpos >= buf.size())
             m_mode = MODE_CSW;
         return USB_RESULT_SUCCESS;
     }
@@ -218,30 +249,42 @@ usb_result drive::set_data(u32 ep, const u8* data, size_t len) {
         }
 
         memcpy(m_req.command, cbw.cmd, 16);
+        m_req.tag = cbw.tag;
         m_buflen = cbw.data_len;
+        m_bufpos = 0;
         m_status = STS_SUCCESS;
         m_tag = cbw.tag;
 
-        if (cbw.flags & 0x80) {
+        // commands with a data phase run once its first packet arrives
+        m_req.payload.clear();
+        m_pending = m_buflen > 0;
+        if (cbw.flags & 0x80)
             m_mode = m_buflen ? MODE_DATA_IN : MODE_CSW;
-            if (failed(disk.scsi_handle_command(m_req))) {
-                m_req.payload.assign(m_buflen, 0xee);
-                m_status = STS_ERROR;
-            }
-        } else {
-            m_req.payload.clear();
+        else
             m_mode = m_buflen ? MODE_DATA_OUT : MODE_CSW;
-        }
+
+        if (!m_pending)
+            execute(nullptr, 0);
 
         return USB_RESULT_SUCCESS;
     }
 
     case MODE_DATA_OUT: {
-        len = min(len, m_buflen);
+        if (m_pending) {
+            m_pending = false;
+            if (len >= m_buflen) {
+                execute(const_cast<u8*>(data), m_buflen);
+                m_mode = MODE_CSW;
+                return USB_RESULT_SUCCESS;
+            }
+
+            m_req.payload.reserve(m_buflen);
+        }
+
+        len = min(len, m_buflen - m_req.payload.size());
         m_req.payload.insert(m_req.payload.end(), data, data + len);
         if (m_req.payload.size() == m_buflen) {
-            if (failed(disk.scsi_handle_command(m_req)))
-                m_status = STS_SUCCESS;
+            execute(nullptr, 0);
             m_mode = MODE_CSW;
         }
 
@@ -271,6 +314,7 @@ usb_result drive::handle_control(u16 req, u16 val, u16 idx, u8* data,
 void drive::usb_reset_device() {
     device::usb_reset_device();
     m_mode = MODE_CBW;
+    m_pending = false;
     m_req.payload.clear();
 }
 
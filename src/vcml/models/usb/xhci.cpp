@@ -1033,42 +1033,107 @@ void xhci::send_port_event(size_t intr, u32 ccode, u64 portid) {
     send_event(intr, event);
 }
 
-u32 xhci::handle_transmit(u32 slotid, u32 epid, trb& cmd) {
+u32 xhci::fetch_td(endpoint* ep, bool dirin, trb& request, u64& addr) {
+    bool ioc = false;
+    m_sglist.clear();
+
+    while (true) {
+        u32 size = get_trb_data_length(request);
+        if (get_trb_type(request) == TRB_TR_EVDATA) {
+            // event data TRBs carry no payload
+        } else if (request.control & TRB_IDT) {
+            // immediate data can only be sent, never received
+            if (dirin || size > sizeof(request.parameter))
+                return TRB_CC_TRB_ERROR;
+            m_sglist.push_back({ request.parameter, size, true });
+        } else if (size > 0) {
+            m_sglist.push_back({ request.parameter, size, false });
+        }
+
+        if (request.control & TRB_IOC)
+            ioc = true;
+        if (!(request.control & TRB_CH))
+            break;
+
+        trb next;
+        while (true) {
+            if (failed(dma.readw(ep->tr.dequeue, next)))
+                return TRB_CC_DATA_BUFFER_ERROR;
+
+            bool ccs = next.control & TRB_C;
+            if (ccs != ep->tr.ccs)
+                return TRB_CC_INVALID; // TD not yet fully enqueued
+
+            if (get_trb_type(next) != TRB_LINK)
+                break;
+
+            ep->tr.dequeue = next.parameter;
+            if (next.control & TRB_TC)
+                ep->tr.ccs = !ep->tr.ccs;
+        }
+
+        addr = ep->tr.dequeue;
+        ep->tr.dequeue += TRB_SIZE;
+        request = next;
+    }
+
+    if (ioc)
+        request.control |= TRB_IOC;
+
+    return TRB_CC_SUCCESS;
+}
+
+u32 xhci::handle_transmit(u32 slotid, u32 epid, bool dirin) {
     auto slot = m_slots + slotid;
     auto ep = slot->endpoints + epid;
     VCML_ERROR_ON(ep->state != EP_RUNNING, "ep%u not running", epid);
 
-    bool dirin = (epid & 1) == 0;
-    if (epid == 0)
-        dirin = cmd.control & TRB_DIR;
+    size_t size = 0;
+    for (const sgentry& sg : m_sglist)
+        size += sg.size;
 
-    u64 addr = cmd.parameter;
-    u32 size = get_trb_data_length(cmd);
-    u32 epno = (epid + 1) / 2;
-    for (u32 off = 0; off < size; off += ep->max_psize) {
-        vector<u8> buf(min(size - off, ep->max_psize));
+    if (size == 0)
+        return TRB_CC_SUCCESS;
 
-        if (dirin) {
-            auto packet = usb_packet_in(slotid, epno, buf.data(), buf.size());
-            usb_out[slot->port].send(packet);
-            if (failed(packet))
-                return usb_packet_ccode(packet);
-            if (failed(dma.write(addr + off, buf.data(), buf.size())))
+    // TDs with a single buffer are handed to the device directly if the
+    // buffer is DMI accessible, otherwise the TD is gathered into (or
+    // scattered from) one intermediate buffer
+    u8* data = nullptr;
+    if (m_sglist.size() == 1 && !m_sglist[0].imm) {
+        vcml_access rw = dirin ? VCML_ACCESS_WRITE : VCML_ACCESS_READ;
+        data = dma.lookup_dmi_ptr(m_sglist[0].addr, size, rw);
+    }
+
+    bool direct = data != nullptr;
+    if (!direct) {
+        m_xferbuf.resize(size);
+        data = m_xferbuf.data();
+    }
+
+    u32 epno = (epid + 1) / 2;
+    if (!dirin && !direct) {
+        size_t off = 0;
+        for (const sgentry& sg : m_sglist) {
+            if (sg.imm)
+                memcpy(data + off, &sg.addr, sg.size);
+            else if (failed(dma.read(sg.addr, data + off, sg.size)))
                 return TRB_CC_DATA_BUFFER_ERROR;
-        } else {
-            if (cmd.control & TRB_IDT) {
-                if (size > sizeof(cmd.parameter))
-                    return TRB_CC_TRB_ERROR;
-                memcpy(buf.data(), (u8*)&cmd.parameter + off, buf.size());
-            } else {
-                if (failed(dma.read(addr + off, buf.data(), buf.size())))
-                    return TRB_CC_DATA_BUFFER_ERROR;
-            }
+            off += sg.size;
+        }
+    }
 
-            auto packet = usb_packet_out(slotid, epno, buf.data(), buf.size());
-            usb_out[slot->port].send(packet);
-            if (failed(packet))
-                return usb_packet_ccode(packet);
+    auto packet = dirin ? usb_packet_in(slotid, epno, data, size)
+                        : usb_packet_out(slotid, epno, data, size);
+    usb_out[slot->port].send(packet);
+    if (failed(packet))
+        return usb_packet_ccode(packet);
+
+    if (dirin && !direct) {
+        size_t off = 0;
+        for (const sgentry& sg : m_sglist) {
+            if (failed(dma.write(sg.addr, data + off, sg.size)))
+                return TRB_CC_DATA_BUFFER_ERROR;
+            off += sg.size;
         }
     }
 
@@ -1123,6 +1188,7 @@ void xhci::run_transfer(u32 slotid, u32 epid) {
 
     while (ep->state == EP_RUNNING) {
         trb request;
+        ring start = ep->tr;
         u64 dequeue = ep->tr.dequeue;
         if (failed(dma.readw(dequeue, request))) {
             log_warn("failed to read transfer data at 0x%llx", dequeue);
@@ -1161,7 +1227,15 @@ void xhci::run_transfer(u32 slotid, u32 epid) {
         }
 
         case TRB_TR_DATA: {
-            code = handle_transmit(slotid, 0, request);
+            bool dirin = request.control & TRB_DIR;
+            code = fetch_td(ep, dirin, request, dequeue);
+            if (code == TRB_CC_INVALID) {
+                ep->tr = start;
+                return;
+            }
+
+            if (code == TRB_CC_SUCCESS)
+                code = handle_transmit(slotid, 0, dirin);
             break;
         }
 
@@ -1181,7 +1255,15 @@ void xhci::run_transfer(u32 slotid, u32 epid) {
 
         case TRB_TR_ISOCH:
         case TRB_TR_NORMAL: {
-            code = handle_transmit(slotid, epid, request);
+            bool dirin = (epid & 1) == 0;
+            code = fetch_td(ep, dirin, request, dequeue);
+            if (code == TRB_CC_INVALID) {
+                ep->tr = start;
+                return;
+            }
+
+            if (code == TRB_CC_SUCCESS)
+                code = handle_transmit(slotid, epid, dirin);
             break;
         }
 
@@ -1908,6 +1990,8 @@ xhci::xhci(const sc_module_name& nm):
     m_events(),
     m_cmdring(),
     m_slots(),
+    m_sglist(),
+    m_xferbuf(),
     num_slots("num_slots", 64),
     num_ports("num_ports", 4),
     num_intrs("num_intrs", 1),
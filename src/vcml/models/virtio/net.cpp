@@ -75,6 +75,10 @@ enum virtio_net_ctrl_mac : u8 {
     VIRTIO_NET_CTRL_MAC_SET = 1,
 };
 
+enum virtio_net_ctrl_mq : u8 {
+    VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET = 0,
+};
+
 bool net::filter(const eth_frame& frame) {
     if (m_promisc)
         return true;
@@ -115,9 +119,15 @@ bool net::filter(const eth_frame& frame) {
     return false;
 }
 
+size_t net::steer(const eth_frame& frame) const {
+    if (m_active_pairs <= 1)
+        return 0;
+    return frame.flow_hash() % m_active_pairs;
+}
+
 void net::handle_ctrl() {
     vq_message msg;
-    while (virtio_in->get(VIRTQUEUE_CTRL, msg)) {
+    while (virtio_in->get(ctrlq(), msg)) {
         u8 command;
         msg.copy_in(command, 0);
 
@@ -131,11 +141,14 @@ void net::handle_ctrl() {
         case VIRTIO_NET_CTRL_MAC:
             handle_ctrl_mac_addr(msg);
             break;
+        case VIRTIO_NET_CTRL_MQ:
+            handle_ctrl_mq(msg);
+            break;
         default:
             log_warn("unsupported command class: %hhu", command);
         }
 
-        if (!virtio_in->put(VIRTQUEUE_CTRL, msg))
+        if (!virtio_in->put(ctrlq(), msg))
             log_warn("control command failed");
     }
 }
@@ -229,25 +242,118 @@ void net::handle_ctrl_mac_addr(vq_message& msg) {
     }
 }
 
-bool net::handle_rx(vq_message& msg, eth_frame& frame) {
-    if (msg.length_out() < frame.size() + sizeof(virtio_net_hdr)) {
-        log_warn("reception buffer too small: %u", msg.length_out());
-        return false;
+void net::handle_ctrl_mq(vq_message& msg) {
+    u8 subcmd;
+    u16 pairs;
+
+    msg.copy_in(subcmd, 1);
+    msg.copy_in(pairs, 2);
+
+    if (subcmd != VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET) {
+        log_warn("unknown multiqueue command: %hhu", subcmd);
+        msg.copy_out(VIRTIO_NET_CTRL_ERR);
+        return;
+    }
+
+    if (pairs < 1 || pairs > m_pairs.size()) {
+        log_warn("invalid number of queue pairs: %hu", pairs);
+        msg.copy_out(VIRTIO_NET_CTRL_ERR);
+        return;
+    }
+
+    // queues that get disabled hand their pending frames to the first one
+    // and return any buffers they were holding on to back to the driver
+    for (size_t i = pairs; i < m_active_pairs; i++) {
+        queue_pair& qp = *m_pairs[i];
+        for (auto& frame : qp.backlog)
+            m_pairs[0]->backlog.push_back(std::move(frame));
+        qp.backlog.clear();
+
+        for (vq_message& buf : qp.rxbufs) {
+            buf.trim(0);
+            if (!virtio_in->put(qp.rxq, buf))
+                log_warn("failed to return buffer to rx queue %u", qp.rxq);
+        }
+
+        qp.rxbufs.clear();
+    }
+
+    log_debug("using %hu queue pairs", pairs);
+    m_active_pairs = pairs;
+    m_pairs[0]->rxev.notify(SC_ZERO_TIME);
+    msg.copy_out(VIRTIO_NET_CTRL_OK);
+}
+
+bool net::handle_rx(queue_pair& qp, const eth_frame& frame) {
+    const size_t total = frame.size() + sizeof(virtio_net_hdr);
+    const bool merge = has_feature(VIRTIO_NET_F_MRG_RXBUF);
+
+    // buffers already taken from the queue remain with us until the frame
+    // fits, even if we have to wait for the driver to post more of them
+    size_t avail = 0;
+    for (const vq_message& msg : qp.rxbufs)
+        avail += msg.length_out();
+
+    while (avail < total && (merge || qp.rxbufs.empty())) {
+        vq_message msg;
+        if (!virtio_in->get(qp.rxq, msg))
+            return false;
+
+        avail += msg.length_out();
+        qp.rxbufs.push_back(std::move(msg));
+    }
+
+    if (avail < total || qp.rxbufs[0].length_out() < sizeof(virtio_net_hdr)) {
+        log_warn_ratelimited("reception buffer too small: %zu", avail);
+        for (vq_message& msg : qp.rxbufs) {
+            msg.trim(0);
+            if (!virtio_in->put(qp.rxq, msg))
+                log_warn_ratelimited("packet reception failed");
+        }
+
+        qp.rxbufs.clear();
+        return true;
     }
 
     virtio_net_hdr hdr{};
     hdr.flags = 0;
     hdr.gso_type = VIRTIO_NET_HDR_GSO_NONE;
-    hdr.num_buffers = 1;
+    hdr.num_buffers = qp.rxbufs.size();
+
+    if (frame.has_offloads()) {
+        hdr.flags = frame.offload.flags;
+        hdr.gso_type = frame.offload.gso_type;
+        hdr.hdr_len = frame.offload.hdr_len;
+        hdr.gso_size = frame.offload.gso_size;
+        hdr.csum_start = frame.offload.csum_start;
+        hdr.csum_offset = frame.offload.csum_offset;
+    } else if (has_feature(VIRTIO_NET_F_GUEST_CSUM)) {
+        if (frame.offload.flags & eth_frame::OFFLOAD_CSUM_VALID ||
+            eth_checksum_valid(frame.data(), frame.size()))
+            hdr.flags |= VIRTIO_NET_HDR_F_DATA_VALID;
+    }
+
+    size_t offset = 0;
+    for (vq_message& msg : qp.rxbufs) {
+        size_t skip = offset ? 0 : sizeof(hdr);
+        size_t size = min<size_t>(msg.length_out() - skip,
+                                  frame.size() - offset);
+        if (skip)
+            msg.copy_out(hdr);
 
-    msg.copy_out(hdr);
-    msg.copy_out(frame.data(), frame.size(), sizeof(hdr));
-    msg.trim(frame.size() + sizeof(hdr));
+        msg.copy_out(frame.data() + offset, size, skip);
+        msg.trim(skip + size);
+        offset += size;
 
+        if (!virtio_in->put(qp.rxq, msg))
+            log_warn_ratelimited("packet reception failed");
+    }
+
+    qp.rxbufs.clear();
     return true;
 }
 
-bool net::handle_tx(vq_message& msg) {
+bool net::handle_tx(queue_pair& qp, vq_message& msg) {
     virtio_net_hdr header;
 
     if (msg.length_in() <= sizeof(header)) {
@@ -257,50 +363,82 @@ bool net::handle_tx(vq_message& msg) {
 
     msg.copy_in(header);
 
-    if (header.flags) {
+    const u8 known = VIRTIO_NET_HDR_F_NEEDS_CSUM | VIRTIO_NET_HDR_F_DATA_VALID;
+    if (header.flags & ~known) {
         log_warn("unsupported packet flags: %hhx", header.flags);
         return false;
     }
 
-    if (header.gso_type != VIRTIO_NET_HDR_GSO_NONE) {
-        log_warn("unsupported packet gso type: %hu", header.gso_type);
+    // reuse the frame buffer of the queue pair to avoid allocations
+    eth_frame& frame = qp.txframe;
+    frame.resize(msg.length_in() - sizeof(header));
+    msg.copy_in(frame.data(), frame.size(), sizeof(header));
+
+    // offloads travel with the frame; receivers that cannot handle them
+    // get the frame segmented and checksummed by the ethernet layer
+    frame.offload.flags = header.flags & VIRTIO_NET_HDR_F_NEEDS_CSUM;
+    frame.offload.gso_type = header.gso_type;
+    frame.offload.hdr_len = header.hdr_len;
+    frame.offload.gso_size = header.gso_size;
+    frame.offload.csum_start = header.csum_start;
+    frame.offload.csum_offset = header.csum_offset;
+
+    switch (frame.gso_type()) {
+    case VIRTIO_NET_HDR_GSO_NONE:
+        if (frame.size() < eth_frame::FRAME_MIN_SIZE)
+            frame.resize(eth_frame::FRAME_MIN_SIZE);
+        if (frame.size() - eth_frame::FRAME_HEADER_SIZE > m_config.mtu)
+            log_warn("packet exceeds MTU: %zu bytes", frame.size());
+        break;
+
+    case VIRTIO_NET_HDR_GSO_TCPV4:
+    case VIRTIO_NET_HDR_GSO_TCPV6:
+    case VIRTIO_NET_HDR_GSO_UDP:
+        if (header.gso_size == 0) {
+            log_warn("invalid gso size: %hu", header.gso_size);
+            return false;
+        }
+        break;
+
+    default:
+        log_warn("unsupported packet gso type: %hhu", header.gso_type);
         return false;
     }
 
-    eth_frame frame(msg.length_in() - sizeof(header));
-    msg.copy_in(frame.data(), frame.size(), sizeof(header));
-
-    if (frame.size() < eth_frame::FRAME_MIN_SIZE)
-        frame.resize(eth_frame::FRAME_MIN_SIZE);
-    if (frame.size() - eth_frame::FRAME_HEADER_SIZE > m_config.mtu)
-        log_warn("packet exceeds MTU: %zu bytes", frame.size());
+    if (frame.needs_csum() &&
+        header.csum_start + header.csum_offset + 2u > frame.size()) {
+        log_warn("invalid checksum offset: %hu+%hu", header.csum_start,
+                 header.csum_offset);
+        return false;
+    }
 
     eth_tx.send(frame);
     return true;
 }
 
-void net::rx_thread() {
+void net::rx_thread(queue_pair& qp) {
     while (true) {
-        eth_frame frame;
-        while (!eth_rx_pop(frame))
-            wait(m_rxev);
+        while (qp.backlog.empty())
+            wait(qp.rxev);
 
-        vq_message msg;
-        while (!virtio_in->get(VIRTQUEUE_RX, msg))
-            wait(m_rxev);
+        // hand over as many frames as the driver has buffers for
+        while (!qp.backlog.empty() && handle_rx(qp, qp.backlog.front()))
+            qp.backlog.pop_front();
 
-        if (!handle_rx(msg, frame) || !virtio_in->put(VIRTQUEUE_RX, msg))
-            log_warn("packet reception failed");
+        if (!qp.backlog.empty())
+            wait(qp.rxev);
     }
 }
 
-void net::tx_thread() {
+void net::tx_thread(queue_pair& qp) {
+    vq_message msg;
     while (true) {
-        vq_message msg;
-        while (!virtio_in->get(VIRTQUEUE_TX, msg))
-            wait(m_txev);
+        while (!virtio_in->get(qp.txq, msg))
+            wait(qp.txev);
 
-        if (!handle_tx(msg) || !virtio_in->put(VIRTQUEUE_TX, msg))
+        // always return the buffer, even if the packet was dropped
+        bool sent = handle_tx(qp, msg);
+        if (!virtio_in->put(qp.txq, msg) || !sent)
             log_warn("packet transmission failed");
     }
 }
@@ -310,33 +448,46 @@ void net::identify(virtio_device_desc& desc) {
     desc.device_id = VIRTIO_DEVICE_NET;
     desc.vendor_id = VIRTIO_VENDOR_VCML;
     desc.pci_class = PCI_CLASS_NETWORK_ETHERNET;
-    desc.request_virtqueue(VIRTQUEUE_RX, 256);
-    desc.request_virtqueue(VIRTQUEUE_TX, 256);
-    desc.request_virtqueue(VIRTQUEUE_CTRL, 64);
+    for (const auto& qp : m_pairs) {
+        desc.request_virtqueue(qp->rxq, 256);
+        desc.request_virtqueue(qp->txq, 256);
+    }
+
+    // features are not negotiated yet, so offer the multiqueue layout; a
+    // driver without multiqueue support uses virtqueue 2 for control
+    desc.request_virtqueue(2 * m_pairs.size(), 64);
 }
 
 bool net::notify(u32 vqid) {
-    switch (vqid) {
-    case VIRTQUEUE_RX:
-        m_rxev.notify(SC_ZERO_TIME);
-        return true;
-    case VIRTQUEUE_TX:
-        m_txev.notify(SC_ZERO_TIME);
-        return true;
-    case VIRTQUEUE_CTRL:
+    if (vqid == ctrlq()) {
         handle_ctrl();
         return true;
-    default:
+    }
+
+    if (vqid > ctrlq()) {
         log_warn("invalid virtqueue notified: %u", vqid);
         return false;
     }
+
+    queue_pair& qp = *m_pairs[vqid / 2];
+    if (vqid == qp.rxq)
+        qp.rxev.notify(SC_ZERO_TIME);
+    else
+        qp.txev.notify(SC_ZERO_TIME);
+
+    return true;
 }
 
 void net::read_features(u64& features) {
     features = VIRTIO_NET_F_MTU | VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS |
                VIRTIO_NET_F_CTRL_VQ | VIRTIO_NET_F_CTRL_RX |
                VIRTIO_NET_F_CTRL_RX_EXTRA | VIRTIO_NET_F_CTRL_ANNOUNCE |
-               VIRTIO_NET_F_CTRL_MAC_ADDR;
+               VIRTIO_NET_F_CTRL_MAC_ADDR | VIRTIO_NET_F_MRG_RXBUF;
+
+    if (offload)
+        features |= VIRTIO_NET_F_OFFLOADS;
+    if (m_pairs.size() > 1)
+        features |= VIRTIO_NET_F_MQ;
 }
 
 bool net::write_features(u64 features) {
@@ -347,6 +498,7 @@ bool net::write_features(u64 features) {
         return false;
     }
 
+    m_features = features;
     return true;
 }
 
@@ -380,10 +532,34 @@ void net::eth_link_down() {
     }
 }
 
+bool net::eth_rx_offload(const eth_target_socket& socket,
+                         const eth_frame& frame) const {
+    if (frame.needs_csum() && !has_feature(VIRTIO_NET_F_GUEST_CSUM))
+        return false;
+
+    if ((frame.offload.gso_type & VIRTIO_NET_HDR_GSO_ECN) &&
+        !has_feature(VIRTIO_NET_F_GUEST_ECN))
+        return false;
+
+    switch (frame.gso_type()) {
+    case VIRTIO_NET_HDR_GSO_NONE:
+        return true;
+    case VIRTIO_NET_HDR_GSO_TCPV4:
+        return has_feature(VIRTIO_NET_F_GUEST_TSO4);
+    case VIRTIO_NET_HDR_GSO_TCPV6:
+        return has_feature(VIRTIO_NET_F_GUEST_TSO6);
+    case VIRTIO_NET_HDR_GSO_UDP:
+        return has_feature(VIRTIO_NET_F_GUEST_UFO);
+    default:
+        return false;
+    }
+}
+
 void net::eth_receive(const eth_frame& frame) {
     if (filter(frame)) {
-        eth_host::eth_receive(frame);
-        m_rxev.notify(SC_ZERO_TIME);
+        queue_pair& qp = *m_pairs[steer(frame)];
+        qp.backlog.push_back(frame);
+        qp.rxev.notify(SC_ZERO_TIME);
     }
 }
 
@@ -401,25 +577,45 @@ net::net(const sc_module_name& nm):
     m_nobcast(false),
     m_unicast(),
     m_multicast(),
-    m_rxev("rxev"),
-    m_txev("txev"),
+    m_pairs(),
+    m_active_pairs(1),
+    m_features(0),
     mac("mac"),
     mtu("mtu", 1500),
+    queues("queues", 1),
+    offload("offload", true),
     virtio_in("virtio_in"),
     eth_tx("eth_tx"),
     eth_rx("eth_rx") {
     if (mac.length() > 0)
         m_mac = mac_addr(mac);
 
-    SC_HAS_PROCESS(net);
-
-    SC_THREAD(rx_thread);
-    sensitive << m_rxev;
-    dont_initialize();
+    size_t npairs = queues;
+    if (npairs < 1 || npairs > (VIRTQUEUE_MAX - 1) / 2) {
+        log_warn("invalid number of queues: %zu", npairs);
+        npairs = 1;
+    }
 
-    SC_THREAD(tx_thread);
-    sensitive << m_txev;
-    dont_initialize();
+    for (size_t i = 0; i < npairs; i++) {
+        auto qp = std::make_unique<queue_pair>();
+        qp->rxq = 2 * i + VIRTQUEUE_RX;
+        qp->txq = 2 * i + VIRTQUEUE_TX;
+
+        queue_pair* p = qp.get();
+        sc_spawn_options rxopts;
+        rxopts.set_sensitivity(&p->rxev);
+        rxopts.dont_initialize();
+        sc_spawn([this, p]() -> void { rx_thread(*p); },
+                 mkstr("rx_thread_%zu", i).c_str(), &rxopts);
+
+        sc_spawn_options txopts;
+        txopts.set_sensitivity(&p->txev);
+        txopts.dont_initialize();
+        sc_spawn([this, p]() -> void { tx_thread(*p); },
+                 mkstr("tx_thread_%zu", i).c_str(), &txopts);
+
+        m_pairs.push_back(std::move(qp));
+    }
 }
 
 net::~net() {
@@ -437,6 +633,14 @@ void net::reset() {
     m_unicast.clear();
     m_multicast.clear();
 
+    for (const auto& qp : m_pairs) {
+        qp->backlog.clear();
+        qp->rxbufs.clear();
+    }
+
+    m_active_pairs = 1;
+    m_features = 0;
+
     if (mac.length() > 0)
         m_mac = mac_addr(mac);
 
@@ -449,7 +653,7 @@ void net::reset() {
     if (eth_rx.link_up() && eth_tx.link_up())
         m_config.status |= VIRTIO_NET_S_LINK_UP;
 
-    m_config.max_vq_pairs = 1;
+    m_config.max_vq_pairs = m_pairs.size();
     m_config.mtu = mtu;
 }
 
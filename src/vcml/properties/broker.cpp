@@ -31,28 +31,93 @@ string broker::expand(const string& s) {
 }
 
 static vector<broker*> g_brokers;
+static vector<broker*> g_dynamic;
+
+// brokers are ranked by precedence, smaller ranks are asked first
+static i64 g_first_rank = 0;
+static i64 g_last_rank = 0;
+
+void broker::insert(const string& key, const string& val, size_t uses) {
+    struct value& v = m_values[key];
+    v.value = val;
+    v.uses = uses;
+
+    if (m_dynamic)
+        return;
+
+    entry& e = index()[key];
+    if (e.owner == nullptr || m_rank <= e.owner->m_rank)
+        e = { this, &v };
+}
+
+void broker::remove(const string& key) {
+    if (m_values.erase(key) == 0 || m_dynamic)
+        return;
+
+    auto it = index().find(key);
+    if (it != index().end() && it->second.owner == this)
+        reindex(key);
+}
+
+unordered_map<string, broker::entry>& broker::index() {
+    static unordered_map<string, entry> instance;
+    return instance;
+}
+
+void broker::reindex(const string& key) {
+    for (broker* brkr : g_brokers) {
+        if (brkr->m_dynamic)
+            continue;
+
+        auto it = brkr->m_values.find(key);
+        if (it != brkr->m_values.end()) {
+            index()[key] = { brkr, &it->second };
+            return;
+        }
+    }
+
+    index().erase(key);
+}
+
+broker::broker(const string& nm, bool insert_front, bool dynamic):
+    m_name(nm),
+    m_values(),
+    m_rank(insert_front ? --g_first_rank : ++g_last_rank),
+    m_dynamic(dynamic) {
+    if (insert_front)
+        g_brokers.insert(g_brokers.begin(), this);
+    else
+        g_brokers.push_back(this);
+
+    if (m_dynamic && insert_front)
+        g_dynamic.insert(g_dynamic.begin(), this);
+    else if (m_dynamic)
+        g_dynamic.push_back(this);
 
-broker::broker(const string& nm, bool insert_front): m_name(nm), m_values() {
     define("app", mwr::progname(), 1);
     define("bin", mwr::dirname(mwr::progname()), 1);
     define("pwd", mwr::curr_dir(), 1);
     define("tmp", mwr::temp_dir(), 1);
     define("usr", mwr::username(), 1);
     define("pid", mwr::getpid(), 1);
-    if (insert_front)
-        g_brokers.insert(g_brokers.begin(), this);
-    else
-        g_brokers.push_back(this);
 }
 
 broker::~broker() {
     stl_remove(g_brokers, this);
+    if (m_dynamic) {
+        stl_remove(g_dynamic, this);
+        return;
+    }
+
+    auto& idx = index();
+    for (const auto& value : m_values) {
+        auto it = idx.find(value.first);
+        if (it != idx.end() && it->second.owner == this)
+            reindex(value.first);
+    }
 }
 
 bool broker::lookup(const string& key, string& value) {
-    if (!stl_contains(m_values, key))
-        return false;
-
     auto it = m_values.find(key);
     if (it == m_values.end())
         return false;
@@ -63,32 +128,59 @@ bool broker::lookup(const string& key, string& value) {
 }
 
 bool broker::defines(const string& key) const {
-    return stl_contains(m_values, key);
+    return m_values.find(key) != m_values.end();
 }
 
 template <>
 broker* broker::init(const string& name, string& value) {
-    for (auto broker : g_brokers)
-        if (broker->lookup(name, value))
-            return broker;
-    return nullptr;
+    auto& idx = index();
+    auto it = idx.find(name);
+    broker* owner = it != idx.end() ? it->second.owner : nullptr;
+
+    // dynamic brokers only need asking if they take precedence
+    for (broker* brkr : g_dynamic) {
+        if (owner != nullptr && owner->m_rank < brkr->m_rank)
+            break;
+        if (brkr->lookup(name, value))
+            return brkr;
+    }
+
+    if (owner == nullptr)
+        return nullptr;
+
+    value = it->second.val->value;
+    it->second.val->uses++;
+    return owner;
+}
+
+vector<pair<string, string>> broker::collect_defined() {
+    static const unordered_set<string> builtins = {
+        "app", "bin", "pwd", "tmp", "usr", "pid",
+    };
+
+    vector<pair<string, string>> defined;
+    for (const auto& [key, e] : index()) {
+        if (builtins.count(key) == 0)
+            defined.push_back({ key, e.val->value });
+    }
+
+    std::sort(defined.begin(), defined.end());
+    return defined;
 }
 
 vector<pair<string, broker*>> broker::collect_unused() {
-    vector<pair<string, broker*>> unused;
-    for (auto& brkr : g_brokers) {
-        for (auto& value : brkr->m_values)
-            if (value.second.uses == 0)
-                unused.push_back({ value.first, brkr });
+    unordered_set<string> used;
+    for (broker* brkr : g_brokers) {
+        for (const auto& value : brkr->m_values)
+            if (value.second.uses > 0)
+                used.insert(value.first);
     }
 
-    for (auto& brkr : g_brokers) {
-        for (auto& value : brkr->m_values) {
-            if (value.second.uses > 0) {
-                stl_remove_if(unused, [&](auto& entry) -> bool {
-                    return entry.first == value.first;
-                });
-            }
+    vector<pair<string, broker*>> unused;
+    for (broker* brkr : g_brokers) {
+        for (const auto& value : brkr->m_values) {
+            if (value.second.uses == 0 && used.count(value.first) == 0)
+                unused.push_back({ value.first, brkr });
         }
     }
 
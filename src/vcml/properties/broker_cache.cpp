@@ -0,0 +1,275 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/properties/broker_cache.h"
+
+#include <filesystem>
+
+#ifndef MWR_MSVC
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace vcml {
+
+// file layout, all integers in little endian:
+//   header: magic[8], stamp (u64), number of sources (u32) and values (u32)
+//   source: mtime (u64), path length (u32), path
+//   value:  key length (u32), value length (u32), key, value
+static const char CACHE_MAGIC[8] = { 'V', 'C', 'M', 'L', 'C', 'F', 'G', '1' };
+
+enum : size_t {
+    CACHE_HEADER_SIZE = 24,
+};
+
+class cache_file
+{
+private:
+    const u8* m_data;
+    size_t m_size;
+#ifdef MWR_MSVC
+    vector<u8> m_buffer;
+#endif
+
+public:
+    const u8* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+    cache_file(const string& path);
+    ~cache_file();
+};
+
+#ifdef MWR_MSVC
+cache_file::cache_file(const string& path):
+    m_data(nullptr), m_size(0), m_buffer() {
+    ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return;
+
+    m_buffer.resize(file.tellg());
+    file.seekg(0);
+    if (file.read((char*)m_buffer.data(), m_buffer.size())) {
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+}
+
+cache_file::~cache_file() {
+    // nothing to do
+}
+#else
+cache_file::cache_file(const string& path): m_data(nullptr), m_size(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            m_data = (const u8*)addr;
+            m_size = st.st_size;
+        }
+    }
+
+    ::close(fd);
+}
+
+cache_file::~cache_file() {
+    if (m_data)
+        munmap((void*)m_data, m_size);
+}
+#endif
+
+class cache_reader
+{
+private:
+    const u8* m_ptr;
+    const u8* m_end;
+
+public:
+    cache_reader(const u8* data, size_t size):
+        m_ptr(data), m_end(data + size) {}
+
+    bool u32v(u32& val) {
+        if (m_end - m_ptr < (ptrdiff_t)sizeof(val))
+            return false;
+        memcpy(&val, m_ptr, sizeof(val));
+        val = le32_to_cpu(val);
+        m_ptr += sizeof(val);
+        return true;
+    }
+
+    bool u64v(u64& val) {
+        if (m_end - m_ptr < (ptrdiff_t)sizeof(val))
+            return false;
+        memcpy(&val, m_ptr, sizeof(val));
+        val = le64_to_cpu(val);
+        m_ptr += sizeof(val);
+        return true;
+    }
+
+    bool bytes(const char*& str, size_t len) {
+        if ((size_t)(m_end - m_ptr) < len)
+            return false;
+        str = (const char*)m_ptr;
+        m_ptr += len;
+        return true;
+    }
+};
+
+static void cache_put32(vector<u8>& buf, u32 val) {
+    val = cpu_to_le32(val);
+    const u8* ptr = (const u8*)&val;
+    buf.insert(buf.end(), ptr, ptr + sizeof(val));
+}
+
+static void cache_put64(vector<u8>& buf, u64 val) {
+    val = cpu_to_le64(val);
+    const u8* ptr = (const u8*)&val;
+    buf.insert(buf.end(), ptr, ptr + sizeof(val));
+}
+
+static void cache_put_str(vector<u8>& buf, const string& s) {
+    buf.insert(buf.end(), s.begin(), s.end());
+}
+
+broker_cache::broker_cache(const string& file): broker(file) {
+    bool ok = read(file, [&](const string& key, const string& val) -> void {
+        insert(key, val, 0);
+    });
+
+    VCML_REPORT_ON(!ok, "cannot read property file '%s'", file.c_str());
+}
+
+broker_cache::~broker_cache() {
+    // nothing to do
+}
+
+bool broker_cache::is_cache(const string& file) {
+    char magic[sizeof(CACHE_MAGIC)] = {};
+    ifstream is(file, std::ios::binary);
+    is.read(magic, sizeof(magic));
+    return is && memcmp(magic, CACHE_MAGIC, sizeof(magic)) == 0;
+}
+
+bool broker_cache::read(const string& file, optional<u64> stamp,
+                        const value_fn& fn) {
+    cache_file map(file);
+    if (map.size() < CACHE_HEADER_SIZE)
+        return false;
+
+    if (memcmp(map.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+        return false;
+
+    cache_reader reader(map.data() + sizeof(CACHE_MAGIC),
+                        map.size() - sizeof(CACHE_MAGIC));
+
+    u64 filestamp;
+    u32 nsources, nvalues;
+    if (!reader.u64v(filestamp) || !reader.u32v(nsources) ||
+        !reader.u32v(nvalues) || (stamp && filestamp != *stamp))
+        return false;
+
+    for (u32 i = 0; i < nsources; i++) {
+        u64 time;
+        u32 len;
+        const char* path;
+        if (!reader.u64v(time) || !reader.u32v(len) || !reader.bytes(path, len))
+            return false;
+        if (mtime(string(path, len)) != time)
+            return false;
+    }
+
+    // check bounds before reporting anything, so that callers never see a
+    // partial set of values from a truncated file
+    cache_reader check = reader;
+    for (u32 i = 0; i < nvalues; i++) {
+        u32 klen, vlen;
+        const char *key, *val;
+        if (!check.u32v(klen) || !check.u32v(vlen) ||
+            !check.bytes(key, klen) || !check.bytes(val, vlen))
+            return false;
+    }
+
+    string key, val;
+    for (u32 i = 0; i < nvalues; i++) {
+        u32 klen, vlen;
+        const char *kptr, *vptr;
+        reader.u32v(klen);
+        reader.u32v(vlen);
+        reader.bytes(kptr, klen);
+        reader.bytes(vptr, vlen);
+        key.assign(kptr, klen);
+        val.assign(vptr, vlen);
+        fn(key, val);
+    }
+
+    return true;
+}
+
+void broker_cache::write(const string& file, u64 stamp,
+                         const vector<source>& sources,
+                         const vector<pair<string, string>>& values) {
+    vector<u8> buf(CACHE_MAGIC, CACHE_MAGIC + sizeof(CACHE_MAGIC));
+    cache_put64(buf, stamp);
+    cache_put32(buf, sources.size());
+    cache_put32(buf, values.size());
+
+    for (const source& src : sources) {
+        cache_put64(buf, src.mtime);
+        cache_put32(buf, src.path.length());
+        cache_put_str(buf, src.path);
+    }
+
+    for (const auto& [key, val] : values) {
+        cache_put32(buf, key.length());
+        cache_put32(buf, val.length());
+        cache_put_str(buf, key);
+        cache_put_str(buf, val);
+    }
+
+    // write to a temporary first, so that concurrent simulations never
+    // map a partially written file
+    string temp = mkstr("%s.%d", file.c_str(), (int)mwr::getpid());
+    ofstream os(temp, std::ios::binary | std::ios::trunc);
+    os.write((const char*)buf.data(), buf.size());
+    os.close();
+    VCML_REPORT_ON(!os, "failed to write '%s'", temp.c_str());
+
+    std::error_code ec;
+    std::filesystem::rename(temp, file, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        VCML_REPORT("failed to write '%s'", file.c_str());
+    }
+}
+
+void broker_cache::dump(const string& file) {
+    write(file, 0, {}, broker::collect_defined());
+}
+
+u64 broker_cache::mtime(const string& path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    return ec ? 0 : (u64)time.time_since_epoch().count();
+}
+
+u64 broker_cache::hash(const void* data, size_t size, u64 seed) {
+    const u8* ptr = (const u8*)data;
+    u64 h = 0xcbf29ce484222325ull ^ seed;
+    for (size_t i = 0; i < size; i++)
+        h = (h ^ ptr[i]) * 0x100000001b3ull;
+    return h;
+}
+
+} // namespace vcml
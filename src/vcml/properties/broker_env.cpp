@@ -12,7 +12,7 @@
 
 namespace vcml {
 
-broker_env::broker_env(): broker("environment") {
+broker_env::broker_env(): broker("environment", false, true) {
     // nothing to do
 }
 
@@ -9,9 +9,11 @@
  ******************************************************************************/
 
 #include "vcml/properties/broker_lua.h"
+#include "vcml/properties/broker_cache.h"
 #include "vcml/logging/logger.h"
 #include "vcml/core/version.h"
 
+#include <filesystem>
 #include <lua.hpp>
 
 namespace vcml {
@@ -63,6 +65,16 @@ static optional<string> lua_getstring(lua_State* lua, int idx,
     }
 }
 
+// caching is opt-in, since scripts may depend on inputs that cannot be
+// tracked, such as environment variables, the time or files read via io
+static optional<string> lua_cache_dir() {
+    return mwr::getenv("VCML_LUA_CACHE");
+}
+
+// set once the script consulted anything that is not part of the cache
+// stamp, such as other brokers or the pid, so its results must not be cached
+static bool g_cache_tainted = false;
+
 static logger& lua_logger() {
     static logger log("lua");
     return log;
@@ -116,6 +128,10 @@ static int do_error(lua_State* lua) {
     return 0;
 }
 
+static bool has_expansion(const string& s) {
+    return s.find("${") != string::npos;
+}
+
 static int do_define(lua_State* lua) {
     auto prop_name = lua_getstring(lua, -2);
     if (!prop_name) {
@@ -131,6 +147,10 @@ static int do_define(lua_State* lua) {
         return 0;
     }
 
+    // expansions may resolve to values of other brokers
+    if (has_expansion(*prop_name) || has_expansion(*prop_val))
+        g_cache_tainted = true;
+
     lua_broker(lua)->define(*prop_name, *prop_val);
     return 0;
 }
@@ -142,6 +162,8 @@ static int do_lookup(lua_State* lua) {
         return 0;
     }
 
+    g_cache_tainted = true;
+
     string value, name = lua_tostring(lua, -1);
     if (lua_broker(lua)->lookup(name, value))
         lua_pushstring(lua, value.c_str());
@@ -150,6 +172,17 @@ static int do_lookup(lua_State* lua) {
     return 1;
 }
 
+static int do_index(lua_State* lua) {
+    // the pid changes with every run, so it is handed out on demand only
+    if (lua_isstring(lua, -1) && strcmp(lua_tostring(lua, -1), "pid") == 0) {
+        g_cache_tainted = true;
+        lua_pushinteger(lua, mwr::getpid());
+        return 1;
+    }
+
+    return do_lookup(lua);
+}
+
 static bool g_define_globals = []() -> bool {
     auto env = mwr::getenv("VCML_LUA_DEFINE_GLOBALS");
     return env && *env == "1";
@@ -193,8 +226,11 @@ static void define_globals(lua_State* lua, broker* b, const string& parent) {
         if (!symbol_filtered(name)) {
             if (lua_istable(lua, -1))
                 define_globals(lua, b, name + ".");
-            else if (auto value = lua_getstring(lua, -1))
+            else if (auto value = lua_getstring(lua, -1)) {
+                if (has_expansion(name) || has_expansion(*value))
+                    g_cache_tainted = true;
                 b->define(name, *value);
+            }
         }
 
         lua_pop(lua, 1);
@@ -207,19 +243,100 @@ static void define_globals(lua_State* lua, broker* b) {
     lua_pop(lua, 1);
 }
 
-broker_lua::broker_lua(const string& file): broker("lua") {
-    lua_State* lua = luaL_newstate();
-    luaL_openlibs(lua);
+// records the files pulled in via dofile, loadfile and require, so that
+// cached results can be discarded once any of them changes
+static const char* const TRACK_SOURCES = R"(
+    local track = ...
+    local dofile_, loadfile_ = dofile, loadfile
+    dofile = function(file, ...)
+        if file then track(file) end
+        return dofile_(file, ...)
+    end
+    loadfile = function(file, ...)
+        if file then track(file) end
+        return loadfile_(file, ...)
+    end
+    table.insert(package.searchers, 2, function(name)
+        local path = package.searchpath(name, package.path)
+        if path then track(path) end
+        return nil
+    end)
+)";
+
+static int do_track(lua_State* lua) {
+    void* ud = lua_touserdata(lua, lua_upvalueindex(1));
+    if (lua_isstring(lua, 1))
+        static_cast<vector<string>*>(ud)->push_back(lua_tostring(lua, 1));
+    return 0;
+}
 
-    int err = luaL_loadfile(lua, file.c_str());
-    VCML_REPORT_ON(err, "%s", lua_tostring(lua, -1));
+static int do_dump(lua_State* lua, const void* data, size_t size, void* ud) {
+    const u8* ptr = static_cast<const u8*>(data);
+    vector<u8>* buf = static_cast<vector<u8>*>(ud);
+    buf->insert(buf->end(), ptr, ptr + size);
+    return 0;
+}
 
-    lua_newtable(lua);
+static string read_script(const string& file) {
+    ifstream is(file, std::ios::binary);
+    VCML_REPORT_ON(!is, "cannot open %s", file.c_str());
+    stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+// loads the script from its precompiled bytecode if that was built from
+// the same source, otherwise compiles it and updates the bytecode cache
+static int load_script(lua_State* lua, const string& file,
+                       const string& script, const string& cache) {
+    string chunk = "@" + file;
+    if (cache.empty())
+        return luaL_loadfile(lua, file.c_str());
+
+    u64 hash = broker_cache::hash(script);
+    string luac = cache + ".luac";
+    ifstream is(luac, std::ios::binary);
+    if (is) {
+        stringstream ss;
+        ss << is.rdbuf();
+        string code = ss.str();
+        if (code.size() > sizeof(hash) &&
+            memcmp(code.data(), &hash, sizeof(hash)) == 0) {
+            if (luaL_loadbufferx(lua, code.data() + sizeof(hash),
+                                 code.size() - sizeof(hash), chunk.c_str(),
+                                 "b") == LUA_OK) {
+                return LUA_OK;
+            }
+
+            lua_pop(lua, 1);
+        }
+    }
 
+    // skip a leading #! line like luaL_loadfile, but keep its line break
+    size_t skip = 0;
+    if (starts_with(script, "#"))
+        skip = min(script.find('\n'), script.size());
+
+    int err = luaL_loadbufferx(lua, script.data() + skip, script.size() - skip,
+                               chunk.c_str(), "t");
+    if (err != LUA_OK)
+        return err;
+
+    vector<u8> code((const u8*)&hash, (const u8*)&hash + sizeof(hash));
+    lua_dump(lua, do_dump, &code, 0);
+
+    ofstream os(luac, std::ios::binary | std::ios::trunc);
+    os.write((const char*)code.data(), code.size());
+    if (!os)
+        lua_logger().warn("cannot write %s", luac.c_str());
+
+    return LUA_OK;
+}
+
+broker_lua::broker_lua(const string& file): broker("lua") {
     const vector<pair<string, long long>> integers = {
         { "vcml_version", VCML_VERSION },
         { "systemc_version", SYSTEMC_VERSION },
-        { "pid", mwr::getpid() },
     };
 
     const vector<pair<string, string>> strings = {
@@ -241,9 +358,62 @@ broker_lua::broker_lua(const string& file): broker("lua") {
 
     const vector<pair<string, int (*)(lua_State*)>> methods = {
         { "__newindex", do_define },
-        { "__index", do_lookup },
+        { "__index", do_index },
     };
 
+    // the cache is keyed by the script contents and everything we pass on
+    // to it, scripts that consult anything else are never cached
+    string script, cache;
+    u64 stamp = 0;
+    if (auto cache_dir = lua_cache_dir()) {
+        std::error_code ec;
+        std::filesystem::create_directories(*cache_dir, ec);
+        string path = std::filesystem::absolute(file, ec).string();
+        cache = mkstr("%s/%016llx", cache_dir->c_str(),
+                      (unsigned long long)broker_cache::hash(path));
+
+        script = read_script(file);
+        stamp = broker_cache::hash(script, g_define_globals);
+        for (auto& [field, value] : integers)
+            stamp = broker_cache::hash(mkstr("%lld", value), stamp);
+
+        for (auto& [field, value] : strings)
+            stamp = broker_cache::hash(value, stamp);
+
+        bool cached = broker_cache::read(
+            cache + ".cfg", stamp,
+            [&](const string& key, const string& val) -> void {
+                insert(key, val, 0);
+            });
+
+        if (cached) {
+            lua_logger().debug("using cached configuration for %s",
+                               file.c_str());
+            return;
+        }
+    }
+
+    auto builtins = m_values;
+    vector<string> sources;
+    g_cache_tainted = false;
+
+    lua_State* lua = luaL_newstate();
+    luaL_openlibs(lua);
+
+    if (!cache.empty()) {
+        int err = luaL_loadstring(lua, TRACK_SOURCES);
+        VCML_ERROR_ON(err, "%s", lua_tostring(lua, -1));
+        lua_pushlightuserdata(lua, &sources);
+        lua_pushcclosure(lua, do_track, 1);
+        err = lua_pcall(lua, 1, 0, 0);
+        VCML_ERROR_ON(err, "%s", lua_tostring(lua, -1));
+    }
+
+    int err = load_script(lua, file, script, cache);
+    VCML_REPORT_ON(err, "%s", lua_tostring(lua, -1));
+
+    lua_newtable(lua);
+
     for (auto& [field, value] : integers) {
         lua_pushinteger(lua, value);
         lua_setfield(lua, -2, field.c_str());
@@ -277,6 +447,33 @@ broker_lua::broker_lua(const string& file): broker("lua") {
         define_globals(lua, this);
 
     lua_close(lua);
+
+    if (cache.empty())
+        return;
+
+    if (g_cache_tainted) {
+        lua_logger().debug("not caching %s, it uses other brokers or the pid",
+                           file.c_str());
+        std::error_code ec;
+        std::filesystem::remove(cache + ".cfg", ec);
+        return;
+    }
+
+    vector<broker_cache::source> inputs;
+    inputs.push_back({ file, broker_cache::mtime(file) });
+    for (const string& source : sources)
+        inputs.push_back({ source, broker_cache::mtime(source) });
+
+    vector<pair<string, string>> values;
+    for (const auto& [key, val] : m_values)
+        if (!stl_contains(builtins, key))
+            values.push_back({ key, val.value });
+
+    try {
+        broker_cache::write(cache + ".cfg", stamp, inputs, values);
+    } catch (std::exception& ex) {
+        lua_logger().warn("cannot cache configuration: %s", ex.what());
+    }
 }
 
 broker_lua::~broker_lua() {
@@ -165,6 +165,46 @@ bool eth_frame::is_avtp() const {
     return ether_type() == ETHER_TYPE_AVTP;
 }
 
+u32 eth_frame::flow_hash() const {
+    if (size() < FRAME_HEADER_SIZE + 4)
+        return 0;
+
+    size_t l3 = FRAME_HEADER_SIZE;
+    if (ether_type_raw() == ETHER_TYPE_VLAN)
+        l3 += 4;
+
+    size_t addr, addrlen, l4;
+    u8 proto;
+    switch (ether_type()) {
+    case ETHER_TYPE_IPV4:
+        if (size() < l3 + 20)
+            return 0;
+        proto = at(l3 + 9);
+        addr = l3 + 12;
+        addrlen = 8;
+        l4 = l3 + (at(l3) & 0xf) * 4;
+        break;
+
+    case ETHER_TYPE_IPV6:
+        if (size() < l3 + 40)
+            return 0;
+        proto = at(l3 + 6);
+        addr = l3 + 8;
+        addrlen = 32;
+        l4 = l3 + 40;
+        break;
+
+    default:
+        return 0;
+    }
+
+    u32 hash = crc32(data() + addr, addrlen);
+    if ((proto == IP_TCP || proto == IP_UDP) && l4 + 4 <= size())
+        hash ^= crc32(data() + l4, 4);
+
+    return hash;
+}
+
 bool eth_frame::print_payload = true;
 size_t eth_frame::print_payload_columns = 16;
 
@@ -197,6 +237,322 @@ ostream& operator<<(ostream& os, const eth_frame& frame) {
     return os;
 }
 
+static inline u16 eth_load16(const u8* p) {
+    return (u16)p[0] << 8 | p[1];
+}
+
+static inline u32 eth_load32(const u8* p) {
+    return (u32)p[0] << 24 | (u32)p[1] << 16 | (u32)p[2] << 8 | p[3];
+}
+
+static inline void eth_store16(u8* p, u16 val) {
+    p[0] = val >> 8;
+    p[1] = val;
+}
+
+static inline void eth_store32(u8* p, u32 val) {
+    p[0] = val >> 24;
+    p[1] = val >> 16;
+    p[2] = val >> 8;
+    p[3] = val;
+}
+
+// one's complement sums are byte order independent, so we can add up native
+// words and only swap the folded result into network byte order
+static u32 eth_csum_partial(const u8* data, size_t len, u32 sum) {
+    u64 acc = 0;
+    size_t i = 0;
+
+    for (; i + 4 <= len; i += 4) {
+        u32 val;
+        memcpy(&val, data + i, sizeof(val));
+        acc += val;
+    }
+
+    if (i + 2 <= len) {
+        u16 val;
+        memcpy(&val, data + i, sizeof(val));
+        acc += val;
+        i += 2;
+    }
+
+    if (i < len) {
+        u16 val = 0;
+        memcpy(&val, data + i, 1);
+        acc += val;
+    }
+
+    while (acc >> 16)
+        acc = (acc & 0xffff) + (acc >> 16);
+
+    u16 result = (u16)acc;
+#ifdef MWR_HOST_LITTLE_ENDIAN
+    result = bswap(result);
+#endif
+
+    return sum + result;
+}
+
+static u16 eth_csum_fold(u32 sum) {
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+    return ~sum;
+}
+
+u16 eth_checksum(const u8* data, size_t len, u32 sum) {
+    return eth_csum_fold(eth_csum_partial(data, len, sum));
+}
+
+struct eth_headers {
+    size_t l3;
+    size_t l4;
+    size_t hdrlen;
+    size_t l4len;
+    bool ipv6;
+    u8 proto;
+};
+
+static bool eth_parse_headers(const u8* frame, size_t len, eth_headers& hdr) {
+    if (len < eth_frame::FRAME_HEADER_SIZE)
+        return false;
+
+    hdr.l3 = eth_frame::FRAME_HEADER_SIZE;
+    u16 type = eth_load16(frame + 12);
+    if (type == eth_frame::ETHER_TYPE_VLAN) {
+        if (len < hdr.l3 + 4)
+            return false;
+        type = eth_load16(frame + 16);
+        hdr.l3 += 4;
+    }
+
+    const u8* ip = frame + hdr.l3;
+    if (type == eth_frame::ETHER_TYPE_IPV4) {
+        if (len < hdr.l3 + 20 || (ip[0] >> 4) != 4)
+            return false;
+
+        size_t ihl = (ip[0] & 0xf) * 4;
+        size_t total = eth_load16(ip + 2);
+        if (ihl < 20 || total < ihl || len < hdr.l3 + total)
+            return false;
+
+        // fragments do not carry a complete layer four packet
+        if (eth_load16(ip + 6) & 0x3fff)
+            return false;
+
+        hdr.ipv6 = false;
+        hdr.proto = ip[9];
+        hdr.l4 = hdr.l3 + ihl;
+        hdr.l4len = total - ihl;
+    } else if (type == eth_frame::ETHER_TYPE_IPV6) {
+        if (len < hdr.l3 + 40 || (ip[0] >> 4) != 6)
+            return false;
+
+        hdr.ipv6 = true;
+        hdr.proto = ip[6];
+        hdr.l4 = hdr.l3 + 40;
+        hdr.l4len = eth_load16(ip + 4);
+        if (len < hdr.l4 + hdr.l4len)
+            return false;
+    } else {
+        return false;
+    }
+
+    const u8* l4 = frame + hdr.l4;
+    switch (hdr.proto) {
+    case eth_frame::IP_TCP: {
+        if (hdr.l4len < 20)
+            return false;
+        size_t doff = (l4[12] >> 4) * 4;
+        if (doff < 20 || hdr.l4len < doff)
+            return false;
+        hdr.hdrlen = hdr.l4 + doff;
+        return true;
+    }
+
+    case eth_frame::IP_UDP:
+        if (hdr.l4len < 8)
+            return false;
+        hdr.hdrlen = hdr.l4 + 8;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+static u32 eth_pseudo_sum(const u8* frame, const eth_headers& hdr,
+                          size_t l4len) {
+    const u8* ip = frame + hdr.l3;
+    u32 sum = hdr.ipv6 ? eth_csum_partial(ip + 8, 32, 0)
+                       : eth_csum_partial(ip + 12, 8, 0);
+    return sum + hdr.proto + (u32)(l4len >> 16) + (u32)(l4len & 0xffff);
+}
+
+static void eth_update_l4_csum(u8* frame, const eth_headers& hdr,
+                               size_t l4len) {
+    u8* l4 = frame + hdr.l4;
+    u8* csum = l4 + (hdr.proto == eth_frame::IP_TCP ? 16 : 6);
+    eth_store16(csum, 0);
+
+    u16 val = eth_checksum(l4, l4len, eth_pseudo_sum(frame, hdr, l4len));
+    if (val == 0 && hdr.proto == eth_frame::IP_UDP)
+        val = 0xffff;
+
+    eth_store16(csum, val);
+}
+
+static void eth_update_ip_csum(u8* frame, const eth_headers& hdr) {
+    u8* ip = frame + hdr.l3;
+    eth_store16(ip + 10, 0);
+    eth_store16(ip + 10, eth_checksum(ip, hdr.l4 - hdr.l3));
+}
+
+bool eth_checksum_offload(u8* frame, size_t len, size_t start,
+                          size_t offset) {
+    if (start >= len || offset + 2 > len - start)
+        return false;
+
+    u16 val = eth_checksum(frame + start, len - start);
+    eth_store16(frame + start + offset, val ? val : 0xffff);
+    return true;
+}
+
+bool eth_checksum_valid(const u8* frame, size_t len) {
+    eth_headers hdr;
+    if (!eth_parse_headers(frame, len, hdr))
+        return false;
+
+    const u8* l4 = frame + hdr.l4;
+    if (hdr.proto == eth_frame::IP_UDP && !hdr.ipv6 && !eth_load16(l4 + 6))
+        return true; // checksum not used
+
+    u32 sum = eth_pseudo_sum(frame, hdr, hdr.l4len);
+    return eth_checksum(l4, hdr.l4len, sum) == 0;
+}
+
+static void eth_segment_tcp(const u8* frame, const eth_headers& hdr,
+                            size_t mss, vector<eth_frame>& segments) {
+    size_t payload = hdr.l4 + hdr.l4len - hdr.hdrlen;
+    size_t count = max<size_t>((payload + mss - 1) / mss, 1);
+    segments.resize(count);
+
+    const u8* ip = frame + hdr.l3;
+    const u8* tcp = frame + hdr.l4;
+    u32 seq = eth_load32(tcp + 4);
+    u16 id = hdr.ipv6 ? 0 : eth_load16(ip + 4);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t offset = i * mss;
+        size_t seglen = min(mss, payload - offset);
+
+        eth_frame& seg = segments[i];
+        seg.resize(hdr.hdrlen + seglen);
+        memcpy(seg.data(), frame, hdr.hdrlen);
+        memcpy(seg.data() + hdr.hdrlen, frame + hdr.hdrlen + offset, seglen);
+
+        u8* segip = seg.data() + hdr.l3;
+        u8* segtcp = seg.data() + hdr.l4;
+        size_t l4len = hdr.hdrlen - hdr.l4 + seglen;
+
+        if (hdr.ipv6) {
+            eth_store16(segip + 4, l4len);
+        } else {
+            eth_store16(segip + 2, hdr.l4 - hdr.l3 + l4len);
+            eth_store16(segip + 4, id + i);
+            eth_update_ip_csum(seg.data(), hdr);
+        }
+
+        eth_store32(segtcp + 4, seq + offset);
+        if (i < count - 1)
+            segtcp[13] &= ~0x09; // FIN and PSH only on the last segment
+        if (i > 0)
+            segtcp[13] &= ~0x80; // CWR only on the first segment
+
+        eth_update_l4_csum(seg.data(), hdr, l4len);
+
+        if (seg.size() < eth_frame::FRAME_MIN_SIZE)
+            seg.resize(eth_frame::FRAME_MIN_SIZE);
+    }
+}
+
+static bool eth_segment_udp(const u8* frame, const eth_headers& hdr,
+                            size_t mss, vector<eth_frame>& segments) {
+    if (hdr.ipv6)
+        return false;
+
+    // fragment offsets are counted in units of eight bytes
+    size_t fraglen = mss & ~(size_t)7;
+    if (fraglen == 0)
+        return false;
+
+    size_t count = max<size_t>((hdr.l4len + fraglen - 1) / fraglen, 1);
+    segments.resize(count);
+
+    // the checksum covers the entire datagram, so compute it before
+    // splitting; only the first fragment will carry the udp header
+    vector<u8> datagram(frame, frame + hdr.l4 + hdr.l4len);
+    eth_store16(datagram.data() + hdr.l4 + 4, hdr.l4len);
+    eth_update_l4_csum(datagram.data(), hdr, hdr.l4len);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t offset = i * fraglen;
+        size_t seglen = min(fraglen, hdr.l4len - offset);
+
+        eth_frame& seg = segments[i];
+        seg.resize(hdr.l4 + seglen);
+        memcpy(seg.data(), datagram.data(), hdr.l4);
+        memcpy(seg.data() + hdr.l4, datagram.data() + hdr.l4 + offset,
+               seglen);
+
+        u8* segip = seg.data() + hdr.l3;
+        u16 frag = offset / 8;
+        if (i < count - 1)
+            frag |= 0x2000; // more fragments
+
+        eth_store16(segip + 2, hdr.l4 - hdr.l3 + seglen);
+        eth_store16(segip + 6, frag);
+        eth_update_ip_csum(seg.data(), hdr);
+
+        if (seg.size() < eth_frame::FRAME_MIN_SIZE)
+            seg.resize(eth_frame::FRAME_MIN_SIZE);
+    }
+
+    return true;
+}
+
+bool eth_resolve_offloads(const eth_frame& frame, vector<eth_frame>& out) {
+    if (frame.is_gso()) {
+        return eth_segment(frame.data(), frame.size(), frame.offload.gso_size,
+                           out);
+    }
+
+    out.resize(1);
+    eth_frame& resolved = out[0];
+    resolved.assign(frame.begin(), frame.end());
+    resolved.offload = {};
+
+    if (!frame.needs_csum())
+        return true;
+
+    resolved.offload.flags = eth_frame::OFFLOAD_CSUM_VALID;
+    return eth_checksum_offload(resolved.data(), resolved.size(),
+                                frame.offload.csum_start,
+                                frame.offload.csum_offset);
+}
+
+bool eth_segment(const u8* frame, size_t len, size_t mss,
+                 vector<eth_frame>& segments) {
+    eth_headers hdr;
+    if (mss == 0 || !eth_parse_headers(frame, len, hdr))
+        return false;
+
+    if (hdr.proto == eth_frame::IP_UDP)
+        return eth_segment_udp(frame, hdr, mss, segments);
+
+    eth_segment_tcp(frame, hdr, mss, segments);
+    return true;
+}
+
 eth_initiator_socket* eth_host::eth_find_initiator(const string& name) const {
     for (eth_initiator_socket* socket : m_initiator_sockets)
         if (name == socket->basename())
@@ -232,6 +588,11 @@ void eth_host::eth_receive(const eth_frame& frame) {
     m_rx_queue.push(frame);
 }
 
+bool eth_host::eth_rx_offload(const eth_target_socket& socket,
+                              const eth_frame& frame) const {
+    return false;
+}
+
 bool eth_host::eth_rx_pop(eth_frame& frame) {
     if (m_rx_queue.empty())
         return false;
@@ -444,17 +805,27 @@ void eth_initiator_socket::send(const vector<u8>& data) {
     send(frame);
 }
 
-void eth_initiator_socket::send(eth_frame& frame) {
+void eth_initiator_socket::send(const eth_frame& frame) {
     trace_fw(frame);
     if (m_link_up)
         get_interface(0)->eth_transport(frame);
     trace_bw(frame);
 }
 
-void eth_target_socket::eth_transport(eth_frame& frame) {
+void eth_target_socket::eth_transport(const eth_frame& frame) {
     trace_fw(frame);
-    if (m_link_up)
-        m_host->eth_receive(*this, frame);
+
+    if (m_link_up) {
+        if (!frame.has_offloads() || m_host->eth_rx_offload(*this, frame)) {
+            m_host->eth_receive(*this, frame);
+        } else if (eth_resolve_offloads(frame, m_resolved)) {
+            for (const eth_frame& resolved : m_resolved)
+                m_host->eth_receive(*this, resolved);
+        } else {
+            log_warn("%s: dropping frame with unsupported offloads", name());
+        }
+    }
+
     trace_bw(frame);
 }
 
@@ -491,7 +862,7 @@ eth_initiator_stub::eth_initiator_stub(const char* nm):
     eth_tx.bind(*this);
 }
 
-void eth_target_stub::eth_transport(eth_frame& frame) {
+void eth_target_stub::eth_transport(const eth_frame& frame) {
     // nothing to do
 }
 
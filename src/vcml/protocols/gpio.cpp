@@ -267,6 +267,7 @@ gpio_target_socket::gpio_target_socket(const char* nm, address_space space):
     m_state(),
     m_initiator(nullptr),
     m_targets(),
+    m_hostprof(*this, "gpio"),
     m_transport(this) {
     VCML_ERROR_ON(!m_host, "%s declared outside gpio_host", name());
     bind(m_transport);
@@ -340,6 +341,7 @@ void gpio_target_socket::gpio_transport_internal(gpio_payload& tx) {
     trace_fw(tx);
     if (m_state.count(tx.vector) == 0 || m_state[tx.vector] != tx.state) {
         m_state[tx.vector] = tx.state;
+        debugging::hostprof::scope profile(m_hostprof);
         gpio_transport(tx);
         if (m_event)
             m_event->notify(SC_ZERO_TIME);
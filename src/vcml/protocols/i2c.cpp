@@ -47,13 +47,16 @@ ostream& operator<<(ostream& os, i2c_response resp) {
 }
 
 ostream& operator<<(ostream& os, const i2c_payload& tx) {
-    os << tx.cmd << mkstr(" [%02hhx] ", tx.data);
+    if (tx.is_burst())
+        os << tx.cmd << mkstr(" [%zu bytes] ", tx.length);
+    else
+        os << tx.cmd << mkstr(" [%02hhx] ", tx.data);
     return os << "(" << tx.resp << ")";
 }
 
 void i2c_host::i2c_transport(i2c_target_socket& socket, i2c_payload& tx) {
     if (!stl_contains(m_state, socket.address.get()))
-        m_state[socket.as] = TLM_IGNORE_COMMAND;
+        m_state[socket.address] = TLM_IGNORE_COMMAND;
 
     tlm_command& state = m_state[socket.address];
     if (state == TLM_IGNORE_COMMAND && tx.cmd != I2C_START)
@@ -84,10 +87,17 @@ void i2c_host::i2c_transport(i2c_target_socket& socket, i2c_payload& tx) {
 
     case I2C_DATA: {
         socket.trace_fw(tx);
-        if (state == TLM_READ_COMMAND)
-            tx.resp = i2c_read(socket, tx.data);
-        if (state == TLM_WRITE_COMMAND)
-            tx.resp = i2c_write(socket, tx.data);
+        if (tx.is_burst()) {
+            if (state == TLM_READ_COMMAND)
+                tx.resp = i2c_read_burst(socket, tx.buffer, tx.length);
+            if (state == TLM_WRITE_COMMAND)
+                tx.resp = i2c_write_burst(socket, tx.buffer, tx.length);
+        } else {
+            if (state == TLM_READ_COMMAND)
+                tx.resp = i2c_read(socket, tx.data);
+            if (state == TLM_WRITE_COMMAND)
+                tx.resp = i2c_write(socket, tx.data);
+        }
         socket.trace_bw(tx);
         return;
     }
@@ -113,6 +123,34 @@ i2c_response i2c_host::i2c_write(const i2c_target_socket&, u8 data) {
     return I2C_NACK;
 }
 
+i2c_response i2c_host::i2c_read_burst(const i2c_target_socket& socket,
+                                      u8* data, size_t& len) {
+    i2c_response resp = I2C_ACK;
+    for (size_t i = 0; i < len; i++) {
+        resp = i2c_read(socket, data[i]);
+        if (!success(resp)) {
+            len = i + 1;
+            break;
+        }
+    }
+
+    return resp;
+}
+
+i2c_response i2c_host::i2c_write_burst(const i2c_target_socket& socket,
+                                       const u8* data, size_t& len) {
+    i2c_response resp = I2C_ACK;
+    for (size_t i = 0; i < len; i++) {
+        resp = i2c_write(socket, data[i]);
+        if (!success(resp)) {
+            len = i + 1;
+            break;
+        }
+    }
+
+    return resp;
+}
+
 i2c_base_initiator_socket::i2c_base_initiator_socket(const char* nm,
                                                      address_space space):
     i2c_base_initiator_socket_b(nm, space), m_stub(nullptr) {
@@ -213,14 +251,29 @@ i2c_response i2c_initiator_socket::transport(u8& data) {
     return tx.resp;
 }
 
+i2c_response i2c_initiator_socket::transport(u8* data, size_t& len) {
+    i2c_payload tx;
+    tx.cmd = I2C_DATA;
+    tx.resp = I2C_INCOMPLETE;
+    tx.data = 0;
+    tx.buffer = data;
+    tx.length = len;
+    transport(tx);
+    len = tx.length;
+    return tx.resp;
+}
+
 void i2c_initiator_socket::transport(i2c_payload& tx) {
     trace_fw(tx);
 
     for (int i = 0; i < size(); i++)
         get_interface(i)->i2c_transport(tx);
 
-    if (tx.resp == I2C_INCOMPLETE)
+    if (tx.resp == I2C_INCOMPLETE) {
         tx.resp = I2C_NACK;
+        if (tx.is_burst())
+            tx.length = 0;
+    }
 
     trace_bw(tx);
 }
@@ -36,12 +36,16 @@ void sd_init_read(sd_data& cmd) {
     cmd.mode = SD_READ;
     cmd.data = 0;
     cmd.status.read = SDTX_INCOMPLETE;
+    cmd.buffer = nullptr;
+    cmd.length = 0;
 }
 
 void sd_init_write(sd_data& cmd) {
     cmd.mode = SD_WRITE;
     cmd.data = 0;
     cmd.status.write = SDRX_INCOMPLETE;
+    cmd.buffer = nullptr;
+    cmd.length = 0;
 }
 
 const char* sd_status_str(sd_status status) {
@@ -249,13 +253,18 @@ ostream& operator<<(ostream& os, const sd_data& tx) {
     switch (tx.mode) {
     case SD_READ:
         os << "SD-DATA read";
-        if (success(tx))
+        if (tx.is_block())
+            os << mkstr(" [%zu bytes]", tx.length);
+        else if (success(tx))
             os << mkstr(" [%02hhx]", tx.data);
         os << " (" << sd_status_str(tx.status.read) << ")";
         break;
 
     case SD_WRITE:
-        os << mkstr("SD-DATA write [%02hhx]", tx.data);
+        if (tx.is_block())
+            os << mkstr("SD-DATA write [%zu bytes]", tx.length);
+        else
+            os << mkstr("SD-DATA write [%02hhx]", tx.data);
         os << " (" << sd_status_str(tx.status.write) << ")";
         break;
 
@@ -359,6 +368,28 @@ sd_status_rx sd_initiator_socket::write_data(u8 data) {
     return tx.status.write;
 }
 
+sd_status_tx sd_initiator_socket::read_blocks(u8* data, size_t& len) {
+    sd_data tx;
+    sd_init_read(tx);
+    tx.buffer = data;
+    tx.length = len;
+
+    transport(tx);
+    len = tx.length;
+    return tx.status.read;
+}
+
+sd_status_rx sd_initiator_socket::write_blocks(const u8* data, size_t& len) {
+    sd_data tx;
+    sd_init_write(tx);
+    tx.buffer = const_cast<u8*>(data);
+    tx.length = len;
+
+    transport(tx);
+    len = tx.length;
+    return tx.status.write;
+}
+
 void sd_target_socket::sd_transport(sd_command& tx) {
     trace_fw(tx);
     m_host->sd_transport(*this, tx);
@@ -367,7 +398,10 @@ void sd_target_socket::sd_transport(sd_command& tx) {
 
 void sd_target_socket::sd_transport(sd_data& tx) {
     // trace_fw(tx);
-    m_host->sd_transport(*this, tx);
+    if (tx.is_block())
+        m_host->sd_transport_blocks(*this, tx);
+    else
+        m_host->sd_transport(*this, tx);
     // trace_bw(tx);
 }
 
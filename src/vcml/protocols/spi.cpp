@@ -13,6 +13,9 @@
 namespace vcml {
 
 ostream& operator<<(ostream& os, const spi_payload& spi) {
+    if (spi.is_burst())
+        return os << mkstr("[burst: %zu words]", spi.length);
+
     u32 mosi = spi.mosi & spi.mask;
     u32 miso = spi.miso & spi.mask;
     int len = (fls(spi.mask) + 4) / 4;
@@ -20,6 +23,16 @@ ostream& operator<<(ostream& os, const spi_payload& spi) {
     return os;
 }
 
+void spi_host::spi_burst(const spi_target_socket& socket, spi_payload& spi) {
+    for (size_t i = 0; i < spi.length; i++) {
+        u32 miso = spi.miso_buf ? spi.miso_buf[i] : 0;
+        spi_payload tx(spi.mosi_buf[i], miso, spi.mask);
+        spi_transport(socket, tx);
+        if (spi.miso_buf)
+            spi.miso_buf[i] = tx.miso;
+    }
+}
+
 spi_base_initiator_socket::spi_base_initiator_socket(const char* nm,
                                                      address_space a):
     spi_base_initiator_socket_b(nm, a), m_stub(nullptr) {
@@ -89,9 +102,18 @@ void spi_initiator_socket::transport(spi_payload& spi) {
     trace_bw(spi);
 }
 
+void spi_initiator_socket::transport(const u32* mosi, u32* miso, size_t len,
+                                     u32 mask) {
+    spi_payload spi(mosi, miso, len, mask);
+    transport(spi);
+}
+
 void spi_target_socket::spi_transport(spi_payload& spi) {
     trace_fw(spi);
-    m_host->spi_transport(*this, spi);
+    if (spi.is_burst())
+        m_host->spi_burst(*this, spi);
+    else
+        m_host->spi_transport(*this, spi);
     trace_bw(spi);
 }
 
@@ -32,6 +32,7 @@ void tlm_host::clear_current_transaction(sc_process_b* proc) {
 unsigned int tlm_host::do_transport(tlm_target_socket& socket,
                                     tlm_generic_payload& tx,
                                     const tlm_sbi& info) {
+    debugging::hostprof::scope profile(socket.hostprof());
     set_current_transaction(tx, info, socket.as);
 
     if (tx.get_response_status() != TLM_INCOMPLETE_RESPONSE)
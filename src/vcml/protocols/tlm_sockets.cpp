@@ -43,6 +43,12 @@ tlm_initiator_socket::tlm_initiator_socket(const char* nm,
     m_host(hierarchy_search<tlm_host>()),
     m_parent(hierarchy_search<module>()),
     m_adapter(nullptr),
+    m_sent(0),
+    m_dmi_hits(0),
+    m_num_sent("vcml_tlm_sent_total", "Transactions sent per socket",
+               { { "socket", name() } }, [this]() { return m_sent; }),
+    m_num_dmi("vcml_tlm_dmi_hits_total", "Accesses served via DMI",
+              { { "socket", name() } }, [this]() { return m_dmi_hits; }),
     trace_all(this, "trace", false),
     trace_errors(this, "trace_errors", false),
     allow_dmi(this, "allow_dmi", true),
@@ -147,6 +153,8 @@ unsigned int tlm_initiator_socket::send(tlm_generic_payload& tx,
         if (info.is_sync || m_host->needs_sync())
             m_host->sync();
 
+        m_sent++;
+
         sc_time& offset = m_host->local_time();
         sc_time local = sc_time_stamp() + offset;
 
@@ -204,6 +212,7 @@ tlm_response_status tlm_initiator_socket::access_dmi(tlm_command cmd, u64 addr,
     }
 
     if (!info.is_debug) {
+        m_dmi_hits++;
         m_host->local_time() += latency;
         if (info.is_sync)
             m_host->sync();
@@ -276,6 +285,8 @@ void tlm_initiator_socket::stub_socket(void* data) {
 }
 
 void tlm_target_socket::b_transport_int(tlm_generic_payload& tx, sc_time& t) {
+    // relaxed atomic, targets may be entered from sc_async threads
+    m_num_received.inc();
     b_transport(tx, t);
 }
 
@@ -367,6 +378,10 @@ tlm_target_socket::tlm_target_socket(const char* nm, address_space a):
     m_adapter(nullptr),
     m_payload(),
     m_sideband(),
+    m_hostprof(*this, "tlm"),
+    m_num_received("vcml_tlm_received_total",
+                   "Transactions received per socket",
+                   { { "socket", name() } }),
     trace_all(this, "trace", false),
     trace_errors(this, "trace_errors", false),
     allow_dmi(this, "allow_dmi", true),
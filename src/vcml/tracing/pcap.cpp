@@ -0,0 +1,410 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/tracing/pcap.h"
+
+namespace vcml {
+
+enum pcapng_blocks : u32 {
+    PCAPNG_IDB = 0x00000001,
+    PCAPNG_SPB = 0x00000003,
+    PCAPNG_EPB = 0x00000006,
+    PCAPNG_SHB = 0x0a0d0d0a,
+};
+
+enum pcapng_options : u16 {
+    PCAPNG_OPT_END = 0,
+    PCAPNG_OPT_SHB_USERAPPL = 4,
+    PCAPNG_OPT_IF_NAME = 2,
+    PCAPNG_OPT_IF_TSRESOL = 9,
+    PCAPNG_OPT_EPB_FLAGS = 2,
+};
+
+enum pcap_magics : u32 {
+    PCAPNG_BYTE_ORDER = 0x1a2b3c4d,
+    PCAP_MAGIC_US = 0xa1b2c3d4,
+    PCAP_MAGIC_NS = 0xa1b23c4d,
+};
+
+enum : u32 {
+    PCAP_HEADER_SIZE = 24,
+    PCAP_RECORD_SIZE = 16,
+    PCAP_MAX_BLOCK = 16 * MiB,
+};
+
+static void put16(vector<u8>& buf, u16 val) {
+    val = cpu_to_le16(val);
+    const u8* ptr = reinterpret_cast<const u8*>(&val);
+    buf.insert(buf.end(), ptr, ptr + sizeof(val));
+}
+
+static void put32(vector<u8>& buf, u32 val) {
+    val = cpu_to_le32(val);
+    const u8* ptr = reinterpret_cast<const u8*>(&val);
+    buf.insert(buf.end(), ptr, ptr + sizeof(val));
+}
+
+static void put_data(vector<u8>& buf, const void* data, size_t len) {
+    const u8* ptr = static_cast<const u8*>(data);
+    buf.insert(buf.end(), ptr, ptr + len);
+    buf.resize(buf.size() + (-len & 3)); // blocks are 32bit aligned
+}
+
+static void put_option(vector<u8>& buf, u16 code, const void* data,
+                       size_t len) {
+    put16(buf, code);
+    put16(buf, (u16)len);
+    put_data(buf, data, len);
+}
+
+static size_t begin_block(vector<u8>& buf, u32 type) {
+    size_t start = buf.size();
+    put32(buf, type);
+    put32(buf, 0); // filled in by end_block
+    return start;
+}
+
+static size_t end_block(vector<u8>& buf, size_t start) {
+    u32 total = buf.size() - start + sizeof(u32);
+    put32(buf, total);
+
+    u32 le = cpu_to_le32(total);
+    memcpy(buf.data() + start + sizeof(u32), &le, sizeof(le));
+    return total;
+}
+
+void pcap_writer::open() {
+    string path = rotated_path(m_path, m_index);
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.good())
+        VCML_REPORT("failed to open file '%s'", path.c_str());
+
+    size_t shb = begin_block(m_buffer, PCAPNG_SHB);
+    put32(m_buffer, PCAPNG_BYTE_ORDER);
+    put16(m_buffer, 1); // major version
+    put16(m_buffer, 0); // minor version
+    put32(m_buffer, ~0u); // section length unknown
+    put32(m_buffer, ~0u);
+    put_option(m_buffer, PCAPNG_OPT_SHB_USERAPPL, "vcml", 4);
+    put_option(m_buffer, PCAPNG_OPT_END, nullptr, 0);
+    m_size = end_block(m_buffer, shb);
+
+    u8 tsresol = 9; // nanoseconds
+    size_t idb = begin_block(m_buffer, PCAPNG_IDB);
+    put16(m_buffer, m_linktype);
+    put16(m_buffer, 0); // reserved
+    put32(m_buffer, 0); // no snap length limit
+    if (!m_ifname.empty()) {
+        put_option(m_buffer, PCAPNG_OPT_IF_NAME, m_ifname.data(),
+                   m_ifname.length());
+    }
+    put_option(m_buffer, PCAPNG_OPT_IF_TSRESOL, &tsresol, sizeof(tsresol));
+    put_option(m_buffer, PCAPNG_OPT_END, nullptr, 0);
+    m_size += end_block(m_buffer, idb);
+
+    m_start = m_size;
+}
+
+void pcap_writer::rotate() {
+    flush();
+    m_file.close();
+    m_index++;
+    open();
+}
+
+pcap_writer::pcap_writer(const string& path, pcap_linktype linktype,
+                         const string& ifname, u64 rotate):
+    m_path(path),
+    m_ifname(ifname),
+    m_linktype(linktype),
+    m_limit(rotate),
+    m_size(0),
+    m_start(0),
+    m_index(0),
+    m_packets(0),
+    m_buffer(),
+    m_file() {
+    m_buffer.reserve(BUFFER_SIZE + 4 * KiB);
+    open();
+}
+
+pcap_writer::~pcap_writer() {
+    flush();
+}
+
+void pcap_writer::write(const sc_time& t, const u8* data, size_t len,
+                        pcap_direction dir) {
+    size_t size = 32 + ((len + 3) & ~3);
+    if (dir != PCAP_UNKNOWN)
+        size += 12;
+
+    if (m_limit && m_size > m_start && m_size + size > m_limit)
+        rotate();
+
+    u64 ts = time_to_ns(t);
+    size_t epb = begin_block(m_buffer, PCAPNG_EPB);
+    put32(m_buffer, 0); // interface id
+    put32(m_buffer, (u32)(ts >> 32));
+    put32(m_buffer, (u32)ts);
+    put32(m_buffer, (u32)len);
+    put32(m_buffer, (u32)len);
+    put_data(m_buffer, data, len);
+    if (dir != PCAP_UNKNOWN) {
+        u32 flags = cpu_to_le32(dir);
+        put_option(m_buffer, PCAPNG_OPT_EPB_FLAGS, &flags, sizeof(flags));
+        put_option(m_buffer, PCAPNG_OPT_END, nullptr, 0);
+    }
+
+    m_size += end_block(m_buffer, epb);
+    m_packets++;
+
+    if (m_buffer.size() >= BUFFER_SIZE)
+        flush();
+}
+
+void pcap_writer::flush() {
+    if (m_buffer.empty() || !m_file.is_open())
+        return;
+
+    m_file.write((const char*)m_buffer.data(), m_buffer.size());
+    m_file.flush();
+    m_buffer.clear();
+}
+
+string pcap_writer::rotated_path(const string& path, size_t index) {
+    if (index == 0)
+        return path;
+
+    size_t sep = path.find_last_of("/\\");
+    size_t dot = path.find_last_of('.');
+    if (dot == string::npos || dot == sep + 1 ||
+        (sep != string::npos && dot < sep))
+        return mkstr("%s.%zu", path.c_str(), index);
+
+    return mkstr("%s.%zu%s", path.substr(0, dot).c_str(), index,
+                 path.substr(dot).c_str());
+}
+
+u16 pcap_reader::get16(const u8* p) const {
+    u16 val;
+    memcpy(&val, p, sizeof(val));
+    return m_swap ? bswap(val) : val;
+}
+
+u32 pcap_reader::get32(const u8* p) const {
+    u32 val;
+    memcpy(&val, p, sizeof(val));
+    return m_swap ? bswap(val) : val;
+}
+
+bool pcap_reader::read_header() {
+    u8 hdr[PCAP_HEADER_SIZE];
+    if (!m_file.read((char*)hdr, sizeof(u32)))
+        return false;
+
+    u32 magic;
+    memcpy(&magic, hdr, sizeof(magic));
+    if (magic == PCAPNG_SHB) {
+        m_ng = true;
+        m_file.seekg(0);
+        return true;
+    }
+
+    u64 rate;
+    if (magic == PCAP_MAGIC_US || bswap(magic) == PCAP_MAGIC_US)
+        rate = 1000000ull;
+    else if (magic == PCAP_MAGIC_NS || bswap(magic) == PCAP_MAGIC_NS)
+        rate = 1000000000ull;
+    else
+        return false;
+
+    m_ng = false;
+    m_swap = magic != PCAP_MAGIC_US && magic != PCAP_MAGIC_NS;
+
+    if (!m_file.read((char*)hdr + 4, sizeof(hdr) - 4))
+        return false;
+
+    pcap_linktype linktype = (pcap_linktype)get32(hdr + 20);
+    m_ifaces.push_back({ linktype, rate });
+    return true;
+}
+
+bool pcap_reader::read_block(u32& type) {
+    u8 hdr[12];
+    if (!m_file.read((char*)hdr, 8))
+        return false;
+
+    // the byte order may change with every section header
+    size_t have = 0;
+    memcpy(&type, hdr, sizeof(type));
+    if (type == PCAPNG_SHB) {
+        if (!m_file.read((char*)hdr + 8, 4))
+            return false;
+
+        u32 bom;
+        memcpy(&bom, hdr + 8, sizeof(bom));
+        if (bom != PCAPNG_BYTE_ORDER && bswap(bom) != PCAPNG_BYTE_ORDER)
+            return false;
+
+        m_swap = bom != PCAPNG_BYTE_ORDER;
+        have = 4;
+    }
+
+    type = get32(hdr);
+    u32 len = get32(hdr + 4);
+    if (len < 12 + have || len % 4 || len > PCAP_MAX_BLOCK)
+        return false;
+
+    m_block.resize(len - 8);
+    memcpy(m_block.data(), hdr + 8, have);
+    return (bool)m_file.read((char*)m_block.data() + have,
+                             m_block.size() - have);
+}
+
+bool pcap_reader::next_pcap(packet& pkt) {
+    u8 rec[PCAP_RECORD_SIZE];
+    if (m_ifaces.empty() || !m_file.read((char*)rec, sizeof(rec)))
+        return false;
+
+    const iface& ifc = m_ifaces[0];
+    u64 ticks = (u64)get32(rec) * ifc.tsrate + get32(rec + 4);
+    u32 caplen = get32(rec + 8);
+    if (caplen > PCAP_MAX_BLOCK)
+        return false;
+
+    pkt.timestamp = timestamp(ticks, ifc.tsrate);
+    pkt.linktype = ifc.linktype;
+    pkt.direction = PCAP_UNKNOWN;
+    pkt.data.resize(caplen);
+    return (bool)m_file.read((char*)pkt.data.data(), caplen);
+}
+
+bool pcap_reader::next_pcapng(packet& pkt) {
+    u32 type;
+    while (read_block(type)) {
+        const u8* body = m_block.data();
+        size_t size = m_block.size() - sizeof(u32); // strip trailing length
+
+        switch (type) {
+        case PCAPNG_SHB:
+            m_ifaces.clear();
+            break;
+
+        case PCAPNG_IDB:
+            if (size >= 8)
+                parse_idb();
+            break;
+
+        case PCAPNG_SPB: {
+            if (size < 4 || m_ifaces.empty())
+                break;
+
+            u32 len = min<u32>(get32(body), size - 4);
+            pkt.timestamp = SC_ZERO_TIME;
+            pkt.linktype = m_ifaces[0].linktype;
+            pkt.direction = PCAP_UNKNOWN;
+            pkt.data.assign(body + 4, body + 4 + len);
+            return true;
+        }
+
+        case PCAPNG_EPB: {
+            if (size < 20)
+                break;
+
+            u32 id = get32(body);
+            u64 ticks = (u64)get32(body + 4) << 32 | get32(body + 8);
+            u32 caplen = get32(body + 12);
+            if (id >= m_ifaces.size() || caplen > size - 20)
+                break;
+
+            pkt.timestamp = timestamp(ticks, m_ifaces[id].tsrate);
+            pkt.linktype = m_ifaces[id].linktype;
+            pkt.direction = PCAP_UNKNOWN;
+            pkt.data.assign(body + 20, body + 20 + caplen);
+
+            size_t pos = 20 + ((caplen + 3) & ~3);
+            while (pos + 4 <= size) {
+                u16 code = get16(body + pos);
+                u16 len = get16(body + pos + 2);
+                if (code == PCAPNG_OPT_END || pos + 4 + len > size)
+                    break;
+                if (code == PCAPNG_OPT_EPB_FLAGS && len == 4)
+                    pkt.direction = (pcap_direction)(get32(body + pos + 4) & 3);
+                pos += 4 + ((len + 3) & ~3);
+            }
+
+            return true;
+        }
+
+        default:
+            break; // skip statistics, name resolution, etc.
+        }
+    }
+
+    return false;
+}
+
+void pcap_reader::parse_idb() {
+    const u8* body = m_block.data();
+    size_t size = m_block.size() - sizeof(u32);
+
+    iface ifc;
+    ifc.linktype = (pcap_linktype)get16(body);
+    ifc.tsrate = 1000000ull; // microseconds unless specified otherwise
+
+    size_t pos = 8;
+    while (pos + 4 <= size) {
+        u16 code = get16(body + pos);
+        u16 len = get16(body + pos + 2);
+        if (code == PCAPNG_OPT_END || pos + 4 + len > size)
+            break;
+
+        if (code == PCAPNG_OPT_IF_TSRESOL && len == 1) {
+            u8 resol = body[pos + 4];
+            if (resol & 0x80 && (resol & 0x7f) < 64) {
+                ifc.tsrate = 1ull << (resol & 0x7f);
+            } else if (resol <= 19) {
+                ifc.tsrate = 1;
+                while (resol--)
+                    ifc.tsrate *= 10;
+            }
+        }
+
+        pos += 4 + ((len + 3) & ~3);
+    }
+
+    m_ifaces.push_back(ifc);
+}
+
+sc_time pcap_reader::timestamp(u64 ticks, u64 rate) {
+    u64 secs = ticks / rate;
+    u64 frac = ticks % rate;
+    return sc_time((double)secs, SC_SEC) +
+           sc_time((double)frac * 1e12 / (double)rate, SC_PS);
+}
+
+pcap_reader::pcap_reader(const string& path):
+    m_path(path),
+    m_file(path, std::ios::binary),
+    m_ng(false),
+    m_swap(false),
+    m_ifaces(),
+    m_block() {
+    if (!m_file.is_open())
+        VCML_REPORT("failed to open file '%s'", path.c_str());
+    if (!read_header())
+        VCML_REPORT("'%s' is not a pcap or pcapng file", path.c_str());
+}
+
+bool pcap_reader::next(packet& pkt) {
+    return m_ng ? next_pcapng(pkt) : next_pcap(pkt);
+}
+
+} // namespace vcml
@@ -147,7 +147,10 @@ string trace_payload_to_json(const i2c_payload& tx) {
     os << "{";
     os << "\"command\":\"" << i2c_command_str(tx.cmd) << "\",";
     os << "\"response\":\"" << i2c_response_str(tx.resp) << "\",";
-    os << "\"data\":" << (int)tx.data;
+    if (tx.is_burst())
+        os << "\"length\":" << tx.length;
+    else
+        os << "\"data\":" << (int)tx.data;
     os << "}";
     return os.str();
 }
@@ -172,8 +175,12 @@ string trace_payload_to_json(const lin_payload& tx) {
 string trace_payload_to_json(const spi_payload& tx) {
     ostringstream os;
     os << "{";
-    os << "\"miso\":" << (int)tx.miso << ",";
-    os << "\"mosi\":" << (int)tx.mosi;
+    if (tx.is_burst()) {
+        os << "\"length\":" << tx.length;
+    } else {
+        os << "\"miso\":" << (int)tx.miso << ",";
+        os << "\"mosi\":" << (int)tx.mosi;
+    }
     os << "}";
     return os.str();
 }
@@ -213,14 +220,19 @@ string trace_payload_to_json(const sd_data& tx) {
     switch (tx.mode) {
     case SD_READ:
         os << "\"command\":\"SD_DATA_READ\",";
-        if (success(tx))
+        if (tx.is_block())
+            os << "\"length\":" << tx.length << ",";
+        else if (success(tx))
             os << "\"data\":" << (int)tx.data << ",";
         os << "\"status\":\"" << sd_status_str(tx.status.read) << "\"";
         break;
 
     case SD_WRITE:
         os << "\"command\":\"SD_DATA_WRITE\",";
-        os << "\"data\":" << (int)tx.data << ",";
+        if (tx.is_block())
+            os << "\"length\":" << tx.length << ",";
+        else
+            os << "\"data\":" << (int)tx.data << ",";
         os << "\"status\":\"" << sd_status_str(tx.status.write) << "\"";
         break;
 
@@ -0,0 +1,496 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/ui/capture.h"
+
+namespace vcml {
+namespace ui {
+
+static u8 read_channel(u32 pixel, const color_channel& ch) {
+    if (ch.size == 0)
+        return 0;
+
+    u32 mask = bitmask(ch.size);
+    u32 val = (pixel >> ch.offset) & mask;
+    if (ch.size >= 8)
+        return val >> (ch.size - 8);
+
+    return (val * 255 + mask / 2) / mask;
+}
+
+static void read_rgb(const videomode& mode, const u8* px, u8* rgb) {
+    u32 pixel = 0;
+    if (mode.endian == ENDIAN_BIG) {
+        for (size_t i = 0; i < mode.bpp; i++)
+            pixel = pixel << 8 | px[i];
+    } else {
+        for (size_t i = mode.bpp; i-- > 0;)
+            pixel = pixel << 8 | px[i];
+    }
+
+    if (mode.grayscale) {
+        rgb[0] = rgb[1] = rgb[2] = pixel & 0xff;
+        return;
+    }
+
+    rgb[0] = read_channel(pixel, mode.r);
+    rgb[1] = read_channel(pixel, mode.g);
+    rgb[2] = read_channel(pixel, mode.b);
+}
+
+void convert_rgb24(const videomode& mode, const u8* fb, u8* rgb) {
+    for (u32 y = 0; y < mode.yres; y++) {
+        const u8* line = fb + y * mode.stride;
+        for (u32 x = 0; x < mode.xres; x++, rgb += 3)
+            read_rgb(mode, line + x * mode.bpp, rgb);
+    }
+}
+
+static u32 png_crc32(const u8* data, size_t size, u32 crc = 0) {
+    static const auto table = []() {
+        array<u32, 256> t{};
+        for (u32 n = 0; n < 256; n++) {
+            u32 c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static u32 adler32(const u8* data, size_t size) {
+    const u32 mod = 65521;
+    u32 a = 1, b = 0;
+    while (size > 0) {
+        size_t n = min<size_t>(size, 5552);
+        size -= n;
+        while (n--) {
+            a += *data++;
+            b += a;
+        }
+
+        a %= mod;
+        b %= mod;
+    }
+
+    return b << 16 | a;
+}
+
+static void put_be32(vector<u8>& out, u32 val) {
+    out.push_back(val >> 24);
+    out.push_back(val >> 16);
+    out.push_back(val >> 8);
+    out.push_back(val);
+}
+
+class bitwriter
+{
+private:
+    vector<u8>& m_out;
+    u64 m_bits;
+    u32 m_count;
+
+public:
+    bitwriter(vector<u8>& out): m_out(out), m_bits(0), m_count(0) {}
+
+    void put(u32 val, u32 n) {
+        m_bits |= (u64)val << m_count;
+        m_count += n;
+        while (m_count >= 8) {
+            m_out.push_back(m_bits & 0xff);
+            m_bits >>= 8;
+            m_count -= 8;
+        }
+    }
+
+    void put_reversed(u32 code, u32 n) {
+        u32 rev = 0;
+        for (u32 i = 0; i < n; i++, code >>= 1)
+            rev = rev << 1 | (code & 1);
+        put(rev, n);
+    }
+
+    void flush() {
+        if (m_count > 0)
+            m_out.push_back(m_bits & 0xff);
+        m_bits = 0;
+        m_count = 0;
+    }
+};
+
+static void deflate_symbol(bitwriter& bw, u32 sym) {
+    if (sym < 144)
+        bw.put_reversed(0x30 + sym, 8);
+    else if (sym < 256)
+        bw.put_reversed(0x190 + sym - 144, 9);
+    else if (sym < 280)
+        bw.put_reversed(sym - 256, 7);
+    else
+        bw.put_reversed(0xc0 + sym - 280, 8);
+}
+
+static void deflate_match(bitwriter& bw, u32 len, u32 dist) {
+    static const u16 len_base[29] = {
+        3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+    };
+
+    static const u8 len_extra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+        2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+    };
+
+    static const u16 dist_base[30] = {
+        1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+        33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+        1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577,
+    };
+
+    static const u8 dist_extra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+        6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+    };
+
+    u32 l = 28;
+    while (len_base[l] > len)
+        l--;
+
+    deflate_symbol(bw, 257 + l);
+    bw.put(len - len_base[l], len_extra[l]);
+
+    u32 d = 29;
+    while (dist_base[d] > dist)
+        d--;
+
+    bw.put_reversed(d, 5);
+    bw.put(dist - dist_base[d], dist_extra[d]);
+}
+
+// single block deflate using the fixed huffman table and a greedy matcher
+// that only remembers the most recent position for each 3-byte sequence
+static void deflate(const u8* data, size_t size, vector<u8>& out) {
+    enum : size_t {
+        HASH_BITS = 15,
+        WINDOW = 32768,
+        MIN_MATCH = 3,
+        MAX_MATCH = 258,
+        NONE = ~(size_t)0,
+    };
+
+    auto hash3 = [data](size_t pos) -> u32 {
+        u32 v = data[pos] << 16 | data[pos + 1] << 8 | data[pos + 2];
+        return (v * 2654435761u) >> (32 - HASH_BITS);
+    };
+
+    vector<size_t> head(1u << HASH_BITS, NONE);
+    bitwriter bw(out);
+    bw.put(1, 1); // final block
+    bw.put(1, 2); // fixed huffman codes
+
+    size_t pos = 0;
+    while (pos < size) {
+        size_t len = 0, dist = 0;
+        if (pos + MIN_MATCH <= size) {
+            u32 h = hash3(pos);
+            size_t cand = head[h];
+            head[h] = pos;
+
+            if (cand != NONE && pos - cand <= WINDOW) {
+                size_t limit = min<size_t>(MAX_MATCH, size - pos);
+                while (len < limit && data[cand + len] == data[pos + len])
+                    len++;
+                dist = pos - cand;
+            }
+        }
+
+        if (len < MIN_MATCH) {
+            deflate_symbol(bw, data[pos++]);
+            continue;
+        }
+
+        deflate_match(bw, len, dist);
+        for (size_t i = 1; i < len && pos + i + MIN_MATCH <= size; i++)
+            head[hash3(pos + i)] = pos + i;
+        pos += len;
+    }
+
+    deflate_symbol(bw, 256); // end of block
+    bw.flush();
+}
+
+static void png_chunk(vector<u8>& png, const char* type, const u8* data,
+                      size_t size) {
+    put_be32(png, size);
+    size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    if (size > 0)
+        png.insert(png.end(), data, data + size);
+    put_be32(png, png_crc32(png.data() + start, png.size() - start));
+}
+
+static u8 png_paeth(u8 a, u8 b, u8 c) {
+    int p = (int)a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc)
+        return a;
+    return pb <= pc ? b : c;
+}
+
+// picks the filter with the smallest sum of absolute residuals per line
+static void png_filter(const u8* rgb, u32 width, u32 height,
+                       vector<u8>& out) {
+    const size_t linesz = width * 3;
+    vector<u8> zero(linesz, 0);
+    vector<u8> cand[4];
+    for (auto& c : cand)
+        c.resize(linesz);
+
+    out.reserve(height * (linesz + 1));
+    for (u32 y = 0; y < height; y++) {
+        const u8* cur = rgb + y * linesz;
+        const u8* up = y > 0 ? cur - linesz : zero.data();
+
+        u64 best_sum = ~0ull;
+        int best = 0;
+        for (int f = 0; f < 4; f++) {
+            u64 sum = 0;
+            for (size_t i = 0; i < linesz; i++) {
+                u8 left = i >= 3 ? cur[i - 3] : 0;
+                u8 diag = i >= 3 ? up[i - 3] : 0;
+                u8 pred = 0;
+                switch (f) {
+                case 1:
+                    pred = left;
+                    break;
+                case 2:
+                    pred = up[i];
+                    break;
+                case 3:
+                    pred = png_paeth(left, up[i], diag);
+                    break;
+                default:
+                    break;
+                }
+
+                cand[f][i] = cur[i] - pred;
+                sum += abs((i8)cand[f][i]);
+            }
+
+            if (sum < best_sum) {
+                best_sum = sum;
+                best = f;
+            }
+        }
+
+        // filter types: 0 none, 1 sub, 2 up, 4 paeth
+        out.push_back(best == 3 ? 4 : best);
+        out.insert(out.end(), cand[best].begin(), cand[best].end());
+    }
+}
+
+void encode_png(const u8* rgb, u32 width, u32 height, vector<u8>& png,
+                const string& comment) {
+    static const u8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a,
+                                     '\n' };
+
+    png.clear();
+    png.insert(png.end(), signature, signature + sizeof(signature));
+
+    vector<u8> ihdr;
+    put_be32(ihdr, width);
+    put_be32(ihdr, height);
+    ihdr.push_back(8); // bit depth
+    ihdr.push_back(2); // color type: truecolor
+    ihdr.push_back(0); // compression: deflate
+    ihdr.push_back(0); // filter method: adaptive
+    ihdr.push_back(0); // no interlace
+    png_chunk(png, "IHDR", ihdr.data(), ihdr.size());
+
+    if (!comment.empty()) {
+        string text = string("Comment") + '\0' + comment;
+        png_chunk(png, "tEXt", (const u8*)text.data(), text.size());
+    }
+
+    vector<u8> raw;
+    png_filter(rgb, width, height, raw);
+
+    vector<u8> idat;
+    idat.reserve(raw.size() / 4 + 64);
+    idat.push_back(0x78); // deflate, 32k window
+    idat.push_back(0x01); // fastest compression, no dictionary
+    deflate(raw.data(), raw.size(), idat);
+    put_be32(idat, adler32(raw.data(), raw.size()));
+    png_chunk(png, "IDAT", idat.data(), idat.size());
+
+    png_chunk(png, "IEND", nullptr, 0);
+}
+
+u64 phash(const videomode& mode, const u8* fb) {
+    // average luminance of a 9x8 grid, one bit per horizontal gradient
+    enum : u32 { W = 9, H = 8 };
+    if (fb == nullptr || mode.xres == 0 || mode.yres == 0)
+        return 0;
+
+    double sum[H][W] = {};
+    u32 cnt[H][W] = {};
+    for (u32 y = 0; y < mode.yres; y++) {
+        const u8* line = fb + y * mode.stride;
+        u32 gy = (u64)y * H / mode.yres;
+        for (u32 x = 0; x < mode.xres; x++) {
+            u8 rgb[3];
+            read_rgb(mode, line + x * mode.bpp, rgb);
+            u32 gx = (u64)x * W / mode.xres;
+            sum[gy][gx] += 0.299 * rgb[0] + 0.587 * rgb[1] + 0.114 * rgb[2];
+            cnt[gy][gx]++;
+        }
+    }
+
+    u64 hash = 0;
+    for (u32 y = 0; y < H; y++) {
+        for (u32 x = 0; x < W - 1; x++) {
+            double l = cnt[y][x] ? sum[y][x] / cnt[y][x] : 0.0;
+            double r = cnt[y][x + 1] ? sum[y][x + 1] / cnt[y][x + 1] : 0.0;
+            hash = hash << 1 | (l > r ? 1 : 0);
+        }
+    }
+
+    return hash;
+}
+
+capture::capture():
+    m_mtx(),
+    m_cv(),
+    m_jobs(),
+    m_active(0),
+    m_running(true),
+    m_worker() {
+    m_worker = thread(&capture::work, this);
+}
+
+capture::~capture() {
+    {
+        lock_guard<mutex> lock(m_mtx);
+        m_running = false;
+    }
+
+    m_cv.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+}
+
+void capture::submit(job&& j) {
+    std::unique_lock<mutex> lock(m_mtx);
+    m_cv.wait(lock, [&]() { return m_jobs.size() < MAX_PENDING; });
+    m_jobs.push_back(std::move(j));
+    lock.unlock();
+    m_cv.notify_all();
+}
+
+void capture::work() {
+    mwr::set_thread_name("vcml_capture");
+
+    ofstream video;
+    while (true) {
+        job j;
+
+        {
+            std::unique_lock<mutex> lock(m_mtx);
+            m_cv.wait(lock, [&]() { return !m_jobs.empty() || !m_running; });
+            if (m_jobs.empty())
+                break;
+
+            j = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_active++;
+        }
+
+        m_cv.notify_all();
+        process(j, video);
+
+        {
+            lock_guard<mutex> lock(m_mtx);
+            m_active--;
+        }
+
+        m_cv.notify_all();
+    }
+}
+
+void capture::process(job& j, ofstream& video) {
+    vector<u8> rgb, png;
+    switch (j.kind) {
+    case JOB_SCREENSHOT: {
+        rgb.resize((size_t)j.mode.xres * j.mode.yres * 3);
+        convert_rgb24(j.mode, j.data.data(), rgb.data());
+        encode_png(rgb.data(), j.mode.xres, j.mode.yres, png, j.comment);
+
+        ofstream file(j.path, std::ios::binary);
+        if (!file.write((const char*)png.data(), png.size()))
+            log_warn("failed to store screenshot in '%s'", j.path.c_str());
+        break;
+    }
+
+    case JOB_VIDEO_OPEN:
+        if (video.is_open())
+            video.close();
+        video.open(j.path, std::ios::binary | std::ios::trunc);
+        if (!video)
+            log_warn("failed to open capture file '%s'", j.path.c_str());
+        break;
+
+    case JOB_VIDEO_FRAME:
+        if (!video.is_open())
+            break;
+
+        rgb.resize((size_t)j.mode.xres * j.mode.yres * 3);
+        convert_rgb24(j.mode, j.data.data(), rgb.data());
+        encode_png(rgb.data(), j.mode.xres, j.mode.yres, png, j.comment);
+        video.write((const char*)png.data(), png.size());
+        break;
+
+    case JOB_VIDEO_CLOSE:
+        video.close();
+        break;
+    }
+}
+
+void capture::screenshot(const string& path, const videomode& mode,
+                         const u8* fb, const string& comment) {
+    vector<u8> data(fb, fb + mode.size);
+    submit({ JOB_SCREENSHOT, path, comment, mode, std::move(data) });
+}
+
+void capture::start(const string& path) {
+    submit({ JOB_VIDEO_OPEN, path, "", videomode(), {} });
+}
+
+void capture::record(const videomode& mode, const u8* fb,
+                     const string& comment) {
+    vector<u8> data(fb, fb + mode.size);
+    submit({ JOB_VIDEO_FRAME, "", comment, mode, std::move(data) });
+}
+
+void capture::stop() {
+    submit({ JOB_VIDEO_CLOSE, "", "", videomode(), {} });
+}
+
+void capture::flush() {
+    std::unique_lock<mutex> lock(m_mtx);
+    m_cv.wait(lock, [&]() { return m_jobs.empty() && m_active == 0; });
+}
+
+} // namespace ui
+} // namespace vcml
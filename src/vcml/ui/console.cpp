@@ -14,7 +14,16 @@ namespace vcml {
 namespace ui {
 
 console::console():
-    m_fbptr(), m_mode(), m_inputs(), m_displays(), displays("displays") {
+    m_fbptr(),
+    m_mode(),
+    m_inputs(),
+    m_displays(),
+    m_capture(),
+    m_capture_damage(),
+    m_capture_interval(),
+    m_capture_next(),
+    m_capturing(false),
+    displays("displays") {
     for (const string& type : displays) {
         try {
             auto disp = display::lookup(type);
@@ -30,6 +39,22 @@ console::~console() {
     shutdown();
 }
 
+capture& console::capturer() const {
+    if (!m_capture)
+        m_capture.reset(new capture());
+    return *m_capture;
+}
+
+bool console::has_clients() const {
+    if (m_capturing)
+        return true;
+
+    for (const auto& disp : m_displays)
+        if (disp->has_clients())
+            return true;
+    return false;
+}
+
 void console::notify(input& device) {
     m_inputs.insert(&device);
     for (auto& disp : m_displays)
@@ -55,6 +80,9 @@ void console::render() {
 }
 
 void console::shutdown() {
+    stop_capture();
+    m_capture.reset(); // waits for pending frames to be written
+
     m_mode.clear();
     m_fbptr = nullptr;
 
@@ -117,7 +145,73 @@ inline void write_binary<dib_header>(ostream& os, const dib_header& h) {
     write_binary(os, h.imp_col);
 }
 
+bool console::start_capture(const string& path, const sc_time& interval) {
+    if (m_capturing)
+        stop_capture();
+
+    capturer().start(path);
+    m_capture_damage.invalidate();
+    m_capture_interval = interval;
+    m_capture_next = SC_ZERO_TIME;
+    m_capturing = true;
+    return true;
+}
+
+void console::stop_capture() {
+    if (!m_capturing)
+        return;
+
+    capturer().stop();
+    m_capturing = false;
+}
+
+bool console::cmd_capture(const vector<string>& args, ostream& os) {
+    if (args[0] == "stop") {
+        stop_capture();
+        os << "capture stopped";
+        return true;
+    }
+
+    sc_time interval = args.size() > 1 ? from_string<sc_time>(args[1])
+                                       : sc_time(100, SC_MS);
+    if (!start_capture(args[0], interval)) {
+        os << "failed to start capture into '" << args[0] << "'";
+        return false;
+    }
+
+    os << "capturing into '" << args[0] << "' every " << interval;
+    return true;
+}
+
+void console::sample() {
+    if (!m_capturing || !m_fbptr)
+        return;
+
+    sc_time now = sc_time_stamp();
+    if (now < m_capture_next)
+        return;
+
+    m_capture_next = now + m_capture_interval;
+    if (m_capture_damage.check(m_fbptr, m_mode.size))
+        capturer().record(m_mode, m_fbptr, now.to_string());
+}
+
+void console::flush_capture() const {
+    if (m_capture)
+        m_capture->flush();
+}
+
+u64 console::phash() const {
+    return ui::phash(m_mode, m_fbptr);
+}
+
 bool console::screenshot(const string& path) const {
+    if (m_fbptr && ends_with(to_lower(path), ".png")) {
+        capturer().screenshot(path, m_mode, m_fbptr,
+                              sc_time_stamp().to_string());
+        return true;
+    }
+
     // need to have a framebuffer and a sane pixelformat
     if (!m_fbptr || m_mode.bpp > 4 || m_mode.grayscale)
         return false;
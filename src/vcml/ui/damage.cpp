@@ -0,0 +1,74 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "vcml/ui/damage.h"
+
+namespace vcml {
+namespace ui {
+
+damage::damage(size_t pagesize):
+    m_pagesize(pagesize), m_hashes(), m_valid(false) {
+    VCML_ERROR_ON(pagesize == 0, "damage tracking page size cannot be zero");
+}
+
+bool damage::check(const u8* data, size_t size, range& changed) {
+    size_t npages = (size + m_pagesize - 1) / m_pagesize;
+    if (m_hashes.size() != npages) {
+        m_hashes.assign(npages, 0);
+        m_valid = false;
+    }
+
+    bool dirty = false;
+    for (size_t i = 0; i < npages; i++) {
+        size_t offset = i * m_pagesize;
+        size_t length = min(m_pagesize, size - offset);
+        u64 h = hash(data + offset, length);
+        if (m_valid && h == m_hashes[i])
+            continue;
+
+        m_hashes[i] = h;
+        if (!dirty)
+            changed.start = offset;
+        changed.end = offset + length - 1;
+        dirty = true;
+    }
+
+    m_valid = true;
+    return dirty;
+}
+
+u64 damage::hash(const u8* data, size_t size) {
+    // four independent multiply-xor lanes keep the multiplier busy
+    const u64 prime = 0x100000001b3ull;
+    u64 h[4] = {
+        0xcbf29ce484222325ull,
+        0x84222325cbf29ce4ull,
+        0x9ce484222325cbf2ull,
+        0x2325cbf29ce48422ull,
+    };
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        u64 v[4];
+        memcpy(v, data + i, sizeof(v));
+        h[0] = (h[0] ^ v[0]) * prime;
+        h[1] = (h[1] ^ v[1]) * prime;
+        h[2] = (h[2] ^ v[2]) * prime;
+        h[3] = (h[3] ^ v[3]) * prime;
+    }
+
+    for (; i < size; i++)
+        h[0] = (h[0] ^ data[i]) * prime;
+
+    return (h[0] ^ (h[1] >> 13) ^ (h[2] << 7) ^ (h[3] >> 29)) * prime;
+}
+
+} // namespace ui
+} // namespace vcml
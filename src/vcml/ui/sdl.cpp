@@ -372,6 +372,8 @@ void sdl_client::init_window() {
 
     SDL_RenderClear(renderer);
     SDL_RenderPresent(renderer);
+
+    disp->render(); // texture is empty, upload everything on next frame
 }
 
 void sdl_client::reinit_window() {
@@ -395,6 +397,8 @@ void sdl_client::reinit_window() {
     SDL_RenderClear(renderer);
     SDL_RenderPresent(renderer);
 
+    disp->render(); // texture is empty, upload everything on next frame
+
     reinit = false;
 }
 
@@ -415,29 +419,58 @@ void sdl_client::exit_window() {
     }
 }
 
-void sdl_client::draw_window() {
-    if (!disp || !window || !renderer || !texture)
+void sdl_client::upload(const SDL_Rect& rect) {
+    const videomode& mode = disp->mode();
+    const size_t linesz = rect.w * mode.bpp;
+    const u8* src = disp->framebuffer() + rect.y * mode.stride +
+                    rect.x * mode.bpp;
+
+    int pitch = 0;
+    void* pixels = nullptr;
+    if (SDL_LockTexture(texture, &rect, &pixels, &pitch) < 0) {
+        log_debug("cannot lock SDL texture: %s", SDL_GetError());
         return;
+    }
+
+    u8* dest = (u8*)pixels;
+    for (int y = 0; y < rect.h; y++, src += mode.stride, dest += pitch)
+        memcpy(dest, src, linesz);
 
-    SDL_Rect rect = {};
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = disp->xres();
-    rect.h = disp->yres();
+    SDL_UnlockTexture(texture);
+}
 
-    int pitch = disp->framebuffer_size() / disp->yres();
-    const void* pixels = disp->framebuffer();
+void sdl_client::draw_window(bool force) {
+    if (!disp || !window || !renderer || !texture)
+        return;
 
-    SDL_RenderClear(renderer);
+    // all times in microseconds
+    u64 now = mwr::timestamp_us();
+    if (!force && now < time_next)
+        return;
 
-    if (pixels) {
-        SDL_UpdateTexture(texture, &rect, pixels, pitch);
-        SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+    // only upload regions the framebuffer model reported as changed; if
+    // nothing changed, there is no need to present a new frame at all
+    if (!disp->fetch_damage(damage) && !force)
+        return;
+
+    if (disp->framebuffer()) {
+        for (const SDL_Rect& rect : damage)
+            upload(rect);
     }
 
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, texture, nullptr, nullptr);
     SDL_RenderPresent(renderer);
     frames++;
 
+    u32 fps = disp->fps();
+    time_next = fps ? now + 1000000 / fps : now;
+}
+
+void sdl_client::update_title() {
+    if (!disp || !window)
+        return;
+
     // all times in microseconds
     const u64 update_interval = 1000000;
     u64 delta = mwr::timestamp_us() - time_frame;
@@ -487,9 +520,9 @@ void sdl::check_clients() {
     });
 }
 
-void sdl::poll_events() {
+void sdl::poll_events(u32 timeout_ms) {
     SDL_Event event = {};
-    while (SDL_WaitEventTimeout(&event, 1) && sim_running()) {
+    while (SDL_WaitEventTimeout(&event, timeout_ms) && sim_running()) {
         lock_guard<mutex> lock(m_mtx);
         switch (event.type) {
         case SDL_QUIT:
@@ -503,7 +536,7 @@ void sdl::poll_events() {
             }
 
             if (event.window.event == SDL_WINDOWEVENT_EXPOSED && client)
-                client->draw_window();
+                client->draw_window(true);
             break;
         }
 
@@ -558,8 +591,22 @@ void sdl::poll_events() {
 
 void sdl::draw_windows() {
     lock_guard<mutex> lock(m_mtx);
-    for (auto& client : m_clients)
+    for (auto& client : m_clients) {
         client.draw_window();
+        client.update_title();
+    }
+}
+
+u32 sdl::frame_timeout() {
+    lock_guard<mutex> lock(m_mtx);
+    u32 fps = 0;
+    for (const auto& client : m_clients) {
+        if (client.disp)
+            fps = max(fps, client.disp->fps());
+    }
+
+    // wait at most one frame for input events before checking for damage
+    return fps > 0 ? max(1000u / fps, 1u) : 1u;
 }
 
 void sdl::run() {
@@ -576,7 +623,7 @@ void sdl::run() {
 
     while (sim_running() && !m_exit) {
         check_clients();
-        poll_events();
+        poll_events(frame_timeout());
         draw_windows();
     }
 
@@ -591,7 +638,7 @@ sdl::~sdl() {
         m_uithread.join();
 }
 
-void sdl::register_display(display* disp) {
+void sdl::register_display(sdl_display* disp) {
     auto finder = [disp](const sdl_client& s) -> bool {
         return s.disp == disp;
     };
@@ -610,7 +657,7 @@ void sdl::register_display(display* disp) {
 #endif
 }
 
-void sdl::unregister_display(display* disp) {
+void sdl::unregister_display(sdl_display* disp) {
     lock_guard<mutex> lock(m_mtx);
 
     auto finder = [disp](const sdl_client& s) -> bool {
@@ -624,7 +671,7 @@ void sdl::unregister_display(display* disp) {
     it->disp = nullptr;
 }
 
-void sdl::update_display(display* disp) {
+void sdl::update_display(sdl_display* disp) {
     lock_guard<mutex> lock(m_mtx);
 
     auto finder = [disp](const sdl_client& s) -> bool {
@@ -648,7 +695,11 @@ display* sdl::create(u32 nr) {
 }
 
 sdl_display::sdl_display(u32 nr, sdl& owner):
-    display("sdl", nr), m_owner(owner) {
+    display("sdl", nr),
+    m_owner(owner),
+    m_fps(DEFAULT_FPS),
+    m_damage_mtx(),
+    m_damage() {
 }
 
 sdl_display::~sdl_display() {
@@ -666,17 +717,65 @@ void sdl_display::reinit(const videomode& mode, u8* fb) {
     m_owner.update_display(this);
 }
 
+bool sdl_display::fetch_damage(vector<SDL_Rect>& rects) {
+    rects.clear();
+    lock_guard<mutex> lock(m_damage_mtx);
+    m_damage.swap(rects);
+    return !rects.empty();
+}
+
 void sdl_display::render(u32 x, u32 y, u32 w, u32 h) {
-    // nothing to do
+    if (x >= xres() || y >= yres())
+        return;
+
+    SDL_Rect rect;
+    rect.x = x;
+    rect.y = y;
+    rect.w = min(w, xres() - x);
+    rect.h = min(h, yres() - y);
+
+    if (rect.w == 0 || rect.h == 0)
+        return;
+
+    lock_guard<mutex> lock(m_damage_mtx);
+
+    // merge with an overlapping region, or collapse everything into a
+    // single bounding box once we track too many separate regions
+    for (SDL_Rect& other : m_damage) {
+        if (SDL_HasIntersection(&other, &rect)) {
+            SDL_UnionRect(&other, &rect, &other);
+            return;
+        }
+    }
+
+    if (m_damage.size() >= MAX_DAMAGE_RECTS) {
+        for (const SDL_Rect& other : m_damage)
+            SDL_UnionRect(&rect, &other, &rect);
+        m_damage.clear();
+    }
+
+    m_damage.push_back(rect);
 }
 
 void sdl_display::render() {
-    // nothing to do
+    render(0, 0, xres(), yres());
 }
 
 void sdl_display::shutdown() {
     m_owner.unregister_display(this);
     display::shutdown();
+
+    lock_guard<mutex> lock(m_damage_mtx);
+    m_damage.clear();
+}
+
+void sdl_display::handle_option(const string& option) {
+    if (starts_with(option, "fps=")) {
+        m_fps = from_string<u32>(option.substr(4));
+        return;
+    }
+
+    display::handle_option(option);
 }
 
 } // namespace ui
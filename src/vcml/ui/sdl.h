@@ -26,17 +26,21 @@
 namespace vcml {
 namespace ui {
 
+class sdl_display;
+
 struct sdl_client {
-    display* disp;
+    sdl_display* disp;
     SDL_Window* window;
     SDL_Renderer* renderer;
     SDL_Texture* texture;
     u32 window_id;
     u64 time_frame;
     u64 time_sim;
+    u64 time_next;
     u64 frames;
     bool grabbing;
     bool reinit;
+    vector<SDL_Rect> damage;
 
     void notify_key(u32 keysym, bool down);
     void notify_btn(SDL_MouseButtonEvent& event);
@@ -46,7 +50,9 @@ struct sdl_client {
     void init_window();
     void reinit_window();
     void exit_window();
-    void draw_window();
+    void upload(const SDL_Rect& rect);
+    void draw_window(bool force = false);
+    void update_title();
 };
 
 class sdl
@@ -60,9 +66,11 @@ private:
     sdl_client* find_by_window_id(u32 id);
 
     void check_clients();
-    void poll_events();
+    void poll_events(u32 timeout_ms);
     void draw_windows();
 
+    u32 frame_timeout();
+
     sdl() = default;
     sdl(const sdl&) = delete;
 
@@ -70,9 +78,9 @@ public:
     ~sdl();
 
     void run();
-    void register_display(display* disp);
-    void unregister_display(display* disp);
-    void update_display(display* disp);
+    void register_display(sdl_display* disp);
+    void unregister_display(sdl_display* disp);
+    void update_display(sdl_display* disp);
 
     static sdl& instance();
     static display* create(u32 nr);
@@ -82,16 +90,31 @@ class sdl_display : public display
 {
 private:
     sdl& m_owner;
+    u32 m_fps;
+
+    mutable mutex m_damage_mtx;
+    vector<SDL_Rect> m_damage;
 
 public:
+    enum : size_t { MAX_DAMAGE_RECTS = 16 };
+    enum : u32 { DEFAULT_FPS = 60 };
+
+    u32 fps() const { return m_fps; }
+
     sdl_display(u32 nr, sdl& owner);
     virtual ~sdl_display();
 
+    bool fetch_damage(vector<SDL_Rect>& rects);
+
     virtual void init(const videomode& mode, u8* fb) override;
     virtual void reinit(const videomode& mode, u8* fb) override;
     virtual void render(u32 x, u32 y, u32 w, u32 h) override;
     virtual void render() override;
     virtual void shutdown() override;
+
+    virtual bool has_clients() const override { return has_framebuffer(); }
+
+    virtual void handle_option(const string& option) override;
 };
 
 } // namespace ui
@@ -849,12 +849,15 @@ void vnc::run() {
             if (m_running)
                 handshake();
 
+            m_connected = true;
             while (m_running && sim_running() && m_socket.is_connected()) {
                 if (m_socket.poll(100) >= 0)
                     handle_command();
             }
 
+            m_connected = false;
         } catch (std::exception& ex) {
+            m_connected = false;
             if (sim_running())
                 log.debug(ex);
 
@@ -882,6 +885,7 @@ vnc::vnc(u32 no):
     m_buffer(),
     m_socket(1),
     m_running(),
+    m_connected(),
     m_mutex(),
     m_thread() {
     static bool debug_vnc = []() {
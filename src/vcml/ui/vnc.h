@@ -95,6 +95,7 @@ private:
     mwr::server_socket m_socket;
 
     atomic<bool> m_running;
+    atomic<bool> m_connected;
     mutex m_mutex;
     thread m_thread;
 
@@ -140,6 +141,8 @@ public:
     virtual void reinit(const videomode& newmode, u8* newfb) override;
     virtual void shutdown() override;
 
+    virtual bool has_clients() const override { return m_connected; }
+
     virtual void handle_option(const string& option) override;
 
     static display* create(u32 nr);
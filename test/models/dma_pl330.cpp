@@ -288,6 +288,14 @@ public:
 
     virtual void run_test() override {
         test_transfer();
+        EXPECT_GT(dma.icache.size(), 0);
+        dma.reset();
+        EXPECT_EQ(dma.icache.size(), 0);
+
+        // without DMI every burst has to pass through the mfifo
+        dma.dma.allow_dmi = false;
+        test_transfer();
+        dma.dma.allow_dmi = true;
         dma.reset();
         test_unaligned_source_transfer();
         dma.reset();
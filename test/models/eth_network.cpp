@@ -0,0 +1,157 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class eth_node : public module, public eth_host
+{
+public:
+    mac_addr addr;
+    size_t rx_frames;
+    size_t rx_foreign;
+
+    eth_initiator_socket eth_tx;
+    eth_target_socket eth_rx;
+
+    eth_node(const sc_module_name& nm, u8 id):
+        module(nm),
+        eth_host(),
+        addr(0x02, 0x00, 0x00, 0x00, 0x00, id),
+        rx_frames(0),
+        rx_foreign(0),
+        eth_tx("eth_tx"),
+        eth_rx("eth_rx") {}
+
+    virtual void eth_receive(const eth_target_socket& rx,
+                             const eth_frame& frame) override {
+        rx_frames++;
+        if (frame.is_unicast() && frame.destination() != addr)
+            rx_foreign++;
+    }
+};
+
+class eth_network_test : public test_base
+{
+public:
+    enum : size_t { NUM_NODES = 8 };
+
+    ethernet::network net;
+    vector<eth_node*> nodes;
+
+    eth_network_test(const sc_module_name& nm):
+        test_base(nm), net("net"), nodes() {
+        net.learning = true;
+        for (size_t i = 0; i < NUM_NODES; i++) {
+            string name = mkstr("node%zu", i);
+            nodes.push_back(new eth_node(name.c_str(), (u8)i + 1));
+            net.connect(*nodes.back());
+        }
+
+        add_test("learning", &eth_network_test::test_learning);
+        add_test("switching", &eth_network_test::test_switching);
+    }
+
+    virtual ~eth_network_test() {
+        for (eth_node* node : nodes)
+            delete node;
+    }
+
+    void clear_counters() {
+        for (eth_node* node : nodes)
+            node->rx_frames = node->rx_foreign = 0;
+    }
+
+    size_t total_rx() const {
+        size_t total = 0;
+        for (eth_node* node : nodes)
+            total += node->rx_frames;
+        return total;
+    }
+
+    void send(size_t from, size_t to, const vector<u8>& payload) {
+        eth_frame frame(nodes[to]->addr, nodes[from]->addr, payload);
+        nodes[from]->eth_tx.send(frame);
+    }
+
+    void test_learning() {
+        vector<u8> payload(46, 0xab);
+        net.flush_macs();
+        clear_counters();
+
+        // destination unknown: frame is flooded to everyone but the sender
+        send(0, 1, payload);
+        EXPECT_EQ(total_rx(), NUM_NODES - 1);
+        EXPECT_EQ(nodes[0]->rx_frames, 0u);
+
+        // node1 replies, node0 is known, so only node0 sees the reply
+        clear_counters();
+        send(1, 0, payload);
+        EXPECT_EQ(total_rx(), 1u);
+        EXPECT_EQ(nodes[0]->rx_frames, 1u);
+
+        // both addresses learned now, no more flooding between them
+        clear_counters();
+        send(0, 1, payload);
+        EXPECT_EQ(total_rx(), 1u);
+        EXPECT_EQ(nodes[1]->rx_frames, 1u);
+
+        size_t port = 0;
+        EXPECT_TRUE(net.lookup_port(nodes[0]->addr, port));
+        EXPECT_EQ(port, 0u);
+        EXPECT_TRUE(net.lookup_port(nodes[1]->addr, port));
+        EXPECT_EQ(port, 1u);
+        EXPECT_FALSE(net.lookup_port(nodes[2]->addr, port));
+
+        // broadcasts are always flooded
+        clear_counters();
+        eth_frame bcast("ff:ff:ff:ff:ff:ff", nodes[2]->addr, payload);
+        nodes[2]->eth_tx.send(bcast);
+        EXPECT_EQ(total_rx(), NUM_NODES - 1);
+        EXPECT_EQ(nodes[2]->rx_frames, 0u);
+
+        stringstream ss;
+        EXPECT_TRUE(net.execute("show_macs", ss));
+        EXPECT_NE(ss.str().find("02:00:00:00:00:03"), string::npos);
+        EXPECT_TRUE(net.execute("flush_macs", ss));
+        EXPECT_FALSE(net.lookup_port(nodes[0]->addr, port));
+    }
+
+    void test_switching() {
+        vector<u8> payload(64, 0x5a);
+        vector<eth_frame> frames;
+        for (size_t i = 0; i < NUM_NODES; i++) {
+            size_t j = (i + 1) % NUM_NODES;
+            frames.emplace_back(nodes[j]->addr, nodes[i]->addr, payload);
+        }
+
+        // prime the MAC table, so that only the first round floods
+        net.flush_macs();
+        for (size_t i = 0; i < NUM_NODES; i++)
+            nodes[i]->eth_tx.send(frames[i]);
+
+        clear_counters();
+        const size_t rounds = 4;
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < NUM_NODES; i++)
+                nodes[i]->eth_tx.send(frames[i]);
+        }
+
+        EXPECT_EQ(total_rx(), rounds * NUM_NODES);
+        for (eth_node* node : nodes) {
+            EXPECT_EQ(node->rx_frames, rounds);
+            EXPECT_EQ(node->rx_foreign, 0u);
+        }
+    }
+};
+
+TEST(ethernet, network) {
+    eth_network_test test("test");
+    sc_core::sc_start();
+}
@@ -126,6 +126,7 @@ public:
         add_test("msi_mrif", &iommu_test::test_iommu_msi_mrif);
         add_test("tr_debug", &iommu_test::test_iommu_tr_debug);
         add_test("iommu_dmi", &iommu_test::test_iommu_dmi);
+        add_test("iommu_iotlb", &iommu_test::test_iommu_iotlb);
 
         EXPECT_STREQ(iommu.kind(), "vcml::riscv::iommu");
     }
@@ -560,6 +561,137 @@ public:
 
         dma.allow_dmi = false;
     }
+
+    u64 iotlb_stat(const string& stage, const string& stat) {
+        stringstream ss;
+        EXPECT_TRUE(iommu.execute("iotlb", ss));
+
+        string line;
+        bool found = false;
+        while (std::getline(ss, line)) {
+            if (line.rfind(stage, 0) == 0)
+                found = true;
+            else if (found && line.find(stat + ":") != string::npos)
+                return std::stoull(line.substr(line.find(':') + 1));
+        }
+
+        ADD_FAILURE() << "no " << stage << " iotlb " << stat;
+        return 0;
+    }
+
+    void iotinval(u32& cqt, u64 cmd, u64 addr) {
+        u64* cq = (u64*)(mem.data() + CMDQ_OFFSET);
+        cq[cqt * 2 + 0] = cmd;
+        cq[cqt * 2 + 1] = addr >> 2;
+        cqt = (cqt + 1) % 8;
+        ASSERT_OK(out.writew(IOMMU_CQT, cqt));
+        wait(1, SC_MS);
+
+        u32 cqh;
+        ASSERT_OK(out.readw(IOMMU_CQH, cqh));
+        EXPECT_EQ(cqh, cqt);
+    }
+
+    void test_iommu_iotlb() {
+        u64* pgtp = (u64*)(mem.data() + PGTP_OFFSET);
+        memset(pgtp, 0, 4096);
+        pgtp[0] = (MEM_ADDR >> 2) | 0xdf; // 0x0 -> MEM | DA | U | RWX | V
+
+        u64* ddtp0 = (u64*)(mem.data() + DDTP0_OFFSET);
+        ddtp0[0] = DDTP1_ADDR >> 2 | 1;
+
+        u64* ddtp1 = (u64*)(mem.data() + DDTP1_OFFSET);
+        u64 gatp = PGTP_ADDR >> 12 | 5ull << 44 | 8ull << 60;
+        ddtp1[16] = 0x0000000000000011; // dev[2].tc = V | DTF
+        ddtp1[17] = gatp;               // dev[2].gatp = sv39, gscid 5
+        ddtp1[18] = 0x0000000000003000; // dev[2].ta.pscid = 3
+        ddtp1[19] = 0x0000000000000000; // dev[2].satp = bare
+        ddtp1[20] = 0x0000000000000000; // dev[2].msiptp
+        ddtp1[21] = 0x0000000000000000; // dev[2].msi_addr_mask
+        ddtp1[22] = 0x0000000000000000; // dev[2].msi_addr_patter
+        ddtp1[23] = 0x0000000000000000; // dev[2].reserverd
+        ASSERT_OK(out.writew(IOMMU_DDTP, (DDTP0_ADDR >> 2) | 3));
+
+        u64 cqb = CMDQ_ADDR >> 2 | 2; // 8 entries
+        ASSERT_OK(out.writew(IOMMU_CQB, cqb));
+        ASSERT_OK(out.writew(IOMMU_CQCSR, 1u));
+        wait(1, SC_MS);
+
+        u32 cqt;
+        ASSERT_OK(out.readw(IOMMU_CQT, cqt));
+
+        const u64 page0 = 512 * KiB;
+        const u64 page1 = page0 + 4 * KiB;
+        *(u32*)(mem.data() + page0) = 0x11111111;
+        *(u32*)(mem.data() + page1) = 0x22222222;
+
+        const u64 s_hits = iotlb_stat("first-stage", "hits");
+        const u64 s_misses = iotlb_stat("first-stage", "misses");
+        const u64 s_invals = iotlb_stat("first-stage", "invalidations");
+        const u64 g_hits = iotlb_stat("second-stage", "hits");
+        const u64 g_misses = iotlb_stat("second-stage", "misses");
+        const u64 g_invals = iotlb_stat("second-stage", "invalidations");
+
+        u32 data;
+        tlm_sbi info = sbi_cpuid(2);
+
+        // first access to each page misses in both stages, repeated
+        // accesses to the same page hit in the first stage
+        ASSERT_OK(dma.readw(page0, data, info));
+        EXPECT_EQ(data, 0x11111111);
+        ASSERT_OK(dma.readw(page0 + 4, data, info));
+        ASSERT_OK(dma.readw(page1, data, info));
+        EXPECT_EQ(data, 0x22222222);
+        ASSERT_OK(dma.readw(page1 + 4, data, info));
+        EXPECT_EQ(iotlb_stat("first-stage", "hits"), s_hits + 2);
+        EXPECT_EQ(iotlb_stat("first-stage", "misses"), s_misses + 2);
+        EXPECT_EQ(iotlb_stat("second-stage", "hits"), g_hits);
+        EXPECT_EQ(iotlb_stat("second-stage", "misses"), g_misses + 2);
+
+        // iotinval.vma with address only drops the first-stage entry of
+        // page0, its second-stage translation remains cached
+        iotinval(cqt, 0x0000000000000401, page0);
+        EXPECT_EQ(iotlb_stat("first-stage", "invalidations"), s_invals + 1);
+        EXPECT_EQ(iotlb_stat("second-stage", "invalidations"), g_invals);
+
+        ASSERT_OK(dma.readw(page0, data, info));
+        EXPECT_EQ(data, 0x11111111);
+        ASSERT_OK(dma.readw(page1, data, info));
+        EXPECT_EQ(data, 0x22222222);
+        EXPECT_EQ(iotlb_stat("first-stage", "hits"), s_hits + 3);
+        EXPECT_EQ(iotlb_stat("first-stage", "misses"), s_misses + 3);
+        EXPECT_EQ(iotlb_stat("second-stage", "hits"), g_hits + 1);
+        EXPECT_EQ(iotlb_stat("second-stage", "misses"), g_misses + 2);
+
+        // global iotinval.gvma flushes both stages
+        iotinval(cqt, 0x0000000000000081, 0);
+        EXPECT_EQ(iotlb_stat("first-stage", "invalidations"), s_invals + 3);
+        EXPECT_EQ(iotlb_stat("second-stage", "invalidations"), g_invals + 2);
+
+        // translations must be fetched again after the flush
+        ASSERT_OK(dma.readw(page0, data, info));
+        EXPECT_EQ(data, 0x11111111);
+        EXPECT_EQ(iotlb_stat("first-stage", "misses"), s_misses + 4);
+        EXPECT_EQ(iotlb_stat("second-stage", "misses"), g_misses + 3);
+
+        // iotinval.gvma for another guest leaves both stages alone
+        iotinval(cqt, 0x0000700200000081, 0);
+        EXPECT_EQ(iotlb_stat("first-stage", "invalidations"), s_invals + 3);
+        EXPECT_EQ(iotlb_stat("second-stage", "invalidations"), g_invals + 2);
+
+        // iotinval.gvma for gscid 5 drops the entries of that guest
+        iotinval(cqt, 0x0000500200000081, 0);
+        EXPECT_EQ(iotlb_stat("first-stage", "invalidations"), s_invals + 4);
+        EXPECT_EQ(iotlb_stat("second-stage", "invalidations"), g_invals + 3);
+
+        ASSERT_OK(dma.readw(page0, data, info));
+        EXPECT_EQ(data, 0x11111111);
+        EXPECT_EQ(iotlb_stat("first-stage", "misses"), s_misses + 5);
+        EXPECT_EQ(iotlb_stat("second-stage", "misses"), g_misses + 4);
+
+        ASSERT_OK(out.writew(IOMMU_CQCSR, 0u));
+        wait(1, SC_MS);
+    }
 };
 
 TEST(riscv, iommu) {
@@ -45,7 +45,7 @@ public:
     sdhci_harness(const sc_module_name& nm):
         test_base(nm),
         sdhci("sdhci"),
-        mem("mem", 1024),
+        mem("mem", 8 * KiB),
         sdcard("mock_sd"),
         out("out") {
         rst.bind(sdhci.rst);
@@ -502,6 +502,245 @@ public:
         ASSERT_OK(out.readw(0x32, value_of_error_int_stat))
             << "error interrupt has been triggered additionally";
         EXPECT_EQ(0x0000, value_of_error_int_stat);
+
+        /**********************************************************************
+         *                                                                    *
+         *             test read_multiple_block (with ADMA2)                  *
+         *                                                                    *
+         **********************************************************************/
+
+        ASSERT_OK(out.writew<u8>(0x2F, 0x01)) << "reset the SDHCI";
+        sdhci.dma_enabled = true; // tests with DMA
+
+        u32 value_of_capabilities;
+        ASSERT_OK(out.readw(0x40, value_of_capabilities))
+            << "read the CAPABILITIES register";
+        EXPECT_TRUE(value_of_capabilities & bit(19)) << "ADMA2 support";
+
+        u16 value_of_version;
+        ASSERT_OK(out.readw(0xfe, value_of_version))
+            << "read the HOST_CONTROLLER_VERSION register";
+        EXPECT_EQ(value_of_version & 0xff, 1) << "spec version 2.00";
+
+        cmd.spi = false;
+        cmd.opcode = 18;
+        cmd.argument = 0;
+        cmd.crc = 0;
+        cmd.resp_len = 6;
+        cmd.response[0] = 0;
+        cmd.response[1] = 1;
+        cmd.response[2] = 2;
+        cmd.response[3] = 3;
+        cmd.response[4] = 4;
+        cmd.response[5] = 0;
+        cmd.status = SD_INCOMPLETE;
+
+        EXPECT_CALL(sdcard, test_transport(_))
+            .WillOnce(DoAll(SetArgReferee<0>(cmd), Return(SD_OK_TX_RDY)));
+
+        EXPECT_CALL(sdcard, test_data_read(_))
+            .WillOnce(DoAll(SetArgReferee<0>(0x01), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0X02), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x03), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x04), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x05), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x06), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x07), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x08), Return(SDTX_OK_BLK_DONE)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x09), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0A), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0X0B), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0C), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0D), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0E), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0F), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x10), Return(SDTX_OK_BLK_DONE)));
+
+        // descriptor table: 4 bytes to 0x200, link to 0x180, then the
+        // remaining 12 bytes to 0x300, splitting the first block
+        u32 desc[6] = {
+            4u << 16 | 0x21, 0x200, // valid, tran
+            0x31, 0x180,            // valid, link
+            12u << 16 | 0x23, 0x300 // valid, end, tran
+        };
+
+        ASSERT_OK(mem.write(range(0x100, 0x10f), desc, SBI_NONE));
+        ASSERT_OK(mem.write(range(0x180, 0x187), desc + 4, SBI_NONE));
+
+        ASSERT_OK(out.writew<u32>(0x58, 0x00000100)) << "set ADMA address";
+        ASSERT_OK(out.writew<u8>(0x28, 0x10)) << "select ADMA2";
+        ASSERT_OK(out.writew<u16>(0x04, 0x0008))
+            << "define block size to eight byte";
+        ASSERT_OK(out.writew<u16>(0x06, 0x0002))
+            << "write two to BLOCK_COUNT_16BIT register";
+        ASSERT_OK(out.writew<u32>(0x08, 0x00000000))
+            << "write zero to ARG register";
+        ASSERT_OK(out.writew<u16>(0x0e, 0x123a))
+            << "write CMD18 (READ_MULTIPLE_BLOCK) to CMD register";
+
+        wait(1, SC_US); // allow the ADMA transfer to complete
+        EXPECT_TRUE(sdhci.irq.read())
+            << "check whether an interrupt has been triggered";
+
+        ASSERT_OK(out.readw(0x30, value_of_normal_int_stat))
+            << "check if it was the right interrupt (transfer complete)";
+        EXPECT_EQ(0x0003, value_of_normal_int_stat);
+        ASSERT_OK(out.writew<u16>(0x30, 0x0003)) << "clear the interrupt";
+
+        ASSERT_OK(out.readw(0x32, value_of_error_int_stat))
+            << "error interrupt has been triggered additionally";
+        EXPECT_EQ(0x0000, value_of_error_int_stat);
+
+        u32 mem2;
+        mem.read(range(0x200, 0x203), &mem2, SBI_NONE);
+        mem.read(range(0x300, 0x307), &mem0, SBI_NONE);
+        mem.read(range(0x308, 0x30b), &mem1, SBI_NONE);
+
+        EXPECT_EQ(mem2, 0x04030201) << "check first ADMA segment";
+        EXPECT_EQ(mem0, 0x0c0b0a0908070605) << "check second ADMA segment";
+        EXPECT_EQ((u32)mem1, 0x100f0e0d) << "check second ADMA segment";
+
+        /**********************************************************************
+         *                                                                    *
+         *             test ADMA2 interrupt on the last descriptor            *
+         *                                                                    *
+         **********************************************************************/
+
+        ASSERT_OK(out.writew<u8>(0x2F, 0x01)) << "reset the SDHCI";
+        sdhci.dma_enabled = true; // tests with DMA
+
+        EXPECT_CALL(sdcard, test_transport(_))
+            .WillOnce(DoAll(SetArgReferee<0>(cmd), Return(SD_OK_TX_RDY)));
+
+        EXPECT_CALL(sdcard, test_data_read(_))
+            .WillOnce(DoAll(SetArgReferee<0>(0x01), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0X02), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x03), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x04), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x05), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x06), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x07), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x08), Return(SDTX_OK_BLK_DONE)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x09), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0A), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0X0B), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0C), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0D), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0E), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0F), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x10), Return(SDTX_OK_BLK_DONE)));
+
+        // a single descriptor carrying all 16 bytes with END and INT set
+        u32 last[2] = { 16u << 16 | 0x27, 0x400 }; // valid, end, int, tran
+        ASSERT_OK(mem.write(range(0x100, 0x107), last, SBI_NONE));
+
+        ASSERT_OK(out.writew<u32>(0x58, 0x00000100)) << "set ADMA address";
+        ASSERT_OK(out.writew<u8>(0x28, 0x10)) << "select ADMA2";
+        ASSERT_OK(out.writew<u16>(0x04, 0x0008))
+            << "define block size to eight byte";
+        ASSERT_OK(out.writew<u16>(0x06, 0x0002))
+            << "write two to BLOCK_COUNT_16BIT register";
+        ASSERT_OK(out.writew<u32>(0x08, 0x00000000))
+            << "write zero to ARG register";
+        ASSERT_OK(out.writew<u16>(0x0e, 0x123a))
+            << "write CMD18 (READ_MULTIPLE_BLOCK) to CMD register";
+
+        wait(1, SC_US); // allow the ADMA transfer to complete
+        EXPECT_TRUE(sdhci.irq.read())
+            << "check whether an interrupt has been triggered";
+
+        ASSERT_OK(out.readw(0x30, value_of_normal_int_stat))
+            << "check for DMA interrupt next to transfer complete";
+        EXPECT_EQ(0x000b, value_of_normal_int_stat);
+        ASSERT_OK(out.writew<u16>(0x30, 0x000b)) << "clear the interrupt";
+
+        ASSERT_OK(out.readw(0x32, value_of_error_int_stat))
+            << "error interrupt has been triggered additionally";
+        EXPECT_EQ(0x0000, value_of_error_int_stat);
+
+        mem.read(range(0x400, 0x407), &mem0, SBI_NONE);
+        mem.read(range(0x408, 0x40f), &mem1, SBI_NONE);
+        EXPECT_EQ(mem0, 0x0807060504030201) << "check ADMA transfer";
+        EXPECT_EQ(mem1, 0x100f0e0d0c0b0a09) << "check ADMA transfer";
+
+        /**********************************************************************
+         *                                                                    *
+         *             test SDMA resume at a boundary                         *
+         *                                                                    *
+         **********************************************************************/
+
+        ASSERT_OK(out.writew<u8>(0x2F, 0x01)) << "reset the SDHCI";
+        sdhci.dma_enabled = true; // tests with DMA
+
+        EXPECT_CALL(sdcard, test_transport(_))
+            .WillOnce(DoAll(SetArgReferee<0>(cmd), Return(SD_OK_TX_RDY)));
+
+        EXPECT_CALL(sdcard, test_data_read(_))
+            .WillOnce(DoAll(SetArgReferee<0>(0x01), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0X02), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x03), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x04), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x05), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x06), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x07), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x08), Return(SDTX_OK_BLK_DONE)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x09), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0A), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0X0B), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0C), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0D), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0E), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x0F), Return(SDTX_OK)))
+            .WillOnce(DoAll(SetArgReferee<0>(0x10), Return(SDTX_OK_BLK_DONE)));
+
+        // the first block ends right at the 4KiB boundary
+        ASSERT_OK(out.writew<u32>(0x00, 0x00000ff8)) << "set the SDMA address";
+        ASSERT_OK(out.writew<u16>(0x04, 0x0008))
+            << "define block size to eight byte, 4KiB SDMA boundary";
+        ASSERT_OK(out.writew<u16>(0x06, 0x0002))
+            << "write two to BLOCK_COUNT_16BIT register";
+        ASSERT_OK(out.writew<u32>(0x08, 0x00000000))
+            << "write zero to ARG register";
+        ASSERT_OK(out.writew<u16>(0x0e, 0x123a))
+            << "write CMD18 (READ_MULTIPLE_BLOCK) to CMD register";
+
+        wait(1, SC_US); // allow the DMA to reach the boundary
+        EXPECT_TRUE(sdhci.irq.read())
+            << "check whether an interrupt has been triggered";
+
+        ASSERT_OK(out.readw(0x30, value_of_normal_int_stat))
+            << "check for DMA interrupt without transfer complete";
+        EXPECT_EQ(0x0009, value_of_normal_int_stat);
+        ASSERT_OK(out.writew<u16>(0x30, 0x0009)) << "clear the interrupt";
+
+        u32 value_of_sdma_address;
+        ASSERT_OK(out.readw(0x00, value_of_sdma_address))
+            << "read the SDMA address where the transfer paused";
+        EXPECT_EQ(0x00001000, value_of_sdma_address);
+
+        wait(1, SC_US); // transfer must stay paused
+        EXPECT_FALSE(sdhci.irq.read()) << "DMA continued without new address";
+
+        ASSERT_OK(out.writew<u32>(0x00, 0x00001100))
+            << "resume the transfer at a new SDMA address";
+
+        wait(1, SC_US); // allow the DMA transfer to complete
+        EXPECT_TRUE(sdhci.irq.read())
+            << "check whether an interrupt has been triggered";
+
+        ASSERT_OK(out.readw(0x30, value_of_normal_int_stat))
+            << "check if it was the right interrupt (transfer complete)";
+        EXPECT_EQ(0x0002, value_of_normal_int_stat);
+        ASSERT_OK(out.writew<u16>(0x30, 0x0002)) << "clear the interrupt";
+
+        ASSERT_OK(out.readw(0x32, value_of_error_int_stat))
+            << "error interrupt has been triggered additionally";
+        EXPECT_EQ(0x0000, value_of_error_int_stat);
+
+        mem.read(range(0xff8, 0xfff), &mem0, SBI_NONE);
+        mem.read(range(0x1100, 0x1107), &mem1, SBI_NONE);
+        EXPECT_EQ(mem0, 0x0807060504030201) << "check block before boundary";
+        EXPECT_EQ(mem1, 0x100f0e0d0c0b0a09) << "check block after resume";
     }
 };
 
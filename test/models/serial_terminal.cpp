@@ -0,0 +1,107 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class mock_backend : public serial::backend
+{
+public:
+    queue<u8> rx;
+    vector<vector<u8>> tx;
+
+    mock_backend(serial::terminal* term):
+        serial::backend(term, "mock"), rx(), tx() {}
+    virtual ~mock_backend() = default;
+
+    virtual bool read(u8& val) override { return read(&val, 1) > 0; }
+    virtual void write(u8 val) override { write(&val, 1); }
+
+    virtual size_t read(u8* buf, size_t len) override {
+        size_t n = 0;
+        for (; n < len && !rx.empty(); n++) {
+            buf[n] = rx.front();
+            rx.pop();
+        }
+
+        return n;
+    }
+
+    virtual void write(const u8* buf, size_t len) override {
+        tx.emplace_back(buf, buf + len);
+    }
+};
+
+class terminal_test : public test_base, public serial_host
+{
+public:
+    vector<u8> rxdata;
+
+    serial_initiator_socket serial_tx;
+    serial_target_socket serial_rx;
+
+    serial::terminal term;
+    mock_backend mock;
+
+    virtual void serial_receive(u8 data) override { rxdata.push_back(data); }
+
+    terminal_test(const sc_module_name& nm):
+        test_base(nm),
+        serial_host(),
+        rxdata(),
+        serial_tx("serial_tx"),
+        serial_rx("serial_rx"),
+        term("term"),
+        mock(&term) {
+        term.connect(*this);
+        term.burst = 4;
+        term.flush_size = 4;
+        term.flush_interval = sc_time(10.0, SC_US);
+
+        for (u8 c : { 'a', 'b', 'c', 'd' })
+            mock.rx.push(c);
+
+        EXPECT_STREQ(term.kind(), "vcml::serial::terminal");
+
+        add_test("test_burst", &terminal_test::test_burst);
+        add_test("test_flush", &terminal_test::test_flush);
+    }
+
+    void test_burst() {
+        // all four characters must go out in a single burst
+        wait(term.serial_tx.cycle());
+        EXPECT_TRUE(mock.rx.empty());
+        EXPECT_EQ(rxdata, vector<u8>({ 'a', 'b', 'c', 'd' }));
+    }
+
+    void test_flush() {
+        // less than flush_size characters are held back until flush_interval
+        for (u8 c : { 'x', 'y', 'z' })
+            serial_tx.send(c);
+        EXPECT_TRUE(mock.tx.empty());
+        wait(2 * term.flush_interval.get());
+        ASSERT_EQ(mock.tx.size(), 1);
+        EXPECT_EQ(mock.tx[0], vector<u8>({ 'x', 'y', 'z' }));
+
+        // reaching flush_size writes out immediately as one span
+        for (u8 c : { '1', '2', '3', '4' })
+            serial_tx.send(c);
+        ASSERT_EQ(mock.tx.size(), 2);
+        EXPECT_EQ(mock.tx[1], vector<u8>({ '1', '2', '3', '4' }));
+
+        vector<u8> hist;
+        term.fetch_history(hist);
+        EXPECT_EQ(hist.size(), 7);
+    }
+};
+
+TEST(serial, terminal) {
+    terminal_test testbench("test");
+    sc_core::sc_start();
+}
@@ -56,6 +56,25 @@ public:
         spi_send(0x05); // READ_STATUS
         status = spi_recv();
         EXPECT_EQ(status, 0);
+
+        u32 wdata[16], rdata[16] = {};
+        for (u32 i = 0; i < 16; i++)
+            wdata[i] = 0xa0 + i;
+
+        spi_send(0x02); // PAGE_PROGRAM
+        spi_send(0x00);
+        spi_send(0x10);
+        spi_send(0x00);
+        spi_out.transport(wdata, nullptr, 16);
+
+        flash.reset();
+        spi_send(0x03); // READ_DATA
+        spi_send(0x00);
+        spi_send(0x10);
+        spi_send(0x00);
+        spi_out.transport(wdata, rdata, 16);
+        for (u32 i = 0; i < 16; i++)
+            EXPECT_EQ(rdata[i], wdata[i]) << "burst read word " << i;
     }
 };
 
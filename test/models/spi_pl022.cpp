@@ -69,6 +69,7 @@ public:
 
         add_test("strings", &pl022test::test_strings);
         add_test("txrx", &pl022test::test_txrx);
+        add_test("burst", &pl022test::test_burst);
     }
 
     void test_strings() {
@@ -116,6 +117,33 @@ public:
         EXPECT_EQ(data, rxdata);
         EXPECT_TRUE(miso.empty());
     }
+
+    void test_burst() {
+        mosi.reset();
+        miso.reset();
+
+        // fill the fifo while disabled, so that it gets sent in one go
+        ASSERT_OK(out.writew<u16>(ADDR_CR1, 0u)); // disable SPI
+        for (u16 i = 0; i < 4; i++) {
+            miso.push(0x100 + i);
+            ASSERT_OK(out.writew<u16>(ADDR_DR, 0x200 + i));
+        }
+
+        ASSERT_OK(out.writew<u16>(ADDR_CR1, 2u)); // enable SPI
+        ASSERT_OK(out.writew<u16>(ADDR_DR, 0x204));
+        wait(1, SC_MS);
+
+        for (u16 i = 0; i < 5; i++) {
+            ASSERT_FALSE(mosi.empty());
+            EXPECT_EQ(mosi.pop(), 0x200 + i);
+        }
+
+        for (u16 i = 0; i < 4; i++) {
+            u16 data = 0;
+            ASSERT_OK(out.readw<u16>(ADDR_DR, data));
+            EXPECT_EQ(data, 0x100 + i);
+        }
+    }
 };
 
 TEST(spi, pl022) {
@@ -10,11 +10,50 @@
 
 #include "testing.h"
 
+enum xhci_test_addrs : u64 {
+    RAM_BASE = 0x10000,
+    DCBAA = RAM_BASE + 0x0000,
+    ERST = RAM_BASE + 0x0400,
+    EVRING = RAM_BASE + 0x0800,
+    CMDRING = RAM_BASE + 0x0c00,
+    INCTX = RAM_BASE + 0x1000,
+    OUTCTX = RAM_BASE + 0x1400,
+    TRRING = RAM_BASE + 0x2000,
+    TRRING2 = RAM_BASE + 0x2800,
+    BUFFER = RAM_BASE + 0x3000,
+};
+
+enum xhci_test_trbs : u32 {
+    TRB_C = bit(0),
+    TRB_CH = bit(4),
+    TRB_IOC = bit(5),
+    TRB_IDT = bit(6),
+    TRB_DIR = bit(16),
+
+    TRB_NORMAL = 1 << 10,
+    TRB_SETUP = 2 << 10,
+    TRB_DATA = 3 << 10,
+    TRB_STATUS = 4 << 10,
+    TRB_LINK = 6 << 10,
+    TRB_ENABLE_SLOT = 9 << 10,
+    TRB_ADDRESS_DEVICE = 11 << 10,
+    TRB_STOP_ENDPOINT = 15 << 10,
+    TRB_TRANSFER_EVENT = 32,
+    TRB_COMMAND_COMPLETE = 33,
+
+    CC_SUCCESS = 1,
+    CC_TRB_ERROR = 5,
+};
+
+// GET_DESCRIPTOR(DEVICE), 18 bytes
+constexpr u64 SETUP_GET_DEVICE_DESC = 0x0012000001000680ull;
+
 class xhci_test : public test_base
 {
 public:
     generic::bus bus;
     generic::memory mem;
+    generic::memory ram;
 
     usb::xhci xhci;
     usb::keyboard keyboard2;
@@ -30,6 +69,7 @@ public:
         test_base(nm),
         bus("bus"),
         mem("mem", 0x1000),
+        ram("ram", 0x10000),
         xhci("xhci"),
         keyboard2("keyboard2"),
         keyboard3("keyboard3"),
@@ -46,6 +86,7 @@ public:
 
         bus.bind(mem.in, 0, 0xfff);
         bus.bind(xhci.in, 0x1000, 0x1fff);
+        bus.bind(ram.in, RAM_BASE, RAM_BASE + 0xffff);
 
         bus.bind(out);
         bus.bind(xhci.dma);
@@ -54,10 +95,12 @@ public:
 
         clk.bind(bus.clk);
         clk.bind(mem.clk);
+        clk.bind(ram.clk);
         clk.bind(xhci.clk);
 
         rst.bind(bus.rst);
         rst.bind(mem.rst);
+        rst.bind(ram.rst);
         rst.bind(xhci.rst);
 
         EXPECT_STREQ(xhci.kind(), "vcml::usb::xhci");
@@ -114,6 +157,150 @@ public:
         EXPECT_EQ(end - start, 1);
     }
 
+    size_t evidx = 0;
+    bool evccs = true;
+    size_t cmdidx = 0;
+
+    void write_trb(u64 addr, u64 param, u32 status, u32 control) {
+        usb::xhci::trb trb{ param, status, control };
+        ASSERT_OK(out.writew(addr, trb));
+    }
+
+    bool next_event(usb::xhci::trb& ev) {
+        for (int i = 0; i < 100; i++) {
+            EXPECT_OK(out.readw(EVRING + evidx * 16, ev));
+            if (((ev.control & TRB_C) != 0) == evccs) {
+                if (++evidx == 16) {
+                    evidx = 0;
+                    evccs = !evccs;
+                }
+
+                EXPECT_OK(out.writew<u64>(0x1638, EVRING + evidx * 16));
+                return true;
+            }
+
+            wait(100, SC_US);
+        }
+
+        return false;
+    }
+
+    u32 command(u64 param, u32 control, u32* slot = nullptr) {
+        u64 addr = CMDRING + cmdidx++ * 16;
+        write_trb(addr, param, 0, control | TRB_C);
+        EXPECT_OK(out.writew<u32>(0x1800, 0)); // command doorbell
+
+        usb::xhci::trb ev;
+        EXPECT_TRUE(next_event(ev));
+        EXPECT_EQ((ev.control >> 10) & 0x3f, TRB_COMMAND_COMPLETE);
+        EXPECT_EQ(ev.parameter, addr);
+        if (slot)
+            *slot = ev.control >> 24;
+        return ev.status >> 24;
+    }
+
+    u64 stopped_dequeue() {
+        u64 dequeue = 0;
+        u32 ccode = command(0, TRB_STOP_ENDPOINT | 1 << 16 | 1 << 24);
+        EXPECT_EQ(ccode, CC_SUCCESS);
+        EXPECT_OK(out.readw(OUTCTX + 32 + 8, dequeue));
+        return dequeue;
+    }
+
+    void ring_ep0() {
+        ASSERT_OK(out.writew<u32>(0x1804, 1));
+        wait(1, SC_MS);
+    }
+
+    void expect_transfer(u32 ccode, u64 addr) {
+        usb::xhci::trb ev;
+        ASSERT_TRUE(next_event(ev));
+        EXPECT_EQ((ev.control >> 10) & 0x3f, TRB_TRANSFER_EVENT);
+        EXPECT_EQ(ev.status >> 24, ccode);
+        EXPECT_EQ(ev.parameter, addr);
+    }
+
+    void test_setup_slot() {
+        // event ring with 16 entries, command ring, device context array
+        write_trb(ERST, EVRING, 16, 0);
+        ASSERT_OK(out.writew<u64>(0x1080 + 0x30, DCBAA));
+        ASSERT_OK(out.writew<u32>(0x1628, 1));
+        ASSERT_OK(out.writew<u64>(0x1638, EVRING));
+        ASSERT_OK(out.writew<u64>(0x1630, ERST));
+        ASSERT_OK(out.writew<u32>(0x1098, CMDRING | 1));
+        ASSERT_OK(out.writew<u32>(0x109c, 0));
+        ASSERT_OK(out.writew<u32>(0x1080, 1)); // run
+
+        u32 slot = 0;
+        ASSERT_EQ(command(0, TRB_ENABLE_SLOT, &slot), CC_SUCCESS);
+        ASSERT_EQ(slot, 1);
+
+        // input context: add slot and ep0, keyboard2 sits on port 1, ep0
+        // is a control endpoint with 64 byte packets, dequeue at TRRING
+        ASSERT_OK(out.writew<u64>(DCBAA + 8, OUTCTX));
+        ASSERT_OK(out.writew<u32>(INCTX + 0, 0));
+        ASSERT_OK(out.writew<u32>(INCTX + 4, 3));
+        ASSERT_OK(out.writew<u32>(INCTX + 32, 1 << 27));
+        ASSERT_OK(out.writew<u32>(INCTX + 36, 1 << 16));
+        ASSERT_OK(out.writew<u32>(INCTX + 64 + 4, 4 << 3 | 64 << 16));
+        ASSERT_OK(out.writew<u64>(INCTX + 64 + 8, TRRING | 1));
+
+        ASSERT_EQ(command(INCTX, TRB_ADDRESS_DEVICE | 1 << 24), CC_SUCCESS);
+    }
+
+    void test_transfer_chained() {
+        // data stage is split across two buffers, and the chain continues
+        // behind a link TRB; the last part of the TD is not yet enqueued
+        write_trb(TRRING + 0x00, SETUP_GET_DEVICE_DESC, 8,
+                  TRB_SETUP | TRB_IDT | TRB_C);
+        write_trb(TRRING + 0x10, BUFFER, 8,
+                  TRB_DATA | TRB_DIR | TRB_CH | TRB_C);
+        write_trb(TRRING + 0x20, TRRING2, 0, TRB_LINK | TRB_C);
+        write_trb(TRRING2 + 0x00, BUFFER + 0x100, 10, TRB_NORMAL);
+        write_trb(TRRING2 + 0x10, 0, 0, TRB_STATUS | TRB_IOC);
+
+        // the incomplete TD must be rolled back to its first TRB
+        ring_ep0();
+        EXPECT_EQ(stopped_dequeue(), (TRRING + 0x10) | 1);
+
+        write_trb(TRRING2 + 0x00, BUFFER + 0x100, 10, TRB_NORMAL | TRB_C);
+        write_trb(TRRING2 + 0x10, 0, 0, TRB_STATUS | TRB_IOC | TRB_C);
+        ring_ep0();
+        expect_transfer(CC_SUCCESS, TRRING2 + 0x10);
+
+        u8 desc[2];
+        ASSERT_OK(out.read(BUFFER, desc, sizeof(desc)));
+        EXPECT_EQ(desc[0], 18); // bLength
+        EXPECT_EQ(desc[1], 1);  // bDescriptorType
+    }
+
+    void test_transfer_direct() {
+        // single buffer data stage, handed to the device via DMI
+        write_trb(TRRING2 + 0x20, SETUP_GET_DEVICE_DESC, 8,
+                  TRB_SETUP | TRB_IDT | TRB_C);
+        write_trb(TRRING2 + 0x30, BUFFER + 0x200, 18,
+                  TRB_DATA | TRB_DIR | TRB_C);
+        write_trb(TRRING2 + 0x40, 0, 0, TRB_STATUS | TRB_IOC | TRB_C);
+        ring_ep0();
+        expect_transfer(CC_SUCCESS, TRRING2 + 0x40);
+
+        u8 gathered[18], direct[18];
+        ASSERT_OK(out.read(BUFFER, gathered, 8));
+        ASSERT_OK(out.read(BUFFER + 0x100, gathered + 8, 10));
+        ASSERT_OK(out.read(BUFFER + 0x200, direct, 18));
+        EXPECT_EQ(memcmp(gathered, direct, sizeof(direct)), 0);
+    }
+
+    void test_transfer_immediate_in() {
+        // immediate data cannot be received, so the TD must be rejected
+        // before anything is sent to the device
+        write_trb(TRRING2 + 0x50, 0, 8,
+                  TRB_DATA | TRB_DIR | TRB_IDT | TRB_IOC | TRB_C);
+        ring_ep0();
+        expect_transfer(CC_TRB_ERROR, TRRING2 + 0x50);
+        EXPECT_EQ(stopped_dequeue(), (TRRING2 + 0x60) | 1);
+    }
+
     virtual void run_test() override {
         wait(SC_ZERO_TIME);
         test_capabilities();
@@ -121,6 +308,11 @@ public:
         test_ports();
         wait(SC_ZERO_TIME);
         test_microframes();
+        wait(SC_ZERO_TIME);
+        test_setup_slot();
+        test_transfer_chained();
+        test_transfer_direct();
+        test_transfer_immediate_in();
     }
 };
 
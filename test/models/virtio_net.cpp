@@ -30,7 +30,9 @@ public:
                             virtio::net::VIRTIO_NET_F_CTRL_RX |
                             virtio::net::VIRTIO_NET_F_CTRL_RX_EXTRA |
                             virtio::net::VIRTIO_NET_F_CTRL_ANNOUNCE |
-                            virtio::net::VIRTIO_NET_F_CTRL_MAC_ADDR;
+                            virtio::net::VIRTIO_NET_F_CTRL_MAC_ADDR |
+                            virtio::net::VIRTIO_NET_F_MRG_RXBUF |
+                            virtio::net::VIRTIO_NET_F_OFFLOADS;
 
     virtio_net_stim(const sc_module_name& nm = sc_gen_unique_name("stim")):
         test_base(nm),
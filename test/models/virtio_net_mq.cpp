@@ -0,0 +1,302 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2022 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+
+class virtio_net_driver : public test_base,
+                          public virtio_controller,
+                          public eth_host
+{
+public:
+    enum : u32 {
+        HEADER_SIZE = 12,
+        MEM_SIZE = 64 * KiB,
+    };
+
+    enum : u8 {
+        CTRL_RX = 0,
+        CTRL_RX_PROMISC = 0,
+        CTRL_MQ = 4,
+        CTRL_MQ_VQ_PAIRS_SET = 0,
+        CTRL_OK = 0,
+        CTRL_ERR = 1,
+    };
+
+    vector<u8> mem;
+    u64 next;
+
+    std::map<u32, std::deque<vq_message>> avail;
+    std::map<u32, vector<vq_message>> used;
+
+    virtio::net net;
+    virtio_initiator_socket virtio_out;
+    eth_initiator_socket eth_tx;
+
+    virtio_net_driver(const sc_module_name& nm):
+        test_base(nm),
+        virtio_controller(),
+        eth_host(),
+        mem(MEM_SIZE),
+        next(0),
+        avail(),
+        used(),
+        net("net"),
+        virtio_out("virtio_out"),
+        eth_tx("eth_tx") {
+        virtio_out.bind(net.virtio_in);
+        eth_tx.bind(net.eth_rx);
+        net.eth_tx.stub();
+
+        add_test("ctrl", &virtio_net_driver::test_ctrl);
+        add_test("mrg_rxbuf", &virtio_net_driver::test_mrg_rxbuf);
+        add_test("steering", &virtio_net_driver::test_steering);
+        add_test("disable_pairs", &virtio_net_driver::test_disable_pairs);
+    }
+
+    virtual bool put(u32 vqid, vq_message& msg) override {
+        used[vqid].push_back(msg);
+        return true;
+    }
+
+    virtual bool get(u32 vqid, vq_message& msg) override {
+        auto& queue = avail[vqid];
+        if (queue.empty())
+            return false;
+
+        msg = queue.front();
+        queue.pop_front();
+        return true;
+    }
+
+    virtual bool notify() override { return true; }
+
+    virtual bool shm_map(u32 shmid, u64 id, u64 offset, void* ptr,
+                         u64 len) override {
+        return false;
+    }
+
+    virtual bool shm_unmap(u32 shmid, u64 id) override { return false; }
+
+    u64 alloc(u64 size) {
+        VCML_ERROR_ON(next + size > mem.size(), "out of driver memory");
+        u64 addr = next;
+        next += size;
+        return addr;
+    }
+
+    vq_message message() {
+        vq_message msg;
+        msg.dmi = [this](u64 addr, u64 size, vcml_access acs) -> u8* {
+            return addr + size <= mem.size() ? mem.data() + addr : nullptr;
+        };
+        return msg;
+    }
+
+    void setup(u64 features) {
+        avail.clear();
+        used.clear();
+        next = 0;
+
+        virtio_device_desc desc;
+        desc.reset();
+        virtio_out->identify(desc);
+        EXPECT_EQ(desc.virtqueues.size(), 5);
+
+        u64 offered = 0;
+        virtio_out->read_features(offered);
+        ASSERT_EQ(offered & features, features);
+        ASSERT_TRUE(virtio_out->write_features(features));
+    }
+
+    u64 post_rx(u32 vqid, u32 size) {
+        vq_message msg = message();
+        u64 addr = alloc(size);
+        msg.append(addr, size, true);
+        avail[vqid].push_back(msg);
+        return addr;
+    }
+
+    u8 command(u32 vqid, const vector<u8>& cmd) {
+        vq_message msg = message();
+        u64 addr = alloc(cmd.size() + 1);
+        memcpy(mem.data() + addr, cmd.data(), cmd.size());
+        mem[addr + cmd.size()] = 0xff;
+        msg.append(addr, cmd.size(), false);
+        msg.append(addr + cmd.size(), 1, true);
+        avail[vqid].push_back(msg);
+
+        size_t n = used[vqid].size();
+        EXPECT_TRUE(virtio_out->notify(vqid));
+        EXPECT_EQ(used[vqid].size(), n + 1) << "command not completed";
+        return mem[addr + cmd.size()];
+    }
+
+    u8 set_pairs(u32 ctrlq, u16 pairs) {
+        return command(ctrlq, { CTRL_MQ, CTRL_MQ_VQ_PAIRS_SET, (u8)pairs,
+                                (u8)(pairs >> 8) });
+    }
+
+    eth_frame udp_frame(u16 port, size_t payload) {
+        vector<u8> ip(20 + 8 + payload);
+        ip[0] = 0x45;
+        ip[2] = ip.size() >> 8;
+        ip[3] = ip.size() & 0xff;
+        ip[8] = 64;
+        ip[9] = eth_frame::IP_UDP;
+        ip[12] = ip[16] = 10;
+        ip[15] = 1;
+        ip[19] = 2;
+        ip[20] = port >> 8;
+        ip[21] = port & 0xff;
+        ip[22] = 0x12;
+        ip[23] = 0x34;
+        for (size_t i = 28; i < ip.size(); i++)
+            ip[i] = i & 0xff;
+
+        mac_addr bcast(0xff, 0xff, 0xff, 0xff, 0xff, 0xff);
+        mac_addr src(0x02, 0x00, 0x00, 0x00, 0x00, 0x01);
+        return eth_frame(bcast, src, eth_frame::ETHER_TYPE_IPV4, ip);
+    }
+
+    // finds a source port whose flow gets steered onto the given pair
+    u16 port_for_pair(size_t pair, size_t npairs) {
+        for (u16 port = 1000; port < 2000; port++) {
+            if (udp_frame(port, 0).flow_hash() % npairs == pair)
+                return port;
+        }
+
+        ADD_FAILURE() << "no port found for pair " << pair;
+        return 0;
+    }
+
+    void receive(const eth_frame& frame) {
+        eth_tx.send(frame);
+        wait(1, SC_US);
+    }
+
+    void test_ctrl() {
+        // without multiqueue the control queue directly follows pair 0
+        setup(virtio::net::VIRTIO_NET_F_CTRL_VQ |
+              virtio::net::VIRTIO_NET_F_CTRL_RX);
+        EXPECT_EQ(command(2, { CTRL_RX, CTRL_RX_PROMISC, 1 }), CTRL_OK);
+        EXPECT_TRUE(used[0].empty());
+        EXPECT_FALSE(virtio_out->notify(4));
+
+        // with multiqueue it moves behind the last pair
+        setup(virtio::net::VIRTIO_NET_F_CTRL_VQ |
+              virtio::net::VIRTIO_NET_F_CTRL_RX | virtio::net::VIRTIO_NET_F_MQ);
+        EXPECT_EQ(command(4, { CTRL_RX, CTRL_RX_PROMISC, 1 }), CTRL_OK);
+        EXPECT_EQ(set_pairs(4, 3), CTRL_ERR);
+        EXPECT_EQ(set_pairs(4, 0), CTRL_ERR);
+        EXPECT_EQ(set_pairs(4, 2), CTRL_OK);
+        EXPECT_EQ(net.active_queue_pairs(), 2);
+        EXPECT_TRUE(used[2].empty());
+    }
+
+    void test_mrg_rxbuf() {
+        setup(virtio::net::VIRTIO_NET_F_CTRL_VQ |
+              virtio::net::VIRTIO_NET_F_MRG_RXBUF);
+
+        u64 bufs[3];
+        for (u64& buf : bufs)
+            buf = post_rx(0, 512);
+
+        eth_frame frame = udp_frame(1000, 900);
+        ASSERT_GT(frame.size() + HEADER_SIZE, 512);
+        ASSERT_LE(frame.size() + HEADER_SIZE, 1024);
+        receive(frame);
+
+        // the frame spans two buffers, the third one stays available
+        ASSERT_EQ(used[0].size(), 2);
+        EXPECT_EQ(avail[0].size(), 1);
+        EXPECT_EQ(used[0][0].length_out(), 512);
+        EXPECT_EQ(used[0][1].length_out(), frame.size() + HEADER_SIZE - 512);
+
+        u16 num_buffers;
+        memcpy(&num_buffers, mem.data() + bufs[0] + 10, sizeof(num_buffers));
+        EXPECT_EQ(num_buffers, 2);
+
+        vector<u8> data(mem.data() + bufs[0] + HEADER_SIZE,
+                        mem.data() + bufs[0] + 512);
+        data.insert(data.end(), mem.data() + bufs[1],
+                    mem.data() + bufs[1] + used[0][1].length_out());
+        EXPECT_EQ(eth_frame(data), frame);
+    }
+
+    void test_steering() {
+        setup(virtio::net::VIRTIO_NET_F_CTRL_VQ | virtio::net::VIRTIO_NET_F_MQ |
+              virtio::net::VIRTIO_NET_F_MRG_RXBUF);
+
+        // a single pair stays active until the driver enables more
+        for (u32 i = 0; i < 8; i++) {
+            post_rx(0, 2048);
+            post_rx(2, 2048);
+        }
+
+        receive(udp_frame(port_for_pair(1, 2), 64));
+        EXPECT_EQ(used[0].size(), 1);
+        EXPECT_TRUE(used[2].empty());
+
+        ASSERT_EQ(set_pairs(4, 2), CTRL_OK);
+        used.clear();
+
+        for (u16 port = 1000; port < 1008; port++) {
+            eth_frame frame = udp_frame(port, 64);
+            u32 rxq = 2 * (frame.flow_hash() % 2);
+            size_t n = used[rxq].size();
+            receive(frame);
+            EXPECT_EQ(used[rxq].size(), n + 1) << "port " << port;
+        }
+
+        EXPECT_EQ(used[0].size() + used[2].size(), 8);
+
+        // frames without flow information always go to the first pair
+        mac_addr bcast(0xff, 0xff, 0xff, 0xff, 0xff, 0xff);
+        mac_addr src(0x02, 0x00, 0x00, 0x00, 0x00, 0x01);
+        size_t n = used[0].size();
+        receive(eth_frame(bcast, src, 0x88b5, vector<u8>(64)));
+        EXPECT_EQ(used[0].size(), n + 1);
+    }
+
+    void test_disable_pairs() {
+        setup(virtio::net::VIRTIO_NET_F_CTRL_VQ | virtio::net::VIRTIO_NET_F_MQ |
+              virtio::net::VIRTIO_NET_F_MRG_RXBUF);
+        ASSERT_EQ(set_pairs(4, 2), CTRL_OK);
+
+        // pair 1 takes the only buffer it has, but the frame does not fit
+        // into it, so the device holds on to it waiting for more
+        post_rx(2, 128);
+        eth_frame frame = udp_frame(port_for_pair(1, 2), 500);
+        receive(frame);
+        EXPECT_TRUE(avail[2].empty());
+        EXPECT_TRUE(used[2].empty());
+
+        // disabling pair 1 returns the buffer unused and moves the frame
+        u64 buf = post_rx(0, 2048);
+        ASSERT_EQ(set_pairs(4, 1), CTRL_OK);
+        EXPECT_EQ(net.active_queue_pairs(), 1);
+        ASSERT_EQ(used[2].size(), 1);
+        EXPECT_EQ(used[2][0].length_out(), 0);
+
+        wait(1, SC_US);
+        ASSERT_EQ(used[0].size(), 1);
+        EXPECT_EQ(used[0][0].length_out(), frame.size() + HEADER_SIZE);
+        vector<u8> data(mem.data() + buf + HEADER_SIZE,
+                        mem.data() + buf + HEADER_SIZE + frame.size());
+        EXPECT_EQ(eth_frame(data), frame);
+    }
+};
+
+TEST(virtio, net_mq) {
+    vcml::broker broker("test");
+    broker.define("driver.net.queues", 2);
+    virtio_net_driver driver("driver");
+    sc_core::sc_start();
+}
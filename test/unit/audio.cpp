@@ -86,3 +86,142 @@ TEST(audio, fill_silence) {
     fill_silence(&buf, sizeof(buf), FORMAT_S32BE);
     EXPECT_EQ(buf, 0x00000000);
 }
+
+TEST(audio, convert_identity) {
+    converter conv;
+    ASSERT_TRUE(conv.configure(FORMAT_S16LE, 2, 48000, FORMAT_S16LE, 2, 48000));
+    EXPECT_TRUE(conv.is_identity());
+
+    const u8 data[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    vector<u8> out;
+    EXPECT_EQ(conv.convert(data, sizeof(data), out), sizeof(data));
+    EXPECT_EQ(out, vector<u8>(data, data + sizeof(data)));
+}
+
+TEST(audio, convert_endian) {
+    converter conv;
+    ASSERT_TRUE(conv.configure(FORMAT_S16LE, 1, 8000, FORMAT_S16BE, 1, 8000));
+    EXPECT_FALSE(conv.is_identity());
+
+    const u8 data[] = { 0x34, 0x12, 0xcd, 0xab };
+    vector<u8> out;
+    EXPECT_EQ(conv.convert(data, sizeof(data), out), sizeof(data));
+    EXPECT_EQ(out, vector<u8>({ 0x12, 0x34, 0xab, 0xcd }));
+}
+
+TEST(audio, convert_width) {
+    converter conv;
+    ASSERT_TRUE(conv.configure(FORMAT_U8, 1, 8000, FORMAT_S16LE, 1, 8000));
+
+    const u8 data[] = { 0x00, 0x80, 0xff };
+    vector<u8> out;
+    EXPECT_EQ(conv.convert(data, sizeof(data), out), 6u);
+    EXPECT_EQ(out, vector<u8>({ 0x00, 0x80, 0x00, 0x00, 0x00, 0x7f }));
+}
+
+TEST(audio, convert_partial) {
+    converter conv;
+    ASSERT_TRUE(conv.configure(FORMAT_S32LE, 1, 8000, FORMAT_S16LE, 1, 8000));
+
+    const u8 data[] = { 0x00, 0x00, 0x34, 0x12, 0x00, 0x00, 0xcd, 0xab };
+    vector<u8> out;
+    EXPECT_EQ(conv.convert(data, 3, out), 0u);
+    EXPECT_EQ(conv.convert(data + 3, 3, out), 2u);
+    EXPECT_EQ(conv.convert(data + 6, 2, out), 2u);
+    EXPECT_EQ(out, vector<u8>({ 0x34, 0x12, 0xcd, 0xab }));
+}
+
+TEST(audio, convert_float) {
+    converter to_float, to_int;
+    ASSERT_TRUE(to_float.configure(FORMAT_S16LE, 1, 8000, FORMAT_F32LE, 1,
+                                   8000));
+    ASSERT_TRUE(to_int.configure(FORMAT_F32LE, 1, 8000, FORMAT_S16LE, 1,
+                                 8000));
+
+    const i16 data[] = { 0, 1, -1, 16384, -16384, 32767, -32768 };
+    vector<u8> flt, out;
+    to_float.convert(data, sizeof(data), flt);
+    ASSERT_EQ(flt.size(), 7 * sizeof(float));
+
+    float f;
+    memcpy(&f, flt.data() + 3 * sizeof(float), sizeof(f));
+    EXPECT_FLOAT_EQ(f, 0.5f);
+    memcpy(&f, flt.data() + 6 * sizeof(float), sizeof(f));
+    EXPECT_FLOAT_EQ(f, -1.0f);
+
+    to_int.convert(flt.data(), flt.size(), out);
+    ASSERT_EQ(out.size(), sizeof(data));
+    EXPECT_EQ(memcmp(out.data(), data, sizeof(data)), 0);
+
+    const float clip[] = { 2.0f, -2.0f };
+    out.clear();
+    to_int.convert(clip, sizeof(clip), out);
+    const i16* samples = (const i16*)out.data();
+    EXPECT_EQ(samples[0], 32767);
+    EXPECT_EQ(samples[1], -32768);
+}
+
+TEST(audio, convert_channels) {
+    converter up, down;
+    ASSERT_TRUE(up.configure(FORMAT_S16LE, 1, 8000, FORMAT_S16LE, 2, 8000));
+    ASSERT_TRUE(down.configure(FORMAT_S16LE, 2, 8000, FORMAT_S16LE, 1, 8000));
+    EXPECT_TRUE(up.needs_mixing());
+    EXPECT_TRUE(down.needs_mixing());
+
+    const i16 mono[] = { 1000, -2000 };
+    vector<u8> out;
+    up.convert(mono, sizeof(mono), out);
+    ASSERT_EQ(out.size(), 4 * sizeof(i16));
+    const i16* stereo = (const i16*)out.data();
+    EXPECT_EQ(stereo[0], 1000);
+    EXPECT_EQ(stereo[1], 1000);
+    EXPECT_EQ(stereo[2], -2000);
+    EXPECT_EQ(stereo[3], -2000);
+
+    const i16 lr[] = { 1000, 3000, -4000, 0 };
+    out.clear();
+    down.convert(lr, sizeof(lr), out);
+    ASSERT_EQ(out.size(), 2 * sizeof(i16));
+    const i16* mixed = (const i16*)out.data();
+    EXPECT_EQ(mixed[0], 2000);
+    EXPECT_EQ(mixed[1], -2000);
+}
+
+TEST(audio, convert_rate) {
+    converter conv;
+    ASSERT_TRUE(conv.configure(FORMAT_F32LE, 1, 48000, FORMAT_F32LE, 1,
+                               24000));
+    EXPECT_TRUE(conv.needs_resampling());
+    EXPECT_EQ(conv.input_size(100 * sizeof(float)), 200 * sizeof(float));
+
+    // a low frequency tone must pass, a tone above the new nyquist
+    // frequency must be filtered out
+    const size_t n = 4800;
+    vector<float> low(n), high(n);
+    for (size_t i = 0; i < n; i++) {
+        low[i] = std::sin(2.0 * 3.14159265358979 * 1000.0 * i / 48000.0);
+        high[i] = std::sin(2.0 * 3.14159265358979 * 18000.0 * i / 48000.0);
+    }
+
+    vector<u8> out;
+    conv.convert(low.data(), n * sizeof(float), out);
+    size_t frames = out.size() / sizeof(float);
+    EXPECT_GE(frames, n / 2 - converter::RESAMPLER_TAPS);
+    EXPECT_LE(frames, n / 2);
+
+    const float* res = (const float*)out.data();
+    float peak = 0.0f;
+    for (size_t i = 100; i < frames; i++)
+        peak = max(peak, std::fabs(res[i]));
+    EXPECT_NEAR(peak, 1.0f, 0.05f);
+
+    conv.reset();
+    out.clear();
+    conv.convert(high.data(), n * sizeof(float), out);
+    frames = out.size() / sizeof(float);
+    res = (const float*)out.data();
+    peak = 0.0f;
+    for (size_t i = 100; i < frames; i++)
+        peak = max(peak, std::fabs(res[i]));
+    EXPECT_LT(peak, 0.05f);
+}
@@ -39,3 +39,101 @@ TEST(broker, file) {
     EXPECT_DEF(broker, "loop.iter2", "2");
     EXPECT_UDF(broker, "loop.iter3");
 }
+
+TEST(broker, precedence) {
+    string s;
+    broker low("low");
+    low.define("prec.a", 1);
+    low.define("prec.b", 2);
+
+    EXPECT_EQ(broker::init("prec.a", s), &low);
+    EXPECT_EQ(s, "1");
+
+    {
+        broker high("high", true);
+        high.define("prec.a", 3);
+        EXPECT_EQ(broker::init("prec.a", s), &high);
+        EXPECT_EQ(s, "3");
+
+        high.undefine("prec.a");
+        EXPECT_EQ(broker::init("prec.a", s), &low);
+        EXPECT_EQ(s, "1");
+
+        high.define("prec.a", 4);
+        EXPECT_EQ(broker::init("prec.a", s), &high);
+    }
+
+    EXPECT_EQ(broker::init("prec.a", s), &low);
+    EXPECT_EQ(s, "1");
+    EXPECT_EQ(broker::init("prec.c", s), nullptr);
+
+    auto unused = broker::collect_unused();
+    ASSERT_EQ(unused.size(), 1);
+    EXPECT_EQ(unused[0].first, "prec.b");
+    EXPECT_EQ(unused[0].second, &low);
+
+    low.undefine("prec.b");
+    EXPECT_TRUE(broker::collect_unused().empty());
+}
+
+TEST(broker, cache) {
+    string s;
+    mwr::publishers::terminal logger;
+
+    {
+        std::ofstream src("cache.src");
+        src << "source" << std::endl;
+    }
+
+    vector<broker_cache::source> sources = {
+        { "cache.src", broker_cache::mtime("cache.src") },
+    };
+
+    vector<pair<string, string>> values = {
+        { "cache.a", "1" },
+        { "cache.b", "hello world" },
+        { "cache.c", "" },
+    };
+
+    broker_cache::write("cache.bin", 42, sources, values);
+    EXPECT_TRUE(broker_cache::is_cache("cache.bin"));
+    EXPECT_FALSE(broker_cache::is_cache("cache.src"));
+
+    vector<pair<string, string>> read;
+    auto collect = [&](const string& key, const string& val) -> void {
+        read.emplace_back(key, val);
+    };
+
+    EXPECT_TRUE(broker_cache::read("cache.bin", 42, collect));
+    EXPECT_EQ(read, values);
+
+    read.clear();
+    EXPECT_FALSE(broker_cache::read("cache.bin", 43, collect));
+    EXPECT_TRUE(read.empty());
+
+    {
+        broker_cache cache("cache.bin");
+        EXPECT_DEF(cache, "cache.b", "hello world");
+        EXPECT_DEF(cache, "cache.c", "");
+        EXPECT_UDF(cache, "cache.d");
+
+        auto defined = broker::collect_defined();
+        EXPECT_TRUE(stl_contains(defined, values[0]));
+        EXPECT_TRUE(stl_contains(defined, values[1]));
+    }
+
+    {
+        // files loaded via -f are accepted regardless of their stamp
+        broker_cache::write("cache.bin", 7, sources, values);
+        broker_cache cache("cache.bin");
+        EXPECT_DEF(cache, "cache.a", "1");
+    }
+
+    sources[0].mtime++;
+    broker_cache::write("cache.bin", 42, sources, values);
+    EXPECT_FALSE(broker_cache::read("cache.bin", 42, collect));
+    EXPECT_TRUE(read.empty());
+
+    std::remove("cache.bin");
+    std::remove("cache.src");
+}
@@ -123,6 +123,63 @@ TEST(can, serialization_canxl) {
     EXPECT_EQ(frame, frame2);
 }
 
+static can_frame socketcan_roundtrip(const can_frame& frame) {
+    vector<u8> raw;
+    can::to_socketcan(frame, raw);
+
+    can_frame frame2{};
+    EXPECT_TRUE(can::from_socketcan(frame2, raw.data(), raw.size()));
+    return frame2;
+}
+
+TEST(can, socketcan) {
+    can_frame frame{};
+    frame.canid = 0x1234567;
+    frame.eff = true;
+    frame.data.assign({ 0x11, 0x22, 0x33 });
+    frame.dlc = len2dlc(frame.length());
+
+    vector<u8> raw;
+    can::to_socketcan(frame, raw);
+    ASSERT_EQ(raw.size(), 11);
+    EXPECT_EQ(raw[0], 0x81); // EFF flag, big endian identifier
+    EXPECT_EQ(raw[3], 0x67);
+    EXPECT_EQ(raw[4], 3);
+    EXPECT_EQ(raw[5], 0);
+    EXPECT_EQ(raw[8], 0x11);
+    EXPECT_EQ(socketcan_roundtrip(frame), frame);
+
+    frame.canid = 0x123;
+    frame.eff = false;
+    frame.fdf = true;
+    frame.brs = true;
+    frame.data.assign(20, 0xab);
+    frame.dlc = len2dlc(frame.length());
+    can::to_socketcan(frame, raw);
+    EXPECT_EQ(raw[4], 20);
+    EXPECT_EQ(raw[5], 0x05); // FDF | BRS
+    EXPECT_EQ(socketcan_roundtrip(frame), frame);
+
+    frame.fdf = false;
+    frame.brs = false;
+    frame.xlf = true;
+    frame.sec = true;
+    frame.sdt = 0x12;
+    frame.vcid = 0x28;
+    frame.af = 0xcaffee;
+    frame.data.assign(100, 0xcd);
+    frame.dlc = len2dlc(frame.length(), true);
+    can::to_socketcan(frame, raw);
+    ASSERT_EQ(raw.size(), 112);
+    EXPECT_EQ(raw[0], 0x23); // little endian priority
+    EXPECT_EQ(raw[2], 0x28);
+    EXPECT_EQ(raw[4], 0x81); // XLF | SEC
+    EXPECT_EQ(raw[6], 100);
+    EXPECT_EQ(socketcan_roundtrip(frame), frame);
+
+    EXPECT_FALSE(can::from_socketcan(frame, raw.data(), 20));
+}
+
 MATCHER_P(can_match_socket, name, "Matches a CAN socket") {
     return strcmp(arg.basename(), name) == 0;
 }
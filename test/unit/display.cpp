@@ -92,3 +92,315 @@ TEST(display, server) {
     p4->shutdown();
     p5->shutdown();
 }
+
+TEST(display, damage) {
+    vector<u8> fb(4 * KiB * 4 + 100, 0x55);
+    damage tracker(4 * KiB);
+    range changed;
+
+    EXPECT_TRUE(tracker.check(fb.data(), fb.size(), changed));
+    EXPECT_EQ(changed, range(0, fb.size() - 1));
+    EXPECT_FALSE(tracker.check(fb.data(), fb.size(), changed));
+
+    fb[4 * KiB + 17] = 0xaa;
+    fb[8 * KiB] = 0xaa;
+    EXPECT_TRUE(tracker.check(fb.data(), fb.size(), changed));
+    EXPECT_EQ(changed, range(4 * KiB, 12 * KiB - 1));
+    EXPECT_FALSE(tracker.check(fb.data(), fb.size(), changed));
+
+    fb.back() = 0xaa;
+    EXPECT_TRUE(tracker.check(fb.data(), fb.size(), changed));
+    EXPECT_EQ(changed, range(16 * KiB, fb.size() - 1));
+
+    tracker.invalidate();
+    EXPECT_TRUE(tracker.check(fb.data(), fb.size()));
+    EXPECT_FALSE(tracker.check(fb.data(), fb.size()));
+}
+
+static vector<u8> make_gradient(const videomode& mode, bool invert) {
+    vector<u8> fb(mode.size);
+    for (u32 y = 0; y < mode.yres; y++) {
+        for (u32 x = 0; x < mode.xres; x++) {
+            u8 val = x * 255 / (mode.xres - 1);
+            u32 pixel = invert ? ~val & 0xff : val;
+            pixel = 0xff000000 | pixel << 16 | pixel << 8 | pixel;
+            memcpy(fb.data() + y * mode.stride + x * 4, &pixel, 4);
+        }
+    }
+
+    return fb;
+}
+
+// minimal zlib inflater for checking encoder output, it only handles fixed
+// huffman blocks, which is all that encode_png produces
+class bitreader
+{
+private:
+    const vector<u8>& m_data;
+    size_t m_pos;
+
+public:
+    bitreader(const vector<u8>& data, size_t pos):
+        m_data(data), m_pos(pos * 8) {}
+
+    bool eof() const { return m_pos >= m_data.size() * 8; }
+
+    u32 bits(u32 n) {
+        u32 val = 0;
+        for (u32 i = 0; i < n; i++, m_pos++) {
+            if (eof())
+                throw std::out_of_range("inflate: truncated stream");
+            val |= ((m_data[m_pos / 8] >> (m_pos % 8)) & 1u) << i;
+        }
+        return val;
+    }
+
+    u32 code(u32 n) {
+        u32 val = 0;
+        for (u32 i = 0; i < n; i++)
+            val = val << 1 | bits(1);
+        return val;
+    }
+
+    size_t align() {
+        m_pos = (m_pos + 7) & ~(size_t)7;
+        return m_pos / 8;
+    }
+};
+
+static u32 inflate_fixed_symbol(bitreader& br) {
+    u32 code = br.code(7);
+    if (code < 0x18)
+        return 256 + code;
+
+    code = code << 1 | br.code(1);
+    if (code >= 0x30 && code < 0xc0)
+        return code - 0x30;
+    if (code >= 0xc0 && code < 0xc8)
+        return 280 + code - 0xc0;
+
+    code = code << 1 | br.code(1);
+    return 144 + code - 0x190;
+}
+
+static vector<u8> inflate(const vector<u8>& zlib) {
+    static const u16 len_base[29] = {
+        3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+    };
+
+    static const u8 len_extra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+        2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+    };
+
+    static const u16 dist_base[30] = {
+        1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+        33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+        1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577,
+    };
+
+    static const u8 dist_extra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+        6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+    };
+
+    if (zlib.size() < 6 || (zlib[0] & 0xf) != 8 ||
+        (zlib[0] << 8 | zlib[1]) % 31)
+        throw std::runtime_error("inflate: invalid zlib header");
+
+    vector<u8> out;
+    bitreader br(zlib, 2);
+    bool last = false;
+    while (!last) {
+        last = br.bits(1);
+        if (br.bits(2) != 1)
+            throw std::runtime_error("inflate: unsupported block type");
+
+        while (true) {
+            u32 sym = inflate_fixed_symbol(br);
+            if (sym < 256) {
+                out.push_back(sym);
+                continue;
+            }
+
+            if (sym == 256)
+                break;
+            if (sym > 285)
+                throw std::runtime_error("inflate: invalid length");
+
+            u32 len = len_base[sym - 257] + br.bits(len_extra[sym - 257]);
+            u32 d = br.code(5);
+            if (d >= 30)
+                throw std::runtime_error("inflate: invalid distance");
+
+            size_t dist = dist_base[d] + br.bits(dist_extra[d]);
+            if (dist > out.size())
+                throw std::runtime_error("inflate: distance too far");
+
+            for (u32 i = 0; i < len; i++)
+                out.push_back(out[out.size() - dist]);
+        }
+    }
+
+    size_t pos = br.align();
+    if (pos + 4 > zlib.size())
+        throw std::out_of_range("inflate: missing adler32");
+
+    u32 a = 1, b = 0;
+    for (u8 val : out) {
+        a = (a + val) % 65521;
+        b = (b + a) % 65521;
+    }
+
+    u32 adler = (u32)zlib[pos] << 24 | zlib[pos + 1] << 16 |
+                zlib[pos + 2] << 8 | zlib[pos + 3];
+    if (adler != (b << 16 | a))
+        throw std::runtime_error("inflate: adler32 mismatch");
+
+    return out;
+}
+
+static u32 get_be32(const u8* ptr) {
+    return (u32)ptr[0] << 24 | ptr[1] << 16 | ptr[2] << 8 | ptr[3];
+}
+
+// decodes an 8bit truecolor PNG back into packed RGB triplets
+static vector<u8> decode_png(const vector<u8>& png, u32& width, u32& height) {
+    vector<u8> idat;
+    width = height = 0;
+    for (size_t pos = 8; pos + 12 <= png.size();) {
+        u32 size = get_be32(png.data() + pos);
+        string type((const char*)png.data() + pos + 4, 4);
+        const u8* data = png.data() + pos + 8;
+        if (pos + 12 + size > png.size())
+            throw std::out_of_range("png: truncated chunk " + type);
+
+        if (type == "IHDR") {
+            width = get_be32(data);
+            height = get_be32(data + 4);
+            if (data[8] != 8 || data[9] != 2 || data[12] != 0)
+                throw std::runtime_error("png: unsupported format");
+        } else if (type == "IDAT") {
+            idat.insert(idat.end(), data, data + size);
+        }
+
+        pos += 12 + size;
+    }
+
+    vector<u8> raw = inflate(idat);
+    const size_t linesz = width * 3;
+    if (raw.size() != height * (linesz + 1))
+        throw std::runtime_error("png: image data size mismatch");
+
+    vector<u8> rgb(height * linesz);
+    for (u32 y = 0; y < height; y++) {
+        u8 filter = raw[y * (linesz + 1)];
+        const u8* src = raw.data() + y * (linesz + 1) + 1;
+        u8* cur = rgb.data() + y * linesz;
+        const u8* up = y > 0 ? cur - linesz : nullptr;
+        for (size_t i = 0; i < linesz; i++) {
+            int a = i >= 3 ? cur[i - 3] : 0;
+            int b = up ? up[i] : 0;
+            int c = up && i >= 3 ? up[i - 3] : 0;
+            int p = a + b - c;
+            switch (filter) {
+            case 0:
+                cur[i] = src[i];
+                break;
+            case 1:
+                cur[i] = src[i] + a;
+                break;
+            case 2:
+                cur[i] = src[i] + b;
+                break;
+            case 3:
+                cur[i] = src[i] + (a + b) / 2;
+                break;
+            case 4:
+                if (abs(p - a) <= abs(p - b) && abs(p - a) <= abs(p - c))
+                    cur[i] = src[i] + a;
+                else if (abs(p - b) <= abs(p - c))
+                    cur[i] = src[i] + b;
+                else
+                    cur[i] = src[i] + c;
+                break;
+            default:
+                throw std::runtime_error("png: invalid filter type");
+            }
+        }
+    }
+
+    return rgb;
+}
+
+TEST(display, png) {
+    videomode mode = videomode::a8r8g8b8(64, 32);
+    vector<u8> fb = make_gradient(mode, false);
+
+    // noise in the lower half to defeat the matcher and vary the filters
+    u32 seed = 1;
+    for (size_t i = fb.size() / 2; i < fb.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        fb[i] = seed >> 16;
+    }
+
+    vector<u8> rgb(64 * 32 * 3);
+    convert_rgb24(mode, fb.data(), rgb.data());
+    EXPECT_EQ(rgb[0], 0);
+    EXPECT_EQ(rgb[63 * 3], 255);
+
+    vector<u8> png;
+    encode_png(rgb.data(), 64, 32, png, "test");
+    ASSERT_GT(png.size(), 8 + 25 + 12);
+    EXPECT_EQ(memcmp(png.data(), "\x89PNG\r\n\x1a\n", 8), 0);
+    EXPECT_EQ(memcmp(png.data() + 12, "IHDR", 4), 0);
+    EXPECT_EQ(memcmp(png.data() + png.size() - 8, "IEND", 4), 0);
+    EXPECT_LT(png.size(), rgb.size());
+
+    u32 width = 0, height = 0;
+    vector<u8> image;
+    ASSERT_NO_THROW(image = decode_png(png, width, height));
+    ASSERT_EQ(width, mode.xres);
+    ASSERT_EQ(height, mode.yres);
+
+    for (u32 y = 0; y < height; y++) {
+        for (u32 x = 0; x < width; x++) {
+            u32 pixel;
+            memcpy(&pixel, fb.data() + y * mode.stride + x * 4, 4);
+            const u8* px = image.data() + (y * width + x) * 3;
+            ASSERT_EQ(px[0], (pixel >> 16) & 0xff) << "x=" << x << " y=" << y;
+            ASSERT_EQ(px[1], (pixel >> 8) & 0xff) << "x=" << x << " y=" << y;
+            ASSERT_EQ(px[2], pixel & 0xff) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+TEST(display, phash) {
+    videomode small = videomode::a8r8g8b8(64, 32);
+    videomode large = videomode::a8r8g8b8(256, 128);
+
+    u64 h0 = phash(small, make_gradient(small, false).data());
+    u64 h1 = phash(large, make_gradient(large, false).data());
+    u64 h2 = phash(small, make_gradient(small, true).data());
+
+    EXPECT_LE(phash_distance(h0, h1), 4);
+    EXPECT_GE(phash_distance(h0, h2), 32);
+}
+
+TEST(display, capture) {
+    videomode mode = videomode::a8r8g8b8(64, 32);
+    vector<u8> fb = make_gradient(mode, false);
+    string path = "display_capture.png";
+    std::remove(path.c_str());
+
+    capture cap;
+    cap.screenshot(path, mode, fb.data());
+    cap.flush();
+
+    ifstream file(path, std::ios::binary);
+    ASSERT_TRUE(file.good());
+    char sig[8]{};
+    file.read(sig, sizeof(sig));
+    EXPECT_EQ(memcmp(sig, "\x89PNG\r\n\x1a\n", 8), 0);
+}
@@ -11,6 +11,7 @@
 #include "testing.h"
 
 #include "vcml/protocols/eth.h"
+#include "vcml/tracing/pcap.h"
 
 TEST(ethernet, macaddr) {
     mac_addr addr("12:23:34:45:56:67");
@@ -49,6 +50,149 @@ TEST(ethernet, frame) {
     EXPECT_EQ(frame, frame);
 }
 
+static vector<u8> make_tcp4(size_t payload, u8 flags) {
+    vector<u8> pkt(14 + 20 + 20 + payload);
+    u8* ip = pkt.data() + 14;
+    u8* tcp = ip + 20;
+
+    pkt[12] = 0x08; // IPv4
+    ip[0] = 0x45;
+    ip[2] = (20 + 20 + payload) >> 8;
+    ip[3] = (20 + 20 + payload) & 0xff;
+    ip[4] = 0x12; // id
+    ip[8] = 64;   // ttl
+    ip[9] = eth_frame::IP_TCP;
+    ip[12] = 10;
+    ip[15] = 1;
+    ip[16] = 10;
+    ip[19] = 2;
+
+    tcp[7] = 100; // sequence number
+    tcp[12] = 5 << 4;
+    tcp[13] = flags;
+
+    for (size_t i = 0; i < payload; i++)
+        tcp[20 + i] = i & 0xff;
+
+    return pkt;
+}
+
+TEST(ethernet, checksum) {
+    const u8 data[] = { 0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40,
+                        0x11, 0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01, 0xc0, 0xa8,
+                        0x00, 0xc7 };
+    EXPECT_EQ(eth_checksum(data, sizeof(data)), 0xb861);
+
+    vector<u8> pkt = make_tcp4(100, 0x18);
+    EXPECT_FALSE(eth_checksum_valid(pkt.data(), pkt.size()));
+
+    // emulate a sender that leaves the checksum to us: it stores the
+    // pseudo header sum (addresses, protocol and length) in the checksum
+    u16 pseudo = ~eth_checksum(pkt.data() + 26, 8, eth_frame::IP_TCP + 120);
+    pkt[50] = pseudo >> 8;
+    pkt[51] = pseudo & 0xff;
+
+    EXPECT_TRUE(eth_checksum_offload(pkt.data(), pkt.size(), 34, 16));
+    EXPECT_TRUE(eth_checksum_valid(pkt.data(), pkt.size()));
+    EXPECT_FALSE(eth_checksum_offload(pkt.data(), pkt.size(), 34, 200));
+}
+
+TEST(ethernet, segment) {
+    vector<u8> pkt = make_tcp4(4000, 0x19); // PSH | FIN | ACK
+    vector<eth_frame> segments;
+
+    ASSERT_TRUE(eth_segment(pkt.data(), pkt.size(), 1448, segments));
+    ASSERT_EQ(segments.size(), 3);
+
+    vector<u8> payload;
+    for (size_t i = 0; i < segments.size(); i++) {
+        const eth_frame& seg = segments[i];
+        EXPECT_TRUE(eth_checksum_valid(seg.data(), seg.size()));
+        EXPECT_EQ(eth_checksum(seg.data() + 14, 20), 0);
+
+        size_t iplen = seg.read<u16>(16);
+        EXPECT_EQ(seg.read<u32>(38), 100 + payload.size());
+        EXPECT_EQ(seg.read<u16>(18), 0x1200 + i);
+        EXPECT_EQ(seg[47], i < 2 ? 0x10 : 0x19);
+
+        auto data = seg.begin() + 54;
+        payload.insert(payload.end(), data, data + iplen - 40);
+    }
+
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(), pkt.begin() + 54));
+    EXPECT_EQ(payload.size(), 4000);
+
+    // non-ip frames cannot be segmented
+    pkt[12] = 0x08;
+    pkt[13] = 0x06;
+    EXPECT_FALSE(eth_segment(pkt.data(), pkt.size(), 1448, segments));
+}
+
+TEST(ethernet, offloads) {
+    vector<u8> pkt = make_tcp4(3000, 0x18);
+    vector<eth_frame> resolved;
+
+    eth_frame frame(pkt.size());
+    std::copy(pkt.begin(), pkt.end(), frame.begin());
+    EXPECT_FALSE(frame.has_offloads());
+
+    frame.offload.gso_type = eth_frame::GSO_TCPV4;
+    frame.offload.gso_size = 1000;
+    EXPECT_TRUE(frame.is_gso());
+    ASSERT_TRUE(eth_resolve_offloads(frame, resolved));
+    ASSERT_EQ(resolved.size(), 3);
+    for (const eth_frame& seg : resolved) {
+        EXPECT_FALSE(seg.has_offloads());
+        EXPECT_EQ(seg.size(), 14 + 40 + 1000);
+        EXPECT_EQ(seg.flow_hash(), frame.flow_hash());
+    }
+
+    frame.offload = {};
+    frame.offload.flags = eth_frame::OFFLOAD_NEEDS_CSUM;
+    frame.offload.csum_start = 34;
+    frame.offload.csum_offset = 16;
+    ASSERT_TRUE(eth_resolve_offloads(frame, resolved));
+    ASSERT_EQ(resolved.size(), 1);
+    EXPECT_EQ(resolved[0].offload.flags, eth_frame::OFFLOAD_CSUM_VALID);
+    EXPECT_EQ(resolved[0].size(), frame.size());
+}
+
+TEST(ethernet, pcap) {
+    vector<u8> frame = make_tcp4(100, 0x18);
+    {
+        pcap_writer writer("test.pcapng", PCAP_LINKTYPE_ETHERNET, "eth0",
+                           256);
+        writer.write(sc_time(1, SC_US), frame.data(), frame.size(),
+                     PCAP_OUTBOUND);
+        writer.write(sc_time(2, SC_US), frame.data(), frame.size(),
+                     PCAP_INBOUND);
+        EXPECT_EQ(writer.packets(), 2);
+        EXPECT_EQ(writer.files(), 2);
+    }
+
+    EXPECT_EQ(pcap_writer::rotated_path("test.pcapng", 1), "test.1.pcapng");
+    EXPECT_EQ(pcap_writer::rotated_path("dir.d/test", 2), "dir.d/test.2");
+
+    pcap_reader::packet pkt;
+    pcap_reader reader("test.pcapng");
+    ASSERT_TRUE(reader.next(pkt));
+    EXPECT_EQ(pkt.timestamp, sc_time(1, SC_US));
+    EXPECT_EQ(pkt.linktype, PCAP_LINKTYPE_ETHERNET);
+    EXPECT_EQ(pkt.direction, PCAP_OUTBOUND);
+    EXPECT_EQ(pkt.data, frame);
+    EXPECT_FALSE(reader.next(pkt));
+
+    pcap_reader rotated("test.1.pcapng");
+    ASSERT_TRUE(rotated.next(pkt));
+    EXPECT_EQ(pkt.timestamp, sc_time(2, SC_US));
+    EXPECT_EQ(pkt.direction, PCAP_INBOUND);
+    EXPECT_EQ(pkt.data, frame);
+    EXPECT_FALSE(rotated.next(pkt));
+
+    std::remove("test.pcapng");
+    std::remove("test.1.pcapng");
+}
+
 MATCHER_P(eth_match_socket, socket, "Matches an ethernet socket") {
     return &arg == socket;
 }
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#include "testing.h"
+
+using debugging::hostprof;
+
+static const hostprof::entry* find_entry(const vector<hostprof::entry>& v,
+                                         const string& name) {
+    for (const auto& entry : v) {
+        if (entry.name == name)
+            return &entry;
+    }
+
+    return nullptr;
+}
+
+class hostprof_test : public test_base
+{
+public:
+    tlm_initiator_socket out;
+    tlm_target_socket in;
+
+    gpio_initiator_socket gpio_out;
+    gpio_target_socket gpio_in;
+
+    hostprof_test(const sc_module_name& nm):
+        test_base(nm),
+        out("out"),
+        in("in"),
+        gpio_out("gpio_out"),
+        gpio_in("gpio_in") {
+        out.bind(in);
+        gpio_out.bind(gpio_in);
+        hostprof::enable(1, SC_ZERO_TIME);
+    }
+
+    virtual ~hostprof_test() { hostprof::disable(); }
+
+    virtual unsigned int transport(tlm_generic_payload& tx,
+                                   const tlm_sbi& info,
+                                   address_space as) override {
+        tx.set_response_status(TLM_OK_RESPONSE);
+        return tx.get_data_length();
+    }
+
+    virtual void run_test() override {
+        hostprof::reset();
+
+        u32 data = 0;
+        for (int i = 0; i < 100; i++)
+            EXPECT_OK(out.writew(i * 4, data));
+
+        for (int i = 0; i < 10; i++)
+            gpio_out = !gpio_out;
+
+        vector<hostprof::entry> entries = hostprof::collect(*this);
+
+        const hostprof::entry* tlm = find_entry(entries, in.name());
+        ASSERT_NE(tlm, nullptr);
+        EXPECT_STREQ(tlm->kind, "tlm");
+        EXPECT_EQ(tlm->module, name());
+        EXPECT_EQ(tlm->calls, 100);
+        EXPECT_GT(tlm->nanos, 0);
+
+        const hostprof::entry* gpio = find_entry(entries, gpio_in.name());
+        ASSERT_NE(gpio, nullptr);
+        EXPECT_STREQ(gpio->kind, "gpio");
+        EXPECT_EQ(gpio->calls, 10);
+
+        auto modules = hostprof::summarize(entries);
+        ASSERT_FALSE(modules.empty());
+        EXPECT_EQ(modules[0].name, name());
+        EXPECT_GE(modules[0].calls, 110);
+
+        stringstream ss;
+        EXPECT_TRUE(execute("hostprof", ss));
+        EXPECT_NE(ss.str().find(in.name()), string::npos);
+    }
+};
+
+TEST(hostprof, sockets) {
+    hostprof_test test("test");
+    sc_core::sc_start();
+}
+
+TEST(hostprof, nested) {
+    hostprof::enable(4, SC_ZERO_TIME);
+    hostprof::reset();
+
+    // a fixed pattern of two nested sites must still time both of them
+    hostprof::site outer("nested.bus", "nested", "tlm");
+    hostprof::site inner("nested.mem", "nested", "tlm");
+    for (int i = 0; i < 64; i++) {
+        hostprof::scope bus(outer);
+        hostprof::scope mem(inner);
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+    }
+
+    vector<hostprof::entry> entries = hostprof::collect();
+    hostprof::disable();
+
+    const hostprof::entry* bus = find_entry(entries, "nested.bus");
+    const hostprof::entry* mem = find_entry(entries, "nested.mem");
+    ASSERT_NE(bus, nullptr);
+    ASSERT_NE(mem, nullptr);
+    EXPECT_EQ(bus->calls, 64);
+    EXPECT_EQ(mem->calls, 64);
+    EXPECT_GT(bus->nanos, 0);
+    EXPECT_GT(mem->nanos, 0);
+    EXPECT_GE(bus->nanos, mem->nanos);
+}
@@ -129,12 +129,18 @@ public:
         // does the data get received?
         u8 data = 0xab;
         EXPECT_CALL(*this, i2c_write(i2c_match_address(44), data))
-            .Times(3)
+            .Times(6)
             .WillRepeatedly(Return(I2C_ACK));
         EXPECT_ACK(i2c_out.transport(data));
         EXPECT_ACK(i2c_out.transport(data));
         EXPECT_ACK(i2c_out.transport(data));
 
+        // do bursts get delivered byte by byte?
+        u8 burst[3] = { data, data, data };
+        size_t len = sizeof(burst);
+        EXPECT_ACK(i2c_out.transport(burst, len));
+        EXPECT_EQ(len, sizeof(burst));
+
         // can we stop the transfer?
         EXPECT_CALL(*this, i2c_stop(i2c_match_address(44)))
             .Times(1)
@@ -157,6 +157,62 @@ TEST(logging, reporting) {
     vcml::log.error(rep);
 }
 
+TEST(logging, deferred_format) {
+    vcml::log_args args;
+    args.add_all(-3, 3.14, "str", 42u, vcml::LOG_WARN, 'x');
+    EXPECT_EQ(args.format("%d %.2f %s %u %d %c"), "-3 3.14 str 42 1 x");
+    EXPECT_EQ(args.format("%5d|%-4s|%%"), "   -3|<?>|%");
+    EXPECT_EQ(args.format("%d %d %d %d %d %d %d"), "-3 3 <?> 42 1 120 <?>");
+}
+
+TEST(logging, ratelimit) {
+    mwr::publishers::terminal cons;
+    mock_publisher publisher;
+
+    cons.set_level(vcml::LOG_ERROR);
+    publisher.set_level(vcml::LOG_DEBUG);
+
+    vcml::component comp("ratelimit");
+    comp.loglvl = vcml::LOG_DEBUG;
+
+    EXPECT_CALL(publisher, publish(match_sender(comp.name()))).Times(10);
+    for (int i = 0; i < 100; i++)
+        VCML_LOG_RATELIMITED(comp.log, vcml::LOG_WARN, "message %d", i);
+
+    EXPECT_CALL(publisher, publish(match_level(vcml::LOG_WARN))).Times(1);
+    vcml::log_site::report_suppressed();
+
+    // the level check comes first, filtered messages never reach the site
+    comp.loglvl = vcml::LOG_INFO;
+    EXPECT_CALL(publisher, publish(_)).Times(0);
+    for (int i = 0; i < 100; i++)
+        VCML_LOG_RATELIMITED(comp.log, vcml::LOG_DEBUG, "filtered %d", i);
+    vcml::log_site::report_suppressed();
+}
+
+TEST(logging, async) {
+    mwr::publishers::terminal cons;
+    mock_publisher publisher;
+
+    cons.set_level(vcml::LOG_ERROR);
+    publisher.set_level(vcml::LOG_DEBUG);
+
+    vcml::component comp("async");
+    comp.loglvl = vcml::LOG_DEBUG;
+
+    vcml::log_site::set_ratelimit(0, sc_core::SC_ZERO_TIME);
+    vcml::log_queue::start();
+    EXPECT_TRUE(vcml::log_queue::is_async());
+
+    EXPECT_CALL(publisher, publish(match_sender(comp.name()))).Times(50);
+    for (int i = 0; i < 50; i++)
+        VCML_LOG_RATELIMITED(comp.log, vcml::LOG_INFO, "message %d", i);
+
+    vcml::log_queue::stop();
+    EXPECT_FALSE(vcml::log_queue::is_async());
+    vcml::log_site::set_ratelimit(10, sc_core::sc_time(1.0, sc_core::SC_SEC));
+}
+
 int sc_main(int argc, char** argv) {
     ADD_FAILURE() << "sc_main should not be called";
     return EXIT_FAILURE;
@@ -10,6 +10,8 @@
 
 #include "testing.h"
 
+#include <filesystem>
+
 TEST(core, lua) {
     string s;
     mwr::publishers::terminal logger;
@@ -35,3 +37,69 @@ TEST(core, lua) {
         std::cout << prop << " = " << val << std::endl;
     }
 }
+
+static string write_file(const string& path, const string& contents) {
+    ofstream os(path);
+    os << contents;
+    return path;
+}
+
+static size_t count_cached(const string& dir) {
+    size_t n = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir))
+        n += entry.path().extension() == ".cfg" ? 1 : 0;
+    return n;
+}
+
+TEST(core, lua_cache) {
+    string dir = mkstr("%s/vcml-lua-cache-%d",
+                       std::filesystem::temp_directory_path().c_str(),
+                       (int)mwr::getpid());
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir + "/cache");
+    setenv("VCML_LUA_CACHE", (dir + "/cache").c_str(), 1);
+
+    // every run of the script appends to the runs file, cached loads do not
+    string runs = dir + "/runs";
+    string plain = write_file(dir + "/plain.lua",
+                              mkstr("io.open('%s', 'a'):write('x'):close()\n"
+                                    "vp['cache.plain'] = 'abc'\n",
+                                    runs.c_str()));
+
+    string s;
+    for (int i = 0; i < 2; i++) {
+        broker_lua lua(plain);
+        EXPECT_TRUE(lua.lookup("cache.plain", s));
+        EXPECT_EQ(s, "abc");
+    }
+
+    EXPECT_EQ(std::filesystem::file_size(runs), 1u);
+    EXPECT_EQ(count_cached(dir + "/cache"), 1u);
+
+    // scripts that pull in values from elsewhere must be run every time
+    string volatile_lua = write_file(dir + "/volatile.lua",
+                                     "vp['cache.ref'] = '${cache.other}'\n"
+                                     "vp['cache.pid'] = vp.pid\n");
+
+    broker other("other");
+    other.define("cache.other", "one");
+    {
+        broker_lua lua(volatile_lua);
+        EXPECT_TRUE(lua.lookup("cache.ref", s));
+        EXPECT_EQ(s, "one");
+        EXPECT_TRUE(lua.lookup("cache.pid", s));
+        EXPECT_EQ(s, mkstr("%d", (int)mwr::getpid()));
+    }
+
+    other.define("cache.other", "two");
+    {
+        broker_lua lua(volatile_lua);
+        EXPECT_TRUE(lua.lookup("cache.ref", s));
+        EXPECT_EQ(s, "two");
+    }
+
+    EXPECT_EQ(count_cached(dir + "/cache"), 1u);
+
+    unsetenv("VCML_LUA_CACHE");
+    std::filesystem::remove_all(dir);
+}
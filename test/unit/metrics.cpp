@@ -0,0 +1,192 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+
+#include "testing.h"
+
+using namespace debugging;
+
+static const metric_sample* find_sample(const vector<metric_sample>& v,
+                                        const string& name,
+                                        const string& label = "") {
+    for (const auto& s : v) {
+        if (s.name != name)
+            continue;
+        if (label.empty())
+            return &s;
+        for (const auto& [key, val] : s.labels) {
+            if (val == label)
+                return &s;
+        }
+    }
+
+    return nullptr;
+}
+
+static string read_file(const string& path) {
+    ifstream file(path);
+    stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+TEST(metrics, registry) {
+    u64 value = 42;
+    auto c = std::make_unique<counter>("test_calls_total", "calls",
+                                       metric_labels{ { "id", "a" } });
+    counter cb("test_calls_total", "calls", { { "id", "b" } },
+               [&]() -> u64 { return value; });
+    gauge g("test_level", "level");
+
+    c->inc();
+    c->inc(2);
+    g.set(1.5);
+
+    auto samples = metrics::snapshot();
+    const metric_sample* s = find_sample(samples, "test_calls_total", "a");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->type, METRIC_COUNTER);
+    EXPECT_EQ(s->count, 3);
+
+    s = find_sample(samples, "test_calls_total", "b");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->count, 42);
+
+    s = find_sample(samples, "test_level");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->value, 1.5);
+
+    c.reset();
+    samples = metrics::snapshot();
+    EXPECT_EQ(find_sample(samples, "test_calls_total", "a"), nullptr);
+}
+
+TEST(metrics, histogram) {
+    histogram h("test_latency", "latency", { 1.0, 10.0 });
+    h.observe(0.5);
+    h.observe(1.0);
+    h.observe(5.0);
+    h.observe(50.0);
+
+    EXPECT_EQ(h.count(), 4);
+    EXPECT_EQ(h.sum(), 56.5);
+
+    auto samples = metrics::snapshot();
+    const metric_sample* s = find_sample(samples, "test_latency");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->buckets, vector<u64>({ 2, 3, 4 }));
+    EXPECT_EQ(s->count, 4);
+}
+
+TEST(metrics, formats) {
+    counter c("test_bytes_total", "bytes\nmoved", { { "dev", "a\"b" } });
+    histogram h("test_delay", "delay", { 0.5 });
+    c.inc(7);
+    h.observe(0.25);
+
+    vector<metric_sample> samples;
+    for (const auto& s : metrics::snapshot()) {
+        if (starts_with(s.name, "test_"))
+            samples.push_back(s);
+    }
+
+    stringstream prom;
+    metrics::write_prometheus(prom, samples);
+    EXPECT_EQ(prom.str(),
+              "# HELP test_bytes_total bytes\\nmoved\n"
+              "# TYPE test_bytes_total counter\n"
+              "test_bytes_total{dev=\"a\\\"b\"} 7\n"
+              "# HELP test_delay delay\n"
+              "# TYPE test_delay histogram\n"
+              "test_delay_bucket{le=\"0.5\"} 1\n"
+              "test_delay_bucket{le=\"+Inf\"} 1\n"
+              "test_delay_sum 0.25\n"
+              "test_delay_count 1\n");
+
+    stringstream json;
+    metrics::write_json(json, samples);
+    string line = json.str();
+    EXPECT_TRUE(starts_with(line, "{\"timestamp\":"));
+    EXPECT_NE(line.find("{\"name\":\"test_bytes_total\",\"type\":\"counter\","
+                        "\"labels\":{\"dev\":\"a\\\"b\"},\"value\":7}"),
+              string::npos);
+    EXPECT_NE(line.find("\"buckets\":[{\"le\":0.5,\"count\":1},"
+                        "{\"le\":\"+Inf\",\"count\":1}]"),
+              string::npos);
+    EXPECT_EQ(line.back(), '\n');
+}
+
+class metrics_test : public test_base
+{
+public:
+    tlm_initiator_socket out;
+    tlm_target_socket in;
+
+    u8 memory[64];
+
+    metrics_test(const sc_module_name& nm):
+        test_base(nm), out("out"), in("in"), memory() {
+        out.bind(in);
+    }
+
+    virtual unsigned int transport(tlm_generic_payload& tx,
+                                   const tlm_sbi& info,
+                                   address_space as) override {
+        tx.set_response_status(TLM_OK_RESPONSE);
+        return tx.get_data_length();
+    }
+
+    virtual void run_test() override {
+        u32 data = 0;
+        for (int i = 0; i < 10; i++)
+            EXPECT_OK(out.writew(i * 4, data));
+
+        tlm_dmi dmi;
+        dmi.set_start_address(0);
+        dmi.set_end_address(sizeof(memory) - 1);
+        dmi.set_dmi_ptr(memory);
+        dmi.allow_read_write();
+        out.map_dmi(dmi);
+
+        for (int i = 0; i < 5; i++)
+            EXPECT_OK(out.readw(i * 4, data));
+
+        EXPECT_EQ(out.num_sent(), 10);
+        EXPECT_EQ(out.num_dmi_hits(), 5);
+        EXPECT_EQ(in.num_received(), 10);
+
+        // periodic export samples during the update phase
+        string path = mwr::temp_dir() + "/vcml_metrics_test.prom";
+        std::remove(path.c_str());
+
+        metrics::start("prom:" + path, sc_time(1, SC_MS));
+        for (int i = 0; i < 1000 && !mwr::file_exists(path); i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            wait(SC_ZERO_TIME);
+        }
+
+        metrics::stop();
+        EXPECT_FALSE(metrics::is_exporting());
+
+        string text = read_file(path);
+        EXPECT_NE(text.find("vcml_tlm_sent_total{socket=\"test.out\"} 10"),
+                  string::npos);
+        EXPECT_NE(text.find("vcml_tlm_dmi_hits_total{socket=\"test.out\"} 5"),
+                  string::npos);
+        EXPECT_NE(text.find("# TYPE vcml_sim_time_seconds gauge"),
+                  string::npos);
+        std::remove(path.c_str());
+    }
+};
+
+TEST(metrics, sockets) {
+    metrics_test test("test");
+    sc_core::sc_start();
+}
@@ -134,3 +134,93 @@ TEST(scsi, illegal_command) {
     EXPECT_EQ(req_s.payload[12], block::SENSE_ILLEGAL_REQ.asc);
     EXPECT_EQ(req_s.payload[13], block::SENSE_ILLEGAL_REQ.ascq);
 }
+
+TEST(scsi, buffers) {
+    block::scsi_disk disk("disk");
+    u8 lo[512], hi[512];
+    memset(lo, 0x11, sizeof(lo));
+    memset(hi, 0x22, sizeof(hi));
+
+    block::scsi_request req_w{};
+    req_w.command[0] = 0x2a; // write10
+    req_w.command[5] = 0x04; // offset 2048
+    req_w.command[8] = 0x02; // size 1024
+    req_w.buffers.push_back({ lo, sizeof(lo) });
+    req_w.buffers.push_back({ hi, sizeof(hi) });
+    ASSERT_TRUE(success(disk.scsi_handle_command(req_w)));
+    EXPECT_EQ(req_w.length, 1024);
+    EXPECT_TRUE(req_w.payload.empty());
+
+    u8 data[1024]{};
+    block::scsi_request req_r{};
+    req_r.command[0] = 0x28; // read10
+    req_r.command[5] = 0x04; // offset 2048
+    req_r.command[8] = 0x02; // size 1024
+    req_r.buffers.push_back({ data, 100 });
+    req_r.buffers.push_back({ data + 100, sizeof(data) - 100 });
+    ASSERT_TRUE(success(disk.scsi_handle_command(req_r)));
+    EXPECT_EQ(req_r.length, 1024);
+    EXPECT_TRUE(req_r.payload.empty());
+    EXPECT_EQ(memcmp(data, lo, sizeof(lo)), 0);
+    EXPECT_EQ(memcmp(data + 512, hi, sizeof(hi)), 0);
+
+    // buffers too small for the requested transfer
+    req_r.buffers.pop_back();
+    ASSERT_TRUE(failed(disk.scsi_handle_command(req_r)));
+    EXPECT_EQ(disk.get_sense(), block::SENSE_ILLEGAL_FIELD);
+
+    // commands other than read and write are staged through the payload
+    u8 inquiry[16]{};
+    block::scsi_request req_i{};
+    req_i.command[0] = 0x12;
+    req_i.buffers.push_back({ inquiry, sizeof(inquiry) });
+    ASSERT_TRUE(success(disk.scsi_handle_command(req_i)));
+    EXPECT_EQ(req_i.length, sizeof(inquiry));
+    EXPECT_EQ(inquiry[0], block::SCSI_DEVICE_DIRECT_ACCESS);
+    EXPECT_EQ(memcmp(inquiry + 8, "MWARE", 5), 0);
+}
+
+// must run last, since it starts the simulation
+TEST(scsi, queue) {
+    block::scsi_disk disk("disk");
+    disk.queue_depth = 2;
+
+    vector<pair<u32, block::scsi_response>> done;
+    auto complete = [&](block::scsi_request& req, block::scsi_response rs) {
+        done.push_back({ req.tag, rs });
+    };
+
+    block::scsi_request req_a{};
+    req_a.command[0] = 0x00; // test unit ready
+    req_a.tag = 1;
+
+    block::scsi_request req_b{};
+    req_b.command[0] = 0xee; // illegal
+    req_b.tag = 2;
+
+    block::scsi_request req_c{};
+    req_c.command[0] = 0x35; // flush
+    req_c.tag = 3;
+
+    EXPECT_EQ(disk.scsi_submit(req_a, complete), block::SCSI_GOOD);
+    EXPECT_EQ(disk.scsi_submit(req_a, complete), block::SCSI_CHECK_CONDITION);
+    EXPECT_EQ(disk.get_sense(), block::SENSE_OVERLAPPED_CMD);
+    EXPECT_EQ(disk.scsi_submit(req_b, complete), block::SCSI_GOOD);
+    EXPECT_EQ(disk.scsi_submit(req_c, complete), block::SCSI_TASK_SET_FULL);
+    EXPECT_EQ(disk.scsi_queued(), 2);
+
+    EXPECT_TRUE(disk.scsi_abort(2));
+    EXPECT_FALSE(disk.scsi_abort(2));
+    EXPECT_EQ(disk.scsi_submit(req_c, complete), block::SCSI_GOOD);
+
+    sc_core::sc_start();
+
+    ASSERT_EQ(done.size(), 3);
+    EXPECT_EQ(done[0].first, 2u);
+    EXPECT_EQ(done[0].second, block::SCSI_TASK_ABORTED);
+    EXPECT_EQ(done[1].first, 1u);
+    EXPECT_EQ(done[1].second, block::SCSI_GOOD);
+    EXPECT_EQ(done[2].first, 3u);
+    EXPECT_EQ(done[2].second, block::SCSI_GOOD);
+    EXPECT_EQ(disk.scsi_queued(), 0);
+}
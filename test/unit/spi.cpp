@@ -86,6 +86,15 @@ public:
 
         EXPECT_EQ(count1, 10);
         EXPECT_EQ(count2, 10);
+
+        u32 mosi[4] = { 1, 2, 3, 4 };
+        u32 miso[4] = {};
+        spi_out.transport(mosi, miso, 4);
+        for (size_t i = 0; i < 4; i++)
+            EXPECT_EQ(miso[i], mosi[i] * 2) << "burst word " << i;
+
+        EXPECT_EQ(count1, 14);
+        EXPECT_EQ(count2, 14);
     }
 };
 
@@ -120,4 +129,8 @@ TEST(spi, to_string) {
     tx.mosi = 0x89abcdef;
     tx.mask = 0xffffffff;
     EXPECT_EQ(to_string(tx), "[mosi: 0x89abcdef miso: 0x01234567]");
+
+    u32 words[3] = {};
+    spi_payload burst(words, words, 3);
+    EXPECT_EQ(to_string(burst), "[burst: 3 words]");
 }
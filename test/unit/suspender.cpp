@@ -10,10 +10,27 @@
 
 #include "testing.h"
 
+class session_module : public vcml::module
+{
+public:
+    std::atomic<size_t> num_suspend;
+    std::atomic<size_t> num_resume;
+
+    session_module(const sc_module_name& nm):
+        vcml::module(nm), num_suspend(0), num_resume(0) {}
+
+    virtual void session_suspend() override { num_suspend++; }
+    virtual void session_resume() override { num_resume++; }
+};
+
 class suspender_test : public test_base, debugging::suspender
 {
 public:
+    session_module session;
     std::thread t1;
+    std::atomic<size_t> num_suspended;
+
+    virtual void notify_suspended() override { num_suspended++; }
 
     void test_resume() {
         std::atomic<bool> done = false;
@@ -26,6 +43,9 @@ public:
             yield();
 
             EXPECT_TRUE(is_suspending());
+            EXPECT_EQ(num_suspended.load(), 1);
+            EXPECT_EQ(session.num_suspend.load(), 1);
+            EXPECT_EQ(session.num_resume.load(), 0);
             EXPECT_EQ(debugging::suspender::current(),
                       (debugging::suspender*)this);
 
@@ -44,6 +64,38 @@ public:
             wait(1, SC_MS);
 
         t0.join();
+        EXPECT_EQ(session.num_resume.load(), 1);
+    }
+
+    void test_hold() {
+        EXPECT_FALSE(debugging::suspender::hold_suspension());
+
+        std::atomic<bool> done = false;
+        std::thread t0([&]() -> void {
+            suspend();
+            yield();
+
+            // holding keeps the simulation halted past resume
+            bool held = debugging::suspender::hold_suspension();
+            EXPECT_TRUE(held);
+            size_t resumed = session.num_resume.load();
+            resume();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            EXPECT_TRUE(debugging::suspender::simulation_suspended());
+            EXPECT_EQ(session.num_resume.load(), resumed);
+
+            done = true;
+            if (held)
+                debugging::suspender::release_suspension();
+        });
+
+        while (!done)
+            wait(1, SC_MS);
+
+        t0.join();
+        EXPECT_FALSE(debugging::suspender::simulation_suspended());
+        EXPECT_FALSE(debugging::suspender::hold_suspension());
     }
 
     void test_forced_resume() {
@@ -71,7 +123,11 @@ public:
     }
 
     suspender_test(const sc_module_name& nm = "test"):
-        test_base(nm), debugging::suspender("suspender"), t1() {}
+        test_base(nm),
+        debugging::suspender("suspender"),
+        session("session"),
+        t1(),
+        num_suspended(0) {}
     virtual ~suspender_test() {
         if (t1.joinable())
             t1.join();
@@ -82,6 +138,7 @@ public:
         EXPECT_STREQ(suspender::name(), "test.suspender");
 
         test_resume();
+        test_hold();
         test_forced_resume();
     }
 };
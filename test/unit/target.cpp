@@ -0,0 +1,188 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+using namespace ::vcml::debugging;
+
+class mock_subscriber : public subscriber
+{
+public:
+    MOCK_METHOD(void, notify_basic_block,
+                (target&, u64, size_t, size_t, const sc_time&), (override));
+    MOCK_METHOD(void, notify_breakpoint_hit,
+                (const breakpoint&, const sc_time&), (override));
+    MOCK_METHOD(void, notify_watchpoint_read,
+                (const watchpoint&, const range&, const sc_time&), (override));
+    MOCK_METHOD(void, notify_watchpoint_write,
+                (const watchpoint&, const range&, const void*,
+                 const sc_time&),
+                (override));
+};
+
+class mock_target : public module, public target
+{
+public:
+    u64 pc;
+
+    mock_target(const sc_module_name& nm):
+        module(nm), target(*this), pc(0) {}
+
+    virtual u64 program_counter() override { return pc; }
+
+    virtual bool insert_breakpoint(u64 addr) override { return true; }
+    virtual bool remove_breakpoint(u64 addr) override { return true; }
+
+    virtual bool insert_watchpoint(const range& mem, vcml_access a) override {
+        return true;
+    }
+
+    virtual bool remove_watchpoint(const range& mem, vcml_access a) override {
+        return true;
+    }
+
+    virtual bool start_basic_block_trace() override { return true; }
+    virtual bool stop_basic_block_trace() override { return true; }
+
+    using target::insert_breakpoint;
+    using target::remove_breakpoint;
+    using target::insert_watchpoint;
+    using target::remove_watchpoint;
+
+    using target::notify_breakpoint_hit;
+    using target::notify_watchpoint_read;
+    using target::notify_watchpoint_write;
+    using target::notify_basic_block;
+};
+
+TEST(target, breakpoints) {
+    mock_target tgt("breakpoints");
+    mock_subscriber subscr;
+
+    for (u64 addr = 0; addr < 1000; addr++)
+        ASSERT_NE(tgt.insert_breakpoint(addr * 4, &subscr), nullptr);
+
+    EXPECT_TRUE(tgt.has_breakpoints());
+    EXPECT_EQ(tgt.breakpoints().size(), 1000);
+
+    const breakpoint* bp = tgt.lookup_breakpoint(0x40);
+    ASSERT_NE(bp, nullptr);
+    EXPECT_EQ(bp->address(), 0x40);
+    EXPECT_EQ(tgt.lookup_breakpoint(0x41), nullptr);
+
+    EXPECT_CALL(subscr, notify_breakpoint_hit(Ref(*bp), _)).Times(1);
+    tgt.notify_breakpoint_hit(0x40, SC_ZERO_TIME);
+    tgt.notify_breakpoint_hit(0x41, SC_ZERO_TIME);
+    EXPECT_EQ(bp->hit_count(), 1);
+
+    EXPECT_TRUE(tgt.remove_breakpoint(bp, &subscr));
+    EXPECT_EQ(tgt.lookup_breakpoint(0x40), nullptr);
+    EXPECT_FALSE(tgt.remove_breakpoint(0x40, &subscr));
+    EXPECT_EQ(tgt.breakpoints().size(), 999);
+}
+
+TEST(target, watchpoints) {
+    mock_target tgt("watchpoints");
+    mock_subscriber subscr;
+
+    const watchpoint* wp0 = tgt.insert_watchpoint({ 0x1000, 0x1fff },
+                                                  VCML_ACCESS_READ, &subscr);
+    const watchpoint* wp1 = tgt.insert_watchpoint({ 0x1800, 0x1803 },
+                                                  VCML_ACCESS_WRITE, &subscr);
+    const watchpoint* wp2 = tgt.insert_watchpoint({ 0x8000, 0x8003 },
+                                                  VCML_ACCESS_READ_WRITE,
+                                                  &subscr);
+    ASSERT_NE(wp0, nullptr);
+    ASSERT_NE(wp1, nullptr);
+    ASSERT_NE(wp2, nullptr);
+
+    EXPECT_EQ(tgt.lookup_watchpoint({ 0x1800, 0x1803 }), wp1);
+    EXPECT_EQ(tgt.lookup_watchpoint({ 0x1800, 0x1807 }), nullptr);
+
+    EXPECT_TRUE(tgt.has_watchpoint({ 0x1ffc, 0x2003 }));
+    EXPECT_FALSE(tgt.has_watchpoint({ 0x2000, 0x7fff }));
+    EXPECT_TRUE(tgt.has_watchpoint_in_page(0x1234, 4 * KiB));
+    EXPECT_FALSE(tgt.has_watchpoint_in_page(0x2345, 4 * KiB));
+    EXPECT_TRUE(tgt.has_watchpoint_in_page(0x8abc, 4 * KiB));
+
+    range addr(0x1802, 0x1802);
+    EXPECT_CALL(subscr, notify_watchpoint_read(Ref(*wp0), addr, _)).Times(1);
+    EXPECT_CALL(subscr, notify_watchpoint_read(Ref(*wp1), _, _)).Times(0);
+    tgt.notify_watchpoint_read(addr, SC_ZERO_TIME);
+
+    u8 data = 0xff;
+    EXPECT_CALL(subscr, notify_watchpoint_write(Ref(*wp1), addr, &data, _))
+        .Times(1);
+    tgt.notify_watchpoint_write(addr, &data, SC_ZERO_TIME);
+
+    EXPECT_TRUE(tgt.remove_watchpoint(wp0, VCML_ACCESS_READ, &subscr));
+    EXPECT_TRUE(tgt.has_watchpoint_in_page(0x1000, 4 * KiB));
+    EXPECT_FALSE(tgt.has_watchpoint({ 0x1000, 0x17ff }));
+    EXPECT_EQ(tgt.watchpoints().size(), 2);
+}
+
+TEST(target, overlapping_watchpoints) {
+    mock_target tgt("overlapping_watchpoints");
+    mock_subscriber subscr;
+
+    for (u64 i = 0; i < 12; i++) {
+        EXPECT_NE(tgt.insert_watchpoint({ 0x1000 - i, 0x1000 + i },
+                                        VCML_ACCESS_READ, &subscr),
+                  nullptr);
+    }
+
+    range addr(0x1000, 0x1003);
+    EXPECT_CALL(subscr, notify_watchpoint_read(_, addr, _)).Times(12);
+    tgt.notify_watchpoint_read(addr, SC_ZERO_TIME);
+}
+
+TEST(target, basic_blocks) {
+    mock_target tgt("basic_blocks");
+    mock_subscriber subscr;
+
+    EXPECT_FALSE(tgt.is_tracing_basic_blocks());
+    EXPECT_TRUE(tgt.trace_basic_blocks(&subscr));
+    EXPECT_TRUE(tgt.is_tracing_basic_blocks());
+
+    EXPECT_CALL(subscr, notify_basic_block(Ref(tgt), 0x100, 8, 2, _));
+    tgt.notify_basic_block(0x100, 8, 2, SC_ZERO_TIME);
+
+    EXPECT_TRUE(tgt.untrace_basic_blocks(&subscr));
+    EXPECT_FALSE(tgt.untrace_basic_blocks(&subscr));
+    EXPECT_FALSE(tgt.is_tracing_basic_blocks());
+
+    EXPECT_CALL(subscr, notify_basic_block(_, _, _, _, _)).Times(0);
+    tgt.notify_basic_block(0x100, 8, 2, SC_ZERO_TIME);
+}
+
+TEST(target, profiler) {
+    mock_target tgt("profiler");
+    profiler prof(tgt, PROFILE_CYCLES, 100, 4, 2);
+
+    tgt.pc = 0x1000;
+    prof.update(50);
+    EXPECT_EQ(prof.total_samples(), 0);
+    prof.update(100);
+    EXPECT_EQ(prof.total_samples(), 1);
+
+    tgt.pc = 0x2000;
+    prof.update(400);
+    EXPECT_EQ(prof.total_samples(), 4);
+    prof.update(450);
+    EXPECT_EQ(prof.total_samples(), 4);
+
+    stringstream folded;
+    prof.write_folded(folded);
+    EXPECT_EQ(folded.str(), "0x1000 1\n0x2000 3\n");
+
+    stringstream report;
+    prof.write_report(report);
+    EXPECT_THAT(report.str(), HasSubstr(" 75.00%  75.00%  0x2000"));
+    EXPECT_THAT(report.str(), HasSubstr(" 25.00%  25.00%  0x1000"));
+}
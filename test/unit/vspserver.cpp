@@ -0,0 +1,192 @@
+/******************************************************************************
+ *                                                                            *
+ * Copyright (C) 2026 MachineWare GmbH                                        *
+ * All Rights Reserved                                                        *
+ *                                                                            *
+ * This work is licensed under the terms described in the LICENSE file found  *
+ * in the root directory of this source tree.                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+#include "testing.h"
+using namespace ::vcml::debugging;
+
+class vsp_target : public module, public target
+{
+public:
+    property<u32> value;
+    u32 reg;
+    u8 mem[16];
+
+    vsp_target(const sc_module_name& nm):
+        module(nm), target(*this), value("value", 1), reg(0x11223344), mem() {
+        define_cpureg_rw(0, "r0", 4);
+        SC_HAS_PROCESS(vsp_target);
+        SC_THREAD(run);
+    }
+
+    void run() {
+        while (true)
+            wait(1, SC_US);
+    }
+
+    virtual bool read_reg_dbg(size_t regno, void* buf, size_t len) override {
+        memcpy(buf, &reg, min(len, sizeof(reg)));
+        return true;
+    }
+
+    virtual bool write_reg_dbg(size_t regno, const void* buf,
+                               size_t len) override {
+        return true;
+    }
+
+    virtual u64 read_vmem_dbg(u64 addr, void* buf, u64 size) override {
+        return read_pmem_dbg(addr, buf, size);
+    }
+
+    virtual u64 read_pmem_dbg(u64 addr, void* buf, u64 size) override {
+        memset(buf, 0, size);
+        if (addr >= sizeof(mem))
+            return 0;
+        size = min<u64>(size, sizeof(mem) - addr);
+        memcpy(buf, mem + addr, size);
+        return size;
+    }
+};
+
+static void test_batch(vspserver& server) {
+    const string version = server.handle_command(0, "version");
+    const string reply = mkstr("%zu:", version.length()) + version;
+
+    EXPECT_EQ(server.handle_command(0, "batch"), "OK");
+    EXPECT_EQ(server.handle_command(0, "batch,7:version"), "OK," + reply);
+    EXPECT_EQ(server.handle_command(0, "batch,7:version,14:geta,tgt.value"),
+              "OK," + reply + ",4:OK,1");
+
+    // lengths must be decimal, present and match the command exactly
+    EXPECT_EQ(server.handle_command(0, "batch,"), "E,malformed batch");
+    EXPECT_EQ(server.handle_command(0, "batch,7version"), "E,malformed batch");
+    EXPECT_EQ(server.handle_command(0, "batch,:version"), "E,malformed batch");
+    EXPECT_EQ(server.handle_command(0, "batch,x:version"),
+              "E,malformed batch");
+    EXPECT_EQ(server.handle_command(0, "batch,-7:version"),
+              "E,malformed batch");
+    EXPECT_EQ(server.handle_command(0, "batch,8:version"),
+              "E,malformed batch");
+    EXPECT_EQ(server.handle_command(0, "batch,6:version"),
+              "E,malformed batch");
+    EXPECT_EQ(server.handle_command(0, "batch,99999999999999999999:version"),
+              "E,malformed batch");
+
+    // a trailing comma announces another command that never comes
+    EXPECT_EQ(server.handle_command(0, "batch,7:version,"),
+              "E,malformed batch");
+
+    // batches cannot contain batches
+    EXPECT_EQ(server.handle_command(0, "batch,15:batch,7:version"),
+              "E,nested batch");
+    EXPECT_EQ(server.handle_command(0, "batch,7:version,15:batch,7:version"),
+              "E,nested batch");
+}
+
+static void test_binary(vspserver& server, vsp_target& tgt) {
+    const u8 data[] = { '$', '#', '}', '*', 0x00, 'a', 0x80, 0xff };
+    memcpy(tgt.mem, data, sizeof(data));
+
+    const string raw = "OK," + string((const char*)data, sizeof(data));
+    EXPECT_EQ(server.handle_command(0, "vread,tgt,0,8,bin"), raw);
+    EXPECT_EQ(server.handle_command(0, "pread,tgt,0,8,bin"), raw);
+    EXPECT_EQ(server.handle_command(0, "vread,tgt,0,2"), "OK,0x24,0x23");
+    EXPECT_EQ(server.handle_command(0, "pread,tgt,4,2,hex"), "OK,0x00,0x61");
+
+    // framing characters get escaped, everything else including NUL is
+    // sent as is and contributes to the checksum
+    string body = "OK,}\x04}\x03}]}\x0a";
+    body += string("\0a\x80\xff", 4);
+
+    u8 sum = 0;
+    for (char c : body)
+        sum += (u8)c;
+
+    string packet = rsp_packet(raw);
+    ASSERT_EQ(packet.length(), body.length() + 4);
+    EXPECT_EQ(packet[0], '$');
+    EXPECT_EQ(packet.substr(1, body.length()), body);
+    EXPECT_EQ(packet[body.length() + 1], '#');
+    EXPECT_EQ(std::stoul(packet.substr(body.length() + 2), nullptr, 16), sum);
+
+    EXPECT_EQ(rsp_packet(raw, '%')[0], '%');
+    EXPECT_EQ(rsp_packet(raw, '%').substr(1), packet.substr(1));
+}
+
+static void test_subscriptions(vspserver& server, vsp_target& tgt) {
+    vspclient client(server, 42, "localhost", 0);
+    string notification;
+
+    EXPECT_FALSE(client.collect_updates(notification));
+    EXPECT_EQ(client.handle_sub("sub,a,tgt.value"), "OK,0,1");
+    EXPECT_EQ(client.handle_sub("sub,r,tgt,r0"), "OK,1,44332211");
+    EXPECT_EQ(client.handle_sub("sub,a,tgt.nothing"),
+              "E,attribute 'tgt.nothing' not found");
+    EXPECT_EQ(client.handle_sub("sub,r,tgt,r1"), "E,no such register: r1");
+    EXPECT_EQ(client.handle_sub("sub,x,tgt"),
+              "E,unknown subscription type 'x'");
+
+    // nothing changed since subscribing
+    EXPECT_FALSE(client.collect_updates(notification));
+
+    const string prefix = mkstr("notify,%llu", time_to_ns(sc_time_stamp()));
+
+    tgt.value = 2;
+    EXPECT_TRUE(client.collect_updates(notification));
+    EXPECT_EQ(notification, prefix + ",0:2");
+    EXPECT_FALSE(client.collect_updates(notification));
+
+    tgt.reg = 0x55667788;
+    EXPECT_TRUE(client.collect_updates(notification));
+    EXPECT_EQ(notification, prefix + ",1:88776655");
+
+    tgt.value = 3;
+    tgt.reg = 0x11223344;
+    EXPECT_TRUE(client.collect_updates(notification));
+    EXPECT_EQ(notification, prefix + ",0:3,1:44332211");
+
+    // setting a value back and forth in between is not a change
+    tgt.value = 4;
+    tgt.value = 3;
+    EXPECT_FALSE(client.collect_updates(notification));
+
+    EXPECT_EQ(client.handle_unsub("unsub,0"), "OK");
+    EXPECT_EQ(client.handle_unsub("unsub,0"), "E,invalid subscription id: 0");
+    tgt.value = 5;
+    EXPECT_FALSE(client.collect_updates(notification));
+
+    EXPECT_EQ(client.handle_unsub("unsub,1"), "OK");
+    tgt.reg = 0;
+    EXPECT_FALSE(client.collect_updates(notification));
+}
+
+TEST(vspserver, commands) {
+    vsp_target tgt("tgt");
+    vspserver server("localhost", 0);
+
+    // profiles are only handed out while the simulation is stopped
+    EXPECT_EQ(server.handle_command(0, "hprof"), "E,simulation running");
+
+    // the server starts out suspended, commands are handled while it waits
+    std::thread client([&]() -> void {
+        while (!suspender::simulation_suspended())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        test_batch(server);
+        test_binary(server, tgt);
+        test_subscriptions(server, tgt);
+
+        EXPECT_NE(server.handle_command(0, "hprof"), "E,simulation running");
+
+        EXPECT_EQ(server.handle_command(0, "quit"), "OK");
+    });
+
+    server.start();
+    client.join();
+}